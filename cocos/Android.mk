@@ -8,7 +8,10 @@ LOCAL_MODULE_FILENAME := libcocos2d
 
 LOCAL_SRC_FILES := $(LOCAL_PATH)/base/CCConfiguration.cpp \
                    $(LOCAL_PATH)/base/CCConsole.cpp \
+                   $(LOCAL_PATH)/base/CCAssetBundle.cpp \
+                   $(LOCAL_PATH)/base/CCAutoreleasePool.cpp \
                    $(LOCAL_PATH)/base/CCData.cpp \
+                   $(LOCAL_PATH)/base/CCMappedFile.cpp \
                    $(LOCAL_PATH)/base/ccRandom.cpp \
                    $(LOCAL_PATH)/base/CCRef.cpp \
                    $(LOCAL_PATH)/base/ccTypes.cpp \
@@ -30,7 +33,10 @@ LOCAL_SRC_FILES := $(LOCAL_PATH)/base/CCConfiguration.cpp \
                    $(LOCAL_PATH)/math/Vec4.cpp \
                    $(LOCAL_PATH)/platform/CCFileUtils.cpp \
                    $(LOCAL_PATH)/platform/CCImage.cpp \
+                   $(LOCAL_PATH)/platform/CCImageDecoder.cpp \
+                   $(LOCAL_PATH)/platform/CCPlistParser.cpp \
                    $(LOCAL_PATH)/platform/CCSAXParser.cpp \
+                   $(LOCAL_PATH)/platform/CCXMLPullParser.cpp \
                    $(LOCAL_PATH)/platform/android/CCFileUtils-android.cpp \
                    $(LOCAL_PATH)/platform/android/javaactivity-android.cpp \
                    $(LOCAL_PATH)/platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxHelper.cpp \
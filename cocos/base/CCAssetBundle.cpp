@@ -0,0 +1,420 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCAssetBundle.h"
+#include "base/ZipUtils.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+
+#include <zlib.h>
+#include <algorithm>
+
+#if CC_USE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#if CC_USE_ZSTD
+#include <zstd.h>
+#endif
+
+NS_CC_BEGIN
+
+static_assert(sizeof(AssetBundle::Header) == 32, "AssetBundle::Header must match the file layout");
+static_assert(sizeof(AssetBundle::Entry) == 40, "AssetBundle::Entry must match the file layout");
+
+namespace
+{
+    const char BUNDLE_MAGIC[4] = { 'C', 'C', 'A', 'B' };
+}
+
+AssetBundle* AssetBundle::createWithFile(const std::string& fullPath)
+{
+    MappedFile* file = FileUtils::getInstance()->mapFile(fullPath);
+    if (!file)
+    {
+        CCLOG("cocos2d: AssetBundle: can't open %s", fullPath.c_str());
+        return nullptr;
+    }
+
+    AssetBundle* bundle = createWithMappedFile(file);
+    file->release();
+    if (!bundle)
+        CCLOG("cocos2d: AssetBundle: %s is not a valid bundle", fullPath.c_str());
+    return bundle;
+}
+
+AssetBundle* AssetBundle::createWithMappedFile(MappedFile* file)
+{
+    if (!file)
+        return nullptr;
+
+    AssetBundle* bundle = new (std::nothrow) AssetBundle();
+    if (bundle && !bundle->initWithMappedFile(file))
+    {
+        bundle->release();
+        bundle = nullptr;
+    }
+    return bundle;
+}
+
+uint64_t AssetBundle::hashName(const char* name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool AssetBundle::isCompressionSupported(Compression compression)
+{
+    switch (compression)
+    {
+        case Compression::NONE:
+        case Compression::DEFLATE:
+            return true;
+        case Compression::LZ4:
+            return CC_USE_LZ4 != 0;
+        case Compression::ZSTD:
+            return CC_USE_ZSTD != 0;
+    }
+    return false;
+}
+
+AssetBundle::AssetBundle()
+: _file(nullptr)
+, _index(nullptr)
+, _names(nullptr)
+, _entryCount(0)
+, _alignment(0)
+{
+}
+
+AssetBundle::~AssetBundle()
+{
+    CC_SAFE_RELEASE(_file);
+}
+
+bool AssetBundle::initWithMappedFile(MappedFile* file)
+{
+    const unsigned char* bytes = file->getBytes();
+    const uint64_t size = file->getSize();
+
+    Header header;
+    if (size < sizeof(header))
+        return false;
+    memcpy(&header, bytes, sizeof(header));
+
+    if (memcmp(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0 || header.version != VERSION)
+        return false;
+    if (0 == header.alignment || (header.alignment & (header.alignment - 1)) != 0)
+        return false;
+    if (header.indexOffset > size || (size - header.indexOffset) / sizeof(Entry) < header.entryCount || header.namesOffset > size)
+        return false;
+
+    _index = bytes + header.indexOffset;
+    _names = reinterpret_cast<const char*>(bytes + header.namesOffset);
+    _entryCount = header.entryCount;
+    _alignment = header.alignment;
+
+    // Check every entry once so that reads don't have to.
+    const uint64_t namesSize = size - header.namesOffset;
+    Entry entry;
+    for (uint32_t i = 0; i < _entryCount; ++i)
+    {
+        readEntry(i, &entry);
+        if ((uint64_t)entry.nameOffset + entry.nameLength > namesSize || entry.offset > size || entry.size > size - entry.offset)
+            return false;
+    }
+
+    file->retain();
+    _file = file;
+    return true;
+}
+
+void AssetBundle::readEntry(uint32_t index, Entry* entry) const
+{
+    // The mapping may not be 8 bytes aligned, e.g. an asset in an apk.
+    memcpy(entry, _index + (size_t)index * sizeof(Entry), sizeof(Entry));
+}
+
+bool AssetBundle::findEntry(const std::string& name, Entry* entry) const
+{
+    const uint64_t hash = hashName(name.data(), name.size());
+
+    // lower bound of the hash
+    uint32_t first = 0;
+    uint32_t count = _entryCount;
+    while (count > 0)
+    {
+        uint32_t step = count / 2;
+        uint64_t midHash;
+        memcpy(&midHash, _index + (size_t)(first + step) * sizeof(Entry), sizeof(midHash));
+        if (midHash < hash)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    for (uint32_t i = first; i < _entryCount; ++i)
+    {
+        readEntry(i, entry);
+        if (entry->hash != hash)
+            break;
+        if (entry->nameLength == name.size() && memcmp(_names + entry->nameOffset, name.data(), name.size()) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool AssetBundle::fileExists(const std::string& name) const
+{
+    Entry entry;
+    return findEntry(name, &entry);
+}
+
+ssize_t AssetBundle::getFileSize(const std::string& name) const
+{
+    Entry entry;
+    if (!findEntry(name, &entry))
+        return -1;
+    return (ssize_t)entry.originalSize;
+}
+
+bool AssetBundle::decompress(const Entry& entry, unsigned char* out) const
+{
+    const unsigned char* in = _file->getBytes() + entry.offset;
+    switch ((Compression)entry.compression)
+    {
+        case Compression::NONE:
+            if (entry.size != entry.originalSize)
+                return false;
+            memcpy(out, in, entry.size);
+            return true;
+        case Compression::DEFLATE:
+            return ZipUtils::inflateMemoryTo(in, entry.size, out, entry.originalSize) == (ssize_t)entry.originalSize;
+#if CC_USE_LZ4
+        case Compression::LZ4:
+            return LZ4_decompress_safe((const char*)in, (char*)out, (int)entry.size, (int)entry.originalSize) == (int)entry.originalSize;
+#endif
+#if CC_USE_ZSTD
+        case Compression::ZSTD:
+            return ZSTD_decompress(out, entry.originalSize, in, entry.size) == entry.originalSize;
+#endif
+        default:
+            CCLOG("cocos2d: AssetBundle: compression %d isn't supported by this build", (int)entry.compression);
+            return false;
+    }
+}
+
+bool AssetBundle::getFileData(const std::string& name, ResizableBuffer* buffer) const
+{
+    Entry entry;
+    if (!findEntry(name, &entry))
+        return false;
+
+    buffer->resize(entry.originalSize);
+    return entry.originalSize == 0 || decompress(entry, static_cast<unsigned char*>(buffer->buffer()));
+}
+
+MappedFile* AssetBundle::mapFile(const std::string& name) const
+{
+    Entry entry;
+    if (!findEntry(name, &entry))
+        return nullptr;
+
+    if (Compression::NONE == (Compression)entry.compression)
+    {
+        MappedFile* file = _file;
+        file->retain();
+        return MappedFile::createWithMapping(file->getBytes() + entry.offset, entry.size, [file](const unsigned char*, ssize_t) {
+            file->release();
+        });
+    }
+
+    Data data;
+    ResizableBufferAdapter<Data> buffer(&data);
+    buffer.resize(entry.originalSize);
+    if (entry.originalSize > 0 && !decompress(entry, data.getBytes()))
+        return nullptr;
+    return MappedFile::createWithData(std::move(data));
+}
+
+std::vector<std::string> AssetBundle::getFileNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(_entryCount);
+    Entry entry;
+    for (uint32_t i = 0; i < _entryCount; ++i)
+    {
+        readEntry(i, &entry);
+        names.emplace_back(_names + entry.nameOffset, entry.nameLength);
+    }
+    return names;
+}
+
+// --------------------- AssetBundleWriter ---------------------
+
+AssetBundleWriter::AssetBundleWriter(uint32_t alignment)
+: _alignment(alignment)
+{
+    CCASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "The alignment must be a power of 2");
+}
+
+bool AssetBundleWriter::addFile(const std::string& name, const unsigned char* data, ssize_t size, AssetBundle::Compression compression)
+{
+    if (name.empty() || name.size() > UINT16_MAX || size < 0 || _names.count(name))
+        return false;
+    if (!AssetBundle::isCompressionSupported(compression))
+    {
+        CCLOG("cocos2d: AssetBundleWriter: compression %d isn't supported by this build", (int)compression);
+        return false;
+    }
+
+    File file;
+    file.name = name;
+    file.compression = compression;
+    file.originalSize = size;
+
+    switch (compression)
+    {
+        case AssetBundle::Compression::DEFLATE:
+        {
+            uLongf compressedSize = compressBound(size);
+            file.data.resize(compressedSize);
+            if (compress2(file.data.data(), &compressedSize, data, size, Z_BEST_COMPRESSION) != Z_OK)
+                return false;
+            file.data.resize(compressedSize);
+            break;
+        }
+#if CC_USE_LZ4
+        case AssetBundle::Compression::LZ4:
+        {
+            file.data.resize(LZ4_compressBound((int)size));
+            int compressedSize = LZ4_compress_HC((const char*)data, (char*)file.data.data(), (int)size, (int)file.data.size(), LZ4HC_CLEVEL_MAX);
+            if (compressedSize <= 0)
+                return false;
+            file.data.resize(compressedSize);
+            break;
+        }
+#endif
+#if CC_USE_ZSTD
+        case AssetBundle::Compression::ZSTD:
+        {
+            file.data.resize(ZSTD_compressBound(size));
+            size_t compressedSize = ZSTD_compress(file.data.data(), file.data.size(), data, size, 19);
+            if (ZSTD_isError(compressedSize))
+                return false;
+            file.data.resize(compressedSize);
+            break;
+        }
+#endif
+        default:
+            break;
+    }
+
+    // Not worth decompressing.
+    if (AssetBundle::Compression::NONE == compression || (ssize_t)file.data.size() >= size)
+    {
+        file.compression = AssetBundle::Compression::NONE;
+        file.data.assign(data, data + size);
+    }
+
+    _names.insert(name);
+    _files.push_back(std::move(file));
+    return true;
+}
+
+bool AssetBundleWriter::save(const std::string& fullPath) const
+{
+    // sorted by hash, then name, for the binary search
+    std::vector<std::pair<uint64_t, const File*>> order;
+    order.reserve(_files.size());
+    for (const auto& file : _files)
+        order.emplace_back(AssetBundle::hashName(file.name.data(), file.name.size()), &file);
+    std::sort(order.begin(), order.end(), [](const std::pair<uint64_t, const File*>& a, const std::pair<uint64_t, const File*>& b) {
+        return a.first != b.first ? a.first < b.first : a.second->name < b.second->name;
+    });
+
+    auto align = [this](uint64_t offset) {
+        return (offset + _alignment - 1) & ~(uint64_t)(_alignment - 1);
+    };
+
+    AssetBundle::Header header;
+    memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = AssetBundle::VERSION;
+    header.entryCount = (uint32_t)_files.size();
+    header.alignment = _alignment;
+    header.indexOffset = sizeof(header);
+    header.namesOffset = header.indexOffset + order.size() * sizeof(AssetBundle::Entry);
+
+    std::vector<AssetBundle::Entry> index(order.size());
+    std::string names;
+    uint64_t offset = header.namesOffset;
+    for (const auto& item : order)
+        offset += item.second->name.size();
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const File& file = *order[i].second;
+        AssetBundle::Entry& entry = index[i];
+        offset = align(offset);
+        entry.hash = order[i].first;
+        entry.offset = offset;
+        entry.size = file.data.size();
+        entry.originalSize = file.originalSize;
+        entry.nameOffset = (uint32_t)names.size();
+        entry.nameLength = (uint16_t)file.name.size();
+        entry.compression = (uint8_t)file.compression;
+        entry.reserved = 0;
+        names += file.name;
+        offset += file.data.size();
+    }
+
+    std::vector<unsigned char> bundle(std::max<uint64_t>(offset, header.namesOffset + names.size()), 0);
+    memcpy(bundle.data(), &header, sizeof(header));
+    if (!index.empty())
+        memcpy(bundle.data() + header.indexOffset, index.data(), index.size() * sizeof(AssetBundle::Entry));
+    memcpy(bundle.data() + header.namesOffset, names.data(), names.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const File& file = *order[i].second;
+        if (!file.data.empty())
+            memcpy(bundle.data() + index[i].offset, file.data.data(), file.data.size());
+    }
+
+    Data data;
+    data.fastSet(bundle.data(), bundle.size());
+    bool ret = FileUtils::getInstance()->writeDataToFile(data, fullPath);
+    data.fastSet(nullptr, 0);
+    return ret;
+}
+
+NS_CC_END
@@ -0,0 +1,164 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+#include "base/CCMappedFile.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @js NA
+ * @lua NA
+ */
+NS_CC_BEGIN
+
+class ResizableBuffer;
+
+/**
+ * A packed bundle of asset files, read from a single memory mapping.
+ *
+ * The file starts with a Header, followed by the Entry index sorted by name hash, the entry names and
+ * the file data. Each file starts at a multiple of the bundle alignment, so a stored file can be
+ * uploaded straight from the mapping. Files may be compressed one by one.
+ * All integers are little endian. Bundles are written by AssetBundleWriter.
+ *
+ * The bundle is immutable, it can be read from several threads at the same time.
+ */
+class CC_DLL AssetBundle : public Ref
+{
+public:
+    enum class Compression : uint8_t
+    {
+        NONE = 0,
+        DEFLATE = 1,    /** zlib stream */
+        LZ4 = 2,        /** LZ4 block, needs CC_USE_LZ4 */
+        ZSTD = 3,       /** zstd frame, needs CC_USE_ZSTD */
+    };
+
+    struct Header
+    {
+        char magic[4];              /** "CCAB" */
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t alignment;         /** of the file data, a power of 2 */
+        uint64_t indexOffset;       /** Entry[entryCount] sorted by hash, then name */
+        uint64_t namesOffset;       /** entry names, not terminated */
+    };
+
+    struct Entry
+    {
+        uint64_t hash;              /** AssetBundle::hashName() of the name */
+        uint64_t offset;            /** of the data from the start of the bundle */
+        uint64_t size;              /** of the data in the bundle */
+        uint64_t originalSize;      /** of the data once decompressed */
+        uint32_t nameOffset;        /** from Header::namesOffset */
+        uint16_t nameLength;
+        uint8_t compression;        /** Compression */
+        uint8_t reserved;
+    };
+
+    static const uint32_t VERSION = 1;
+
+    /** Maps the bundle at `fullPath`. The returned object has to be released. */
+    static AssetBundle* createWithFile(const std::string& fullPath);
+    /** Reads the bundle from `file`, which is retained. The returned object has to be released. */
+    static AssetBundle* createWithMappedFile(MappedFile* file);
+
+    /** 64-bit FNV-1a hash of a name, as stored in the index. */
+    static uint64_t hashName(const char* name, size_t length);
+
+    /** Whether a compression can be read (and written) by this build. */
+    static bool isCompressionSupported(Compression compression);
+
+    bool fileExists(const std::string& name) const;
+    /** The size of the file once decompressed, -1 if the bundle doesn't contain it. */
+    ssize_t getFileSize(const std::string& name) const;
+    /** Reads and decompresses a file into `buffer`. */
+    bool getFileData(const std::string& name, ResizableBuffer* buffer) const;
+    /**
+     * Returns the contents of a file without copying it when it is stored uncompressed, the view retains the bundle.
+     * A compressed file is decompressed into memory. The returned object has to be released.
+     */
+    MappedFile* mapFile(const std::string& name) const;
+
+    uint32_t getEntryCount() const { return _entryCount; }
+    uint32_t getAlignment() const { return _alignment; }
+    std::vector<std::string> getFileNames() const;
+
+private:
+    AssetBundle();
+    virtual ~AssetBundle();
+
+    bool initWithMappedFile(MappedFile* file);
+    bool findEntry(const std::string& name, Entry* entry) const;
+    void readEntry(uint32_t index, Entry* entry) const;
+    bool decompress(const Entry& entry, unsigned char* out) const;
+
+    MappedFile* _file;
+    const unsigned char* _index;
+    const char* _names;
+    uint32_t _entryCount;
+    uint32_t _alignment;
+};
+
+/**
+ * Writes an AssetBundle. Files are kept in memory until save().
+ */
+class CC_DLL AssetBundleWriter
+{
+public:
+    /** @param alignment The alignment of the file data in the bundle, a power of 2. */
+    explicit AssetBundleWriter(uint32_t alignment = 64);
+
+    /**
+     * Adds a file. A compressed file which doesn't get smaller is stored uncompressed.
+     * @return false if the name is already used, too long, or the compression isn't supported.
+     */
+    bool addFile(const std::string& name, const unsigned char* data, ssize_t size, AssetBundle::Compression compression = AssetBundle::Compression::NONE);
+
+    /** Writes the bundle to `fullPath`. */
+    bool save(const std::string& fullPath) const;
+
+private:
+    struct File
+    {
+        std::string name;
+        AssetBundle::Compression compression;
+        ssize_t originalSize;
+        std::vector<unsigned char> data;
+    };
+
+    uint32_t _alignment;
+    std::vector<File> _files;
+    std::unordered_set<std::string> _names;
+};
+
+NS_CC_END
+/** @} */
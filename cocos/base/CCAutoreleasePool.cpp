@@ -0,0 +1,151 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCAutoreleasePool.h"
+#include "base/CCConsole.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // The manager of a thread, destroyed when the thread exits. The manager stays set while it is
+    // deleted, so objects autoreleased while its pools are released go to the same manager.
+    struct ThreadPoolManager
+    {
+        PoolManager* manager = nullptr;
+
+        ~ThreadPoolManager()
+        {
+            PoolManager::destroyInstance();
+        }
+    };
+
+    thread_local ThreadPoolManager s_threadPoolManager;
+}
+
+AutoreleasePool::AutoreleasePool()
+: AutoreleasePool("")
+{
+}
+
+AutoreleasePool::AutoreleasePool(const std::string& name)
+: _name(name)
+, _isClearing(false)
+, _manager(PoolManager::getInstance())
+{
+    _managedObjectArray.reserve(150);
+    _manager->push(this);
+}
+
+AutoreleasePool::~AutoreleasePool()
+{
+    clear();
+    _manager->pop();
+}
+
+void AutoreleasePool::addObject(Ref* object)
+{
+    _managedObjectArray.push_back(object);
+}
+
+void AutoreleasePool::clear()
+{
+    _isClearing = true;
+    while (!_managedObjectArray.empty())
+    {
+        _releasingObjectArray.swap(_managedObjectArray);
+        for (auto object : _releasingObjectArray)
+            object->release();
+        _releasingObjectArray.clear();
+    }
+    _isClearing = false;
+}
+
+bool AutoreleasePool::contains(Ref* object) const
+{
+    return std::find(_managedObjectArray.begin(), _managedObjectArray.end(), object) != _managedObjectArray.end()
+        || std::find(_releasingObjectArray.begin(), _releasingObjectArray.end(), object) != _releasingObjectArray.end();
+}
+
+void AutoreleasePool::dump() const
+{
+    log("autorelease pool: %s, number of managed object %d", _name.c_str(), static_cast<int>(_managedObjectArray.size()));
+    log("%20s%20s", "Object pointer", "reference count");
+    for (const auto object : _managedObjectArray)
+        log("%20p%20u", object, object->getReferenceCount());
+}
+
+PoolManager* PoolManager::getInstance()
+{
+    auto& manager = s_threadPoolManager.manager;
+    if (nullptr == manager)
+    {
+        manager = new (std::nothrow) PoolManager();
+        // Adds itself to the manager.
+        new (std::nothrow) AutoreleasePool("cocos2d autorelease pool");
+    }
+    return manager;
+}
+
+void PoolManager::destroyInstance()
+{
+    delete s_threadPoolManager.manager;
+    s_threadPoolManager.manager = nullptr;
+}
+
+PoolManager::PoolManager()
+{
+    _releasePoolStack.reserve(10);
+}
+
+PoolManager::~PoolManager()
+{
+    while (!_releasePoolStack.empty())
+        delete _releasePoolStack.back();
+}
+
+bool PoolManager::isObjectInPools(Ref* object) const
+{
+    for (const auto pool : _releasePoolStack)
+    {
+        if (pool->contains(object))
+            return true;
+    }
+    return false;
+}
+
+void PoolManager::push(AutoreleasePool* pool)
+{
+    _releasePoolStack.push_back(pool);
+}
+
+void PoolManager::pop()
+{
+    CC_ASSERT(!_releasePoolStack.empty());
+    _releasePoolStack.pop_back();
+}
+
+NS_CC_END
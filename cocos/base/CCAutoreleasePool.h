@@ -0,0 +1,133 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCRef.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+class PoolManager;
+
+/**
+ * A pool of objects which are released together, see Ref::autorelease().
+ *
+ * A pool becomes the current pool of the thread which creates it and stays current until it is destroyed,
+ * so a pool on the stack collects the objects autoreleased in its scope:
+ * @code
+ * {
+ *     AutoreleasePool pool;
+ *     ... // objects autoreleased here are released when `pool` goes out of scope
+ * }
+ * @endcode
+ * @js NA
+ */
+class CC_DLL AutoreleasePool
+{
+public:
+    /** Creates a pool and makes it the current pool of the calling thread. */
+    AutoreleasePool();
+    /** Creates a named pool, the name is only used by dump(). */
+    explicit AutoreleasePool(const std::string& name);
+    /** Releases the objects in the pool and makes the previous pool current again. */
+    ~AutoreleasePool();
+
+    /**
+     * Adds an object which is released by the next clear().
+     * An object added several times is released several times.
+     */
+    void addObject(Ref* object);
+
+    /**
+     * Releases every object in the pool in one pass.
+     * Objects autoreleased by the destructors of released objects are released by the same call.
+     * The storage of the pool is kept, so clearing it every frame does not allocate.
+     */
+    void clear();
+
+    /** Whether clear() is releasing the objects of the pool. */
+    inline bool isClearing() const { return _isClearing; }
+    /** Whether `object` is waiting to be released by the pool. */
+    bool contains(Ref* object) const;
+    /** Number of pending releases. */
+    inline size_t getObjectCount() const { return _managedObjectArray.size(); }
+
+    /** Logs the name of the pool and the objects in it. */
+    void dump() const;
+
+private:
+    std::vector<Ref*> _managedObjectArray;
+    // Swapped with _managedObjectArray by clear() so objects can be added while the batch is released.
+    std::vector<Ref*> _releasingObjectArray;
+    std::string _name;
+    bool _isClearing;
+    PoolManager* _manager;
+};
+
+/**
+ * The stack of autorelease pools of a thread.
+ *
+ * Every thread has its own manager, created on first use with one pool at the bottom of its stack.
+ * The owner of a frame loop drains that pool once per frame, after the frame is rendered:
+ * @code
+ * PoolManager::getInstance()->getCurrentPool()->clear();
+ * @endcode
+ * The manager of a thread and the objects left in its pools are released when the thread exits.
+ * @js NA
+ */
+class CC_DLL PoolManager
+{
+public:
+    /** Returns the manager of the calling thread. */
+    static PoolManager* getInstance();
+    /** Releases the manager of the calling thread and every object left in its pools. */
+    static void destroyInstance();
+
+    /** Returns the pool which receives the objects autoreleased by the calling thread. */
+    inline AutoreleasePool* getCurrentPool() const { return _releasePoolStack.back(); }
+
+    /** Whether `object` is waiting to be released by one of the pools of the manager. */
+    bool isObjectInPools(Ref* object) const;
+
+private:
+    friend class AutoreleasePool;
+
+    PoolManager();
+    ~PoolManager();
+
+    void push(AutoreleasePool* pool);
+    void pop();
+
+    std::vector<AutoreleasePool*> _releasePoolStack;
+};
+
+NS_CC_END
+/** @} */
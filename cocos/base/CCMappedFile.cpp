@@ -0,0 +1,69 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "base/CCMappedFile.h"
+
+#include <new>
+
+NS_CC_BEGIN
+
+MappedFile* MappedFile::createWithMapping(const unsigned char* bytes, ssize_t size, const Unmapper& unmapper)
+{
+    auto file = new (std::nothrow) MappedFile();
+    if (file)
+    {
+        file->_bytes = bytes;
+        file->_size = size;
+        file->_unmapper = unmapper;
+    }
+    else if (unmapper)
+        unmapper(bytes, size);
+    return file;
+}
+
+MappedFile* MappedFile::createWithData(Data&& data)
+{
+    auto file = new (std::nothrow) MappedFile();
+    if (file)
+    {
+        file->_data = std::move(data);
+        file->_bytes = file->_data.getBytes();
+        file->_size = file->_data.getSize();
+    }
+    return file;
+}
+
+MappedFile::MappedFile()
+: _bytes(nullptr)
+, _size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    if (_unmapper)
+        _unmapper(_bytes, _size);
+}
+
+NS_CC_END
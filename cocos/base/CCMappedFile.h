@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+
+#include <functional>
+
+/**
+ * @addtogroup base
+ * @js NA
+ * @lua NA
+ */
+NS_CC_BEGIN
+
+/**
+ * A read-only view of the contents of a file, returned by FileUtils::mapFile().
+ * The bytes are memory mapped when the platform can map the file, otherwise they are read into memory.
+ * They stay valid as long as the object is retained.
+ */
+class CC_DLL MappedFile : public Ref
+{
+public:
+    /** Releases the bytes of a mapping. */
+    typedef std::function<void(const unsigned char* bytes, ssize_t size)> Unmapper;
+
+    /**
+     * Wraps `size` bytes mapped by the platform, `unmapper` is invoked with them when the object is destroyed.
+     * The returned object has to be released.
+     */
+    static MappedFile* createWithMapping(const unsigned char* bytes, ssize_t size, const Unmapper& unmapper);
+    /** Takes the contents of a file which was read into `data`. The returned object has to be released. */
+    static MappedFile* createWithData(Data&& data);
+
+    inline const unsigned char* getBytes() const { return _bytes; }
+    inline ssize_t getSize() const { return _size; }
+    /** Whether the bytes are memory mapped instead of read into memory. */
+    inline bool isMapped() const { return _unmapper != nullptr; }
+
+    /** Whether [data, data + dataLen) lies inside the file contents. */
+    inline bool contains(const unsigned char* data, ssize_t dataLen) const
+    {
+        return _bytes && data >= _bytes && data + dataLen <= _bytes + _size;
+    }
+
+private:
+    MappedFile();
+    virtual ~MappedFile();
+
+    const unsigned char* _bytes;
+    ssize_t _size;
+    Unmapper _unmapper;
+    Data _data;
+};
+
+NS_CC_END
+/** @} */
@@ -24,48 +24,149 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "CCRef.h"
+#include "base/CCAutoreleasePool.h"
+
+#if CC_REF_LEAK_DETECTION
+#include "base/CCConsole.h"
+
+#include <algorithm>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_set>
+#include <vector>
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+#endif
 
 NS_CC_BEGIN
 
+#if CC_REF_LEAK_DETECTION
+namespace
+{
+    // Never destroyed, Refs may be released by the destructors of other statics.
+    std::mutex& getLiveObjectsMutex()
+    {
+        static std::mutex* mutex = new std::mutex();
+        return *mutex;
+    }
+
+    std::unordered_set<Ref*>& getLiveObjects()
+    {
+        static std::unordered_set<Ref*>* objects = new std::unordered_set<Ref*>();
+        return *objects;
+    }
+
+    std::string getTypeName(const std::type_info& type)
+    {
+#if defined(__GNUC__)
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (demangled)
+        {
+            std::string name(demangled);
+            free(demangled);
+            return name;
+        }
+#endif
+        return type.name();
+    }
+}
+#endif
+
 Ref::Ref()
 : _referenceCount(1) // when the Ref is created, the reference count of it is 1
 {
+#if CC_REF_LEAK_DETECTION
+    std::lock_guard<std::mutex> lock(getLiveObjectsMutex());
+    getLiveObjects().insert(this);
+#endif
 }
 
 Ref::~Ref()
 {
+#if CC_REF_LEAK_DETECTION
+    std::lock_guard<std::mutex> lock(getLiveObjectsMutex());
+    getLiveObjects().erase(this);
+#endif
 }
 
 void Ref::retain()
 {
+#if CC_REF_THREAD_SAFE
+    // Only the decrements order the writes of the owners, a new reference is taken from an existing one.
+    _referenceCount.fetch_add(1, std::memory_order_relaxed);
+#else
     ++_referenceCount;
+#endif
 }
 
 void Ref::release()
 {
+#if CC_REF_THREAD_SAFE
+    // The last release has to see the writes made by every other owner before they released.
+    if (1 != _referenceCount.fetch_sub(1, std::memory_order_acq_rel))
+        return;
+#else
     --_referenceCount;
+    if (_referenceCount != 0)
+        return;
+#endif
 
-    if (_referenceCount == 0)
-    {
-        delete this;
-    }
+#if CC_REF_LEAK_DETECTION
+    // An object released by its owner while it is still in a pool would be released again by the pool.
+    auto poolManager = PoolManager::getInstance();
+    CC_ASSERT(poolManager->getCurrentPool()->isClearing() || !poolManager->isObjectInPools(this));
+#endif
+    onLastRelease();
+}
+
+void Ref::onLastRelease()
+{
+    delete this;
 }
 
 Ref* Ref::autorelease()
 {
-    //TODO:    release();
-//    return this;
-//    PoolManager::getInstance()->getCurrentPool()->addObject(this);
-//    return this;
-    //assert(false);
-//    return nullptr;
-    
+    PoolManager::getInstance()->getCurrentPool()->addObject(this);
     return this;
 }
 
 unsigned int Ref::getReferenceCount() const
 {
+#if CC_REF_THREAD_SAFE
+    return _referenceCount.load(std::memory_order_relaxed);
+#else
     return _referenceCount;
+#endif
+}
+
+#if CC_REF_LEAK_DETECTION
+std::unordered_map<std::string, unsigned int> Ref::getLiveObjectCounts()
+{
+    std::unordered_map<std::string, unsigned int> counts;
+    std::lock_guard<std::mutex> lock(getLiveObjectsMutex());
+    for (const auto object : getLiveObjects())
+        ++counts[getTypeName(typeid(*object))];
+    return counts;
+}
+
+void Ref::printLeaks()
+{
+    auto counts = getLiveObjectCounts();
+    if (counts.empty())
+    {
+        log("[Ref] no live objects");
+        return;
+    }
+
+    std::vector<std::pair<std::string, unsigned int>> sorted(counts.begin(), counts.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, unsigned int>& a, const std::pair<std::string, unsigned int>& b) {
+        return a.second > b.second;
+    });
+    for (const auto& entry : sorted)
+        log("[Ref] %u live %s", entry.second, entry.first.c_str());
 }
+#endif
 
 NS_CC_END
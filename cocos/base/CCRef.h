@@ -27,6 +27,15 @@ THE SOFTWARE.
 
 #include "platform/CCPlatformMacros.h"
 
+#if CC_REF_THREAD_SAFE
+#include <atomic>
+#endif
+
+#if CC_REF_LEAK_DETECTION
+#include <string>
+#include <unordered_map>
+#endif
+
 NS_CC_BEGIN
 
 /**
@@ -52,8 +61,8 @@ public:
      *
      * This decrements the Ref's reference count.
      *
-     * If the reference count reaches 0 after the decrement, this Ref is
-     * destructed.
+     * If the reference count reaches 0 after the decrement, onLastRelease()
+     * destructs this Ref.
      *
      * @see retain, autorelease
      * @js NA
@@ -85,6 +94,22 @@ public:
      */
     unsigned int getReferenceCount() const;
 
+#if CC_REF_LEAK_DETECTION
+    /**
+     * Returns the number of live Ref objects of each type, keyed by the name of the type.
+     *
+     * Comparing two results shows which types are allocated but never released.
+     * @js NA
+     */
+    static std::unordered_map<std::string, unsigned int> getLiveObjectCounts();
+
+    /**
+     * Logs the number of live Ref objects of each type, call it at shutdown to find leaks.
+     * @js NA
+     */
+    static void printLeaks();
+#endif
+
 protected:
     /**
      * Constructor
@@ -94,6 +119,15 @@ protected:
      */
     Ref();
 
+    /**
+     * Invoked by release() when the reference count reaches 0, deletes the Ref.
+     *
+     * Subclasses which have to be destructed on a specific thread, like GL
+     * objects, override it to queue themselves to that thread.
+     * @js NA
+     */
+    virtual void onLastRelease();
+
 public:
     /**
      * Destructor
@@ -105,7 +139,11 @@ public:
 
 protected:
     /// count of references
+#if CC_REF_THREAD_SAFE
+    std::atomic<unsigned int> _referenceCount;
+#else
     unsigned int _referenceCount;
+#endif
 };
 
 NS_CC_END
@@ -26,6 +26,9 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
 //#include "base/ccUtils.h"
 
 #define MAX_ITOA_BUFFER_SIZE 256
@@ -51,6 +54,54 @@ static double _atof(const char* str)
 
 NS_CC_BEGIN
 
+template <typename T>
+struct Value::Shared
+{
+    std::atomic<int> refs;
+    // false once a non-const reference was handed out, copies must not see later writes through it
+    bool shareable;
+    T value;
+
+    Shared() : refs(1), shareable(true) {}
+    explicit Shared(const T& v) : refs(1), shareable(true), value(v) {}
+    explicit Shared(T&& v) : refs(1), shareable(true), value(std::move(v)) {}
+
+    Shared* share()
+    {
+        if (!shareable)
+            return new (std::nothrow) Shared(value);
+
+        refs.fetch_add(1, std::memory_order_relaxed);
+        return this;
+    }
+
+    void release()
+    {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+
+    // Copies the container if another Value shares it, before it is modified.
+    static T& detach(Shared*& shared)
+    {
+        if (shared->refs.load(std::memory_order_acquire) != 1)
+        {
+            Shared* copy = new (std::nothrow) Shared(shared->value);
+            shared->release();
+            shared = copy;
+        }
+        shared->shareable = false;
+        return shared->value;
+    }
+};
+
+namespace
+{
+    std::mutex s_internedMutex;
+    // never freed, interned Values may outlive static destruction
+    std::unordered_set<std::string>* s_interned = nullptr;
+}
+
 const ValueVector ValueVectorNull;
 const ValueMap ValueMapNull;
 const ValueMapIntKey ValueMapIntKeyNull;
@@ -100,74 +151,76 @@ Value::Value(bool v)
 }
 
 Value::Value(const char* v)
-: _type(Type::STRING)
+: _type(Type::NONE)
 {
-    _field.strVal = new (std::nothrow) std::string();
     if (v)
-    {
-        *_field.strVal = v;
-    }
+        setString(v, strlen(v));
+    else
+        setString("", 0);
 }
 
 Value::Value(const std::string& v)
-: _type(Type::STRING)
+: _type(Type::NONE)
+{
+    setString(v.data(), v.length());
+}
+
+Value::Value(std::string&& v)
+: _type(Type::NONE)
 {
-    _field.strVal = new (std::nothrow) std::string();
-    *_field.strVal = v;
+    setString(std::move(v));
 }
 
 Value::Value(const ValueVector& v)
 : _type(Type::VECTOR)
 {
-    _field.vectorVal = new (std::nothrow) ValueVector();
-    *_field.vectorVal = v;
+    _field.vectorVal = new (std::nothrow) Shared<ValueVector>(v);
 }
 
 Value::Value(ValueVector&& v)
 : _type(Type::VECTOR)
 {
-    _field.vectorVal = new (std::nothrow) ValueVector();
-    *_field.vectorVal = std::move(v);
+    _field.vectorVal = new (std::nothrow) Shared<ValueVector>(std::move(v));
 }
 
 Value::Value(const ValueMap& v)
 : _type(Type::MAP)
 {
-    _field.mapVal = new (std::nothrow) ValueMap();
-    *_field.mapVal = v;
+    _field.mapVal = new (std::nothrow) Shared<ValueMap>(v);
 }
 
 Value::Value(ValueMap&& v)
 : _type(Type::MAP)
 {
-    _field.mapVal = new (std::nothrow) ValueMap();
-    *_field.mapVal = std::move(v);
+    _field.mapVal = new (std::nothrow) Shared<ValueMap>(std::move(v));
 }
 
 Value::Value(const ValueMapIntKey& v)
 : _type(Type::INT_KEY_MAP)
 {
-    _field.intKeyMapVal = new (std::nothrow) ValueMapIntKey();
-    *_field.intKeyMapVal = v;
+    _field.intKeyMapVal = new (std::nothrow) Shared<ValueMapIntKey>(v);
 }
 
 Value::Value(ValueMapIntKey&& v)
 : _type(Type::INT_KEY_MAP)
 {
-    _field.intKeyMapVal = new (std::nothrow) ValueMapIntKey();
-    *_field.intKeyMapVal = std::move(v);
+    _field.intKeyMapVal = new (std::nothrow) Shared<ValueMapIntKey>(std::move(v));
 }
 
 Value::Value(const Value& other)
 : _type(Type::NONE)
 {
-    *this = other;
+    copyFrom(other);
 }
 
-Value::Value(Value&& other)
-: _type(Type::NONE)
+Value::Value(Value&& other) noexcept
+: _field(other._field)
+, _type(other._type)
+, _stringStorage(other._stringStorage)
+, _shortStringLength(other._shortStringLength)
 {
-    *this = std::move(other);
+    other._type = Type::NONE;
+    other._stringStorage = StringStorage::INLINE;
 }
 
 Value::~Value()
@@ -177,112 +230,62 @@ Value::~Value()
 
 Value& Value::operator= (const Value& other)
 {
-    if (this != &other) {
-        reset(other._type);
-
-        switch (other._type) {
-            case Type::BYTE:
-                _field.byteVal = other._field.byteVal;
-                break;
-            case Type::INTEGER:
-                _field.intVal = other._field.intVal;
-                break;
-            case Type::UNSIGNED:
-                _field.unsignedVal = other._field.unsignedVal;
-                break;
-            case Type::FLOAT:
-                _field.floatVal = other._field.floatVal;
-                break;
-            case Type::DOUBLE:
-                _field.doubleVal = other._field.doubleVal;
-                break;
-            case Type::BOOLEAN:
-                _field.boolVal = other._field.boolVal;
-                break;
-            case Type::STRING:
-                if (_field.strVal == nullptr)
-                {
-                    _field.strVal = new std::string();
-                }
-                *_field.strVal = *other._field.strVal;
-                break;
-            case Type::VECTOR:
-                if (_field.vectorVal == nullptr)
-                {
-                    _field.vectorVal = new (std::nothrow) ValueVector();
-                }
-                *_field.vectorVal = *other._field.vectorVal;
-                break;
-            case Type::MAP:
-                if (_field.mapVal == nullptr)
-                {
-                    _field.mapVal = new (std::nothrow) ValueMap();
-                }
-                *_field.mapVal = *other._field.mapVal;
-                break;
-            case Type::INT_KEY_MAP:
-                if (_field.intKeyMapVal == nullptr)
-                {
-                    _field.intKeyMapVal = new (std::nothrow) ValueMapIntKey();
-                }
-                *_field.intKeyMapVal = *other._field.intKeyMapVal;
-                break;
-            default:
-                break;
+    if (this != &other)
+    {
+        // reuse the buffer of a long string
+        if (_type == Type::STRING && _stringStorage == StringStorage::HEAP &&
+            other._type == Type::STRING && other._stringStorage == StringStorage::HEAP)
+        {
+            *_field.strVal = *other._field.strVal;
+        }
+        else
+        {
+            // other may live inside this Value's container, copy it before releasing anything
+            Value tmp(other);
+            swap(tmp);
         }
     }
     return *this;
 }
 
-Value& Value::operator= (Value&& other)
+Value& Value::operator= (Value&& other) noexcept
 {
     if (this != &other)
     {
-        clear();
-        switch (other._type)
-        {
-            case Type::BYTE:
-                _field.byteVal = other._field.byteVal;
-                break;
-            case Type::INTEGER:
-                _field.intVal = other._field.intVal;
-                break;
-            case Type::UNSIGNED:
-                _field.unsignedVal = other._field.unsignedVal;
-                break;
-            case Type::FLOAT:
-                _field.floatVal = other._field.floatVal;
-                break;
-            case Type::DOUBLE:
-                _field.doubleVal = other._field.doubleVal;
-                break;
-            case Type::BOOLEAN:
-                _field.boolVal = other._field.boolVal;
-                break;
-            case Type::STRING:
-                _field.strVal = other._field.strVal;
-                break;
-            case Type::VECTOR:
-                _field.vectorVal = other._field.vectorVal;
-                break;
-            case Type::MAP:
-                _field.mapVal = other._field.mapVal;
-                break;
-            case Type::INT_KEY_MAP:
-                _field.intKeyMapVal = other._field.intKeyMapVal;
-                break;
-            default:
-                break;
-        }
-        _type = other._type;
-
-        memset(&other._field, 0, sizeof(other._field));
-        other._type = Type::NONE;
+        Value tmp(std::move(other));
+        swap(tmp);
     }
 
     return *this;
 }
 
+void Value::swap(Value& other) noexcept
+{
+    std::swap(_field, other._field);
+    std::swap(_type, other._type);
+    std::swap(_stringStorage, other._stringStorage);
+    std::swap(_shortStringLength, other._shortStringLength);
+}
+
+Value Value::intern(const std::string& v)
+{
+    Value ret;
+    if (v.length() <= SHORT_STRING_CAPACITY)
+    {
+        // as cheap to copy inline as interned
+        ret.setString(v.data(), v.length());
+        return ret;
+    }
+
+    std::lock_guard<std::mutex> lock(s_internedMutex);
+    if (!s_interned)
+        s_interned = new std::unordered_set<std::string>();
+    ret._field.internedStrVal = &(*s_interned->insert(v).first);
+    ret._stringStorage = StringStorage::INTERNED;
+    ret._type = Type::STRING;
+    return ret;
+}
+
 Value& Value::operator= (unsigned char v)
 {
     reset(Type::BYTE);
@@ -327,57 +330,77 @@ Value& Value::operator= (bool v)
 
 Value& Value::operator= (const char* v)
 {
-    reset(Type::STRING);
-    *_field.strVal = v ? v : "";
+    if (v)
+        setString(v, strlen(v));
+    else
+        setString("", 0);
     return *this;
 }
 
 Value& Value::operator= (const std::string& v)
 {
-    reset(Type::STRING);
-    *_field.strVal = v;
+    setString(v.data(), v.length());
     return *this;
 }
 
+Value& Value::operator= (std::string&& v)
+{
+    setString(std::move(v));
+    return *this;
+}
+
+// The new container is built before the old one is released, v may be part of it.
 Value& Value::operator= (const ValueVector& v)
 {
-    reset(Type::VECTOR);
-    *_field.vectorVal = v;
+    auto shared = new (std::nothrow) Shared<ValueVector>(v);
+    clear();
+    _field.vectorVal = shared;
+    _type = Type::VECTOR;
     return *this;
 }
 
 Value& Value::operator= (ValueVector&& v)
 {
-    reset(Type::VECTOR);
-    *_field.vectorVal = std::move(v);
+    auto shared = new (std::nothrow) Shared<ValueVector>(std::move(v));
+    clear();
+    _field.vectorVal = shared;
+    _type = Type::VECTOR;
     return *this;
 }
 
 Value& Value::operator= (const ValueMap& v)
 {
-    reset(Type::MAP);
-    *_field.mapVal = v;
+    auto shared = new (std::nothrow) Shared<ValueMap>(v);
+    clear();
+    _field.mapVal = shared;
+    _type = Type::MAP;
     return *this;
 }
 
 Value& Value::operator= (ValueMap&& v)
 {
-    reset(Type::MAP);
-    *_field.mapVal = std::move(v);
+    auto shared = new (std::nothrow) Shared<ValueMap>(std::move(v));
+    clear();
+    _field.mapVal = shared;
+    _type = Type::MAP;
     return *this;
 }
 
 Value& Value::operator= (const ValueMapIntKey& v)
 {
-    reset(Type::INT_KEY_MAP);
-    *_field.intKeyMapVal = v;
+    auto shared = new (std::nothrow) Shared<ValueMapIntKey>(v);
+    clear();
+    _field.intKeyMapVal = shared;
+    _type = Type::INT_KEY_MAP;
     return *this;
 }
 
 Value& Value::operator= (ValueMapIntKey&& v)
 {
-    reset(Type::INT_KEY_MAP);
-    *_field.intKeyMapVal = std::move(v);
+    auto shared = new (std::nothrow) Shared<ValueMapIntKey>(std::move(v));
+    clear();
+    _field.intKeyMapVal = shared;
+    _type = Type::INT_KEY_MAP;
     return *this;
 }
 
@@ -406,13 +429,20 @@ bool Value::operator== (const Value& v) const
         case Type::INTEGER: return v._field.intVal      == this->_field.intVal;
         case Type::UNSIGNED:return v._field.unsignedVal == this->_field.unsignedVal;
         case Type::BOOLEAN: return v._field.boolVal     == this->_field.boolVal;
-        case Type::STRING:  return *v._field.strVal     == *this->_field.strVal;
+        case Type::STRING:
+        {
+            if (_stringStorage == StringStorage::INTERNED && v._stringStorage == StringStorage::INTERNED)
+                return _field.internedStrVal == v._field.internedStrVal;
+            size_t length = getStringLength();
+            return length == v.getStringLength() && memcmp(getStringData(), v.getStringData(), length) == 0;
+        }
         case Type::FLOAT:   return std::abs(v._field.floatVal  - this->_field.floatVal)  <= FLT_EPSILON;
         case Type::DOUBLE:  return std::abs(v._field.doubleVal - this->_field.doubleVal) <= DBL_EPSILON;
         case Type::VECTOR:
         {
-            const auto &v1 = *(this->_field.vectorVal);
-            const auto &v2 = *(v._field.vectorVal);
+            if (_field.vectorVal == v._field.vectorVal) return true;
+            const auto &v1 = this->_field.vectorVal->value;
+            const auto &v2 = v._field.vectorVal->value;
             const auto size = v1.size();
             if (size == v2.size())
             {
@@ -426,8 +456,9 @@ bool Value::operator== (const Value& v) const
         }
         case Type::MAP:
         {
-            const auto &map1 = *(this->_field.mapVal);
-            const auto &map2 = *(v._field.mapVal);
+            if (_field.mapVal == v._field.mapVal) return true;
+            const auto &map1 = this->_field.mapVal->value;
+            const auto &map2 = v._field.mapVal->value;
             for (const auto &kvp : map1)
             {
                 auto it = map2.find(kvp.first);
@@ -440,8 +471,9 @@ bool Value::operator== (const Value& v) const
         }
         case Type::INT_KEY_MAP:
         {
-            const auto &map1 = *(this->_field.intKeyMapVal);
-            const auto &map2 = *(v._field.intKeyMapVal);
+            if (_field.intKeyMapVal == v._field.intKeyMapVal) return true;
+            const auto &map1 = this->_field.intKeyMapVal->value;
+            const auto &map2 = v._field.intKeyMapVal->value;
             for (const auto &kvp : map1)
             {
                 auto it = map2.find(kvp.first);
@@ -481,7 +513,7 @@ unsigned char Value::asByte() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<unsigned char>(atoi(_field.strVal->c_str()));
+        return static_cast<unsigned char>(atoi(getStringData()));
     }
 
     if (_type == Type::FLOAT)
@@ -523,7 +555,7 @@ int Value::asInt() const
 
     if (_type == Type::STRING)
     {
-        return atoi(_field.strVal->c_str());
+        return atoi(getStringData());
     }
 
     if (_type == Type::FLOAT)
@@ -567,7 +599,7 @@ unsigned int Value::asUnsignedInt() const
     if (_type == Type::STRING)
     {
         // NOTE: strtoul is required (need to augment on unsupported platforms)
-        return static_cast<unsigned int>(strtoul(_field.strVal->c_str(), nullptr, 10));
+        return static_cast<unsigned int>(strtoul(getStringData(), nullptr, 10));
     }
 
     if (_type == Type::FLOAT)
@@ -603,7 +635,7 @@ float Value::asFloat() const
 
     if (_type == Type::STRING)
     {
-        return _atof(_field.strVal->c_str());
+        return _atof(getStringData());
     }
 
     if (_type == Type::INTEGER)
@@ -644,7 +676,7 @@ double Value::asDouble() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<double>(_atof(_field.strVal->c_str()));
+        return static_cast<double>(_atof(getStringData()));
     }
 
     if (_type == Type::INTEGER)
@@ -685,7 +717,9 @@ bool Value::asBool() const
 
     if (_type == Type::STRING)
     {
-        return (*_field.strVal == "0" || *_field.strVal == "false") ? false : true;
+        const char* data = getStringData();
+        size_t length = getStringLength();
+        return ((length == 1 && data[0] == '0') || (length == 5 && memcmp(data, "false", 5) == 0)) ? false : true;
     }
 
     if (_type == Type::INTEGER)
@@ -717,7 +751,7 @@ std::string Value::asString() const
 
     if (_type == Type::STRING)
     {
-        return *_field.strVal;
+        return std::string(getStringData(), getStringLength());
     }
 
     std::stringstream ret;
@@ -751,37 +785,37 @@ std::string Value::asString() const
 ValueVector& Value::asValueVector()
 {
     CCASSERT(_type == Type::VECTOR, "The value type isn't Type::VECTOR");
-    return *_field.vectorVal;
+    return Shared<ValueVector>::detach(_field.vectorVal);
 }
 
 const ValueVector& Value::asValueVector() const
 {
     CCASSERT(_type == Type::VECTOR, "The value type isn't Type::VECTOR");
-    return *_field.vectorVal;
+    return _field.vectorVal->value;
 }
 
 ValueMap& Value::asValueMap()
 {
     CCASSERT(_type == Type::MAP, "The value type isn't Type::MAP");
-    return *_field.mapVal;
+    return Shared<ValueMap>::detach(_field.mapVal);
 }
 
 const ValueMap& Value::asValueMap() const
 {
     CCASSERT(_type == Type::MAP, "The value type isn't Type::MAP");
-    return *_field.mapVal;
+    return _field.mapVal->value;
 }
 
 ValueMapIntKey& Value::asIntKeyMap()
 {
     CCASSERT(_type == Type::INT_KEY_MAP, "The value type isn't Type::INT_KEY_MAP");
-    return *_field.intKeyMapVal;
+    return Shared<ValueMapIntKey>::detach(_field.intKeyMapVal);
 }
 
 const ValueMapIntKey& Value::asIntKeyMap() const
 {
     CCASSERT(_type == Type::INT_KEY_MAP, "The value type isn't Type::INT_KEY_MAP");
-    return *_field.intKeyMapVal;
+    return _field.intKeyMapVal->value;
 }
 
 static std::string getTabs(int depth)
@@ -904,16 +938,21 @@ void Value::clear()
             _field.boolVal = false;
             break;
         case Type::STRING:
-            CC_SAFE_DELETE(_field.strVal);
+            if (_stringStorage == StringStorage::HEAP)
+                CC_SAFE_DELETE(_field.strVal);
+            _stringStorage = StringStorage::INLINE;
             break;
         case Type::VECTOR:
-            CC_SAFE_DELETE(_field.vectorVal);
+            if (_field.vectorVal)
+                _field.vectorVal->release();
             break;
         case Type::MAP:
-            CC_SAFE_DELETE(_field.mapVal);
+            if (_field.mapVal)
+                _field.mapVal->release();
             break;
         case Type::INT_KEY_MAP:
-            CC_SAFE_DELETE(_field.intKeyMapVal);
+            if (_field.intKeyMapVal)
+                _field.intKeyMapVal->release();
             break;
         default:
             break;
@@ -924,31 +963,107 @@ void Value::clear()
 
 void Value::reset(Type type)
 {
-    if (_type == type)
-        return;
-
+    // only used for the types that don't allocate
     clear();
+    _type = type;
+}
 
-    // Allocate memory for the new value
-    switch (type)
+void Value::copyFrom(const Value& other)
+{
+    switch (other._type)
     {
         case Type::STRING:
-            _field.strVal = new (std::nothrow) std::string();
+            if (other._stringStorage == StringStorage::HEAP)
+                _field.strVal = new (std::nothrow) std::string(*other._field.strVal);
+            else
+                _field = other._field;
+            _stringStorage = other._stringStorage;
+            _shortStringLength = other._shortStringLength;
             break;
         case Type::VECTOR:
-            _field.vectorVal = new (std::nothrow) ValueVector();
+            _field.vectorVal = other._field.vectorVal->share();
             break;
         case Type::MAP:
-            _field.mapVal = new (std::nothrow) ValueMap();
+            _field.mapVal = other._field.mapVal->share();
             break;
         case Type::INT_KEY_MAP:
-            _field.intKeyMapVal = new (std::nothrow) ValueMapIntKey();
+            _field.intKeyMapVal = other._field.intKeyMapVal->share();
             break;
         default:
+            _field = other._field;
             break;
     }
+    _type = other._type;
+}
 
-    _type = type;
+void Value::setString(const char* data, size_t length)
+{
+    if (_type == Type::STRING && _stringStorage == StringStorage::HEAP && length > SHORT_STRING_CAPACITY)
+    {
+        _field.strVal->assign(data, length);
+        return;
+    }
+
+    clear();
+    if (length <= SHORT_STRING_CAPACITY)
+    {
+        memcpy(_field.shortStrVal, data, length);
+        _field.shortStrVal[length] = '\0';
+        _shortStringLength = (unsigned char)length;
+        _stringStorage = StringStorage::INLINE;
+    }
+    else
+    {
+        _field.strVal = new (std::nothrow) std::string(data, length);
+        _stringStorage = StringStorage::HEAP;
+    }
+    _type = Type::STRING;
+}
+
+void Value::setString(std::string&& v)
+{
+    if (v.length() <= SHORT_STRING_CAPACITY)
+    {
+        setString(v.data(), v.length());
+        return;
+    }
+
+    if (_type == Type::STRING && _stringStorage == StringStorage::HEAP)
+    {
+        *_field.strVal = std::move(v);
+        return;
+    }
+
+    clear();
+    _field.strVal = new (std::nothrow) std::string(std::move(v));
+    _stringStorage = StringStorage::HEAP;
+    _type = Type::STRING;
+}
+
+const char* Value::getStringData() const
+{
+    switch (_stringStorage)
+    {
+        case StringStorage::HEAP:
+            return _field.strVal->c_str();
+        case StringStorage::INTERNED:
+            return _field.internedStrVal->c_str();
+        default:
+            return _field.shortStrVal;
+    }
+}
+
+size_t Value::getStringLength() const
+{
+    switch (_stringStorage)
+    {
+        case StringStorage::HEAP:
+            return _field.strVal->length();
+        case StringStorage::INTERNED:
+            return _field.internedStrVal->length();
+        default:
+            return _shortStringLength;
+    }
 }
 
 NS_CC_END
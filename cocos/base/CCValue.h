@@ -50,6 +50,9 @@ CC_DLL extern const ValueMapIntKey ValueMapIntKeyNull;
 
 /*
  * This class is provide as a wrapper of basic types, such as int and bool.
+ * Strings of up to 15 chars are stored inline, longer ones on the heap or, for interned values, shared.
+ * Vectors and maps are copy-on-write: copying a Value shares the container until one side asks for a
+ * non-const reference to it.
  */
 class CC_DLL Value
 {
@@ -83,6 +86,8 @@ public:
 
     /** Create a Value by a string. */
     explicit Value(const std::string& v);
+    /** Create a Value by a string. It will use std::move internally. */
+    explicit Value(std::string&& v);
 
     /** Create a Value by a ValueVector object. */
     explicit Value(const ValueVector& v);
@@ -102,7 +107,7 @@ public:
     /** Create a Value by another Value object. */
     Value(const Value& other);
     /** Create a Value by a Value object. It will use std::move internally. */
-    Value(Value&& other);
+    Value(Value&& other) noexcept;
 
     /** Destructor. */
     ~Value();
@@ -110,7 +115,7 @@ public:
     /** Assignment operator, assign from Value to Value. */
     Value& operator= (const Value& other);
     /** Assignment operator, assign from Value to Value. It will use std::move internally. */
-    Value& operator= (Value&& other);
+    Value& operator= (Value&& other) noexcept;
 
     /** Assignment operator, assign from unsigned char to Value. */
     Value& operator= (unsigned char v);
@@ -128,6 +133,8 @@ public:
     Value& operator= (const char* v);
     /** Assignment operator, assign from string to Value. */
     Value& operator= (const std::string& v);
+    /** Assignment operator, assign from string to Value. It will use std::move internally. */
+    Value& operator= (std::string&& v);
 
     /** Assignment operator, assign from ValueVector to Value. */
     Value& operator= (const ValueVector& v);
@@ -144,6 +151,16 @@ public:
     /** Assignment operator, assign from ValueMapIntKey to Value. It will use std::move internally. */
     Value& operator= (ValueMapIntKey&& v);
 
+    /** Swaps the contents of two Values, never allocates. */
+    void swap(Value& other) noexcept;
+
+    /**
+     * Creates a string Value from a table of interned strings: all the interned Values of a string
+     * share one immutable copy, so copying and comparing them doesn't touch the characters.
+     * Interned strings are never freed, use it for keys and names that repeat, not for arbitrary data.
+     */
+    static Value intern(const std::string& v);
+
     /** != operator overloading */
     bool operator!= (const Value& v);
     /** != operator overloading */
@@ -223,8 +240,25 @@ public:
     std::string getDescription() const;
 
 private:
+    static const size_t SHORT_STRING_CAPACITY = 15;
+
+    enum class StringStorage : unsigned char
+    {
+        INLINE,
+        HEAP,
+        INTERNED
+    };
+
+    // A reference counted container, shared by the Values copied from each other.
+    template <typename T> struct Shared;
+
     void clear();
     void reset(Type type);
+    void copyFrom(const Value& other);
+    void setString(const char* data, size_t length);
+    void setString(std::string&& v);
+    const char* getStringData() const;
+    size_t getStringLength() const;
 
     union
     {
@@ -235,13 +269,17 @@ private:
         double doubleVal;
         bool boolVal;
 
+        char shortStrVal[SHORT_STRING_CAPACITY + 1];
         std::string* strVal;
-        ValueVector* vectorVal;
-        ValueMap* mapVal;
-        ValueMapIntKey* intKeyMapVal;
+        const std::string* internedStrVal;
+        Shared<ValueVector>* vectorVal;
+        Shared<ValueMap>* mapVal;
+        Shared<ValueMapIntKey>* intKeyMapVal;
     }_field;
 
     Type _type;
+    StringStorage _stringStorage = StringStorage::INLINE;
+    unsigned char _shortStringLength = 0;
 };
 
 /** @} */
@@ -40,6 +40,14 @@
 #include "base/ccMacros.h"
 #include "platform/CCFileUtils.h"
 #include <map>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if CC_USE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
 
 // FIXME: Other platforms should use upstream minizip like mingw-w64
 #ifdef MINIZIP_FROM_SYSTEM
@@ -143,13 +151,145 @@ inline unsigned int ZipUtils::checksumPvr(const unsigned int *data, ssize_t len)
 // Should buffer factor be 1.5 instead of 2 ?
 #define BUFFER_INC_FACTOR (2)
 
+// gzread() reads concatenated gzip members as one file, do the same when a member ends.
+static bool startNextGZipMember(z_stream& stream)
+{
+    if (stream.avail_in < 2 || stream.next_in[0] != 0x1F || stream.next_in[1] != 0x8B)
+        return false;
+    return inflateReset(&stream) == Z_OK;
+}
+
+ssize_t ZipUtils::getInflatedSize(const unsigned char *in, ssize_t inLength)
+{
+    if (isCCZBuffer(in, inLength) && in[3] == '!')
+    {
+        return CC_SWAP_INT32_BIG_TO_HOST(((const struct CCZHeader*)in)->len);
+    }
+
+    // the gzip trailer ends with the inflated size modulo 2^32 (ISIZE), little endian
+    if (isGZipBuffer(in, inLength) && inLength >= 18)
+    {
+        const unsigned char* isize = in + inLength - 4;
+        return (ssize_t)((uint32_t)isize[0] | ((uint32_t)isize[1] << 8) | ((uint32_t)isize[2] << 16) | ((uint32_t)isize[3] << 24));
+    }
+
+    return -1;
+}
+
+ssize_t ZipUtils::inflateMemoryTo(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength)
+{
+#if CC_USE_LIBDEFLATE
+    // whole buffer decode, much faster than zlib's streaming inflate
+    libdeflate_decompressor* decompressor = libdeflate_alloc_decompressor();
+    if (decompressor)
+    {
+        size_t inflated = 0;
+        libdeflate_result result = isGZipBuffer(in, inLength)
+            ? libdeflate_gzip_decompress(decompressor, in, inLength, out, outLength, &inflated)
+            : libdeflate_zlib_decompress(decompressor, in, inLength, out, outLength, &inflated);
+        libdeflate_free_decompressor(decompressor);
+        if (LIBDEFLATE_SUCCESS == result)
+            return inflated;
+        // concatenated gzip members aren't supported by libdeflate, let zlib try
+    }
+#endif
+
+    z_stream d_stream;
+    memset(&d_stream, 0, sizeof(d_stream));
+    d_stream.next_in = const_cast<unsigned char*>(in);
+    d_stream.avail_in = static_cast<unsigned int>(inLength);
+    d_stream.next_out = out;
+    d_stream.avail_out = static_cast<unsigned int>(outLength);
+
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+        return -1;
+
+    int err;
+    do
+    {
+        err = inflate(&d_stream, Z_FINISH);
+    } while (err == Z_STREAM_END && startNextGZipMember(d_stream));
+
+    ssize_t inflated = outLength - d_stream.avail_out;
+    inflateEnd(&d_stream);
+    return err == Z_STREAM_END ? inflated : -1;
+}
+
+bool ZipUtils::inflateMemoryStreamed(const unsigned char *in, ssize_t inLength, const InflateCallback& callback, ssize_t chunkSize)
+{
+    CCASSERT(chunkSize > 0, "chunkSize must be positive");
+
+    z_stream d_stream;
+    memset(&d_stream, 0, sizeof(d_stream));
+    d_stream.next_in = const_cast<unsigned char*>(in);
+    d_stream.avail_in = static_cast<unsigned int>(inLength);
+
+    if (inflateInit2(&d_stream, 15 + 32) != Z_OK)
+        return false;
+
+    std::vector<unsigned char> chunk(chunkSize);
+    int err = Z_OK;
+    for (;;)
+    {
+        d_stream.next_out = chunk.data();
+        d_stream.avail_out = static_cast<unsigned int>(chunkSize);
+
+        err = inflate(&d_stream, Z_NO_FLUSH);
+        if (err != Z_OK && err != Z_STREAM_END)
+            break;
+
+        ssize_t inflated = chunkSize - d_stream.avail_out;
+        if (inflated > 0 && !callback(chunk.data(), inflated))
+        {
+            err = Z_ERRNO;
+            break;
+        }
+
+        if (err == Z_STREAM_END && !startNextGZipMember(d_stream))
+            break;
+    }
+
+    inflateEnd(&d_stream);
+    return err == Z_STREAM_END;
+}
+
+bool ZipUtils::inflateGZipFileStreamed(const char *path, const InflateCallback& callback, ssize_t chunkSize)
+{
+    MappedFile* file = FileUtils::getInstance()->mapFile(path);
+    if (!file)
+    {
+        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
+        return false;
+    }
+
+    bool ret = false;
+    if (isGZipBuffer(file->getBytes(), file->getSize()))
+    {
+        ret = inflateMemoryStreamed(file->getBytes(), file->getSize(), callback, chunkSize);
+    }
+    else
+    {
+        // like gzread(), a file which isn't compressed is read as it is
+        ret = file->getSize() == 0 || callback(file->getBytes(), file->getSize());
+    }
+
+    file->release();
+    return ret;
+}
+
 int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint)
 {
     /* ret value */
     int err = Z_OK;
 
-    ssize_t bufferSize = outLengthHint;
+    // A gzip stream knows its size, then there is nothing to grow.
+    // Deflate can't compress better than 1032:1, a larger size comes from a damaged trailer.
+    ssize_t bufferSize = getInflatedSize(in, inLength);
+    if (bufferSize <= 0 || bufferSize / 1032 > inLength)
+        bufferSize = outLengthHint;
     *out = (unsigned char*)malloc(bufferSize);
+    if (! *out)
+        return Z_MEM_ERROR;
 
     z_stream d_stream; /* decompression stream */
     d_stream.zalloc = (alloc_func)0;
@@ -171,6 +311,8 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
 
         if (err == Z_STREAM_END)
         {
+            if (startNextGZipMember(d_stream))
+                continue;
             break;
         }
 
@@ -184,23 +326,30 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
                 return err;
         }
 
-        // not enough memory ?
-        if (err != Z_STREAM_END)
+        // the output is full, grow it
+        if (d_stream.avail_out == 0)
         {
-            *out = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
+            unsigned char* tmp = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
 
             /* not enough memory, ouch */
-            if (! *out )
+            if (! tmp )
             {
                 CCLOG("cocos2d: ZipUtils: realloc failed");
                 inflateEnd(&d_stream);
                 return Z_MEM_ERROR;
             }
 
+            *out = tmp;
             d_stream.next_out = *out + bufferSize;
             d_stream.avail_out = static_cast<unsigned int>(bufferSize);
             bufferSize *= BUFFER_INC_FACTOR;
         }
+        else if (err == Z_BUF_ERROR)
+        {
+            // no progress with room left, the input is truncated
+            inflateEnd(&d_stream);
+            return Z_DATA_ERROR;
+        }
     }
 
     *outLength = bufferSize - d_stream.avail_out;
@@ -249,72 +398,38 @@ ssize_t ZipUtils::inflateMemory(unsigned char *in, ssize_t inLength, unsigned ch
 
 int ZipUtils::inflateGZipFile(const char *path, unsigned char **out)
 {
-    int len;
-    unsigned int offset = 0;
-
     CCASSERT(out, "out can't be nullptr.");
     CCASSERT(&*out, "&*out can't be nullptr.");
 
-    gzFile inFile = gzopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "rb");
-    if( inFile == nullptr ) {
+    MappedFile* file = FileUtils::getInstance()->mapFile(path);
+    if (!file)
+    {
         CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path);
         return -1;
     }
 
-    /* 512k initial decompress buffer */
-    unsigned int bufferSize = 512 * 1024;
-    unsigned int totalBufferSize = bufferSize;
-
-    *out = (unsigned char*)malloc( bufferSize );
-    if( ! out )
+    ssize_t len = 0;
+    if (isGZipBuffer(file->getBytes(), file->getSize()))
     {
-        CCLOG("cocos2d: ZipUtils: out of memory");
-        return -1;
+        // sized by the gzip trailer, 512k if the stream doesn't tell
+        len = inflateMemoryWithHint(const_cast<unsigned char*>(file->getBytes()), file->getSize(), out, 512 * 1024);
     }
-
-    for (;;) {
-        len = gzread(inFile, *out + offset, bufferSize);
-        if (len < 0)
-        {
-            CCLOG("cocos2d: ZipUtils: error in gzread");
-            free( *out );
-            *out = nullptr;
-            return -1;
-        }
-        if (len == 0)
-        {
-            break;
-        }
-
-        offset += len;
-
-        // finish reading the file
-        if( (unsigned int)len < bufferSize )
-        {
-            break;
-        }
-
-        bufferSize *= BUFFER_INC_FACTOR;
-        totalBufferSize += bufferSize;
-        unsigned char *tmp = (unsigned char*)realloc(*out, totalBufferSize );
-
-        if( ! tmp )
-        {
-            CCLOG("cocos2d: ZipUtils: out of memory");
-            free( *out );
-            *out = nullptr;
-            return -1;
-        }
-
-        *out = tmp;
+    else
+    {
+        // like gzread(), a file which isn't compressed is read as it is
+        len = file->getSize();
+        *out = (unsigned char*)malloc(len);
+        if (*out)
+            memcpy(*out, file->getBytes(), len);
     }
+    file->release();
 
-    if (gzclose(inFile) != Z_OK)
+    if (! *out)
     {
-        CCLOG("cocos2d: ZipUtils: gzclose failed");
+        CCLOG("cocos2d: ZipUtils: error in inflateGZipFile %s", path);
+        return -1;
     }
-
-    return offset;
+    return (int)len;
 }
 
 bool ZipUtils::isCCZFile(const char *path)
@@ -368,86 +483,92 @@ bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
 }
 
 
-int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+const unsigned char* ZipUtils::getCCZPayload(const unsigned char *buffer, ssize_t bufferLen, ssize_t *payloadLen, unsigned int *inflatedLen, unsigned char **decrypted)
 {
-    struct CCZHeader *header = (struct CCZHeader*) buffer;
-
-    // verify header
-    if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!' )
+    *decrypted = nullptr;
+    if (!isCCZBuffer(buffer, bufferLen))
     {
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
-        if( version > 2 )
-        {
-            CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
-        }
-
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
-        {
-            CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
-        }
+        CCLOG("cocos2d: Invalid CCZ file");
+        return nullptr;
     }
-    else if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == 'p' )
+
+    const struct CCZHeader *header = (const struct CCZHeader*) buffer;
+
+    // verify compression format
+    if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
     {
-        // encrypted ccz file
-        header = (struct CCZHeader*) buffer;
+        CCLOG("cocos2d: CCZ Unsupported compression method");
+        return nullptr;
+    }
 
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
-        if( version > 0 )
-        {
-            CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
-        }
+    // verify header version
+    unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
+    if( version > (header->sig[3] == '!' ? 2u : 0u) )
+    {
+        CCLOG("cocos2d: Unsupported CCZ header format");
+        return nullptr;
+    }
 
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
-        {
-            CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
-        }
+    if( header->sig[3] == '!' )
+    {
+        *inflatedLen = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+        *payloadLen = bufferLen - sizeof(*header);
+        return buffer + sizeof(*header);
+    }
 
-        // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
-        ssize_t enclen = (bufferLen-12)/4;
+    // encrypted ccz file, everything after the reserved field is encrypted, the length too.
+    // Decrypt a copy, the buffer may be a read only mapping.
+    ssize_t enclen = (bufferLen-12)/4;
+    unsigned int* ints = (unsigned int*)malloc(bufferLen-12);
+    if (!ints)
+    {
+        CCLOG("cocos2d: CCZ: Failed to allocate memory for decryption");
+        return nullptr;
+    }
+    memcpy(ints, buffer+12, bufferLen-12);
 
-        decodeEncodedPvr(ints, enclen);
+    decodeEncodedPvr(ints, enclen);
 
 #if COCOS2D_DEBUG > 0
-        // verify checksum in debug mode
-        unsigned int calculated = checksumPvr(ints, enclen);
-        unsigned int required = CC_SWAP_INT32_BIG_TO_HOST( header->reserved );
+    // verify checksum in debug mode
+    unsigned int calculated = checksumPvr(ints, enclen);
+    unsigned int required = CC_SWAP_INT32_BIG_TO_HOST( header->reserved );
 
-        if(calculated != required)
-        {
-            CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
-            return -1;
-        }
-#endif
-    }
-    else
+    if(calculated != required)
     {
-        CCLOG("cocos2d: Invalid CCZ file");
-        return -1;
+        CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
+        free(ints);
+        return nullptr;
     }
+#endif
+
+    *decrypted = (unsigned char*)ints;
+    *inflatedLen = CC_SWAP_INT32_BIG_TO_HOST( ints[0] );
+    *payloadLen = bufferLen - sizeof(*header);
+    return *decrypted + 4;
+}
 
-    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+{
+    ssize_t payloadLen = 0;
+    unsigned int len = 0;
+    unsigned char* decrypted = nullptr;
+    const unsigned char* payload = getCCZPayload(buffer, bufferLen, &payloadLen, &len, &decrypted);
+    if (!payload)
+        return -1;
 
     *out = (unsigned char*)malloc( len );
     if(! *out )
     {
         CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
+        free(decrypted);
         return -1;
     }
 
-    unsigned long destlen = len;
-    size_t source = (size_t) buffer + sizeof(*header);
-    int ret = uncompress(*out, &destlen, (Bytef*)source, bufferLen - sizeof(*header) );
+    ssize_t ret = inflateMemoryTo(payload, payloadLen, *out, len);
+    free(decrypted);
 
-    if( ret != Z_OK )
+    if( ret != (ssize_t)len )
     {
         CCLOG("cocos2d: CCZ: Failed to uncompress data");
         free( *out );
@@ -458,6 +579,29 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
     return len;
 }
 
+ssize_t ZipUtils::inflateCCZBufferTo(const unsigned char *buffer, ssize_t bufferLen, unsigned char *out, ssize_t outLength)
+{
+    ssize_t payloadLen = 0;
+    unsigned int len = 0;
+    unsigned char* decrypted = nullptr;
+    const unsigned char* payload = getCCZPayload(buffer, bufferLen, &payloadLen, &len, &decrypted);
+    if (!payload)
+        return -1;
+
+    ssize_t ret = -1;
+    if ((ssize_t)len <= outLength)
+    {
+        ret = inflateMemoryTo(payload, payloadLen, out, len);
+        if (ret != (ssize_t)len)
+        {
+            CCLOG("cocos2d: CCZ: Failed to uncompress data");
+            ret = -1;
+        }
+    }
+    free(decrypted);
+    return ret;
+}
+
 int ZipUtils::inflateCCZFile(const char *path, unsigned char **out)
 {
     CCASSERT(out, "Invalid pointer for buffer!");
@@ -504,16 +648,106 @@ struct ZipEntryInfo
 {
     unz_file_pos pos;
     uLong uncompressed_size;
+    // where the data of a stored entry starts in an in-memory archive, 0 if it has to be read through unzip
+    ZPOS64_T stored_offset;
 };
 
 class ZipFilePrivate
 {
 public:
+    // handle used to list the entries, reads borrow their own handles
     unzFile zipFile;
 
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
     FileListContainer fileList;
+
+    // the archive read by createWithMappedFile()
+    MappedFile* mappedFile;
+
+    // what read handles are opened on, the path of the archive or the archive in memory
+    std::string zipPath;
+    const unsigned char* buffer;
+    uLong bufferSize;
+
+    // idle read handles, each read takes one so that concurrent reads don't share a position in the archive
+    std::mutex handlesMutex;
+    std::vector<unzFile> handles;
+
+    ZipFilePrivate()
+    : zipFile(nullptr)
+    , mappedFile(nullptr)
+    , buffer(nullptr)
+    , bufferSize(0)
+    {
+    }
+
+    ~ZipFilePrivate()
+    {
+        for (auto handle : handles)
+            unzClose(handle);
+        if (zipFile)
+            unzClose(zipFile);
+        CC_SAFE_RELEASE(mappedFile);
+    }
+
+    unzFile acquireHandle()
+    {
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex);
+            if (!handles.empty())
+            {
+                unzFile handle = handles.back();
+                handles.pop_back();
+                return handle;
+            }
+        }
+        return buffer ? unzOpenBuffer(buffer, bufferSize) : unzOpen(zipPath.c_str());
+    }
+
+    void releaseHandle(unzFile handle)
+    {
+        // Keep as many handles as threads read at the same time, up to a limit. A handle that isn't kept is
+        // opened again by the next read, which reopens the archive file and reads its directory end again.
+        static const size_t MAX_IDLE_HANDLES = std::max<size_t>(8, std::thread::hardware_concurrency());
+        {
+            std::lock_guard<std::mutex> lock(handlesMutex);
+            if (handles.size() < MAX_IDLE_HANDLES)
+            {
+                handles.push_back(handle);
+                return;
+            }
+        }
+        unzClose(handle);
+    }
+
+    bool readEntry(const ZipEntryInfo& entry, unsigned char* out)
+    {
+        // nothing to read, `out` may be nullptr
+        if (0 == entry.uncompressed_size)
+            return true;
+
+        if (entry.stored_offset)
+        {
+            memcpy(out, buffer + entry.stored_offset, entry.uncompressed_size);
+            return true;
+        }
+
+        unzFile handle = acquireHandle();
+        if (!handle)
+            return false;
+
+        bool ret = false;
+        unz_file_pos pos = entry.pos;
+        if (UNZ_OK == unzGoToFilePos(handle, &pos) && UNZ_OK == unzOpenCurrentFile(handle))
+        {
+            int size = unzReadCurrentFile(handle, out, static_cast<unsigned int>(entry.uncompressed_size));
+            ret = size == (int)entry.uncompressed_size;
+            unzCloseCurrentFile(handle);
+        }
+        releaseHandle(handle);
+        return ret;
+    }
 };
 
 ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
@@ -527,26 +761,35 @@ ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
     }
 }
 
+ZipFile *ZipFile::createWithMappedFile(MappedFile* file)
+{
+    if (!file)
+        return nullptr;
+
+    ZipFile *zip = createWithBuffer(file->getBytes(), file->getSize());
+    if (zip)
+    {
+        file->retain();
+        zip->_data->mappedFile = file;
+    }
+    return zip;
+}
+
 ZipFile::ZipFile()
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = nullptr;
 }
 
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
+    _data->zipPath = FileUtils::getInstance()->getSuitableFOpen(zipFile);
+    _data->zipFile = unzOpen(_data->zipPath.c_str());
     setFilter(filter);
 }
 
 ZipFile::~ZipFile()
 {
-    if (_data && _data->zipFile)
-    {
-        unzClose(_data->zipFile);
-    }
-
     CC_SAFE_DELETE(_data);
 }
 
@@ -582,6 +825,16 @@ bool ZipFile::setFilter(const std::string &filter)
                     ZipEntryInfo entry;
                     entry.pos = posInfo;
                     entry.uncompressed_size = (uLong)fileInfo.uncompressed_size;
+                    entry.stored_offset = 0;
+                    // Entries that aren't compressed nor encrypted are copied straight out of an archive in memory.
+                    if (_data->buffer && 0 == fileInfo.compression_method && 0 == (fileInfo.flag & 1)
+                        && UNZ_OK == unzOpenCurrentFile(_data->zipFile))
+                    {
+                        ZPOS64_T offset = unzGetCurrentFileZStreamPos64(_data->zipFile);
+                        if (offset > 0 && offset + fileInfo.uncompressed_size <= _data->bufferSize)
+                            entry.stored_offset = offset;
+                        unzCloseCurrentFile(_data->zipFile);
+                    }
                     _data->fileList[currentFileName] = entry;
                 }
             }
@@ -623,23 +876,22 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
         ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
         CC_BREAK_IF(it ==  _data->fileList.end());
 
-        ZipEntryInfo fileInfo = it->second;
-
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
+        const ZipEntryInfo& fileInfo = it->second;
 
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-
-        buffer = (unsigned char*)malloc(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer, static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
+        // malloc(0) may return nullptr, an empty entry still returns a buffer so that it doesn't read as a failure.
+        buffer = (unsigned char*)malloc(fileInfo.uncompressed_size > 0 ? fileInfo.uncompressed_size : 1);
+        CC_BREAK_IF(!buffer);
+        if (!_data->readEntry(fileInfo, buffer))
+        {
+            free(buffer);
+            buffer = nullptr;
+            break;
+        }
 
         if (size)
         {
             *size = fileInfo.uncompressed_size;
         }
-        unzCloseCurrentFile(_data->zipFile);
     } while (0);
 
     return buffer;
@@ -656,24 +908,51 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
         ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
         CC_BREAK_IF(it ==  _data->fileList.end());
 
-        ZipEntryInfo fileInfo = it->second;
-
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
+        const ZipEntryInfo& fileInfo = it->second;
 
         buffer->resize(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer->buffer(), static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
-        unzCloseCurrentFile(_data->zipFile);
-        res = true;
+        res = _data->readEntry(fileInfo, static_cast<unsigned char*>(buffer->buffer()));
     } while (0);
 
     return res;
 }
 
+MappedFile* ZipFile::mapFile(const std::string &fileName)
+{
+    MappedFile* ret = nullptr;
+    do
+    {
+        CC_BREAK_IF(!_data->zipFile);
+        CC_BREAK_IF(fileName.empty());
+
+        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
+        CC_BREAK_IF(it ==  _data->fileList.end());
+
+        const ZipEntryInfo& fileInfo = it->second;
+
+        // A stored entry of a mapped archive is a view into the mapping, which it keeps alive.
+        if (fileInfo.stored_offset && _data->mappedFile)
+        {
+            MappedFile* archive = _data->mappedFile;
+            archive->retain();
+            ret = MappedFile::createWithMapping(_data->buffer + fileInfo.stored_offset, fileInfo.uncompressed_size, [archive](const unsigned char*, ssize_t) {
+                archive->release();
+            });
+            break;
+        }
+
+        ssize_t size = 0;
+        unsigned char* bytes = getFileData(fileName, &size);
+        CC_BREAK_IF(!bytes);
+
+        Data data;
+        data.fastSet(bytes, size);
+        ret = MappedFile::createWithData(std::move(data));
+    } while (0);
+
+    return ret;
+}
+
 std::string ZipFile::getFirstFilename()
 {
     if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
@@ -711,6 +990,9 @@ bool ZipFile::initWithBuffer(const void *buffer, uLong size)
     _data->zipFile = unzOpenBuffer(buffer, size);
     if (!_data->zipFile) return false;
 
+    _data->buffer = static_cast<const unsigned char*>(buffer);
+    _data->bufferSize = size;
+
     setFilter(emptyFilename);
     return true;
 }
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #define __SUPPORT_ZIPUTILS_H__
 /// @cond DO_NOT_SHOW
 
+#include <functional>
 #include <string>
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
@@ -74,7 +75,8 @@ typedef struct unz_file_info_s unz_file_info;
         /**
          * Inflates either zlib or gzip deflated memory. The inflated memory is expected to be freed by the caller.
          *
-         * It will allocate 256k for the destination buffer. If it is not enough it will multiply the previous buffer size per 2, until there is enough memory.
+         * A gzip buffer is inflated into a buffer of the size stored in its trailer. Otherwise it will allocate 256k for the destination buffer.
+         * If it is not enough it will multiply the previous buffer size per 2, until there is enough memory.
          *
          * @return The length of the deflated buffer.
          * @since v0.8.1
@@ -91,9 +93,48 @@ typedef struct unz_file_info_s unz_file_info;
         */
         static ssize_t inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint);
 
+        /**
+         * Returns the inflated size of a CCZ or GZip buffer from its header or trailer, without inflating it.
+         *
+         * The GZip size is the one of the last member modulo 2^32, the inflate functions don't rely on it.
+         *
+         * @return The inflated size, or -1 if the buffer doesn't tell it (zlib streams, encrypted CCZ).
+         */
+        static ssize_t getInflatedSize(const unsigned char *in, ssize_t inLength);
+
+        /**
+         * Inflates either zlib or gzip deflated memory into a buffer provided by the caller, without allocating it.
+         *
+         * Uses libdeflate when CC_USE_LIBDEFLATE is enabled.
+         *
+         * @return The length of the inflated data, or -1 on error or if it doesn't fit into `out`.
+         */
+        static ssize_t inflateMemoryTo(const unsigned char *in, ssize_t inLength, unsigned char *out, ssize_t outLength);
+
+        /**
+         * Receives the inflated data chunk by chunk, returns false to stop inflating.
+         */
+        typedef std::function<bool(const unsigned char *data, ssize_t size)> InflateCallback;
+
+        /**
+         * Inflates either zlib or gzip deflated memory chunk by chunk, at most `chunkSize` bytes are kept in memory.
+         *
+         * @return True if the whole stream was inflated and every callback returned true.
+         */
+        static bool inflateMemoryStreamed(const unsigned char *in, ssize_t inLength, const InflateCallback& callback, ssize_t chunkSize = 64 * 1024);
+
+        /**
+         * Inflates a GZip file chunk by chunk, the file is mapped instead of read into memory.
+         *
+         * @return True if the whole file was inflated and every callback returned true.
+         */
+        static bool inflateGZipFileStreamed(const char *filename, const InflateCallback& callback, ssize_t chunkSize = 64 * 1024);
+
         /**
          * Inflates a GZip file into memory.
          *
+         * The output is allocated once with the size stored in the file.
+         *
          * @return The length of the deflated buffer.
          * @since v0.99.5
          */
@@ -131,6 +172,14 @@ typedef struct unz_file_info_s unz_file_info;
          */
         static int inflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out);
 
+        /**
+         * Inflates a buffer with CCZ format into a buffer provided by the caller, getInflatedSize() tells how large it needs to be.
+         * An encrypted buffer is decrypted into a temporary copy, the input is never written.
+         *
+         * @return The length of the inflated data, or -1 on error or if it doesn't fit into `out`.
+         */
+        static ssize_t inflateCCZBufferTo(const unsigned char *buffer, ssize_t len, unsigned char *out, ssize_t outLength);
+
         /**
          * Test a file is a CCZ format file or not.
          *
@@ -201,6 +250,7 @@ typedef struct unz_file_info_s unz_file_info;
         static int inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint);
         static inline void decodeEncodedPvr (unsigned int *data, ssize_t len);
         static inline unsigned int checksumPvr(const unsigned int *data, ssize_t len);
+        static const unsigned char* getCCZPayload(const unsigned char *buffer, ssize_t len, ssize_t *payloadLen, unsigned int *inflatedLen, unsigned char **decrypted);
 
         static unsigned int s_uEncryptedPvrKeyParts[4];
         static unsigned int s_uEncryptionKey[1024];
@@ -217,6 +267,13 @@ typedef struct unz_file_info_s unz_file_info;
     * It will cache the file list of a particular zip file with positions inside an archive,
     * so it would be much faster to read some particular files or to check their existence.
     *
+    * Files can be read from several threads at the same time, each read uses its own unzip handle
+    * taken from a pool. Changing the filter or listing the files must not run concurrently with reads.
+    * An archive opened from a path reads every entry through the file system, so concurrent reads can
+    * be no faster than one thread, or slower where the file system serializes reads of a file. Prefer
+    * createWithMappedFile() for archives read from several threads, it copies stored entries straight
+    * out of the mapping.
+    *
     * @since v2.0.5
     */
     class CC_DLL ZipFile
@@ -259,7 +316,7 @@ typedef struct unz_file_info_s unz_file_info;
         * Get resource file data from a zip file.
         * @param fileName File name
         * @param[out] pSize If the file read operation succeeds, it will be the data size, otherwise 0.
-        * @return Upon success, a pointer to the data is returned, otherwise nullptr.
+        * @return Upon success, a pointer to the data is returned, otherwise nullptr. An empty file returns a non-nullptr pointer.
         * @warning Recall: you are responsible for calling free() on any Non-nullptr pointer returned.
         *
         * @since v2.0.5
@@ -274,10 +331,26 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Get resource file data from a zip file without copying it when possible.
+        * An entry stored without compression in an archive opened by createWithMappedFile() is a view into
+        * the archive mapping, the other entries are read into memory.
+        * @param fileName File name
+        * @return Upon success, a MappedFile which the caller has to release, otherwise nullptr.
+        */
+        MappedFile* mapFile(const std::string &fileName);
+
         std::string getFirstFilename();
         std::string getNextFilename();
 
+        /**
+        * Opens a zip archive in memory, `buffer` has to outlive the returned ZipFile.
+        */
         static ZipFile *createWithBuffer(const void* buffer, unsigned long size);
+        /**
+        * Opens a zip archive in a mapped file without copying it, the mapping is retained by the returned ZipFile.
+        */
+        static ZipFile *createWithMappedFile(MappedFile* file);
 
     private:
         /* Only used internal for createWithBuffer() */
@@ -296,6 +296,40 @@ THE SOFTWARE.
 #define CC_USE_TIFF  0
 #endif // CC_USE_TIFF
 
+/** Inflate whole buffers with libdeflate instead of zlib when their size is known, e.g. ccz and gzip files.
+ * libdeflate is not bundled, to enable set it to 1 and link libdeflate. Disabled by default.
+ */
+#ifndef CC_USE_LIBDEFLATE
+#define CC_USE_LIBDEFLATE  0
+#endif // CC_USE_LIBDEFLATE
+
+/** Read and write LZ4 compressed files in asset bundles. LZ4 is not bundled, to enable set it to 1 and link liblz4. Disabled by default.
+ */
+#ifndef CC_USE_LZ4
+#define CC_USE_LZ4  0
+#endif // CC_USE_LZ4
+
+/** Read and write zstd compressed files in asset bundles. zstd is not bundled, to enable set it to 1 and link libzstd. Disabled by default.
+ */
+#ifndef CC_USE_ZSTD
+#define CC_USE_ZSTD  0
+#endif // CC_USE_ZSTD
+
+/** Make Ref::retain() and Ref::release() atomic, so that objects can be shared with loader and render threads.
+ * GL objects released on another thread are deleted on the GL thread at the beginning of the next frame.
+ * Disabled by default, atomic operations make every retain and release slower.
+ */
+#ifndef CC_REF_THREAD_SAFE
+#define CC_REF_THREAD_SAFE  0
+#endif // CC_REF_THREAD_SAFE
+
+/** Track the live Ref objects by type, see Ref::getLiveObjectCounts() and Ref::printLeaks().
+ * Every Ref construction and destruction takes a global lock, so it is disabled by default.
+ */
+#ifndef CC_REF_LEAK_DETECTION
+#define CC_REF_LEAK_DETECTION  0
+#endif // CC_REF_LEAK_DETECTION
+
 /** Support webp or not. If your application don't use webp format picture, you can undefine this macro to save package size.
  */
 #ifndef CC_USE_WEBP
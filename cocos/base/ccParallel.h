@@ -0,0 +1,68 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __ccParallel_H_
+#define __ccParallel_H_
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+* @addtogroup base
+* @{
+*/
+namespace cocos2d {
+
+/**
+ * Splits [0, count) into ranges of a multiple of `alignment` items, one per thread, and runs `func(begin, end)`
+ * for each of them concurrently. The first range runs on the calling thread, returns once all ranges are done.
+ * Uses at most `maxThreads` threads, the number of hardware threads if it is 0.
+ */
+inline void parallelForRanges(int count, int alignment, int maxThreads, const std::function<void(int, int)>& func)
+{
+    int threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    if (maxThreads > 0)
+        threadCount = std::min(threadCount, maxThreads);
+    threadCount = std::max(threadCount, 1);
+
+    int rangeSize = (count + threadCount - 1) / threadCount;
+    rangeSize = std::max((rangeSize + alignment - 1) / alignment * alignment, alignment);
+
+    std::vector<std::thread> threads;
+    for (int begin = rangeSize; begin < count; begin += rangeSize)
+        threads.emplace_back(func, begin, std::min(begin + rangeSize, count));
+
+    func(0, std::min(rangeSize, count));
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+}//namespace cocos2d
+// end group
+/// @}
+
+#endif // __ccParallel_H_
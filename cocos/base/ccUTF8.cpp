@@ -28,6 +28,16 @@
 #include "base/CCConsole.h"
 #include "ConvertUTF/ConvertUTF.h"
 
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CC_UTF8_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CC_UTF8_NEON 1
+#endif
+
 NS_CC_BEGIN
 
 namespace StringUtils {
@@ -197,9 +207,211 @@ bool utfConvert(
 };
 
 
+/*
+ * Returns the number of leading bytes of [s, s + len) that are 7-bit ASCII.
+ * */
+static size_t countLeadingASCII(const unsigned char* s, size_t len)
+{
+    size_t i = 0;
+#if CC_UTF8_SSE2
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) != 0)
+            break;
+    }
+#elif CC_UTF8_NEON
+    for (; i + 16 <= len; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(s + i);
+#if defined(__aarch64__)
+        if (vmaxvq_u8(v) >= 0x80)
+            break;
+#else
+        uint8x8_t m = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+        if (vget_lane_u64(vreinterpret_u64_u8(m), 0) & 0x8080808080808080ULL)
+            break;
+#endif
+    }
+#endif
+    while (i < len && s[i] < 0x80)
+        ++i;
+    return i;
+}
+
+/*
+ * Copies the leading ASCII bytes of [s, s + len) to out as UTF-16 code units.
+ *
+ * Return value: the number of bytes converted.
+ * */
+static size_t convertLeadingASCIIToUTF16(const unsigned char* s, size_t len, char16_t* out)
+{
+    size_t i = 0;
+#if CC_UTF8_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) != 0)
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#elif CC_UTF8_NEON
+    for (; i + 16 <= len; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(s + i);
+#if defined(__aarch64__)
+        if (vmaxvq_u8(v) >= 0x80)
+            break;
+#else
+        uint8x8_t m = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+        if (vget_lane_u64(vreinterpret_u64_u8(m), 0) & 0x8080808080808080ULL)
+            break;
+#endif
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i), vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + i + 8), vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    for (; i < len && s[i] < 0x80; ++i)
+        out[i] = s[i];
+    return i;
+}
+
+/*
+ * Copies the leading code units of [s, s + len) that are below 0x80 to out as bytes.
+ *
+ * Return value: the number of code units converted.
+ * */
+static size_t convertLeadingASCIIToUTF8(const char16_t* s, size_t len, char* out)
+{
+    size_t i = 0;
+#if CC_UTF8_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80));
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 8));
+        __m128i high = _mm_and_si128(_mm_or_si128(lo, hi), nonASCII);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF)
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+#elif CC_UTF8_NEON
+    for (; i + 16 <= len; i += 16)
+    {
+        uint16x8_t lo = vld1q_u16(reinterpret_cast<const uint16_t*>(s + i));
+        uint16x8_t hi = vld1q_u16(reinterpret_cast<const uint16_t*>(s + i + 8));
+        uint16x8_t any = vorrq_u16(lo, hi);
+#if defined(__aarch64__)
+        if (vmaxvq_u16(any) >= 0x80)
+            break;
+#else
+        uint16x4_t m = vorr_u16(vget_low_u16(any), vget_high_u16(any));
+        if (vget_lane_u64(vreinterpret_u64_u16(m), 0) & 0xFF80FF80FF80FF80ULL)
+            break;
+#endif
+        vst1q_u8(reinterpret_cast<uint8_t*>(out + i), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+#endif
+    for (; i < len && s[i] < 0x80; ++i)
+        out[i] = static_cast<char>(s[i]);
+    return i;
+}
+
+/*
+ * Decodes the UTF-8 sequence starting at s with the same rules as ConvertUTF's strict
+ * conversion: no overlong forms, no surrogates and nothing above U+10FFFF.
+ *
+ * Return value: the length of the sequence, or 0 if it is illegal or truncated by end.
+ * */
+static int decodeUTF8Sequence(const unsigned char* s, const unsigned char* end, char32_t* outCodePoint)
+{
+    const unsigned char c = s[0];
+    const ptrdiff_t avail = end - s;
+
+    if (c < 0x80)
+    {
+        *outCodePoint = c;
+        return 1;
+    }
+    if (c < 0xC2)
+        return 0;
+    if (c < 0xE0)
+    {
+        if (avail < 2 || (s[1] & 0xC0) != 0x80)
+            return 0;
+        *outCodePoint = ((c & 0x1F) << 6) | (s[1] & 0x3F);
+        return 2;
+    }
+    if (c < 0xF0)
+    {
+        if (avail < 3 || (s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80)
+            return 0;
+        if ((c == 0xE0 && s[1] < 0xA0) || (c == 0xED && s[1] > 0x9F))
+            return 0;
+        *outCodePoint = ((c & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        return 3;
+    }
+    if (c < 0xF5)
+    {
+        if (avail < 4 || (s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80 || (s[3] & 0xC0) != 0x80)
+            return 0;
+        if ((c == 0xF0 && s[1] < 0x90) || (c == 0xF4 && s[1] > 0x8F))
+            return 0;
+        *outCodePoint = ((c & 0x07) << 18) | ((s[1] & 0x3F) << 12) | ((s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+        return 4;
+    }
+    return 0;
+}
+
 bool UTF8ToUTF16(const std::string& utf8, std::u16string& outUtf16)
 {
-    return utfConvert(utf8, outUtf16, ConvertUTF8toUTF16);
+    if (utf8.empty())
+    {
+        outUtf16.clear();
+        return true;
+    }
+
+    // Each UTF-8 byte produces at most one UTF-16 code unit.
+    std::u16string working(utf8.length(), 0);
+
+    auto src = reinterpret_cast<const unsigned char*>(utf8.data());
+    auto end = src + utf8.length();
+    char16_t* dst = &working[0];
+
+    while (src < end)
+    {
+        if (*src < 0x80)
+        {
+            size_t ascii = convertLeadingASCIIToUTF16(src, end - src, dst);
+            src += ascii;
+            dst += ascii;
+            continue;
+        }
+
+        char32_t ch;
+        int length = decodeUTF8Sequence(src, end, &ch);
+        if (length == 0)
+            return false;
+        src += length;
+
+        if (ch < 0x10000)
+        {
+            *dst++ = static_cast<char16_t>(ch);
+        }
+        else
+        {
+            ch -= 0x10000;
+            *dst++ = static_cast<char16_t>(0xD800 + (ch >> 10));
+            *dst++ = static_cast<char16_t>(0xDC00 + (ch & 0x3FF));
+        }
+    }
+
+    working.resize(dst - &working[0]);
+    outUtf16 = std::move(working);
+    return true;
 }
 
 bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
@@ -209,7 +421,62 @@ bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
 
 bool UTF16ToUTF8(const std::u16string& utf16, std::string& outUtf8)
 {
-    return utfConvert(utf16, outUtf8, ConvertUTF16toUTF8);
+    if (utf16.empty())
+    {
+        outUtf8.clear();
+        return true;
+    }
+
+    // Each UTF-16 code unit produces at most three UTF-8 bytes, a surrogate pair four.
+    std::string working(utf16.length() * 3, 0);
+
+    const char16_t* src = utf16.data();
+    const char16_t* end = src + utf16.length();
+    char* dst = &working[0];
+
+    while (src < end)
+    {
+        if (*src < 0x80)
+        {
+            size_t ascii = convertLeadingASCIIToUTF8(src, end - src, dst);
+            src += ascii;
+            dst += ascii;
+            continue;
+        }
+
+        char32_t ch = *src++;
+        if (ch >= 0xD800 && ch <= 0xDBFF)
+        {
+            if (src == end || *src < 0xDC00 || *src > 0xDFFF)
+                return false;
+            ch = ((ch - 0xD800) << 10) + (*src++ - 0xDC00) + 0x10000;
+        }
+        else if (ch >= 0xDC00 && ch <= 0xDFFF)
+        {
+            return false;
+        }
+
+        if (ch < 0x800)
+        {
+            *dst++ = static_cast<char>(0xC0 | (ch >> 6));
+        }
+        else if (ch < 0x10000)
+        {
+            *dst++ = static_cast<char>(0xE0 | (ch >> 12));
+            *dst++ = static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        }
+        else
+        {
+            *dst++ = static_cast<char>(0xF0 | (ch >> 18));
+            *dst++ = static_cast<char>(0x80 | ((ch >> 12) & 0x3F));
+            *dst++ = static_cast<char>(0x80 | ((ch >> 6) & 0x3F));
+        }
+        *dst++ = static_cast<char>(0x80 | (ch & 0x3F));
+    }
+
+    working.resize(dst - &working[0]);
+    outUtf8 = std::move(working);
+    return true;
 }
     
 bool UTF16ToUTF32(const std::u16string& utf16, std::u32string& outUtf32)
@@ -275,7 +542,52 @@ std::vector<char16_t> getChar16VectorFromUTF16String(const std::u16string& utf16
 
 long getCharacterCountInUTF8String(const std::string& utf8)
 {
-    return getUTF8StringLength((const UTF8*)utf8.c_str());
+    // Counting stops at the first NUL, as the string is treated as a C string.
+    auto src = reinterpret_cast<const unsigned char*>(utf8.c_str());
+    auto nul = static_cast<const unsigned char*>(memchr(src, 0, utf8.length()));
+    auto end = nul ? nul : src + utf8.length();
+
+    long count = 0;
+    while (src < end)
+    {
+        if (*src < 0x80)
+        {
+            size_t ascii = countLeadingASCII(src, end - src);
+            src += ascii;
+            count += static_cast<long>(ascii);
+            continue;
+        }
+
+        char32_t ch;
+        int length = decodeUTF8Sequence(src, end, &ch);
+        if (length == 0)
+            return 0;
+        src += length;
+        ++count;
+    }
+    return count;
+}
+
+bool isValidUTF8String(const std::string& utf8)
+{
+    auto src = reinterpret_cast<const unsigned char*>(utf8.data());
+    auto end = src + utf8.length();
+
+    while (src < end)
+    {
+        if (*src < 0x80)
+        {
+            src += countLeadingASCII(src, end - src);
+            continue;
+        }
+
+        char32_t ch;
+        int length = decodeUTF8Sequence(src, end, &ch);
+        if (length == 0)
+            return false;
+        src += length;
+    }
+    return true;
 }
 
 
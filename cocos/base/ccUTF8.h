@@ -166,6 +166,13 @@ CC_DLL bool isCJKUnicode(char16_t ch);
  */
 CC_DLL long getCharacterCountInUTF8String(const std::string& utf8);
 
+/**
+ *  @brief Whether the string is well-formed UTF-8.
+ *  @param utf8 The string to check.
+ *  @returns true if the string would be accepted by \a UTF8ToUTF16.
+ */
+CC_DLL bool isValidUTF8String(const std::string& utf8);
+
 /**
  *  @brief Gets the index of the last character that is not equal to the character given.
  *  @param str   The string to be searched.
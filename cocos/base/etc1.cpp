@@ -13,9 +13,28 @@
 // limitations under the License.
 
 #include "base/etc1.h"
+#include "base/ccParallel.h"
 
 #include <string.h>
 
+// Vectorized block decoders, the table lookups need SSSE3 pshufb or AArch64 tbl.
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define ETC1_DECODE_SSSE3 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define ETC1_DECODE_NEON 1
+#endif
+
+// Vectorized modifier search for the encoder, plain SSE2 or NEON is enough.
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ETC1_ENCODE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ETC1_ENCODE_NEON 1
+#endif
+
 /* From http://www.khronos.org/registry/gles/extensions/OES/OES_compressed_ETC1_RGB8_texture.txt
 
  The number of bits that represent a 4x4 texel block is 64 bits if
@@ -194,42 +213,191 @@ void decode_subblock(etc1_byte* pOut, int r, int g, int b, const int* table,
     }
 }
 
-// Input is an ETC1 compressed version of the data.
-// Output is a 4 x 4 square of 3-byte pixels in form R, G, B
+// Base colors, modifier tables and pixel indices of a block.
 
-void etc1_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
+typedef struct {
+    int r[2];
+    int g[2];
+    int b[2];
+    const int* table[2];
+    bool flipped;
+    etc1_uint32 low;
+} etc1_block_info;
+
+static
+inline void read_block(const etc1_byte* pIn, etc1_block_info* info) {
     etc1_uint32 high = (pIn[0] << 24) | (pIn[1] << 16) | (pIn[2] << 8) | pIn[3];
     etc1_uint32 low = (pIn[4] << 24) | (pIn[5] << 16) | (pIn[6] << 8) | pIn[7];
-    int r1, r2, g1, g2, b1, b2;
     if (high & 2) {
         // differential
         int rBase = high >> 27;
         int gBase = high >> 19;
         int bBase = high >> 11;
-        r1 = convert5To8(rBase);
-        r2 = convertDiff(rBase, high >> 24);
-        g1 = convert5To8(gBase);
-        g2 = convertDiff(gBase, high >> 16);
-        b1 = convert5To8(bBase);
-        b2 = convertDiff(bBase, high >> 8);
+        info->r[0] = convert5To8(rBase);
+        info->r[1] = convertDiff(rBase, high >> 24);
+        info->g[0] = convert5To8(gBase);
+        info->g[1] = convertDiff(gBase, high >> 16);
+        info->b[0] = convert5To8(bBase);
+        info->b[1] = convertDiff(bBase, high >> 8);
     } else {
         // not differential
-        r1 = convert4To8(high >> 28);
-        r2 = convert4To8(high >> 24);
-        g1 = convert4To8(high >> 20);
-        g2 = convert4To8(high >> 16);
-        b1 = convert4To8(high >> 12);
-        b2 = convert4To8(high >> 8);
+        info->r[0] = convert4To8(high >> 28);
+        info->r[1] = convert4To8(high >> 24);
+        info->g[0] = convert4To8(high >> 20);
+        info->g[1] = convert4To8(high >> 16);
+        info->b[0] = convert4To8(high >> 12);
+        info->b[1] = convert4To8(high >> 8);
     }
     int tableIndexA = 7 & (high >> 5);
     int tableIndexB = 7 & (high >> 2);
-    const int* tableA = kModifierTable + tableIndexA * 4;
-    const int* tableB = kModifierTable + tableIndexB * 4;
-    bool flipped = (high & 1) != 0;
-    decode_subblock(pOut, r1, g1, b1, tableA, low, false, flipped);
-    decode_subblock(pOut, r2, g2, b2, tableB, low, true, flipped);
+    info->table[0] = kModifierTable + tableIndexA * 4;
+    info->table[1] = kModifierTable + tableIndexB * 4;
+    info->flipped = (high & 1) != 0;
+    info->low = low;
+}
+
+// Input is an ETC1 compressed version of the data.
+// Output is a 4 x 4 square of 3-byte pixels in form R, G, B
+
+void etc1_decode_block(const etc1_byte* pIn, etc1_byte* pOut) {
+    etc1_block_info info;
+    read_block(pIn, &info);
+    decode_subblock(pOut, info.r[0], info.g[0], info.b[0], info.table[0], info.low, false, info.flipped);
+    decode_subblock(pOut, info.r[1], info.g[1], info.b[1], info.table[1], info.low, true, info.flipped);
+}
+
+#if defined(ETC1_DECODE_SSSE3) || defined(ETC1_DECODE_NEON)
+
+// The vectorized decoders build the 4 colors of each subblock, then look up the color of every
+// output byte with a byte shuffle. Pixels are numbered j = x + 4 * y, their index bits are
+// k = y + 4 * x in the low word.
+
+// Byte of the low word holding the lsb / msb index bit of pixel j, and the bit itself.
+static const etc1_byte kLsbSelect[16] = { 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x01 };
+static const etc1_byte kMsbSelect[16] = { 0x02, 0x02, 0x03, 0x03, 0x02, 0x02, 0x03, 0x03, 0x02, 0x02, 0x03, 0x03, 0x02, 0x02, 0x03, 0x03 };
+static const etc1_byte kIndexBit[16] = { 0x01, 0x10, 0x01, 0x10, 0x02, 0x20, 0x02, 0x20, 0x04, 0x40, 0x04, 0x40, 0x08, 0x80, 0x08, 0x80 };
+
+// 0xFF for the pixels of the second subblock.
+static const etc1_byte kSecondSubblock[2][16] = {
+    { 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFF },
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } };
+
+// Pixel of every byte of an RGB row, and the channel of every byte. 0x80 clears the 4 unused bytes.
+static const etc1_byte kRowPixel[4][16] = {
+    { 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x02, 0x02, 0x02, 0x03, 0x03, 0x03, 0x80, 0x80, 0x80, 0x80 },
+    { 0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x06, 0x06, 0x06, 0x07, 0x07, 0x07, 0x80, 0x80, 0x80, 0x80 },
+    { 0x08, 0x08, 0x08, 0x09, 0x09, 0x09, 0x0A, 0x0A, 0x0A, 0x0B, 0x0B, 0x0B, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0C, 0x0C, 0x0C, 0x0D, 0x0D, 0x0D, 0x0E, 0x0E, 0x0E, 0x0F, 0x0F, 0x0F, 0x80, 0x80, 0x80, 0x80 } };
+static const etc1_byte kRowChannel[16] = { 0x00, 0x01, 0x02, 0x00, 0x01, 0x02, 0x00, 0x01, 0x02, 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80 };
+
+#endif
+
+#if defined(ETC1_DECODE_SSSE3)
+
+static
+inline __m128i load_table(const etc1_byte* table) {
+    return _mm_loadu_si128((const __m128i*) table);
+}
+
+// Decodes the top left `columns` x `rows` pixels of a block into 3-byte RGB pixels.
+static
+void decode_block_rgb(const etc1_byte* pIn, etc1_byte* pOut, etc1_uint32 stride,
+        etc1_uint32 columns, etc1_uint32 rows) {
+    etc1_block_info info;
+    read_block(pIn, &info);
+
+    // the 4 RGBX colors of each subblock, packus clamps them the same way as clamp()
+    __m128i palette[2];
+    for (int i = 0; i < 2; i++) {
+        const int* t = info.table[i];
+        __m128i base = _mm_setr_epi16(info.r[i], info.g[i], info.b[i], 0, info.r[i], info.g[i], info.b[i], 0);
+        __m128i lo = _mm_add_epi16(base, _mm_setr_epi16(t[0], t[0], t[0], 0, t[1], t[1], t[1], 0));
+        __m128i hi = _mm_add_epi16(base, _mm_setr_epi16(t[2], t[2], t[2], 0, t[3], t[3], t[3], 0));
+        palette[i] = _mm_packus_epi16(lo, hi);
+    }
+
+    // byte offset of the color of every pixel in its palette
+    __m128i bits = _mm_cvtsi32_si128((int) info.low);
+    __m128i bit = load_table(kIndexBit);
+    __m128i lsb = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(bits, load_table(kLsbSelect)), bit), bit);
+    __m128i msb = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(bits, load_table(kMsbSelect)), bit), bit);
+    __m128i index = _mm_or_si128(_mm_and_si128(lsb, _mm_set1_epi8(1)), _mm_and_si128(msb, _mm_set1_epi8(2)));
+    index = _mm_slli_epi16(index, 2);
+
+    __m128i second = load_table(kSecondSubblock[info.flipped ? 1 : 0]);
+    __m128i channel = load_table(kRowChannel);
+
+    for (etc1_uint32 y = 0; y < rows; y++) {
+        __m128i pixel = load_table(kRowPixel[y]);
+        __m128i select = _mm_add_epi8(_mm_shuffle_epi8(index, pixel), channel);
+        __m128i isSecond = _mm_shuffle_epi8(second, pixel);
+        __m128i rgb = _mm_or_si128(_mm_and_si128(isSecond, _mm_shuffle_epi8(palette[1], select)),
+                _mm_andnot_si128(isSecond, _mm_shuffle_epi8(palette[0], select)));
+
+        etc1_byte* p = pOut + stride * y;
+        if (columns == 4) {
+            _mm_storel_epi64((__m128i*) p, rgb);
+            int tail = _mm_cvtsi128_si32(_mm_srli_si128(rgb, 8));
+            memcpy(p + 8, &tail, 4);
+        } else {
+            etc1_byte row[16];
+            _mm_storeu_si128((__m128i*) row, rgb);
+            memcpy(p, row, columns * 3);
+        }
+    }
+}
+
+#elif defined(ETC1_DECODE_NEON)
+
+// Decodes the top left `columns` x `rows` pixels of a block into 3-byte RGB pixels.
+static
+void decode_block_rgb(const etc1_byte* pIn, etc1_byte* pOut, etc1_uint32 stride,
+        etc1_uint32 columns, etc1_uint32 rows) {
+    etc1_block_info info;
+    read_block(pIn, &info);
+
+    // the 4 RGBX colors of each subblock, vqmovun clamps them the same way as clamp()
+    uint8x16_t palette[2];
+    for (int i = 0; i < 2; i++) {
+        const int* t = info.table[i];
+        const int16_t lo[8] = { (int16_t) (info.r[i] + t[0]), (int16_t) (info.g[i] + t[0]), (int16_t) (info.b[i] + t[0]), 0,
+                (int16_t) (info.r[i] + t[1]), (int16_t) (info.g[i] + t[1]), (int16_t) (info.b[i] + t[1]), 0 };
+        const int16_t hi[8] = { (int16_t) (info.r[i] + t[2]), (int16_t) (info.g[i] + t[2]), (int16_t) (info.b[i] + t[2]), 0,
+                (int16_t) (info.r[i] + t[3]), (int16_t) (info.g[i] + t[3]), (int16_t) (info.b[i] + t[3]), 0 };
+        palette[i] = vcombine_u8(vqmovun_s16(vld1q_s16(lo)), vqmovun_s16(vld1q_s16(hi)));
+    }
+
+    // byte offset of the color of every pixel in its palette
+    uint8x16_t bits = vreinterpretq_u8_u32(vdupq_n_u32(info.low));
+    uint8x16_t bit = vld1q_u8(kIndexBit);
+    uint8x16_t lsb = vtstq_u8(vqtbl1q_u8(bits, vld1q_u8(kLsbSelect)), bit);
+    uint8x16_t msb = vtstq_u8(vqtbl1q_u8(bits, vld1q_u8(kMsbSelect)), bit);
+    uint8x16_t index = vorrq_u8(vandq_u8(lsb, vdupq_n_u8(1)), vandq_u8(msb, vdupq_n_u8(2)));
+    index = vshlq_n_u8(index, 2);
+
+    uint8x16_t second = vld1q_u8(kSecondSubblock[info.flipped ? 1 : 0]);
+    uint8x16_t channel = vld1q_u8(kRowChannel);
+
+    for (etc1_uint32 y = 0; y < rows; y++) {
+        uint8x16_t pixel = vld1q_u8(kRowPixel[y]);
+        uint8x16_t select = vaddq_u8(vqtbl1q_u8(index, pixel), channel);
+        uint8x16_t rgb = vbslq_u8(vqtbl1q_u8(second, pixel), vqtbl1q_u8(palette[1], select),
+                vqtbl1q_u8(palette[0], select));
+
+        etc1_byte* p = pOut + stride * y;
+        if (columns == 4) {
+            vst1_u8(p, vget_low_u8(rgb));
+            vst1q_lane_u32((uint32_t*) (p + 8), vreinterpretq_u32_u8(rgb), 2);
+        } else {
+            etc1_byte row[16];
+            vst1q_u8(row, rgb);
+            memcpy(p, row, columns * 3);
+        }
+    }
 }
 
+#endif
+
 typedef struct {
     etc1_uint32 high;
     etc1_uint32 low;
@@ -295,6 +463,119 @@ inline int square(int x) {
     return x * x;
 }
 
+#if defined(ETC1_ENCODE_SSE2) || defined(ETC1_ENCODE_NEON)
+
+// Collect the valid pixels of a sub-block and the bit index of their modifier, returns how many there are.
+
+static
+int etc_gather_subblock(const etc1_byte* pIn, etc1_uint32 inMask, bool flipped, bool second,
+        etc1_byte pPixels[3][8], int* pBitIndex) {
+    int count = 0;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int i = x + 4 * y;
+            if ((flipped ? (y >= 2) : (x >= 2)) != second || !(inMask & (1 << i))) {
+                continue;
+            }
+            const etc1_byte* p = pIn + i * 3;
+            pPixels[0][count] = p[0];
+            pPixels[1][count] = p[1];
+            pPixels[2][count] = p[2];
+            pBitIndex[count] = y + x * 4;
+            count++;
+        }
+    }
+    return count;
+}
+
+// Same as running chooseModifier on every pixel of the sub-block, with the 8 pixels
+// in the lanes of a vector. Ties go to the first modifier like in chooseModifier.
+
+static
+void etc_encode_subblock_helper(const etc1_byte* pIn, etc1_uint32 inMask,
+        etc_compressed* pCompressed, bool flipped, bool second,
+        const etc1_byte* pBaseColors, const int* pModifierTable) {
+    etc1_byte pixels[3][8] = {};
+    int bitIndex[8];
+    int count = etc_gather_subblock(pIn, inMask, flipped, second, pixels, bitIndex);
+
+    etc1_uint32 scores[8];
+    int indices[8];
+#if defined(ETC1_ENCODE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_set_epi16(3, 6, 3, 6, 3, 6, 3, 6);
+    __m128i r = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) pixels[0]), zero);
+    __m128i g = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) pixels[1]), zero);
+    __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) pixels[2]), zero);
+    __m128i bestScore[2], bestIndex[2];
+    for (int i = 0; i < 4; i++) {
+        int modifier = pModifierTable[i];
+        __m128i dr = _mm_sub_epi16(_mm_set1_epi16(clamp(pBaseColors[0] + modifier)), r);
+        __m128i dg = _mm_sub_epi16(_mm_set1_epi16(clamp(pBaseColors[1] + modifier)), g);
+        __m128i db = _mm_sub_epi16(_mm_set1_epi16(clamp(pBaseColors[2] + modifier)), b);
+        // 6 * dg^2 + 3 * dr^2 + db^2 in 32 bits, 4 pixels per register
+        __m128i gr[2] = { _mm_unpacklo_epi16(dg, dr), _mm_unpackhi_epi16(dg, dr) };
+        __m128i bz[2] = { _mm_unpacklo_epi16(db, zero), _mm_unpackhi_epi16(db, zero) };
+        for (int h = 0; h < 2; h++) {
+            __m128i score = _mm_add_epi32(_mm_madd_epi16(gr[h], _mm_mullo_epi16(gr[h], weights)),
+                    _mm_madd_epi16(bz[h], bz[h]));
+            if (i == 0) {
+                bestScore[h] = score;
+                bestIndex[h] = zero;
+            } else {
+                __m128i better = _mm_cmplt_epi32(score, bestScore[h]);
+                bestScore[h] = _mm_or_si128(_mm_and_si128(better, score), _mm_andnot_si128(better, bestScore[h]));
+                bestIndex[h] = _mm_or_si128(_mm_and_si128(better, _mm_set1_epi32(i)), _mm_andnot_si128(better, bestIndex[h]));
+            }
+        }
+    }
+    for (int h = 0; h < 2; h++) {
+        _mm_storeu_si128((__m128i*) (scores + h * 4), bestScore[h]);
+        _mm_storeu_si128((__m128i*) (indices + h * 4), bestIndex[h]);
+    }
+#else
+    int16x8_t r = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pixels[0])));
+    int16x8_t g = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pixels[1])));
+    int16x8_t b = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pixels[2])));
+    int32x4_t bestScore[2], bestIndex[2];
+    for (int i = 0; i < 4; i++) {
+        int modifier = pModifierTable[i];
+        int16x8_t dr = vsubq_s16(vdupq_n_s16((int16_t) clamp(pBaseColors[0] + modifier)), r);
+        int16x8_t dg = vsubq_s16(vdupq_n_s16((int16_t) clamp(pBaseColors[1] + modifier)), g);
+        int16x8_t db = vsubq_s16(vdupq_n_s16((int16_t) clamp(pBaseColors[2] + modifier)), b);
+        int16x4_t drh[2] = { vget_low_s16(dr), vget_high_s16(dr) };
+        int16x4_t dgh[2] = { vget_low_s16(dg), vget_high_s16(dg) };
+        int16x4_t dbh[2] = { vget_low_s16(db), vget_high_s16(db) };
+        for (int h = 0; h < 2; h++) {
+            int32x4_t score = vmulq_n_s32(vmull_s16(dgh[h], dgh[h]), 6);
+            score = vmlaq_n_s32(score, vmull_s16(drh[h], drh[h]), 3);
+            score = vaddq_s32(score, vmull_s16(dbh[h], dbh[h]));
+            if (i == 0) {
+                bestScore[h] = score;
+                bestIndex[h] = vdupq_n_s32(0);
+            } else {
+                uint32x4_t better = vcltq_s32(score, bestScore[h]);
+                bestScore[h] = vbslq_s32(better, score, bestScore[h]);
+                bestIndex[h] = vbslq_s32(better, vdupq_n_s32(i), bestIndex[h]);
+            }
+        }
+    }
+    for (int h = 0; h < 2; h++) {
+        vst1q_u32(scores + h * 4, vreinterpretq_u32_s32(bestScore[h]));
+        vst1q_s32(indices + h * 4, bestIndex[h]);
+    }
+#endif
+
+    etc1_uint32 score = pCompressed->score;
+    for (int k = 0; k < count; k++) {
+        score += scores[k];
+        pCompressed->low |= ((etc1_uint32) (((indices[k] >> 1) << 16) | (indices[k] & 1))) << bitIndex[k];
+    }
+    pCompressed->score = score;
+}
+
+#else
+
 static etc1_uint32 chooseModifier(const etc1_byte* pBaseColors,
         const etc1_byte* pIn, etc1_uint32 *pLow, int bitIndex,
         const int* pModifierTable) {
@@ -370,12 +651,14 @@ void etc_encode_subblock_helper(const etc1_byte* pIn, etc1_uint32 inMask,
     pCompressed->score = score;
 }
 
+#endif
+
 static bool inRange4bitSigned(int color) {
     return color >= -4 && color <= 3;
 }
 
 static void etc_encodeBaseColors(etc1_byte* pBaseColors,
-        const etc1_byte* pColors, etc_compressed* pCompressed) {
+        const etc1_byte* pColors, etc_compressed* pCompressed, bool individual) {
     int r1, g1, b1, r2, g2, b2; // 8 bit base colors for sub-blocks
     bool differential;
     {
@@ -394,7 +677,7 @@ static void etc_encodeBaseColors(etc1_byte* pBaseColors,
         int dg = g52 - g51;
         int db = b52 - b51;
 
-        differential = inRange4bitSigned(dr) && inRange4bitSigned(dg)
+        differential = !individual && inRange4bitSigned(dr) && inRange4bitSigned(dg)
                 && inRange4bitSigned(db);
         if (differential) {
             r2 = convert5To8(r51 + dr);
@@ -431,14 +714,15 @@ static void etc_encodeBaseColors(etc1_byte* pBaseColors,
 
 static
 void etc_encode_block_helper(const etc1_byte* pIn, etc1_uint32 inMask,
-        const etc1_byte* pColors, etc_compressed* pCompressed, bool flipped) {
+        const etc1_byte* pColors, etc_compressed* pCompressed, bool flipped,
+        bool individual) {
     pCompressed->score = ~0;
     pCompressed->high = (flipped ? 1 : 0);
     pCompressed->low = 0;
 
     etc1_byte pBaseColors[6];
 
-    etc_encodeBaseColors(pBaseColors, pColors, pCompressed);
+    etc_encodeBaseColors(pBaseColors, pColors, pCompressed, individual);
 
     int originalHigh = pCompressed->high;
 
@@ -476,13 +760,28 @@ static void writeBigEndian(etc1_byte* pOut, etc1_uint32 d) {
     pOut[3] = (etc1_byte) d;
 }
 
-// Input is a 4 x 4 square of 3-byte pixels in form R, G, B
-// inmask is a 16-bit mask where bit (1 << (x + y * 4)) tells whether the corresponding (x,y)
-// pixel is valid or not. Invalid pixel color values are ignored when compressing.
-// Output is an ETC1 compressed version of the data.
+// Error of the pixels against the averages of their sub-blocks, the fast preset
+// only encodes the orientation where it is lower.
+
+static etc1_uint32 etc_average_error(const etc1_byte* pIn, etc1_uint32 inMask,
+        const etc1_byte* pColors, bool flipped) {
+    etc1_uint32 error = 0;
+    for (int i = 0; i < 16; i++) {
+        if (inMask & (1 << i)) {
+            int x = i & 3;
+            int y = i >> 2;
+            const etc1_byte* c = pColors + ((flipped ? y >= 2 : x >= 2) ? 3 : 0);
+            const etc1_byte* p = pIn + i * 3;
+            error += (etc1_uint32) (3 * square(p[0] - c[0]) + 6 * square(p[1] - c[1])
+                    + square(p[2] - c[2]));
+        }
+    }
+    return error;
+}
 
-void etc1_encode_block(const etc1_byte* pIn, etc1_uint32 inMask,
-        etc1_byte* pOut) {
+static
+void etc_encode_block_quality(const etc1_byte* pIn, etc1_uint32 inMask,
+        etc1_byte* pOut, int quality) {
     etc1_byte colors[6];
     etc1_byte flippedColors[6];
     etc_average_colors_subblock(pIn, inMask, colors, false, false);
@@ -491,29 +790,51 @@ void etc1_encode_block(const etc1_byte* pIn, etc1_uint32 inMask,
     etc_average_colors_subblock(pIn, inMask, flippedColors + 3, true, true);
 
     etc_compressed a, b;
-    etc_encode_block_helper(pIn, inMask, colors, &a, false);
-    etc_encode_block_helper(pIn, inMask, flippedColors, &b, true);
-    take_best(&a, &b);
+    if (quality == ETC1_QUALITY_FAST) {
+        bool flipped = etc_average_error(pIn, inMask, flippedColors, true)
+                < etc_average_error(pIn, inMask, colors, false);
+        etc_encode_block_helper(pIn, inMask, flipped ? flippedColors : colors, &a, flipped, false);
+    } else {
+        etc_encode_block_helper(pIn, inMask, colors, &a, false, false);
+        etc_encode_block_helper(pIn, inMask, flippedColors, &b, true, false);
+        take_best(&a, &b);
+        if (quality == ETC1_QUALITY_HIGH) {
+            // Differential base colors are used whenever they fit, individual ones may still be closer.
+            etc_encode_block_helper(pIn, inMask, colors, &b, false, true);
+            take_best(&a, &b);
+            etc_encode_block_helper(pIn, inMask, flippedColors, &b, true, true);
+            take_best(&a, &b);
+        }
+    }
     writeBigEndian(pOut, a.high);
     writeBigEndian(pOut + 4, a.low);
 }
 
+// Input is a 4 x 4 square of 3-byte pixels in form R, G, B
+// inmask is a 16-bit mask where bit (1 << (x + y * 4)) tells whether the corresponding (x,y)
+// pixel is valid or not. Invalid pixel color values are ignored when compressing.
+// Output is an ETC1 compressed version of the data.
+
+void etc1_encode_block(const etc1_byte* pIn, etc1_uint32 inMask,
+        etc1_byte* pOut) {
+    etc_encode_block_quality(pIn, inMask, pOut, ETC1_QUALITY_MEDIUM);
+}
+
 // Return the size of the encoded image data (does not include size of PKM header).
 
 etc1_uint32 etc1_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height) {
     return (((width + 3) & ~3) * ((height + 3) & ~3)) >> 1;
 }
 
-// Encode an entire image.
-// pIn - pointer to the image data. Formatted such that the Red component of
-//       pixel (x,y) is at pIn + pixelSize * x + stride * y + redOffset;
-// pOut - pointer to encoded data. Must be large enough to store entire encoded image.
+// Images of at least this many pixels are encoded in bands of block rows on several threads.
+static const etc1_uint32 kParallelEncodeMinPixels = 128 * 128;
 
-int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
-        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut) {
-    if (pixelSize < 2 || pixelSize > 3) {
-        return -1;
-    }
+// Encode the block rows [blockRowBegin, blockRowEnd) of an image.
+
+static
+void encode_block_rows(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut, int quality,
+        etc1_uint32 blockRowBegin, etc1_uint32 blockRowEnd) {
     static const unsigned short kYMask[] = { 0x0, 0xf, 0xff, 0xfff, 0xffff };
     static const unsigned short kXMask[] = { 0x0, 0x1111, 0x3333, 0x7777,
             0xffff };
@@ -521,9 +842,9 @@ int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 heigh
     etc1_byte encoded[ETC1_ENCODED_BLOCK_SIZE];
 
     etc1_uint32 encodedWidth = (width + 3) & ~3;
-    etc1_uint32 encodedHeight = (height + 3) & ~3;
+    pOut += blockRowBegin * (encodedWidth / 4) * ETC1_ENCODED_BLOCK_SIZE;
 
-    for (etc1_uint32 y = 0; y < encodedHeight; y += 4) {
+    for (etc1_uint32 y = blockRowBegin * 4; y < blockRowEnd * 4; y += 4) {
         etc1_uint32 yEnd = height - y;
         if (yEnd > 4) {
             yEnd = 4;
@@ -550,11 +871,41 @@ int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 heigh
                     }
                 }
             }
-            etc1_encode_block(block, mask, encoded);
+            etc_encode_block_quality(block, mask, encoded, quality);
             memcpy(pOut, encoded, sizeof(encoded));
             pOut += sizeof(encoded);
         }
     }
+}
+
+// Encode an entire image.
+// pIn - pointer to the image data. Formatted such that the Red component of
+//       pixel (x,y) is at pIn + pixelSize * x + stride * y + redOffset;
+// pOut - pointer to encoded data. Must be large enough to store entire encoded image.
+
+int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut) {
+    return etc1_encode_image_quality(pIn, width, height, pixelSize, stride, pOut,
+            ETC1_QUALITY_MEDIUM, 0);
+}
+
+int etc1_encode_image_quality(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut, int quality, int maxThreads) {
+    if (pixelSize < 2 || pixelSize > 3) {
+        return -1;
+    }
+    if (quality < ETC1_QUALITY_FAST || quality > ETC1_QUALITY_HIGH) {
+        return -1;
+    }
+
+    etc1_uint32 blockRows = (height + 3) / 4;
+    if (maxThreads == 1 || width * height < kParallelEncodeMinPixels) {
+        encode_block_rows(pIn, width, height, pixelSize, stride, pOut, quality, 0, blockRows);
+    } else {
+        cocos2d::parallelForRanges((int) blockRows, 1, maxThreads, [=](int begin, int end) {
+            encode_block_rows(pIn, width, height, pixelSize, stride, pOut, quality, begin, end);
+        });
+    }
     return 0;
 }
 
@@ -565,18 +916,22 @@ int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 heigh
 //        large enough to store entire image.
 
 
-int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
+// Images of at least this many pixels are decoded in bands of block rows on several threads.
+static const etc1_uint32 kParallelDecodeMinPixels = 256 * 256;
+
+// Decode the block rows [blockRowBegin, blockRowEnd) of an image.
+
+static
+void decode_block_rows(const etc1_byte* pIn, etc1_byte* pOut,
         etc1_uint32 width, etc1_uint32 height,
-        etc1_uint32 pixelSize, etc1_uint32 stride) {
-    if (pixelSize < 2 || pixelSize > 3) {
-        return -1;
-    }
+        etc1_uint32 pixelSize, etc1_uint32 stride,
+        etc1_uint32 blockRowBegin, etc1_uint32 blockRowEnd) {
     etc1_byte block[ETC1_DECODED_BLOCK_SIZE];
 
     etc1_uint32 encodedWidth = (width + 3) & ~3;
-    etc1_uint32 encodedHeight = (height + 3) & ~3;
+    pIn += blockRowBegin * (encodedWidth / 4) * ETC1_ENCODED_BLOCK_SIZE;
 
-    for (etc1_uint32 y = 0; y < encodedHeight; y += 4) {
+    for (etc1_uint32 y = blockRowBegin * 4; y < blockRowEnd * 4; y += 4) {
         etc1_uint32 yEnd = height - y;
         if (yEnd > 4) {
             yEnd = 4;
@@ -586,6 +941,13 @@ int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
             if (xEnd > 4) {
                 xEnd = 4;
             }
+#if defined(ETC1_DECODE_SSSE3) || defined(ETC1_DECODE_NEON)
+            if (pixelSize == 3) {
+                decode_block_rgb(pIn, pOut + 3 * x + stride * y, stride, xEnd, yEnd);
+                pIn += ETC1_ENCODED_BLOCK_SIZE;
+                continue;
+            }
+#endif
             etc1_decode_block(pIn, block);
             pIn += ETC1_ENCODED_BLOCK_SIZE;
             for (etc1_uint32 cy = 0; cy < yEnd; cy++) {
@@ -606,6 +968,29 @@ int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
             }
         }
     }
+}
+
+int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
+        etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride) {
+    return etc1_decode_image_threads(pIn, pOut, width, height, pixelSize, stride, 0);
+}
+
+int etc1_decode_image_threads(const etc1_byte* pIn, etc1_byte* pOut,
+        etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, int maxThreads) {
+    if (pixelSize < 2 || pixelSize > 3) {
+        return -1;
+    }
+
+    etc1_uint32 blockRows = (height + 3) / 4;
+    if (maxThreads == 1 || width * height < kParallelDecodeMinPixels) {
+        decode_block_rows(pIn, pOut, width, height, pixelSize, stride, 0, blockRows);
+    } else {
+        cocos2d::parallelForRanges((int) blockRows, 1, maxThreads, [=](int begin, int end) {
+            decode_block_rows(pIn, pOut, width, height, pixelSize, stride, begin, end);
+        });
+    }
     return 0;
 }
 
@@ -68,6 +68,22 @@ etc1_uint32 etc1_get_encoded_data_size(etc1_uint32 width, etc1_uint32 height);
 int etc1_encode_image(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
         etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut);
 
+// Encoder presets for etc1_encode_image_quality.
+// ETC1_QUALITY_FAST only encodes the sub-block orientation that fits the block best.
+// ETC1_QUALITY_MEDIUM is what etc1_encode_block and etc1_encode_image use.
+// ETC1_QUALITY_HIGH also tries individual base colors where differential ones fit.
+
+#define ETC1_QUALITY_FAST 0
+#define ETC1_QUALITY_MEDIUM 1
+#define ETC1_QUALITY_HIGH 2
+
+// Encode an entire image like etc1_encode_image, with one of the ETC1_QUALITY_* presets.
+// Rows of blocks are encoded on up to maxThreads threads, all hardware threads if it is 0.
+// returns non-zero if there is an error.
+
+int etc1_encode_image_quality(const etc1_byte* pIn, etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, etc1_byte* pOut, int quality, int maxThreads);
+
 // Decode an entire image.
 // pIn - pointer to encoded data.
 // pOut - pointer to the image data. Will be written such that
@@ -80,6 +96,14 @@ int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
         etc1_uint32 width, etc1_uint32 height,
         etc1_uint32 pixelSize, etc1_uint32 stride);
 
+// Decode an entire image like etc1_decode_image, on up to maxThreads threads, all hardware
+// threads if it is 0. Pass 1 to decode on the calling thread only.
+// returns non-zero if there is an error.
+
+int etc1_decode_image_threads(const etc1_byte* pIn, etc1_byte* pOut,
+        etc1_uint32 width, etc1_uint32 height,
+        etc1_uint32 pixelSize, etc1_uint32 stride, int maxThreads);
+
 // Size of a PKM header, in bytes.
 
 #define ETC_PKM_HEADER_SIZE 16
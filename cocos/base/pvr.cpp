@@ -19,6 +19,15 @@
 #include <assert.h>
 #include <cstdint>
 #include "base/pvr.h"
+#include "base/ccParallel.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PVRT_DECODE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PVRT_DECODE_NEON 1
+#endif
 
 #define PVRT_MIN(a,b)            (((a) < (b)) ? (a) : (b))
 #define PVRT_MAX(a,b)            (((a) > (b)) ? (a) : (b))
@@ -38,6 +47,10 @@
 
 #define WRAP_COORD(Val, Size) ((Val) & ((Size)-1))
 
+// 4bpp images of at least this many pixels are decompressed on several threads,
+// 2bpp images are always decompressed on the calling thread
+#define PARALLEL_DECODE_MIN_PIXELS (256 * 256)
+
 #define POWER_OF_2(X)   util_number_is_power_2(X)
 
 /*
@@ -74,24 +87,88 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
                        const int XDim,
                        const int YDim,
                        const int AssumeImageTiles,
+                       const int FirstRow,
+                       const int NumRows,
                        unsigned char* pResultImage);
 
+static void PVRDecompress4bppRegions(const AMTC_BLOCK_STRUCT *pCompressedData,
+                                     const int XDim,
+                                     const int YDim,
+                                     const int FirstRegionRow,
+                                     const int EndRegionRow,
+                                     unsigned char* pResultImage);
+
+static int util_number_is_power_2(unsigned input);
+
 /*!***********************************************************************
  @Function        PVRTDecompressPVRTC
  @Input            pCompressedData The PVRTC texture data to decompress
  @Input            Do2bitMode Signifies whether the data is PVRTC2 or PVRTC4
  @Input            XDim X dimension of the texture
  @Input            YDim Y dimension of the texture
+ @Input            MaxThreads Maximum number of threads, 0 for all hardware threads
  @Modified        pResultImage The decompressed texture data
- @Description    Decompresses PVRTC to RGBA 8888
+ @Description    Decompresses PVRTC to RGBA 8888. 4bpp textures of at least
+                 8x8 pixels take the vectorized path, large 4bpp textures
+                 are decompressed in bands on up to MaxThreads threads, all
+                 hardware threads if it is 0.
  *************************************************************************/
-int PVRTDecompressPVRTC(const void * const pCompressedData,const int XDim,const int YDim, void *pDestData,const bool Do2bitMode)
+int PVRTDecompressPVRTC(const void * const pCompressedData,const int XDim,const int YDim, void *pDestData,const bool Do2bitMode,const int MaxThreads)
 {
-    PVRDecompress((AMTC_BLOCK_STRUCT*)pCompressedData,Do2bitMode,XDim,YDim,1,(unsigned char*)pDestData);
+    AMTC_BLOCK_STRUCT* pBlocks = (AMTC_BLOCK_STRUCT*)pCompressedData;
+    unsigned char* pResultImage = (unsigned char*)pDestData;
+    bool parallel = !Do2bitMode && MaxThreads != 1 && XDim * YDim >= PARALLEL_DECODE_MIN_PIXELS;
+
+    if(!Do2bitMode && XDim >= 8 && YDim >= 8 && POWER_OF_2(XDim) && POWER_OF_2(YDim))
+    {
+        // every row of regions covers 4 rows of pixels
+        int RegionRows = YDim / BLK_Y_SIZE;
+        if(parallel)
+        {
+            cocos2d::parallelForRanges(RegionRows, 1, MaxThreads, [=](int Begin, int End) {
+                PVRDecompress4bppRegions(pBlocks, XDim, YDim, Begin, End, pResultImage);
+            });
+        }
+        else
+        {
+            PVRDecompress4bppRegions(pBlocks, XDim, YDim, 0, RegionRows, pResultImage);
+        }
+    }
+    else if(parallel)
+    {
+        cocos2d::parallelForRanges(YDim, 1, MaxThreads, [=](int Begin, int End) {
+            PVRDecompress(pBlocks, Do2bitMode, XDim, YDim, 1, Begin, End - Begin, pResultImage);
+        });
+    }
+    else
+    {
+        PVRDecompress(pBlocks, Do2bitMode, XDim, YDim, 1, 0, YDim, pResultImage);
+    }
 
     return XDim*YDim/2;
 }
 
+/*!***********************************************************************
+ @Function        PVRTDecompressPVRTCRows
+ @Input            pCompressedData The PVRTC texture data to decompress
+ @Input            XDim X dimension of the texture
+ @Input            YDim Y dimension of the texture
+ @Input            Do2bitMode Signifies whether the data is PVRTC2 or PVRTC4
+ @Input            FirstRow First pixel row to decompress
+ @Input            NumRows Number of pixel rows to decompress
+ @Modified        pDestData The full size decompressed texture, only the
+                  requested rows are written
+ @Description    Decompresses a band of rows of PVRTC to RGBA 8888 with the
+                 reference per pixel decoder. Rows don't depend on each
+                 other, so bands can be decompressed concurrently.
+ *************************************************************************/
+int PVRTDecompressPVRTCRows(const void * const pCompressedData,const int XDim,const int YDim, void *pDestData,const bool Do2bitMode,const int FirstRow,const int NumRows)
+{
+    PVRDecompress((AMTC_BLOCK_STRUCT*)pCompressedData,Do2bitMode,XDim,YDim,1,FirstRow,NumRows,(unsigned char*)pDestData);
+
+    return XDim*NumRows/2;
+}
+
 /*!***********************************************************************
  @Function        util_number_is_power_2
  @Input        input A number
@@ -100,7 +177,7 @@ int PVRTDecompressPVRTC(const void * const pCompressedData,const int XDim,const
  1, 2, 4, 8, ... etc.
  Returns FALSE for zero.
  *************************************************************************/
-int util_number_is_power_2( unsigned  input )
+static int util_number_is_power_2( unsigned  input )
 {
     unsigned minus1;
 
@@ -557,6 +634,8 @@ static U32 TwiddleUV(U32 YSize, U32 XSize, U32 YPos, U32 XPos)
  @Input            XDim X dimension of the texture
  @Input            YDim Y dimension of the texture
  @Input            AssumeImageTiles Assume the texture data tiles
+ @Input            FirstRow First pixel row to decompress
+ @Input            NumRows Number of pixel rows to decompress
  @Modified        pResultImage The decompressed texture data
  @Description    Decompresses PVRTC to RGBA 8888
  *************************************************************************/
@@ -565,6 +644,8 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
                        const int XDim,
                        const int YDim,
                        const int AssumeImageTiles,
+                       const int FirstRow,
+                       const int NumRows,
                        unsigned char* pResultImage)
 {
     int x, y;
@@ -614,7 +695,7 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
 
      Note that this is a hideously inefficient way to do this!
      */
-    for(y = 0; y < YDim; y++)
+    for(y = FirstRow; y < FirstRow + NumRows; y++)
     {
         for(x = 0; x < XDim; x++)
         {
@@ -708,6 +789,303 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
     }
 }
 
+/*!***********************************************************************
+ @Function        DecodeRegion
+ @Input            Colours A and B colours of the 2x2 neighbourhood of blocks
+ @Input            Mod Modulation value of every pixel of the region
+ @Input            DoPT Punch-through flag of every pixel of the region
+ @Modified        Out The decompressed RGBA 8888 rows of the region
+ @Description    Decompresses the 4x4 pixels which share one neighbourhood of
+ 4bpp blocks. The region starts at the centre of the top left
+ block, so every pixel has u, v = 0..3 in InterpolateColours.
+ The results are bit exact with PVRDecompress.
+ *************************************************************************/
+#if defined(PVRT_DECODE_SSE2)
+static inline __m128i LoadColourPair(const int Colour[4])
+{
+    return _mm_set_epi16(Colour[3], Colour[2], Colour[1], Colour[0],
+                         Colour[3], Colour[2], Colour[1], Colour[0]);
+}
+
+static void DecodeRegion(const int Colours[2][2][2][4],
+                         const int Mod[BLK_Y_SIZE][BLK_X_4BPP],
+                         const int DoPT[BLK_Y_SIZE][BLK_X_4BPP],
+                         U8 Out[BLK_Y_SIZE][BLK_X_4BPP * 4])
+{
+    const __m128i U[2] = { _mm_set_epi16(1, 1, 1, 1, 0, 0, 0, 0), _mm_set_epi16(3, 3, 3, 3, 2, 2, 2, 2) };
+    const __m128i AlphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+    // Top row signal (times 4) and vertical delta of each pixel pair, [pair][A/B]
+    __m128i Top[2][2], Delta[2][2];
+    for(int ab = 0; ab < 2; ab++)
+    {
+        __m128i P = LoadColourPair(Colours[0][0][ab]);
+        __m128i Q = LoadColourPair(Colours[0][1][ab]);
+        __m128i R = LoadColourPair(Colours[1][0][ab]);
+        __m128i S = LoadColourPair(Colours[1][1][ab]);
+
+        for(int h = 0; h < 2; h++)
+        {
+            __m128i tmp1 = _mm_add_epi16(_mm_slli_epi16(P, 2), _mm_mullo_epi16(U[h], _mm_sub_epi16(Q, P)));
+            __m128i tmp2 = _mm_add_epi16(_mm_slli_epi16(R, 2), _mm_mullo_epi16(U[h], _mm_sub_epi16(S, R)));
+            Top[h][ab] = _mm_slli_epi16(tmp1, 2);
+            Delta[h][ab] = _mm_sub_epi16(tmp2, tmp1);
+        }
+    }
+
+    for(int v = 0; v < BLK_Y_SIZE; v++)
+    {
+        const __m128i V = _mm_set1_epi16(v);
+        __m128i Result[2];
+
+        for(int h = 0; h < 2; h++)
+        {
+            __m128i Sig[2];
+            for(int ab = 0; ab < 2; ab++)
+            {
+                __m128i Val = _mm_add_epi16(Top[h][ab], _mm_mullo_epi16(V, Delta[h][ab]));
+
+                // RGB drop a bit to get 8 bit precision, then expand 5554 to 8888
+                Val = _mm_or_si128(_mm_andnot_si128(AlphaMask, _mm_srai_epi16(Val, 1)), _mm_and_si128(AlphaMask, Val));
+                Sig[ab] = _mm_add_epi16(Val, _mm_or_si128(_mm_andnot_si128(AlphaMask, _mm_srai_epi16(Val, 5)),
+                                                         _mm_and_si128(AlphaMask, _mm_srai_epi16(Val, 4))));
+            }
+
+            const int u = h * 2;
+            __m128i M = _mm_set_epi16(Mod[v][u+1], Mod[v][u+1], Mod[v][u+1], Mod[v][u+1],
+                                      Mod[v][u], Mod[v][u], Mod[v][u], Mod[v][u]);
+            __m128i Keep = _mm_set_epi16(DoPT[v][u+1] ? 0 : -1, -1, -1, -1,
+                                         DoPT[v][u] ? 0 : -1, -1, -1, -1);
+
+            __m128i Val = _mm_add_epi16(_mm_slli_epi16(Sig[0], 3), _mm_mullo_epi16(M, _mm_sub_epi16(Sig[1], Sig[0])));
+            Result[h] = _mm_and_si128(_mm_srai_epi16(Val, 3), Keep);
+        }
+
+        _mm_storeu_si128((__m128i*)Out[v], _mm_packus_epi16(Result[0], Result[1]));
+    }
+}
+#elif defined(PVRT_DECODE_NEON)
+static inline int16x8_t LoadColourPair(const int Colour[4])
+{
+    const int16_t Lanes[8] = {
+        (int16_t)Colour[0], (int16_t)Colour[1], (int16_t)Colour[2], (int16_t)Colour[3],
+        (int16_t)Colour[0], (int16_t)Colour[1], (int16_t)Colour[2], (int16_t)Colour[3]
+    };
+    return vld1q_s16(Lanes);
+}
+
+static void DecodeRegion(const int Colours[2][2][2][4],
+                         const int Mod[BLK_Y_SIZE][BLK_X_4BPP],
+                         const int DoPT[BLK_Y_SIZE][BLK_X_4BPP],
+                         U8 Out[BLK_Y_SIZE][BLK_X_4BPP * 4])
+{
+    static const int16_t ULanes[2][8] = { {0, 0, 0, 0, 1, 1, 1, 1}, {2, 2, 2, 2, 3, 3, 3, 3} };
+    static const uint16_t AlphaLanes[8] = {0, 0, 0, 0xFFFF, 0, 0, 0, 0xFFFF};
+    const uint16x8_t AlphaMask = vld1q_u16(AlphaLanes);
+
+    // Top row signal (times 4) and vertical delta of each pixel pair, [pair][A/B]
+    int16x8_t Top[2][2], Delta[2][2];
+    for(int ab = 0; ab < 2; ab++)
+    {
+        int16x8_t P = LoadColourPair(Colours[0][0][ab]);
+        int16x8_t Q = LoadColourPair(Colours[0][1][ab]);
+        int16x8_t R = LoadColourPair(Colours[1][0][ab]);
+        int16x8_t S = LoadColourPair(Colours[1][1][ab]);
+
+        for(int h = 0; h < 2; h++)
+        {
+            const int16x8_t U = vld1q_s16(ULanes[h]);
+            int16x8_t tmp1 = vmlaq_s16(vshlq_n_s16(P, 2), U, vsubq_s16(Q, P));
+            int16x8_t tmp2 = vmlaq_s16(vshlq_n_s16(R, 2), U, vsubq_s16(S, R));
+            Top[h][ab] = vshlq_n_s16(tmp1, 2);
+            Delta[h][ab] = vsubq_s16(tmp2, tmp1);
+        }
+    }
+
+    for(int v = 0; v < BLK_Y_SIZE; v++)
+    {
+        const int16x8_t V = vdupq_n_s16((int16_t)v);
+        int16x8_t Result[2];
+
+        for(int h = 0; h < 2; h++)
+        {
+            int16x8_t Sig[2];
+            for(int ab = 0; ab < 2; ab++)
+            {
+                int16x8_t Val = vmlaq_s16(Top[h][ab], V, Delta[h][ab]);
+
+                // RGB drop a bit to get 8 bit precision, then expand 5554 to 8888
+                Val = vbslq_s16(AlphaMask, Val, vshrq_n_s16(Val, 1));
+                Sig[ab] = vaddq_s16(Val, vbslq_s16(AlphaMask, vshrq_n_s16(Val, 4), vshrq_n_s16(Val, 5)));
+            }
+
+            const int u = h * 2;
+            const int16_t ModLanes[8] = {
+                (int16_t)Mod[v][u], (int16_t)Mod[v][u], (int16_t)Mod[v][u], (int16_t)Mod[v][u],
+                (int16_t)Mod[v][u+1], (int16_t)Mod[v][u+1], (int16_t)Mod[v][u+1], (int16_t)Mod[v][u+1]
+            };
+            const int16_t KeepLanes[8] = {
+                -1, -1, -1, (int16_t)(DoPT[v][u] ? 0 : -1),
+                -1, -1, -1, (int16_t)(DoPT[v][u+1] ? 0 : -1)
+            };
+
+            int16x8_t Val = vmlaq_s16(vshlq_n_s16(Sig[0], 3), vld1q_s16(ModLanes), vsubq_s16(Sig[1], Sig[0]));
+            Result[h] = vandq_s16(vshrq_n_s16(Val, 3), vld1q_s16(KeepLanes));
+        }
+
+        vst1q_u8(Out[v], vcombine_u8(vqmovun_s16(Result[0]), vqmovun_s16(Result[1])));
+    }
+}
+#else
+static void DecodeRegion(const int Colours[2][2][2][4],
+                         const int Mod[BLK_Y_SIZE][BLK_X_4BPP],
+                         const int DoPT[BLK_Y_SIZE][BLK_X_4BPP],
+                         U8 Out[BLK_Y_SIZE][BLK_X_4BPP * 4])
+{
+    for(int v = 0; v < BLK_Y_SIZE; v++)
+    {
+        for(int u = 0; u < BLK_X_4BPP; u++)
+        {
+            int Sig[2][4];
+            for(int ab = 0; ab < 2; ab++)
+            {
+                for(int k = 0; k < 4; k++)
+                {
+                    const int P = Colours[0][0][ab][k], Q = Colours[0][1][ab][k];
+                    const int R = Colours[1][0][ab][k], S = Colours[1][1][ab][k];
+                    int tmp1 = P * 4 + u * (Q - P);
+                    int tmp2 = R * 4 + u * (S - R);
+                    int Val = tmp1 * 4 + v * (tmp2 - tmp1);
+
+                    // RGB drop a bit to get 8 bit precision, then expand 5554 to 8888
+                    if(k < 3)
+                    {
+                        Val >>= 1;
+                        Val += Val >> 5;
+                    }
+                    else
+                    {
+                        Val += Val >> 4;
+                    }
+                    Sig[ab][k] = Val;
+                }
+            }
+
+            for(int k = 0; k < 4; k++)
+            {
+                Out[v][u*4+k] = (U8)((Sig[0][k] * 8 + Mod[v][u] * (Sig[1][k] - Sig[0][k])) >> 3);
+            }
+
+            if(DoPT[v][u])
+                Out[v][u*4+3] = 0;
+        }
+    }
+}
+#endif
+
+/*!***********************************************************************
+ @Function        PVRDecompress4bppRegions
+ @Input            pCompressedData The PVRTC texture data to decompress
+ @Input            XDim X dimension of the texture, a power of 2 >= 8
+ @Input            YDim Y dimension of the texture, a power of 2 >= 8
+ @Input            FirstRegionRow First row of regions to decompress
+ @Input            EndRegionRow Row of regions to stop at
+ @Modified        pResultImage The decompressed texture data
+ @Description    Decompresses 4bpp PVRTC to RGBA 8888 one 4x4 pixel region
+ at a time instead of one pixel at a time. Region row N covers
+ the pixel rows 4N+2 to 4N+5 (wrapped), so bands of region rows
+ can be decompressed concurrently.
+ *************************************************************************/
+static void PVRDecompress4bppRegions(const AMTC_BLOCK_STRUCT *pCompressedData,
+                                     const int XDim,
+                                     const int YDim,
+                                     const int FirstRegionRow,
+                                     const int EndRegionRow,
+                                     unsigned char* pResultImage)
+{
+    static const int RepVals0[4] = {0, 3, 5, 8};
+    static const int RepVals1[4] = {0, 4, 4, 8};
+
+    const int BlkXDim = XDim / BLK_X_4BPP;
+    const int BlkYDim = YDim / BLK_Y_SIZE;
+
+    // local neighbourhood of blocks and their colours, [block row][block column][A/B][channel]
+    const AMTC_BLOCK_STRUCT *pBlocks[2][2];
+    int Colours[2][2][2][4];
+
+    int Mod[BLK_Y_SIZE][BLK_X_4BPP];
+    int DoPT[BLK_Y_SIZE][BLK_X_4BPP];
+    U8 Out[BLK_Y_SIZE][BLK_X_4BPP * 4];
+
+    for(int BlkY = FirstRegionRow; BlkY < EndRegionRow; BlkY++)
+    {
+        const int BlkYp1 = WRAP_COORD(BlkY + 1, BlkYDim);
+
+        pBlocks[0][1] = pCompressedData + TwiddleUV(BlkYDim, BlkXDim, BlkY, 0);
+        pBlocks[1][1] = pCompressedData + TwiddleUV(BlkYDim, BlkXDim, BlkYp1, 0);
+        Unpack5554Colour(pBlocks[0][1], Colours[0][1]);
+        Unpack5554Colour(pBlocks[1][1], Colours[1][1]);
+
+        for(int BlkX = 0; BlkX < BlkXDim; BlkX++)
+        {
+            const int BlkXp1 = WRAP_COORD(BlkX + 1, BlkXDim);
+
+            // the right blocks of the previous region are the left blocks of this one
+            for(int i = 0; i < 2; i++)
+            {
+                pBlocks[i][0] = pBlocks[i][1];
+                memcpy(Colours[i][0], Colours[i][1], sizeof(Colours[i][0]));
+            }
+
+            pBlocks[0][1] = pCompressedData + TwiddleUV(BlkYDim, BlkXDim, BlkY, BlkXp1);
+            pBlocks[1][1] = pCompressedData + TwiddleUV(BlkYDim, BlkXDim, BlkYp1, BlkXp1);
+            Unpack5554Colour(pBlocks[0][1], Colours[0][1]);
+            Unpack5554Colour(pBlocks[1][1], Colours[1][1]);
+
+            // every pixel takes its modulation from the block it lies in
+            for(int v = 0; v < BLK_Y_SIZE; v++)
+            {
+                for(int u = 0; u < BLK_X_4BPP; u++)
+                {
+                    const AMTC_BLOCK_STRUCT *pBlock = pBlocks[v >> 1][u >> 1];
+                    const int Shift = 2 * (((v + 2) & 3) * BLK_X_4BPP + ((u + 2) & 3));
+                    const int ModVal = (pBlock->PackedData[0] >> Shift) & 3;
+
+                    if(pBlock->PackedData[1] & 1)
+                    {
+                        Mod[v][u] = RepVals1[ModVal];
+                        DoPT[v][u] = ModVal == PT_INDEX;
+                    }
+                    else
+                    {
+                        Mod[v][u] = RepVals0[ModVal];
+                        DoPT[v][u] = 0;
+                    }
+                }
+            }
+
+            DecodeRegion((const int (*)[2][2][4])Colours, (const int (*)[BLK_X_4BPP])Mod,
+                         (const int (*)[BLK_X_4BPP])DoPT, Out);
+
+            // Store the region, wrapping around the right and bottom edges
+            const int StartX = BlkX * BLK_X_4BPP + BLK_X_4BPP / 2;
+            for(int v = 0; v < BLK_Y_SIZE; v++)
+            {
+                unsigned char* pRow = pResultImage + WRAP_COORD(BlkY * BLK_Y_SIZE + BLK_Y_SIZE / 2 + v, YDim) * XDim * 4;
+                if(StartX + BLK_X_4BPP <= XDim)
+                {
+                    memcpy(pRow + StartX * 4, Out[v], sizeof(Out[v]));
+                }
+                else
+                {
+                    memcpy(pRow + StartX * 4, Out[v], sizeof(Out[v]) / 2);
+                    memcpy(pRow, Out[v] + sizeof(Out[v]) / 2, sizeof(Out[v]) / 2);
+                }
+            }
+        }
+    }
+}
+
 /*****************************************************************************
  End of file (pvr.cpp)
  *****************************************************************************/
@@ -16,7 +16,11 @@
 #define __PVR_H__
 
 
-int PVRTDecompressPVRTC(const void * const pCompressedData,const int XDim,const int YDim,void *pDestData,const bool Do2bitMode);
+// Large 4bpp images are decompressed on up to MaxThreads threads, all hardware threads if it is 0.
+int PVRTDecompressPVRTC(const void * const pCompressedData,const int XDim,const int YDim,void *pDestData,const bool Do2bitMode,const int MaxThreads = 0);
+
+// Decompresses rows [FirstRow, FirstRow + NumRows) into the full size pDestData image.
+int PVRTDecompressPVRTCRows(const void * const pCompressedData,const int XDim,const int YDim,void *pDestData,const bool Do2bitMode,const int FirstRow,const int NumRows);
 
 
 #endif //__PVR_H__
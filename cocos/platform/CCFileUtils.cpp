@@ -25,11 +25,12 @@ THE SOFTWARE.
 
 #include "platform/CCFileUtils.h"
 
-#include <stack>
+#include <algorithm>
 
 #include "base/CCData.h"
+#include "base/CCAssetBundle.h"
 #include "base/ccMacros.h"
-#include "platform/CCSAXParser.h"
+#include "platform/CCPlistParser.h"
 
 #include "tinyxml2/tinyxml2.h"
 #include "tinydir/tinydir.h"
@@ -40,292 +41,14 @@ THE SOFTWARE.
 #include "unzip/unzip.h"
 #endif
 #include <sys/stat.h>
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 NS_CC_BEGIN
 
-// Implement DictMaker
-
-#if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
-
-typedef enum
-{
-    SAX_NONE = 0,
-    SAX_KEY,
-    SAX_DICT,
-    SAX_INT,
-    SAX_REAL,
-    SAX_STRING,
-    SAX_ARRAY
-}SAXState;
-
-typedef enum
-{
-    SAX_RESULT_NONE = 0,
-    SAX_RESULT_DICT,
-    SAX_RESULT_ARRAY
-}SAXResult;
-
-class DictMaker : public SAXDelegator
-{
-public:
-    SAXResult _resultType;
-    ValueMap _rootDict;
-    ValueVector _rootArray;
-
-    std::string _curKey;   ///< parsed key
-    std::string _curValue; // parsed value
-    SAXState _state;
-
-    ValueMap*  _curDict;
-    ValueVector* _curArray;
-
-    std::stack<ValueMap*> _dictStack;
-    std::stack<ValueVector*> _arrayStack;
-    std::stack<SAXState>  _stateStack;
-
-public:
-    DictMaker()
-        : _resultType(SAX_RESULT_NONE)
-    {
-    }
-
-    ~DictMaker()
-    {
-    }
-
-    ValueMap dictionaryWithContentsOfFile(const std::string& fileName)
-    {
-        _resultType = SAX_RESULT_DICT;
-        SAXParser parser;
-
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
-
-        parser.parse(fileName);
-        return _rootDict;
-    }
-
-    ValueMap dictionaryWithDataOfFile(const char* filedata, int filesize)
-    {
-        _resultType = SAX_RESULT_DICT;
-        SAXParser parser;
-
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
-
-        parser.parse(filedata, filesize);
-        return _rootDict;
-    }
-
-    ValueVector arrayWithContentsOfFile(const std::string& fileName)
-    {
-        _resultType = SAX_RESULT_ARRAY;
-        SAXParser parser;
-
-        CCASSERT(parser.init("UTF-8"), "The file format isn't UTF-8");
-        parser.setDelegator(this);
-
-        parser.parse(fileName);
-        return _rootArray;
-    }
-
-    void startElement(void *ctx, const char *name, const char **atts)
-    {
-        CC_UNUSED_PARAM(ctx);
-        CC_UNUSED_PARAM(atts);
-        const std::string sName(name);
-        if( sName == "dict" )
-        {
-            if(_resultType == SAX_RESULT_DICT && _rootDict.empty())
-            {
-                _curDict = &_rootDict;
-            }
-
-            _state = SAX_DICT;
-
-            SAXState preState = SAX_NONE;
-            if (! _stateStack.empty())
-            {
-                preState = _stateStack.top();
-            }
-
-            if (SAX_ARRAY == preState)
-            {
-                // add a new dictionary into the array
-                _curArray->push_back(Value(ValueMap()));
-                _curDict = &(_curArray->rbegin())->asValueMap();
-            }
-            else if (SAX_DICT == preState)
-            {
-                // add a new dictionary into the pre dictionary
-                CCASSERT(! _dictStack.empty(), "The state is wrong!");
-                ValueMap* preDict = _dictStack.top();
-                (*preDict)[_curKey] = Value(ValueMap());
-                _curDict = &(*preDict)[_curKey].asValueMap();
-            }
-
-            // record the dict state
-            _stateStack.push(_state);
-            _dictStack.push(_curDict);
-        }
-        else if(sName == "key")
-        {
-            _state = SAX_KEY;
-        }
-        else if(sName == "integer")
-        {
-            _state = SAX_INT;
-        }
-        else if(sName == "real")
-        {
-            _state = SAX_REAL;
-        }
-        else if(sName == "string")
-        {
-            _state = SAX_STRING;
-        }
-        else if (sName == "array")
-        {
-            _state = SAX_ARRAY;
-
-            if (_resultType == SAX_RESULT_ARRAY && _rootArray.empty())
-            {
-                _curArray = &_rootArray;
-            }
-            SAXState preState = SAX_NONE;
-            if (! _stateStack.empty())
-            {
-                preState = _stateStack.top();
-            }
-
-            if (preState == SAX_DICT)
-            {
-                (*_curDict)[_curKey] = Value(ValueVector());
-                _curArray = &(*_curDict)[_curKey].asValueVector();
-            }
-            else if (preState == SAX_ARRAY)
-            {
-                CCASSERT(! _arrayStack.empty(), "The state is wrong!");
-                ValueVector* preArray = _arrayStack.top();
-                preArray->push_back(Value(ValueVector()));
-                _curArray = &(_curArray->rbegin())->asValueVector();
-            }
-            // record the array state
-            _stateStack.push(_state);
-            _arrayStack.push(_curArray);
-        }
-        else
-        {
-            _state = SAX_NONE;
-        }
-    }
-
-    void endElement(void *ctx, const char *name)
-    {
-        CC_UNUSED_PARAM(ctx);
-        SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string sName((char*)name);
-        if( sName == "dict" )
-        {
-            _stateStack.pop();
-            _dictStack.pop();
-            if ( !_dictStack.empty())
-            {
-                _curDict = _dictStack.top();
-            }
-        }
-        else if (sName == "array")
-        {
-            _stateStack.pop();
-            _arrayStack.pop();
-            if (! _arrayStack.empty())
-            {
-                _curArray = _arrayStack.top();
-            }
-        }
-        else if (sName == "true")
-        {
-            if (SAX_ARRAY == curState)
-            {
-                _curArray->push_back(Value(true));
-            }
-            else if (SAX_DICT == curState)
-            {
-                (*_curDict)[_curKey] = Value(true);
-            }
-        }
-        else if (sName == "false")
-        {
-            if (SAX_ARRAY == curState)
-            {
-                _curArray->push_back(Value(false));
-            }
-            else if (SAX_DICT == curState)
-            {
-                (*_curDict)[_curKey] = Value(false);
-            }
-        }
-        else if (sName == "string" || sName == "integer" || sName == "real")
-        {
-            if (SAX_ARRAY == curState)
-            {
-                if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
-                else if (sName == "integer")
-                    _curArray->push_back(Value(atoi(_curValue.c_str())));
-                else
-                    _curArray->push_back(Value(std::atof(_curValue.c_str())));
-            }
-            else if (SAX_DICT == curState)
-            {
-                if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
-                else if (sName == "integer")
-                    (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
-                else
-                    (*_curDict)[_curKey] = Value(std::atof(_curValue.c_str()));
-            }
-
-            _curValue.clear();
-        }
-
-        _state = SAX_NONE;
-    }
-
-    void textHandler(void *ctx, const char *ch, int len)
-    {
-        CC_UNUSED_PARAM(ctx);
-        if (_state == SAX_NONE)
-        {
-            return;
-        }
-
-        SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string text = std::string((char*)ch,len);
-
-        switch(_state)
-        {
-        case SAX_KEY:
-            _curKey = text;
-            break;
-        case SAX_INT:
-        case SAX_REAL:
-        case SAX_STRING:
-            {
-                if (curState == SAX_DICT)
-                {
-                    CCASSERT(!_curKey.empty(), "key not found : <integer/real>");
-                }
-
-                _curValue.append(text);
-            }
-            break;
-        default:
-            break;
-        }
-    }
-};
-
 ValueMap FileUtils::getValueMapFromFile(const std::string& filename)
 {
     const std::string fullPath = fullPathForFilename(filename);
@@ -335,23 +58,40 @@ ValueMap FileUtils::getValueMapFromFile(const std::string& filename)
         return ret;
     }
 
-    DictMaker tMaker;
-    return tMaker.dictionaryWithContentsOfFile(fullPath);
+    MappedFile* file = mapFile(fullPath);
+    if (!file)
+        return ValueMap();
+
+    Value root = PlistParser::parse((const char*)file->getBytes(), file->getSize());
+    file->release();
+    if (Value::Type::MAP != root.getType())
+        return ValueMap();
+    return std::move(root.asValueMap());
 }
 
 ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize)
 {
-    DictMaker tMaker;
-    return tMaker.dictionaryWithDataOfFile(filedata, filesize);
+    Value root = PlistParser::parse(filedata, filesize > 0 ? filesize : 0);
+    if (Value::Type::MAP != root.getType())
+        return ValueMap();
+    return std::move(root.asValueMap());
 }
 
 ValueVector FileUtils::getValueVectorFromFile(const std::string& filename)
 {
     const std::string fullPath = fullPathForFilename(filename);
-    DictMaker tMaker;
-    return tMaker.arrayWithContentsOfFile(fullPath);
+    MappedFile* file = fullPath.empty() ? nullptr : mapFile(fullPath);
+    if (!file)
+        return ValueVector();
+
+    Value root = PlistParser::parse((const char*)file->getBytes(), file->getSize());
+    file->release();
+    if (Value::Type::VECTOR != root.getType())
+        return ValueVector();
+    return std::move(root.asValueVector());
 }
 
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
 
 /*
  * forward statement
@@ -535,10 +275,7 @@ static tinyxml2::XMLElement* generateElementForArray(const ValueVector& array, t
 
 #else
 
-/* The subclass FileUtilsApple should override these two method. */
-ValueMap FileUtils::getValueMapFromFile(const std::string& filename) {return ValueMap();}
-ValueMap FileUtils::getValueMapFromData(const char* filedata, int filesize) {return ValueMap();}
-ValueVector FileUtils::getValueVectorFromFile(const std::string& filename) {return ValueVector();}
+/* The subclass FileUtilsApple should override this method. */
 bool FileUtils::writeToFile(const ValueMap& dict, const std::string &fullPath) {return false;}
 
 #endif /* (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC) */
@@ -566,6 +303,8 @@ FileUtils::FileUtils()
 
 FileUtils::~FileUtils()
 {
+    for (auto& bundle : _bundles)
+        bundle.second->release();
 }
 
 bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string& fullPath)
@@ -616,6 +355,189 @@ void FileUtils::purgeCachedEntries()
     _fullPathCache.clear();
 }
 
+// The file systems of Windows and Apple platforms ignore case by default, so the path index does too there:
+// "Foo.png" has to find "foo.png" as the file system would. The index keeps the case it was given for savePathIndex.
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT) || (CC_TARGET_PLATFORM == CC_PLATFORM_IOS) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+size_t FileUtils::PathIndexHash::operator()(const std::string& path) const
+{
+    // FNV-1a of the lowercase path
+    size_t hash = 2166136261u;
+    for (char c : path)
+    {
+        hash = (hash ^ (unsigned char)::tolower((unsigned char)c)) * 16777619u;
+    }
+    return hash;
+}
+
+bool FileUtils::PathIndexEqual::operator()(const std::string& a, const std::string& b) const
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return ::tolower((unsigned char)x) == ::tolower((unsigned char)y);
+    });
+}
+#else
+size_t FileUtils::PathIndexHash::operator()(const std::string& path) const
+{
+    return std::hash<std::string>()(path);
+}
+
+bool FileUtils::PathIndexEqual::operator()(const std::string& a, const std::string& b) const
+{
+    return a == b;
+}
+#endif
+
+namespace
+{
+    // Adds a path and the directories above it, so that looking up a directory finds it too.
+    // Directories are indexed without the trailing '/'.
+    template <typename Index>
+    void addToPathIndex(Index& index, std::string path)
+    {
+        while (!path.empty() && path.back() == '/')
+        {
+            path.pop_back();
+        }
+        while (!path.empty() && index.insert(path).second)
+        {
+            size_t pos = path.find_last_of('/');
+            if (pos == std::string::npos)
+            {
+                break;
+            }
+            path.resize(pos);
+        }
+    }
+}
+
+size_t FileUtils::buildPathIndex()
+{
+    PathIndex index;
+
+    const std::string& root = _defaultResRootPath;
+    if (!root.empty() && isDirectoryExistInternal(root))
+    {
+        std::vector<std::string> files;
+        listFilesRecursively(root, &files);
+        for (const auto& file : files)
+        {
+            // Directories end with '/', they are indexed too.
+            if (file.compare(0, root.size(), root) == 0)
+            {
+                addToPathIndex(index, file.substr(root.size()));
+            }
+        }
+    }
+    else
+    {
+        CCLOG("cocos2d: buildPathIndex: can't scan resource root \"%s\", use loadPathIndex instead.", root.c_str());
+    }
+
+    _pathIndex.swap(index);
+    return _pathIndex.size();
+}
+
+bool FileUtils::loadPathIndex(const std::string& filename)
+{
+    std::string manifest;
+    if (getContents(filename, &manifest) != Status::OK)
+    {
+        CCLOG("cocos2d: loadPathIndex: can't read %s.", filename.c_str());
+        return false;
+    }
+
+    PathIndex index;
+    size_t begin = 0;
+    while (begin < manifest.size())
+    {
+        size_t end = manifest.find('\n', begin);
+        if (end == std::string::npos)
+        {
+            end = manifest.size();
+        }
+
+        size_t last = end;
+        while (last > begin && (manifest[last-1] == '\r' || manifest[last-1] == ' ' || manifest[last-1] == '\t'))
+        {
+            --last;
+        }
+        if (last > begin && manifest[begin] != '#')
+        {
+            addToPathIndex(index, manifest.substr(begin, last - begin));
+        }
+
+        begin = end + 1;
+    }
+
+    _pathIndex.swap(index);
+    return true;
+}
+
+bool FileUtils::savePathIndex(const std::string& fullPath)
+{
+    // Sorted so that the manifest is stable across builds.
+    std::vector<std::string> files(_pathIndex.begin(), _pathIndex.end());
+    std::sort(files.begin(), files.end());
+
+    std::string manifest;
+    for (const auto& file : files)
+    {
+        manifest += file;
+        manifest += '\n';
+    }
+    return writeStringToFile(manifest, fullPath);
+}
+
+void FileUtils::clearPathIndex()
+{
+    _pathIndex.clear();
+}
+
+FileUtils::FullPathCache::Shard& FileUtils::FullPathCache::getShard(const std::string& key) const
+{
+    return _shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+bool FileUtils::FullPathCache::find(const std::string& key, std::string* value) const
+{
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.map.find(key);
+    if (iter == shard.map.end())
+    {
+        return false;
+    }
+    *value = iter->second;
+    return true;
+}
+
+void FileUtils::FullPathCache::insert(const std::string& key, const std::string& value)
+{
+    Shard& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.map.emplace(key, value);
+}
+
+void FileUtils::FullPathCache::clear()
+{
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.clear();
+    }
+}
+
+std::unordered_map<std::string, std::string> FileUtils::FullPathCache::snapshot() const
+{
+    std::unordered_map<std::string, std::string> ret;
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        ret.insert(shard.map.begin(), shard.map.end());
+    }
+    return ret;
+}
+
 std::string FileUtils::getStringFromFile(const std::string& filename)
 {
     std::string s;
@@ -631,6 +553,54 @@ Data FileUtils::getDataFromFile(const std::string& filename)
 }
 
 
+MappedFile* FileUtils::mapFile(const std::string& filename)
+{
+    if (filename.empty())
+        return nullptr;
+
+    if (!_bundles.empty())
+    {
+        std::string name;
+        AssetBundle* bundle = getBundleForPath(fullPathForFilename(filename), &name);
+        if (bundle)
+            return bundle->mapFile(name);
+    }
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return nullptr;
+
+    int descriptor = open(getSuitableFOpen(fullPath).c_str(), O_RDONLY);
+    if (descriptor != -1)
+    {
+        struct stat statBuf;
+        void* address = MAP_FAILED;
+        size_t size = 0;
+        // Empty files can't be mapped, they are read below.
+        if (fstat(descriptor, &statBuf) != -1 && statBuf.st_size > 0)
+        {
+            size = statBuf.st_size;
+            address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        }
+        // The mapping stays valid after the descriptor is closed.
+        close(descriptor);
+
+        if (address != MAP_FAILED)
+        {
+            return MappedFile::createWithMapping(static_cast<const unsigned char*>(address), size, [](const unsigned char* bytes, ssize_t size) {
+                munmap(const_cast<unsigned char*>(bytes), size);
+            });
+        }
+    }
+#endif
+
+    Data data;
+    if (getContents(filename, &data) != Status::OK)
+        return nullptr;
+    return MappedFile::createWithData(std::move(data));
+}
+
 FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableBuffer* buffer)
 {
     if (filename.empty())
@@ -642,6 +612,11 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    std::string name;
+    AssetBundle* bundle = fs->getBundleForPath(fullPath, &name);
+    if (bundle)
+        return bundle->getFileData(name, buffer) ? Status::OK : Status::ReadFailed;
+
     FILE *fp = fopen(fs->getSuitableFOpen(fullPath).c_str(), "rb");
     if (!fp)
         return Status::OpenFailed;
@@ -758,6 +733,17 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
         file = filename.substr(pos+1);
     }
 
+    if (!_bundles.empty())
+    {
+        auto bundleIter = _bundles.find(searchPath);
+        if (bundleIter != _bundles.end())
+        {
+            // file_path + resourceDirectory + file, inside the bundle
+            std::string name = file_path + resolutionDirectory + file;
+            return bundleIter->second->fileExists(name) ? searchPath + name : "";
+        }
+    }
+
     // searchPath + file_path + resourceDirectory
     std::string path = searchPath;
     path += file_path;
@@ -768,6 +754,55 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
     return path;
 }
 
+int FileUtils::findInPathIndex(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const
+{
+    if (_pathIndex.empty())
+    {
+        return -1;
+    }
+
+    // Only the search paths under the resource root are indexed, bundles have their own index.
+    if (!_bundles.empty() && _bundles.find(searchPath) != _bundles.end())
+    {
+        return -1;
+    }
+
+    const size_t rootLength = _defaultResRootPath.size();
+    if (searchPath.compare(0, rootLength, _defaultResRootPath) != 0 || (0 == rootLength && isAbsolutePath(searchPath)))
+    {
+        return -1;
+    }
+
+    // Same layout as getPathForFilename: searchPath + file_path + resolutionDirectory + file
+    std::string path(searchPath, rootLength);
+    size_t pos = filename.find_last_of("/");
+    if (pos != std::string::npos)
+    {
+        path.append(filename, 0, pos+1);
+        path += resolutionDirectory;
+        path.append(filename, pos+1, std::string::npos);
+    }
+    else
+    {
+        path += resolutionDirectory;
+        path += filename;
+    }
+
+    // The index only holds normalized paths, let the file system resolve "./" and "../".
+    if (path.find("./") != std::string::npos)
+    {
+        return -1;
+    }
+
+    // A directory looked up with a trailing '/'
+    if (!path.empty() && path.back() == '/')
+    {
+        path.pop_back();
+    }
+
+    return _pathIndex.count(path) ? 1 : 0;
+}
+
 std::string FileUtils::fullPathForFilename(const std::string &filename) const
 {
     if (filename.empty())
@@ -780,28 +815,33 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return filename;
     }
 
+    std::string fullpath;
+
     // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if(cacheIter != _fullPathCache.end())
+    if (_fullPathCache.find(filename, &fullpath))
     {
-        return cacheIter->second;
+        return fullpath;
     }
 
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
 
-    std::string fullpath;
-
     for (const auto& searchIt : _searchPathArray)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
+            // Don't query the file system for files the index doesn't list.
+            if (0 == findInPathIndex(newFilename, resolutionIt, searchIt))
+            {
+                continue;
+            }
+
             fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
 
             if (!fullpath.empty())
             {
                 // Using the filename passed in as key.
-                _fullPathCache.insert(std::make_pair(filename, fullpath));
+                _fullPathCache.insert(filename, fullpath);
                 return fullpath;
             }
 
@@ -878,6 +918,11 @@ void FileUtils::setWritablePath(const std::string& writablePath)
 
 void FileUtils::setDefaultResourceRootPath(const std::string& path)
 {
+    // The index is relative to the root.
+    if (path != _defaultResRootPath)
+    {
+        _pathIndex.clear();
+    }
     _defaultResRootPath = path;
 }
 
@@ -913,6 +958,20 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         //CCLOG("Default root path doesn't exist, adding it.");
         _searchPathArray.push_back(_defaultResRootPath);
     }
+
+    // close the bundles which aren't searched anymore
+    for (auto it = _bundles.begin(); it != _bundles.end();)
+    {
+        if (std::find(_searchPathArray.begin(), _searchPathArray.end(), it->first) == _searchPathArray.end())
+        {
+            it->second->release();
+            it = _bundles.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -933,6 +992,47 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     }
 }
 
+bool FileUtils::addSearchBundle(const std::string& filename, bool front)
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+    {
+        CCLOG("cocos2d: addSearchBundle: can't find %s", filename.c_str());
+        return false;
+    }
+
+    std::string searchPath = fullPath + '/';
+    if (_bundles.find(searchPath) != _bundles.end())
+        return true;
+
+    AssetBundle* bundle = AssetBundle::createWithFile(fullPath);
+    if (!bundle)
+        return false;
+
+    _bundles[searchPath] = bundle;
+    if (front) {
+        _searchPathArray.insert(_searchPathArray.begin(), searchPath);
+    } else {
+        _searchPathArray.push_back(searchPath);
+    }
+    // the bundle may shadow files which were found before
+    _fullPathCache.clear();
+    return true;
+}
+
+AssetBundle* FileUtils::getBundleForPath(const std::string& fullPath, std::string* name) const
+{
+    for (const auto& bundle : _bundles)
+    {
+        if (fullPath.size() > bundle.first.size() && fullPath.compare(0, bundle.first.size(), bundle.first) == 0)
+        {
+            name->assign(fullPath, bundle.first.size(), std::string::npos);
+            return bundle.second;
+        }
+    }
+    return nullptr;
+}
+
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
     _fullPathCache.clear();
@@ -979,6 +1079,10 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
+        std::string name;
+        AssetBundle* bundle = getBundleForPath(filename, &name);
+        if (bundle)
+            return bundle->fileExists(name);
         return isFileExistInternal(filename);
     }
     else
@@ -1005,14 +1109,14 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
         return isDirectoryExistInternal(dirPath);
     }
 
+    std::string fullpath;
+
     // Already Cached ?
-    auto cacheIter = _fullPathCache.find(dirPath);
-    if( cacheIter != _fullPathCache.end() )
+    if (_fullPathCache.find(dirPath, &fullpath))
     {
-        return isDirectoryExistInternal(cacheIter->second);
+        return isDirectoryExistInternal(fullpath);
     }
 
-    std::string fullpath;
     for (const auto& searchIt : _searchPathArray)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
@@ -1021,7 +1125,7 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
             fullpath = fullPathForFilename(searchIt + dirPath + resolutionIt);
             if (isDirectoryExistInternal(fullpath))
             {
-                _fullPathCache.insert(std::make_pair(dirPath, fullpath));
+                _fullPathCache.insert(dirPath, fullpath);
                 return true;
             }
         }
@@ -1377,6 +1481,11 @@ long FileUtils::getFileSize(const std::string &filepath)
             return 0;
     }
 
+    std::string name;
+    AssetBundle* bundle = getBundleForPath(fullpath, &name);
+    if (bundle)
+        return (long)bundle->getFileSize(name);
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
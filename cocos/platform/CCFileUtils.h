@@ -28,12 +28,15 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <mutex>
 #include <type_traits>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "base/CCMappedFile.h"
 
 NS_CC_BEGIN
 
@@ -113,6 +116,8 @@ public:
     }
 };
 
+class AssetBundle;
+
 /** Helper class to handle file operations. */
 class CC_DLL FileUtils
 {
@@ -165,6 +170,13 @@ public:
      */
     virtual Data getDataFromFile(const std::string& filename);
 
+    /**
+     *  Maps a file read-only, so that it can be parsed in place without copying it.
+     *  The file is memory mapped when possible, otherwise its contents are read into memory.
+     *  @return A mapping which has to be released, or nullptr if the file can't be read.
+     */
+    virtual MappedFile* mapFile(const std::string& filename);
+
 
     enum class Status
     {
@@ -428,6 +440,19 @@ public:
       */
     void addSearchPath(const std::string & path, const bool front=false);
 
+    /**
+     *  Adds an asset bundle to the search paths, see AssetBundle.
+     *  Files are looked up in the bundle as in a directory, resolution directories apply, and their
+     *  full paths are the bundle path followed by the file name. getContents, mapFile, isFileExist and
+     *  getFileSize read them from the bundle without touching the file system.
+     *  Add bundles before starting loader threads. setSearchPaths closes the bundles it doesn't keep.
+     *
+     *  @param filename The bundle file, it could be a relative or absolute path.
+     *  @param front Whether to search the bundle before the current search paths.
+     *  @return True if the bundle was opened.
+     */
+    virtual bool addSearchBundle(const std::string& filename, bool front = false);
+
     /**
      *  Gets the array of search paths.
      *
@@ -459,7 +484,7 @@ public:
     virtual bool isPopupNotify() const;
 
     /**
-     *  Converts the contents of a file to a ValueMap.
+     *  Converts the contents of a file to a ValueMap. The file is an XML or a binary plist.
      *  @param filename The filename of the file to gets content.
      *  @return ValueMap of the file contents.
      *  @note This method is used internally.
@@ -635,8 +660,43 @@ public:
      */
     virtual long getFileSize(const std::string &filepath);
 
-    /** Returns the full path cache. */
-    const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
+    /** Returns a copy of the full path cache. */
+    std::unordered_map<std::string, std::string> getFullPathCache() const { return _fullPathCache.snapshot(); }
+
+    /**
+     *  Builds the path index by scanning the default resource root once.
+     *  While the index is set, lookups under the resource root only probe the files it lists,
+     *  so a missing search path or resolution directory costs a hash lookup instead of a file system query.
+     *  Directories are indexed along with the files. On Windows, iOS and Mac the index ignores case like their file systems do.
+     *  The root must be a readable directory, use loadPathIndex on Android.
+     *
+     *  @return The number of indexed files and directories.
+     */
+    virtual size_t buildPathIndex();
+
+    /**
+     *  Loads the path index from a manifest, for example one written by savePathIndex at build time.
+     *  The manifest lists one file per line, relative to the default resource root. Empty lines and lines starting with '#' are ignored.
+     *  The directories of the listed files are indexed too, empty directories can be listed on their own.
+     *
+     *  @param filename The manifest file, it could be a relative or absolute path.
+     *  @return True if the manifest was read, false otherwise.
+     */
+    virtual bool loadPathIndex(const std::string& filename);
+
+    /**
+     *  Writes the path index to a manifest that loadPathIndex accepts.
+     *
+     *  @param fullPath The full path of the manifest.
+     *  @return True if the manifest was written, false otherwise.
+     */
+    virtual bool savePathIndex(const std::string& fullPath);
+
+    /** Removes the path index, lookups probe the file system again. */
+    void clearPathIndex();
+
+    /** Returns the number of files and directories in the path index, 0 when there is no index. */
+    size_t getPathIndexSize() const { return _pathIndex.size(); }
 
 protected:
     /**
@@ -729,11 +789,73 @@ protected:
      */
     std::string _defaultResRootPath;
 
+    /**
+     *  A string map split into shards with a lock each, so that threads resolving paths concurrently rarely contend.
+     */
+    class FullPathCache
+    {
+    public:
+        bool find(const std::string& key, std::string* value) const;
+        void insert(const std::string& key, const std::string& value);
+        void clear();
+        std::unordered_map<std::string, std::string> snapshot() const;
+
+    private:
+        static const size_t SHARD_COUNT = 16;
+
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            std::unordered_map<std::string, std::string> map;
+        };
+
+        Shard& getShard(const std::string& key) const;
+
+        mutable Shard _shards[SHARD_COUNT];
+    };
+
+    /**
+     *  Returns the bundle which contains `fullPath` and the name of the file inside it.
+     *  @return nullptr if the path isn't inside a bundle.
+     */
+    AssetBundle* getBundleForPath(const std::string& fullPath, std::string* name) const;
+
+    /** Hashes paths of the path index, ignoring case where the file system does. */
+    struct PathIndexHash
+    {
+        size_t operator()(const std::string& path) const;
+    };
+
+    /** Compares paths of the path index, ignoring case where the file system does. */
+    struct PathIndexEqual
+    {
+        bool operator()(const std::string& a, const std::string& b) const;
+    };
+
+    typedef std::unordered_set<std::string, PathIndexHash, PathIndexEqual> PathIndex;
+
+    /**
+     *  Checks a candidate path against the path index.
+     *  @return 1 if the index lists the file or directory, 0 if it doesn't, -1 if the candidate isn't covered by the index.
+     */
+    int findInPathIndex(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const;
+
     /**
      *  The full path cache. When a file is found, it will be added into this cache.
-     *  This variable is used for improving the performance of file search.
+     *  This variable is used for improving the performance of file search. It is safe to use from several threads.
+     */
+    mutable FullPathCache _fullPathCache;
+
+    /**
+     *  The files and directories under the default resource root, relative to it and without a trailing '/'.
+     *  Empty if there is no index. It is only read by lookups, so build or load it before starting loader threads.
+     */
+    PathIndex _pathIndex;
+
+    /**
+     *  The bundles added by addSearchBundle, by their search path, which is the bundle path followed by '/'.
      */
-    mutable std::unordered_map<std::string, std::string> _fullPathCache;
+    std::unordered_map<std::string, AssetBundle*> _bundles;
 
     /**
      * Writable path.
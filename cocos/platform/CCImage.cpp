@@ -89,6 +89,7 @@ extern "C"
 #endif
 
 #include <map>
+#include <atomic>
 
 #define CC_GL_ATC_RGB_AMD                                          0x8C92
 #define CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD                          0x8C93
@@ -356,6 +357,134 @@ namespace
 }
 //pvr structure end
 
+//////////////////////////////////////////////////////////////////////////
+//struct and data for ktx structure
+
+namespace
+{
+    static const unsigned char gKTX1Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static const unsigned char gKTX2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static const uint32_t KTX_ENDIANNESS = 0x04030201;
+    static const uint32_t KTX_ENDIANNESS_SWAPPED = 0x01020304;
+
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t endianness;
+        uint32_t glType;
+        uint32_t glTypeSize;
+        uint32_t glFormat;
+        uint32_t glInternalFormat;
+        uint32_t glBaseInternalFormat;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t numberOfArrayElements;
+        uint32_t numberOfFaces;
+        uint32_t numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+    } KTX1TexHeader;
+
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    } KTX2TexHeader;
+
+    typedef struct
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    } KTX2LevelIndex;
+
+    // GL enums of the KTX 1.1 header, some of them are missing from the GLES2 headers
+    Image::PixelFormat getKTX1PixelFormat(uint32_t glInternalFormat, uint32_t glFormat, uint32_t glType)
+    {
+        switch (glInternalFormat)
+        {
+            case 0x8D64: return Image::PixelFormat::ETC;                     // GL_ETC1_RGB8_OES
+            case 0x8C00: return Image::PixelFormat::PVRTC4;                  // GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+            case 0x8C01: return Image::PixelFormat::PVRTC2;                  // GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG
+            case 0x8C02: return Image::PixelFormat::PVRTC4A;                 // GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG
+            case 0x8C03: return Image::PixelFormat::PVRTC2A;                 // GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG
+            case 0x83F0:                                                     // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+            case 0x83F1: return Image::PixelFormat::S3TC_DXT1;               // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+            case 0x83F2: return Image::PixelFormat::S3TC_DXT3;               // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+            case 0x83F3: return Image::PixelFormat::S3TC_DXT5;               // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+            case CC_GL_ATC_RGB_AMD: return Image::PixelFormat::ATC_RGB;
+            case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD: return Image::PixelFormat::ATC_EXPLICIT_ALPHA;
+            case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD: return Image::PixelFormat::ATC_INTERPOLATED_ALPHA;
+            default: break;
+        }
+
+        // uncompressed, glInternalFormat may be sized (GL_RGBA8) so match the format and type instead
+        switch (glFormat)
+        {
+            case 0x1908: // GL_RGBA
+                if (0x1401 == glType) return Image::PixelFormat::RGBA8888;   // GL_UNSIGNED_BYTE
+                if (0x8033 == glType) return Image::PixelFormat::RGBA4444;   // GL_UNSIGNED_SHORT_4_4_4_4
+                if (0x8034 == glType) return Image::PixelFormat::RGB5A1;     // GL_UNSIGNED_SHORT_5_5_5_1
+                break;
+            case 0x1907: // GL_RGB
+                if (0x1401 == glType) return Image::PixelFormat::RGB888;
+                if (0x8363 == glType) return Image::PixelFormat::RGB565;     // GL_UNSIGNED_SHORT_5_6_5
+                break;
+            case 0x1906: // GL_ALPHA
+                if (0x1401 == glType) return Image::PixelFormat::A8;
+                break;
+            case 0x1909: // GL_LUMINANCE
+                if (0x1401 == glType) return Image::PixelFormat::I8;
+                break;
+            case 0x190A: // GL_LUMINANCE_ALPHA
+                if (0x1401 == glType) return Image::PixelFormat::AI88;
+                break;
+            default:
+                break;
+        }
+        return Image::PixelFormat::NONE;
+    }
+
+    Image::PixelFormat getKTX2PixelFormat(uint32_t vkFormat)
+    {
+        switch (vkFormat)
+        {
+            case 2: return Image::PixelFormat::RGBA4444;             // VK_FORMAT_R4G4B4A4_UNORM_PACK16
+            case 4: return Image::PixelFormat::RGB565;               // VK_FORMAT_R5G6B5_UNORM_PACK16
+            case 6: return Image::PixelFormat::RGB5A1;               // VK_FORMAT_R5G5B5A1_UNORM_PACK16
+            case 23: return Image::PixelFormat::RGB888;              // VK_FORMAT_R8G8B8_UNORM
+            case 37: return Image::PixelFormat::RGBA8888;            // VK_FORMAT_R8G8B8A8_UNORM
+            case 131:                                                // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+            case 133: return Image::PixelFormat::S3TC_DXT1;          // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+            case 135: return Image::PixelFormat::S3TC_DXT3;          // VK_FORMAT_BC2_UNORM_BLOCK
+            case 137: return Image::PixelFormat::S3TC_DXT5;          // VK_FORMAT_BC3_UNORM_BLOCK
+            case 1000054000: return Image::PixelFormat::PVRTC2A;     // VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG
+            case 1000054001: return Image::PixelFormat::PVRTC4A;     // VK_FORMAT_PVRTC1_4BPP_UNORM_BLOCK_IMG
+            default: return Image::PixelFormat::NONE;
+        }
+    }
+
+    inline uint32_t swapKTX1Value(uint32_t value, bool swapped)
+    {
+        return swapped ? ((value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24)) : value;
+    }
+}
+//ktx structure end
+
 namespace
 {
     typedef struct
@@ -383,26 +512,54 @@ namespace
 #endif //CC_USE_PNG
 }
 
-Image::PixelFormat getDevicePixelFormat(Image::PixelFormat format)
+namespace
 {
-    // switch (format) {
-    //     case Image::PixelFormat::PVRTC4:
-    //     case Image::PixelFormat::PVRTC4A:
-    //     case Image::PixelFormat::PVRTC2:
-    //     case Image::PixelFormat::PVRTC2A:
-    //         if(Configuration::getInstance()->supportsPVRTC())
-    //             return format;
-    //         else
-    //             return Image::PixelFormat::RGBA8888;
-    //     case Image::PixelFormat::ETC:
-    //         if(Configuration::getInstance()->supportsETC())
-    //             return format;
-    //         else
-    //             return Image::PixelFormat::RGB888;
-    //     default:
-    //         return format;
-    // }
-    return format;
+    // one bit per Image::PixelFormat, ETC is decoded by software unless the renderer finds the extension
+    std::atomic<uint32_t> s_compressedFormatSupport(~(1u << static_cast<int>(Image::PixelFormat::ETC)));
+
+    bool hasSoftwareDecoder(Image::PixelFormat format)
+    {
+        switch (format)
+        {
+            case Image::PixelFormat::PVRTC4:
+            case Image::PixelFormat::PVRTC4A:
+            case Image::PixelFormat::PVRTC2:
+            case Image::PixelFormat::PVRTC2A:
+            case Image::PixelFormat::ETC:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Bits per pixel of the formats which have a software decoder, they may be missing from the format table
+    // when the GL headers don't know them.
+    int getCompressedBitsPerPixel(Image::PixelFormat format)
+    {
+        switch (format)
+        {
+            case Image::PixelFormat::PVRTC2:
+            case Image::PixelFormat::PVRTC2A:
+                return 2;
+            case Image::PixelFormat::PVRTC4:
+            case Image::PixelFormat::PVRTC4A:
+            case Image::PixelFormat::ETC:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    // Decodes one PVRTC or ETC mipmap into RGBA8888 or RGB888, the decoders split large mipmaps across threads.
+    bool decodeCompressedMipmap(Image::PixelFormat format, const unsigned char* src, unsigned char* dst, int width, int height, int maxThreads)
+    {
+        if (Image::PixelFormat::ETC == format)
+            return etc1_decode_image_threads(src, dst, width, height, 3, width * 3, maxThreads) == 0;
+
+        bool do2bitMode = Image::PixelFormat::PVRTC2 == format || Image::PixelFormat::PVRTC2A == format;
+        PVRTDecompressPVRTC(src, width, height, dst, do2bitMode, maxThreads);
+        return true;
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -420,6 +577,10 @@ Image::Image()
 , _renderFormat(Image::PixelFormat::NONE)
 , _numberOfMipmaps(0)
 , _hasPremultipliedAlpha(true)
+, _premultiplyAlphaOnDecode(false)
+, _maxDecodeThreads(0)
+, _dataReferenced(false)
+, _mappedFile(nullptr)
 {
 
 }
@@ -431,8 +592,10 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (!_dataReferenced)
         CC_SAFE_FREE(_data);
+
+    CC_SAFE_RELEASE(_mappedFile);
 }
 
 bool Image::initWithImageFile(const std::string& path)
@@ -440,11 +603,17 @@ bool Image::initWithImageFile(const std::string& path)
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // keep the file mapped, so that compressed mipmaps can point into it instead of a copy
+    CC_SAFE_RELEASE(_mappedFile);
+    _mappedFile = FileUtils::getInstance()->mapFile(_filePath);
 
-    if (!data.isNull())
+    if (_mappedFile && _mappedFile->getSize() > 0)
+    {
+        ret = initWithImageData(_mappedFile->getBytes(), _mappedFile->getSize());
+    }
+    else
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        CC_SAFE_RELEASE_NULL(_mappedFile);
     }
 
     return ret;
@@ -476,6 +645,15 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             unpackedLen = dataLen;
         }
 
+        if (unpackedData != data && unpackedLen > 0)
+        {
+            // the inflated buffer is ours, it can be referenced by compressed mipmaps as well,
+            // `data` is released here when it is the mapped file
+            _containerData.clear();
+            _containerData.fastSet(unpackedData, unpackedLen);
+            CC_SAFE_RELEASE_NULL(_mappedFile);
+        }
+
         _fileType = detectFormat(unpackedData, unpackedLen);
 
         switch (_fileType)
@@ -498,6 +676,12 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ETC:
             ret = initWithETCData(unpackedData, unpackedLen);
             break;
+        case Format::KTX:
+            if (memcmp(unpackedData, gKTX2Identifier, sizeof(gKTX2Identifier)) == 0)
+                ret = initWithKTX2Data(unpackedData, unpackedLen);
+            else
+                ret = initWithKTXData(unpackedData, unpackedLen);
+            break;
         default:
             {
                 // load and detect image format
@@ -517,9 +701,10 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
             }
         }
 
-        if(unpackedData != data)
+        if (!_dataReferenced)
         {
-            free(unpackedData);
+            _containerData.clear();
+            CC_SAFE_RELEASE_NULL(_mappedFile);
         }
     } while (0);
 
@@ -583,6 +768,16 @@ bool Image::isWebp(const unsigned char * data, ssize_t dataLen)
     && memcmp(static_cast<const unsigned char*>(data) + 8, WEBP_WEBP, 4) == 0;
 }
 
+bool Image::isKtx(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTX1TexHeader))
+    {
+        return false;
+    }
+
+    return memcmp(data, gKTX1Identifier, sizeof(gKTX1Identifier)) == 0 || memcmp(data, gKTX2Identifier, sizeof(gKTX2Identifier)) == 0;
+}
+
 bool Image::isPvr(const unsigned char * data, ssize_t dataLen)
 {
     if (static_cast<size_t>(dataLen) < sizeof(PVRv2TexHeader) || static_cast<size_t>(dataLen) < sizeof(PVRv3TexHeader))
@@ -622,6 +817,10 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::ETC;
     }
+    else if (isKtx(data, dataLen))
+    {
+        return Format::KTX;
+    }
     else
     {
         return Format::UNKNOWN;
@@ -922,12 +1121,31 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
         {
             row_pointers[i] = _data + i*rowbytes;
         }
-        png_read_image(png_ptr, row_pointers);
+        bool premultiply = _premultiplyAlphaOnDecode && color_type == PNG_COLOR_TYPE_RGB_ALPHA;
+        if (premultiply && png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE)
+        {
+            // premultiply each row right after it is decoded, while it is still in cache
+            for (int i = 0; i < _height; ++i)
+            {
+                png_read_row(png_ptr, row_pointers[i], nullptr);
+                premultiplyRows(i, 1);
+            }
+        }
+        else
+        {
+            png_read_image(png_ptr, row_pointers);
+            if (premultiply)
+                premultiplyRows(0, _height);
+        }
 
         png_read_end(png_ptr, nullptr);
 
+        if (premultiply)
+        {
+            _hasPremultipliedAlpha = true;
+        }
         // premultiplied alpha for RGBA8888
-        if (PNG_PREMULTIPLIED_ALPHA_ENABLED && color_type == PNG_COLOR_TYPE_RGB_ALPHA)
+        else if (PNG_PREMULTIPLIED_ALPHA_ENABLED && color_type == PNG_COLOR_TYPE_RGB_ALPHA)
         {
             //premultipliedAlpha();
         }
@@ -1145,29 +1363,26 @@ namespace
 
     bool testFormatForPvr3TCSupport(PVR3TexturePixelFormat format)
     {
-        // switch (format) {
-        //     case PVR3TexturePixelFormat::BGRA8888:
-        //         return Configuration::getInstance()->supportsBGRA8888();
-
-        //     case PVR3TexturePixelFormat::PVRTC2BPP_RGB:
-        //     case PVR3TexturePixelFormat::PVRTC2BPP_RGBA:
-        //     case PVR3TexturePixelFormat::PVRTC4BPP_RGB:
-        //     case PVR3TexturePixelFormat::PVRTC4BPP_RGBA:
-        //     case PVR3TexturePixelFormat::ETC1:
-        //     case PVR3TexturePixelFormat::RGBA8888:
-        //     case PVR3TexturePixelFormat::RGBA4444:
-        //     case PVR3TexturePixelFormat::RGBA5551:
-        //     case PVR3TexturePixelFormat::RGB565:
-        //     case PVR3TexturePixelFormat::RGB888:
-        //     case PVR3TexturePixelFormat::A8:
-        //     case PVR3TexturePixelFormat::L8:
-        //     case PVR3TexturePixelFormat::LA88:
-        //         return true;
-
-        //     default:
-        //         return false;
-        // }
-        return false;
+        switch (format) {
+            case PVR3TexturePixelFormat::BGRA8888:
+            case PVR3TexturePixelFormat::PVRTC2BPP_RGB:
+            case PVR3TexturePixelFormat::PVRTC2BPP_RGBA:
+            case PVR3TexturePixelFormat::PVRTC4BPP_RGB:
+            case PVR3TexturePixelFormat::PVRTC4BPP_RGBA:
+            case PVR3TexturePixelFormat::ETC1:
+            case PVR3TexturePixelFormat::RGBA8888:
+            case PVR3TexturePixelFormat::RGBA4444:
+            case PVR3TexturePixelFormat::RGBA5551:
+            case PVR3TexturePixelFormat::RGB565:
+            case PVR3TexturePixelFormat::RGB888:
+            case PVR3TexturePixelFormat::A8:
+            case PVR3TexturePixelFormat::L8:
+            case PVR3TexturePixelFormat::LA88:
+                return true;
+
+            default:
+                return false;
+        }
     }
 }
 
@@ -1177,6 +1392,11 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
     int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
     int width = 0, height = 0;
 
+    if (static_cast<size_t>(dataLen) < sizeof(PVRv2TexHeader))
+    {
+        return false;
+    }
+
     //Cast first sizeof(PVRTexHeader) bytes of data stream as PVRTexHeader
     const PVRv2TexHeader *header = static_cast<const PVRv2TexHeader *>(static_cast<const void*>(data));
 
@@ -1186,8 +1406,6 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
         return false;
     }
 
-    // Configuration *configuration = Configuration::getInstance();
-
     //can not detect the premultiplied alpha from pvr file, use _PVRHaveAlphaPremultiplied instead.
     _hasPremultipliedAlpha = _PVRHaveAlphaPremultiplied;
 
@@ -1199,14 +1417,6 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
         CCLOG("cocos2d: WARNING: Image is flipped. Regenerate it using PVRTexTool");
     }
 
-    // if (! configuration->supportsNPOT() &&
-    //     (static_cast<int>(header->width) != ccNextPOT(header->width)
-    //         || static_cast<int>(header->height) != ccNextPOT(header->height)))
-    // {
-    //     CCLOG("cocos2d: ERROR: Loading an NPOT texture (%dx%d) but is not supported on this device", header->width, header->height);
-    //     return false;
-    // }
-
     if (!testFormatForPvr2TCSupport(formatFlags))
     {
         CCLOG("cocos2d: WARNING: Unsupported PVR Pixel Format: 0x%02X. Re-encode it with a OpenGL pixel format variant", (int)formatFlags);
@@ -1219,16 +1429,16 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
         return false;
     }
 
-    auto it = getPixelFormatInfoMap().find(getDevicePixelFormat(v2_pixel_formathash.at(formatFlags)));
+    PixelFormat format = v2_pixel_formathash.at(formatFlags);
+    auto it = getPixelFormatInfoMap().find(format);
 
-    if (it == getPixelFormatInfoMap().end())
+    if (it == getPixelFormatInfoMap().end() && !hasSoftwareDecoder(format))
     {
         CCLOG("cocos2d: WARNING: Unsupported PVR Pixel Format: 0x%02X. Re-encode it with a OpenGL pixel format variant", (int)formatFlags);
         return false;
     }
 
-    _renderFormat = it->first;
-    int bpp = it->second.bpp;
+    int bpp = it != getPixelFormatInfoMap().end() ? it->second.bpp : getCompressedBitsPerPixel(format);
 
     //Reset num of mipmaps
     _numberOfMipmaps = 0;
@@ -1240,49 +1450,29 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
     //Get ptr to where data starts..
     dataLength = CC_SWAP_INT32_LITTLE_TO_HOST(header->dataLength);
 
-    //Move by size of header
-    _dataLen = dataLen - sizeof(PVRv2TexHeader);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, (unsigned char*)data + sizeof(PVRv2TexHeader), _dataLen);
+    //Move by size of header, the mipmaps point into the payload until setCompressedMipmaps() takes them
+    const unsigned char* payload = data + sizeof(PVRv2TexHeader);
+    ssize_t payloadLen = dataLen - sizeof(PVRv2TexHeader);
+    if (dataLength > payloadLen)
+    {
+        CCLOG("cocos2d: WARNING: PVR file is truncated");
+        return false;
+    }
 
     // Calculate the data size for each texture level and respect the minimum number of blocks
-    while (dataOffset < dataLength)
+    while (dataOffset < dataLength && _numberOfMipmaps < MIPMAP_MAX)
     {
         switch (formatFlags) {
             case PVR2TexturePixelFormat::PVRTC2BPP_RGBA:
-                // if (!Configuration::getInstance()->supportsPVRTC())
-                // {
-                //     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
-                //     _unpack = true;
-                //     _mipmaps[_numberOfMipmaps].len = width*height*4;
-                //     _mipmaps[_numberOfMipmaps].address = new (std::nothrow) unsigned char[width*height*4];
-                //     PVRTDecompressPVRTC(_data+dataOffset,width,height,_mipmaps[_numberOfMipmaps].address, true);
-                //     bpp = 2;
-                // }
-                // blockSize = 8 * 4; // Pixel by pixel block size for 2bpp
-                // widthBlocks = width / 8;
-                // heightBlocks = height / 4;
+                blockSize = 8 * 4; // Pixel by pixel block size for 2bpp
+                widthBlocks = width / 8;
+                heightBlocks = height / 4;
                 break;
             case PVR2TexturePixelFormat::PVRTC4BPP_RGBA:
-                // if (!Configuration::getInstance()->supportsPVRTC())
-                // {
-                //     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
-                //     _unpack = true;
-                //     _mipmaps[_numberOfMipmaps].len = width*height*4;
-                //     _mipmaps[_numberOfMipmaps].address = new (std::nothrow) unsigned char[width*height*4];
-                //     PVRTDecompressPVRTC(_data+dataOffset,width,height,_mipmaps[_numberOfMipmaps].address, false);
-                //     bpp = 4;
-                // }
-                // blockSize = 4 * 4; // Pixel by pixel block size for 4bpp
-                // widthBlocks = width / 4;
-                // heightBlocks = height / 4;
+                blockSize = 4 * 4; // Pixel by pixel block size for 4bpp
+                widthBlocks = width / 4;
+                heightBlocks = height / 4;
                 break;
-            case PVR2TexturePixelFormat::BGRA8888:
-                // if (Configuration::getInstance()->supportsBGRA8888() == false)
-                // {
-                //     CCLOG("cocos2d: Image. BGRA8888 not supported on this device");
-                //     return false;
-                // }
             default:
                 blockSize = 1;
                 widthBlocks = width;
@@ -1305,11 +1495,8 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
         packetLength = packetLength > dataSize ? dataSize : packetLength;
 
         //Make record to the mipmaps array and increment counter
-        if(!_unpack)
-        {
-            _mipmaps[_numberOfMipmaps].address = _data + dataOffset;
-            _mipmaps[_numberOfMipmaps].len = packetLength;
-        }
+        _mipmaps[_numberOfMipmaps].address = const_cast<unsigned char*>(payload) + dataOffset;
+        _mipmaps[_numberOfMipmaps].len = packetLength;
         _numberOfMipmaps++;
 
         dataOffset += packetLength;
@@ -1319,13 +1506,7 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
         height = MAX(height >> 1, 1);
     }
 
-    if(_unpack)
-    {
-        _data = _mipmaps[0].address;
-        _dataLen = _mipmaps[0].len;
-    }
-
-    return true;
+    return setCompressedMipmaps(format, payload, payloadLen);
 }
 
 bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
@@ -1362,17 +1543,17 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
         return false;
     }
 
-    auto it = getPixelFormatInfoMap().find(getDevicePixelFormat(v3_pixel_formathash.at(pixelFormat)));
+    PixelFormat format = v3_pixel_formathash.at(pixelFormat);
+    auto it = getPixelFormatInfoMap().find(format);
 
-    if (it == getPixelFormatInfoMap().end())
+    if (it == getPixelFormatInfoMap().end() && !hasSoftwareDecoder(format))
     {
         CCLOG("cocos2d: WARNING: Unsupported PVR Pixel Format: 0x%016llX. Re-encode it with a OpenGL pixel format variant",
               static_cast<unsigned long long>(pixelFormat));
         return false;
     }
 
-    _renderFormat = it->first;
-    int bpp = it->second.bpp;
+    int bpp = it != getPixelFormatInfoMap().end() ? it->second.bpp : getCompressedBitsPerPixel(format);
 
     // flags
     int flags = CC_SWAP_INT32_LITTLE_TO_HOST(header->flags);
@@ -1395,12 +1576,22 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
     int dataOffset = 0, dataSize = 0;
     int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
 
-    _dataLen = dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
+    // the mipmaps point into the payload until setCompressedMipmaps() takes them
+    ssize_t headerLen = sizeof(PVRv3TexHeader) + CC_SWAP_INT32_LITTLE_TO_HOST(header->metadataLength);
+    if (dataLen < headerLen)
+    {
+        return false;
+    }
+    const unsigned char* payload = data + headerLen;
+    ssize_t payloadLen = dataLen - headerLen;
 
-    _numberOfMipmaps = header->numberOfMipmaps;
-    CCASSERT(_numberOfMipmaps < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increase the CC_MIPMAP_MAX value");
+    _numberOfMipmaps = CC_SWAP_INT32_LITTLE_TO_HOST(header->numberOfMipmaps);
+    if (_numberOfMipmaps > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: Image: Maximum number of mimpaps reached. Increase the CC_MIPMAP_MAX value");
+        _numberOfMipmaps = 0;
+        return false;
+    }
 
     for (int i = 0; i < _numberOfMipmaps; i++)
     {
@@ -1408,58 +1599,17 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
         {
             case PVR3TexturePixelFormat::PVRTC2BPP_RGB :
             case PVR3TexturePixelFormat::PVRTC2BPP_RGBA :
-                // if (!Configuration::getInstance()->supportsPVRTC())
-                // {
-                //     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
-                //     _unpack = true;
-                //     _mipmaps[i].len = width*height*4;
-                //     _mipmaps[i].address = new (std::nothrow) unsigned char[width*height*4];
-                //     PVRTDecompressPVRTC(_data+dataOffset,width,height,_mipmaps[i].address, true);
-                //     bpp = 2;
-                // }
                 blockSize = 8 * 4; // Pixel by pixel block size for 2bpp
                 widthBlocks = width / 8;
                 heightBlocks = height / 4;
                 break;
             case PVR3TexturePixelFormat::PVRTC4BPP_RGB :
             case PVR3TexturePixelFormat::PVRTC4BPP_RGBA :
-                // if (!Configuration::getInstance()->supportsPVRTC())
-                // {
-                //     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
-                //     _unpack = true;
-                //     _mipmaps[i].len = width*height*4;
-                //     _mipmaps[i].address = new (std::nothrow) unsigned char[width*height*4];
-                //     PVRTDecompressPVRTC(_data+dataOffset,width,height,_mipmaps[i].address, false);
-                //     bpp = 4;
-                // }
-                blockSize = 4 * 4; // Pixel by pixel block size for 4bpp
-                widthBlocks = width / 4;
-                heightBlocks = height / 4;
-                break;
             case PVR3TexturePixelFormat::ETC1:
-                // if (!Configuration::getInstance()->supportsETC())
-                // {
-                //     CCLOG("cocos2d: Hardware ETC1 decoder not present. Using software decoder");
-                //     int bytePerPixel = 3;
-                //     unsigned int stride = width * bytePerPixel;
-                //     _unpack = true;
-                //     _mipmaps[i].len = width*height*bytePerPixel;
-                //     _mipmaps[i].address = new (std::nothrow) unsigned char[width*height*bytePerPixel];
-                //     if (etc1_decode_image(static_cast<const unsigned char*>(_data+dataOffset), static_cast<etc1_byte*>(_mipmaps[i].address), width, height, bytePerPixel, stride) != 0)
-                //     {
-                //         return false;
-                //     }
-                // }
                 blockSize = 4 * 4; // Pixel by pixel block size for 4bpp
                 widthBlocks = width / 4;
                 heightBlocks = height / 4;
                 break;
-            case PVR3TexturePixelFormat::BGRA8888:
-                // if (! Configuration::getInstance()->supportsBGRA8888())
-                // {
-                //     CCLOG("cocos2d: Image. BGRA8888 not supported on this device");
-                //     return false;
-                // }
             default:
                 blockSize = 1;
                 widthBlocks = width;
@@ -1478,30 +1628,21 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
         }
 
         dataSize = widthBlocks * heightBlocks * ((blockSize  * bpp) / 8);
-        auto packetLength = _dataLen - dataOffset;
+        auto packetLength = payloadLen - dataOffset;
         packetLength = packetLength > dataSize ? dataSize : packetLength;
 
-        if(!_unpack)
-        {
-            _mipmaps[i].address = _data + dataOffset;
-            _mipmaps[i].len = static_cast<int>(packetLength);
-        }
+        _mipmaps[i].address = const_cast<unsigned char*>(payload) + dataOffset;
+        _mipmaps[i].len = static_cast<int>(packetLength);
 
         dataOffset += packetLength;
-        CCASSERT(dataOffset <= _dataLen, "Image: Invalid length");
-        
-        
+        CCASSERT(dataOffset <= payloadLen, "Image: Invalid length");
+
+
         width = MAX(width >> 1, 1);
         height = MAX(height >> 1, 1);
     }
 
-    if (_unpack)
-    {
-        _data = _mipmaps[0].address;
-        _dataLen = _mipmaps[0].len;
-    }
-
-    return true;
+    return setCompressedMipmaps(format, payload, payloadLen);
 }
 
 bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
@@ -1509,7 +1650,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
     const etc1_byte* header = static_cast<const etc1_byte*>(data);
 
     //check the data
-    if (! etc1_pkm_is_valid(header))
+    if (dataLen < ETC_PKM_HEADER_SIZE || ! etc1_pkm_is_valid(header))
     {
         return  false;
     }
@@ -1522,43 +1663,309 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         return false;
     }
 
-    // if (Configuration::getInstance()->supportsETC())
-    if (false)
+    const unsigned char* payload = data + ETC_PKM_HEADER_SIZE;
+    ssize_t payloadLen = dataLen - ETC_PKM_HEADER_SIZE;
+    if (payloadLen < static_cast<ssize_t>(etc1_get_encoded_data_size(_width, _height)))
     {
-        //old opengl version has no define for GL_ETC1_RGB8_OES, add macro to make compiler happy.
-#ifdef GL_ETC1_RGB8_OES
-        _renderFormat = Image::PixelFormat::ETC;
-        _dataLen = dataLen - ETC_PKM_HEADER_SIZE;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy(_data, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
-        return true;
-#endif
+        CCLOG("cocos2d: WARNING: ETC file is truncated");
+        return false;
     }
-    else
+
+    _numberOfMipmaps = 1;
+    _mipmaps[0].address = const_cast<unsigned char*>(payload);
+    _mipmaps[0].len = static_cast<int>(payloadLen);
+
+    return setCompressedMipmaps(Image::PixelFormat::ETC, payload, payloadLen);
+}
+
+bool Image::initWithKTXData(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTX1TexHeader))
     {
-        CCLOG("cocos2d: Hardware ETC1 decoder not present. Using software decoder");
+        return false;
+    }
 
-         //if it is not gles or device do not support ETC, decode texture by software
-        int bytePerPixel = 3;
-        unsigned int stride = _width * bytePerPixel;
-        _renderFormat = Image::PixelFormat::RGB888;
+    KTX1TexHeader header;
+    memcpy(&header, data, sizeof(header));
 
-        _dataLen =  _width * _height * bytePerPixel;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+    if (KTX_ENDIANNESS != header.endianness && KTX_ENDIANNESS_SWAPPED != header.endianness)
+    {
+        CCLOG("cocos2d: WARNING: invalid KTX endianness");
+        return false;
+    }
+    bool swapped = KTX_ENDIANNESS_SWAPPED == header.endianness;
+    if (swapped && swapKTX1Value(header.glTypeSize, swapped) > 1)
+    {
+        CCLOG("cocos2d: WARNING: KTX files with a foreign byte order are only supported for byte sized formats");
+        return false;
+    }
+
+    uint32_t depth = swapKTX1Value(header.pixelDepth, swapped);
+    uint32_t arrayElements = swapKTX1Value(header.numberOfArrayElements, swapped);
+    uint32_t faces = swapKTX1Value(header.numberOfFaces, swapped);
+    if (depth > 1 || arrayElements > 0 || faces != 1)
+    {
+        CCLOG("cocos2d: WARNING: only 2D KTX textures are supported");
+        return false;
+    }
+
+    PixelFormat format = getKTX1PixelFormat(swapKTX1Value(header.glInternalFormat, swapped),
+                                            swapKTX1Value(header.glFormat, swapped),
+                                            swapKTX1Value(header.glType, swapped));
+    if (PixelFormat::NONE == format
+        || (getPixelFormatInfoMap().find(format) == getPixelFormatInfoMap().end() && !hasSoftwareDecoder(format)))
+    {
+        CCLOG("cocos2d: WARNING: Unsupported KTX internal format: 0x%04X", swapKTX1Value(header.glInternalFormat, swapped));
+        return false;
+    }
+
+    _width = swapKTX1Value(header.pixelWidth, swapped);
+    _height = MAX(swapKTX1Value(header.pixelHeight, swapped), 1u);
+    _hasPremultipliedAlpha = false;
+
+    _numberOfMipmaps = MAX(swapKTX1Value(header.numberOfMipmapLevels, swapped), 1u);
+    if (_numberOfMipmaps > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: Image: Maximum number of mimpaps reached. Increase the CC_MIPMAP_MAX value");
+        _numberOfMipmaps = 0;
+        return false;
+    }
+
+    // every level is an imageSize followed by the image, padded to 4 bytes
+    ssize_t offset = sizeof(KTX1TexHeader) + swapKTX1Value(header.bytesOfKeyValueData, swapped);
+    const unsigned char* payload = data + offset + sizeof(uint32_t);
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        uint32_t imageSize = 0;
+        if (offset + static_cast<ssize_t>(sizeof(imageSize)) > dataLen)
+        {
+            break;
+        }
+        memcpy(&imageSize, data + offset, sizeof(imageSize));
+        imageSize = swapKTX1Value(imageSize, swapped);
+        offset += sizeof(imageSize);
 
-        if (etc1_decode_image(static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, static_cast<etc1_byte*>(_data), _width, _height, bytePerPixel, stride) != 0)
+        if (offset + static_cast<ssize_t>(imageSize) > dataLen)
         {
-            _dataLen = 0;
-            if (_data != nullptr)
+            break;
+        }
+        _mipmaps[i].address = const_cast<unsigned char*>(data) + offset;
+        _mipmaps[i].len = static_cast<int>(imageSize);
+        offset += (imageSize + 3) & ~3u;
+    }
+
+    if (nullptr == _mipmaps[_numberOfMipmaps - 1].address)
+    {
+        CCLOG("cocos2d: WARNING: KTX file is truncated");
+        _numberOfMipmaps = 0;
+        return false;
+    }
+
+    ssize_t payloadLen = MIN(offset, dataLen) - (payload - data);
+
+    // rows of uncompressed levels are padded to 4 bytes (GL_UNPACK_ALIGNMENT 4) while the
+    // levels of an Image are tightly packed, copy the rows without their padding
+    auto info = getPixelFormatInfoMap().find(format);
+    bool padded = false;
+    ssize_t packedLen = 0;
+    if (info != getPixelFormatInfoMap().end() && !info->second.compressed)
+    {
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+        {
+            int rowLen = MAX(_width >> i, 1) * info->second.bpp / 8;
+            padded = padded || 0 != rowLen % 4;
+            packedLen += static_cast<ssize_t>(rowLen) * MAX(_height >> i, 1);
+        }
+    }
+
+    if (padded)
+    {
+        Data packed;
+        packed.fastSet(static_cast<unsigned char*>(malloc(packedLen)), packedLen);
+        unsigned char* dest = packed.getBytes();
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+        {
+            int rowLen = MAX(_width >> i, 1) * info->second.bpp / 8;
+            int paddedRowLen = (rowLen + 3) & ~3;
+            int height = MAX(_height >> i, 1);
+            if (_mipmaps[i].len < paddedRowLen * (height - 1) + rowLen)
             {
-                free(_data);
+                CCLOG("cocos2d: WARNING: KTX file is truncated");
+                _numberOfMipmaps = 0;
+                return false;
             }
+
+            for (int row = 0; row < height; ++row)
+            {
+                memcpy(dest + row * rowLen, _mipmaps[i].address + row * paddedRowLen, rowLen);
+            }
+            _mipmaps[i].address = dest;
+            _mipmaps[i].len = rowLen * height;
+            dest += _mipmaps[i].len;
+        }
+
+        // the container is no longer needed, the image references the packed levels instead
+        CC_SAFE_RELEASE_NULL(_mappedFile);
+        _containerData = std::move(packed);
+        payload = _containerData.getBytes();
+        payloadLen = _containerData.getSize();
+    }
+
+    if (!setCompressedMipmaps(format, payload, payloadLen))
+    {
+        return false;
+    }
+
+    // levels are separated by their sizes, expose the first one as the image data
+    _data = _mipmaps[0].address;
+    _dataLen = _mipmaps[0].len;
+    return true;
+}
+
+bool Image::initWithKTX2Data(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTX2TexHeader))
+    {
+        return false;
+    }
+
+    KTX2TexHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if (0 != header.supercompressionScheme)
+    {
+        CCLOG("cocos2d: WARNING: supercompressed KTX2 files are not supported");
+        return false;
+    }
+    if (header.pixelDepth > 1 || header.layerCount > 0 || header.faceCount != 1)
+    {
+        CCLOG("cocos2d: WARNING: only 2D KTX2 textures are supported");
+        return false;
+    }
+
+    PixelFormat format = getKTX2PixelFormat(header.vkFormat);
+    if (PixelFormat::NONE == format
+        || (getPixelFormatInfoMap().find(format) == getPixelFormatInfoMap().end() && !hasSoftwareDecoder(format)))
+    {
+        CCLOG("cocos2d: WARNING: Unsupported KTX2 vkFormat: %u", header.vkFormat);
+        return false;
+    }
+
+    _width = header.pixelWidth;
+    _height = MAX(header.pixelHeight, 1u);
+    _hasPremultipliedAlpha = false;
+
+    _numberOfMipmaps = MAX(header.levelCount, 1u);
+    if (_numberOfMipmaps > MIPMAP_MAX
+        || static_cast<ssize_t>(sizeof(KTX2TexHeader) + _numberOfMipmaps * sizeof(KTX2LevelIndex)) > dataLen)
+    {
+        CCLOG("cocos2d: WARNING: invalid number of KTX2 levels");
+        _numberOfMipmaps = 0;
+        return false;
+    }
+
+    // the level index starts with the largest level, but the levels are stored from the smallest one
+    uint64_t payloadBegin = dataLen;
+    uint64_t payloadEnd = 0;
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        KTX2LevelIndex level;
+        memcpy(&level, data + sizeof(KTX2TexHeader) + i * sizeof(KTX2LevelIndex), sizeof(level));
+        if (level.byteOffset + level.byteLength > static_cast<uint64_t>(dataLen))
+        {
+            CCLOG("cocos2d: WARNING: KTX2 file is truncated");
+            _numberOfMipmaps = 0;
+            return false;
+        }
+
+        _mipmaps[i].address = const_cast<unsigned char*>(data) + level.byteOffset;
+        _mipmaps[i].len = static_cast<int>(level.byteLength);
+        payloadBegin = MIN(payloadBegin, level.byteOffset);
+        payloadEnd = MAX(payloadEnd, level.byteOffset + level.byteLength);
+    }
+
+    if (!setCompressedMipmaps(format, data + payloadBegin, static_cast<ssize_t>(payloadEnd - payloadBegin)))
+    {
+        return false;
+    }
+
+    _data = _mipmaps[0].address;
+    _dataLen = _mipmaps[0].len;
+    return true;
+}
+
+bool Image::setCompressedMipmaps(PixelFormat format, const unsigned char* payload, ssize_t payloadLen)
+{
+    if (!hasSoftwareDecoder(format) || isCompressedFormatSupported(format))
+    {
+        _renderFormat = format;
+        _data = referenceContainerData(payload, payloadLen);
+        if (nullptr == _data)
+        {
+            _numberOfMipmaps = 0;
             return false;
         }
+        _dataLen = payloadLen;
 
+        for (int i = 0; i < _numberOfMipmaps; ++i)
+        {
+            _mipmaps[i].address = _data + (_mipmaps[i].address - payload);
+        }
         return true;
     }
-    return false;
+
+    CCLOG("cocos2d: Hardware decoder for the compressed format not present. Using software decoder");
+
+    bool isETC = Image::PixelFormat::ETC == format;
+    int bytesPerPixel = isETC ? 3 : 4;
+    _renderFormat = isETC ? Image::PixelFormat::RGB888 : Image::PixelFormat::RGBA8888;
+    _unpack = true;
+
+    int numberOfMipmaps = _numberOfMipmaps;
+    for (int i = 0; i < numberOfMipmaps; ++i)
+    {
+        int width = MAX(_width >> i, 1);
+        int height = MAX(_height >> i, 1);
+        int len = width * height * bytesPerPixel;
+        unsigned char* decoded = new (std::nothrow) unsigned char[len];
+
+        if (nullptr == decoded || !decodeCompressedMipmap(format, _mipmaps[i].address, decoded, width, height, _maxDecodeThreads))
+        {
+            CC_SAFE_DELETE_ARRAY(decoded);
+            // only the levels decoded so far are owned by the image
+            _numberOfMipmaps = i;
+            return false;
+        }
+
+        _mipmaps[i].address = decoded;
+        _mipmaps[i].len = len;
+    }
+
+    _data = _mipmaps[0].address;
+    _dataLen = _mipmaps[0].len;
+    return true;
+}
+
+unsigned char* Image::referenceContainerData(const unsigned char* data, ssize_t dataLen)
+{
+    if (_mappedFile && _mappedFile->contains(data, dataLen))
+    {
+        _dataReferenced = true;
+        return const_cast<unsigned char*>(data);
+    }
+
+    const unsigned char* begin = _containerData.getBytes();
+    if (begin && data >= begin && data + dataLen <= begin + _containerData.getSize())
+    {
+        _dataReferenced = true;
+        return const_cast<unsigned char*>(data);
+    }
+
+    // the bytes belong to the caller, keep a copy of the payload only
+    _containerData.copy(data, dataLen);
+    CC_SAFE_RELEASE_NULL(_mappedFile);
+    _dataReferenced = !_containerData.isNull();
+    return _containerData.getBytes();
 }
 
 bool Image::initWithTGAData(tImageTGA* tgaData)
@@ -1988,12 +2395,7 @@ void Image::premultipliedAlpha()
 {
     if (PNG_PREMULTIPLIED_ALPHA_ENABLED && _renderFormat == Image::PixelFormat::RGBA8888)
     {
-        unsigned int* fourBytes = (unsigned int*)_data;
-        for(int i = 0; i < _width * _height; i++)
-        {
-            unsigned char* p = _data + i * 4;
-            fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-        }
+        premultiplyRows(0, _height);
 
         _hasPremultipliedAlpha = true;
     }
@@ -2005,10 +2407,39 @@ void Image::premultipliedAlpha()
 }
 
 
+void Image::premultiplyRows(int row, int rows)
+{
+    unsigned char* p = _data + (size_t)row * _width * 4;
+    unsigned char* end = p + (size_t)rows * _width * 4;
+
+    // same result as CC_RGB_PREMULTIPLY_ALPHA, but written per component so that compilers can vectorize it
+    for (; p < end; p += 4)
+    {
+        unsigned int alpha = p[3] + 1;
+        p[0] = (unsigned char)((p[0] * alpha) >> 8);
+        p[1] = (unsigned char)((p[1] * alpha) >> 8);
+        p[2] = (unsigned char)((p[2] * alpha) >> 8);
+    }
+}
+
 void Image::setPVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied)
 {
     _PVRHaveAlphaPremultiplied = haveAlphaPremultiplied;
 }
 
+void Image::setCompressedFormatSupported(PixelFormat format, bool supported)
+{
+    uint32_t bit = 1u << static_cast<int>(format);
+    if (supported)
+        s_compressedFormatSupport |= bit;
+    else
+        s_compressedFormatSupport &= ~bit;
+}
+
+bool Image::isCompressedFormatSupported(PixelFormat format)
+{
+    return (s_compressedFormatSupport & (1u << static_cast<int>(format))) != 0;
+}
+
 NS_CC_END
 
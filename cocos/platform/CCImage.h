@@ -28,6 +28,8 @@ THE SOFTWARE.
 /// @cond DO_NOT_SHOW
 
 #include "base/CCRef.h"
+#include "base/CCData.h"
+#include "base/CCMappedFile.h"
 #include "platform/CCGL.h"
 
 #include <string>
@@ -89,6 +91,8 @@ public:
         TGA,
         //! Raw Data
         RAW_DATA,
+        //! KTX 1.1 and KTX 2.0 containers
+        KTX,
         //! Unknown format
         UNKNOWN
     };
@@ -182,6 +186,14 @@ public:
      */
     static void setPVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied);
 
+    /** Tells whether the GPU can sample a compressed pixel format. PVRTC and ETC images in a format the GPU
+     can't sample are decoded by software into RGBA8888 and RGB888 when they are loaded.
+
+     By default every format but ETC is assumed to be supported, the renderer updates it from the GL extensions.
+     */
+    static void setCompressedFormatSupported(PixelFormat format, bool supported);
+    static bool isCompressedFormatSupported(PixelFormat format);
+
     /**
     @brief Load the image from the specified path.
     @param path   the absolute file path.
@@ -199,6 +211,18 @@ public:
     */
     bool initWithImageData(const unsigned char * data, ssize_t dataLen);
 
+    /**
+     @brief Premultiply RGBA8888 PNG pixels while decoding, each row is premultiplied right after it is
+     decoded while it is still in cache. Takes effect for the next init call, disabled by default.
+     */
+    inline void setPremultiplyAlphaOnDecode(bool enabled) { _premultiplyAlphaOnDecode = enabled; }
+
+    /**
+     @brief Maximum number of threads used to decode ETC and PVRTC levels on devices without support for them,
+     0 for all hardware threads, which is the default. Takes effect for the next init call.
+     */
+    inline void setMaxDecodeThreads(int maxThreads) { _maxDecodeThreads = maxThreads; }
+
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, ssize_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
@@ -234,6 +258,8 @@ protected:
     bool initWithPVRv2Data(const unsigned char * data, ssize_t dataLen);
     bool initWithPVRv3Data(const unsigned char * data, ssize_t dataLen);
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTX2Data(const unsigned char * data, ssize_t dataLen);
 
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
@@ -241,7 +267,14 @@ protected:
     bool saveImageToPNG(const std::string& filePath, bool isToRGB = true);
     bool saveImageToJPG(const std::string& filePath);
 
+    // Takes the mipmaps of a compressed payload, which address `payload`, either in place or decoded by software.
+    bool setCompressedMipmaps(PixelFormat format, const unsigned char* payload, ssize_t payloadLen);
+    // Returns `data` itself when it lives in _mappedFile or _containerData, otherwise copies it into _containerData.
+    unsigned char* referenceContainerData(const unsigned char* data, ssize_t dataLen);
+
     void premultipliedAlpha();
+    // Premultiply `rows` RGBA8888 rows starting from `row`.
+    void premultiplyRows(int row, int rows);
 
 protected:
     /**
@@ -264,6 +297,13 @@ protected:
     int _numberOfMipmaps;
     // false if we can't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
+    bool _premultiplyAlphaOnDecode;
+    int _maxDecodeThreads;
+    // true if _data points into _mappedFile or _containerData, which is then kept alive instead of copying the payload
+    bool _dataReferenced;
+    Data _containerData;
+    // the file given to initWithImageFile(), parsed in place
+    MappedFile* _mappedFile;
     std::string _filePath;
 
 protected:
@@ -288,6 +328,7 @@ protected:
     bool isWebp(const unsigned char * data, ssize_t dataLen);
     bool isPvr(const unsigned char * data, ssize_t dataLen);
     bool isEtc(const unsigned char * data, ssize_t dataLen);
+    bool isKtx(const unsigned char * data, ssize_t dataLen);
 };
 
 // end of platform group
@@ -0,0 +1,215 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCImageDecoder.h"
+#include "platform/CCImage.h"
+#include "platform/CCFileUtils.h"
+
+#include <algorithm>
+
+NS_CC_BEGIN
+
+ImageDecoder* ImageDecoder::s_sharedImageDecoder = nullptr;
+
+ImageDecoder* ImageDecoder::getInstance()
+{
+    if (!s_sharedImageDecoder)
+    {
+        // leave one core for the render thread
+        unsigned int cores = std::thread::hardware_concurrency();
+        unsigned int threadCount = cores > 1 ? cores - 1 : 1;
+        s_sharedImageDecoder = new (std::nothrow) ImageDecoder(std::min(threadCount, 4u));
+    }
+    return s_sharedImageDecoder;
+}
+
+void ImageDecoder::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedImageDecoder);
+}
+
+ImageDecoder::ImageDecoder(unsigned int threadCount)
+{
+    for (unsigned int i = 0; i < threadCount; ++i)
+        _workers.emplace_back(&ImageDecoder::workerLoop, this);
+}
+
+ImageDecoder::~ImageDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _jobsCondition.notify_all();
+
+    for (auto& worker : _workers)
+        worker.join();
+
+    // Callbacks of dropped jobs are not invoked.
+    for (auto job : _jobs)
+        delete job;
+    for (auto job : _completedJobs)
+    {
+        CC_SAFE_RELEASE(job->image);
+        delete job;
+    }
+}
+
+void ImageDecoder::decodeFile(const std::string& path, const Callback& callback, bool premultiplyAlpha)
+{
+    auto job = new (std::nothrow) Job();
+    if (!job)
+        return;
+
+    // FileUtils caches resolved paths, so resolve on the calling thread. Absolute paths are read
+    // on the worker threads without touching the cache.
+    job->path = FileUtils::getInstance()->fullPathForFilename(path);
+    job->callback = callback;
+    job->premultiplyAlpha = premultiplyAlpha;
+    addJob(job);
+}
+
+void ImageDecoder::decodeData(Data&& data, const Callback& callback, bool premultiplyAlpha)
+{
+    auto job = new (std::nothrow) Job();
+    if (!job)
+        return;
+
+    job->data = std::move(data);
+    job->callback = callback;
+    job->premultiplyAlpha = premultiplyAlpha;
+    addJob(job);
+}
+
+void ImageDecoder::addJob(Job* job)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(job);
+        ++_pendingCount;
+    }
+    _jobsCondition.notify_one();
+}
+
+void ImageDecoder::dispatchCompleted()
+{
+    std::vector<Job*> completedJobs;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_completedJobs.empty())
+            return;
+
+        completedJobs.swap(_completedJobs);
+        _pendingCount -= completedJobs.size();
+    }
+
+    // Callbacks are invoked without the lock, so they can queue new jobs.
+    for (auto job : completedJobs)
+    {
+        if (job->callback)
+            job->callback(job->image);
+
+        CC_SAFE_RELEASE(job->image);
+        delete job;
+    }
+}
+
+void ImageDecoder::waitAll()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _completedCondition.wait(lock, [this]() {
+                return _jobs.empty() && _completedJobs.size() == _pendingCount;
+            });
+        }
+
+        dispatchCompleted();
+
+        // Callbacks may have queued more jobs.
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (0 == _pendingCount)
+            break;
+    }
+}
+
+size_t ImageDecoder::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pendingCount;
+}
+
+void ImageDecoder::workerLoop()
+{
+    while (true)
+    {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobsCondition.wait(lock, [this]() { return _quit || !_jobs.empty(); });
+            if (_quit)
+                return;
+
+            job = _jobs.front();
+            _jobs.pop_front();
+        }
+
+        decode(job);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _completedJobs.push_back(job);
+        }
+        _completedCondition.notify_all();
+    }
+}
+
+void ImageDecoder::decode(Job* job)
+{
+    // The image is only used by this thread until it is passed to dispatchCompleted().
+    auto image = new (std::nothrow) Image();
+    if (!image)
+        return;
+
+    image->setPremultiplyAlphaOnDecode(job->premultiplyAlpha);
+    // the workers already keep the cores busy, decode compressed levels on this thread only
+    image->setMaxDecodeThreads(1);
+
+    bool ret = false;
+    if (!job->path.empty())
+        ret = image->initWithImageFile(job->path);
+    else if (!job->data.isNull())
+        ret = image->initWithImageData(job->data.getBytes(), job->data.getSize());
+
+    // The encoded data is not needed anymore.
+    job->data.clear();
+
+    if (ret)
+        job->image = image;
+    else
+        image->release();
+}
+
+NS_CC_END
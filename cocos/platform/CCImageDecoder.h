@@ -0,0 +1,105 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCData.h"
+#include "base/ccMacros.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+NS_CC_BEGIN
+
+class Image;
+
+/**
+ * Decodes images on a pool of worker threads, so that many images can be decoded in parallel and
+ * off the render thread. Decoded images are delivered to the render thread by dispatchCompleted().
+ */
+class CC_DLL ImageDecoder
+{
+public:
+    /**
+     * The decoded image, or nullptr if decoding failed. The image is released after the callback
+     * returns, retain it to keep it.
+     */
+    typedef std::function<void(Image* image)> Callback;
+
+    static ImageDecoder* getInstance();
+    static void destroyInstance();
+
+    /**
+     * Decodes an image file. The path is resolved on the calling thread, the file is read and decoded
+     * on a worker thread. RGBA8888 PNG images are premultiplied while decoding if `premultiplyAlpha` is true.
+     */
+    void decodeFile(const std::string& path, const Callback& callback, bool premultiplyAlpha = false);
+    /** Decodes an image from memory, the data is moved into the job. */
+    void decodeData(Data&& data, const Callback& callback, bool premultiplyAlpha = false);
+
+    /** Invokes the callbacks of finished jobs, should be invoked on the render thread once per frame. */
+    void dispatchCompleted();
+    /** Blocks until all queued jobs are decoded, then invokes their callbacks. */
+    void waitAll();
+
+    /** Number of jobs whose callbacks are not invoked yet. */
+    size_t getPendingCount() const;
+    inline size_t getThreadCount() const { return _workers.size(); }
+
+private:
+    struct Job
+    {
+        std::string path;
+        Data data;
+        bool premultiplyAlpha = false;
+        Callback callback;
+        Image* image = nullptr;
+    };
+
+    explicit ImageDecoder(unsigned int threadCount);
+    ~ImageDecoder();
+
+    void addJob(Job* job);
+    void workerLoop();
+    static void decode(Job* job);
+
+    static ImageDecoder* s_sharedImageDecoder;
+
+    std::vector<std::thread> _workers;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _jobsCondition;
+    std::condition_variable _completedCondition;
+    std::deque<Job*> _jobs;
+    std::vector<Job*> _completedJobs;
+    size_t _pendingCount = 0;
+    bool _quit = false;
+};
+
+NS_CC_END
@@ -0,0 +1,462 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlistParser.h"
+#include "platform/CCXMLPullParser.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+NS_CC_BEGIN
+
+namespace
+{
+    // deeper documents are rejected, it bounds the recursion of both readers
+    const int MAX_DEPTH = 512;
+
+    class XMLPlistReader
+    {
+    public:
+        XMLPlistReader(const char* data, size_t length)
+        : _parser(data, length)
+        {
+        }
+
+        bool read(Value* out)
+        {
+            // the root object, inside <plist> or on its own
+            for (;;)
+            {
+                switch (_parser.next())
+                {
+                    case XMLPullParser::Event::START_ELEMENT:
+                        if (_parser.getName() != "plist")
+                            return readObject(out, 0);
+                        break;
+                    case XMLPullParser::Event::TEXT:
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+    private:
+        // Reads the object whose start element was just returned by the parser.
+        bool readObject(Value* out, int depth)
+        {
+            if (depth > MAX_DEPTH)
+                return false;
+
+            const std::string& name = _parser.getName();
+            if (name == "dict")
+                return readDict(out, depth);
+            if (name == "array")
+                return readArray(out, depth);
+
+            if (name == "string")
+            {
+                std::string text;
+                if (!readText(&text))
+                    return false;
+                *out = Value(std::move(text));
+                return true;
+            }
+            if (name == "integer" || name == "real")
+            {
+                bool integer = name == "integer";
+                if (!readText(&_text))
+                    return false;
+                *out = integer ? Value(atoi(_text.c_str())) : Value(atof(_text.c_str()));
+                return true;
+            }
+            if (name == "true" || name == "false")
+            {
+                *out = Value(name == "true");
+                return skipElement();
+            }
+
+            *out = Value::Null;
+            return skipElement();
+        }
+
+        bool readDict(Value* out, int depth)
+        {
+            ValueMap dict;
+            std::string key;
+            for (;;)
+            {
+                switch (_parser.next())
+                {
+                    case XMLPullParser::Event::START_ELEMENT:
+                        if (_parser.getName() == "key")
+                        {
+                            if (!readText(&key))
+                                return false;
+                        }
+                        else
+                        {
+                            Value value;
+                            if (!readObject(&value, depth + 1))
+                                return false;
+                            if (!value.isNull())
+                                dict[key] = std::move(value);
+                        }
+                        break;
+                    case XMLPullParser::Event::END_ELEMENT:
+                        *out = Value(std::move(dict));
+                        return true;
+                    case XMLPullParser::Event::TEXT:
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+        bool readArray(Value* out, int depth)
+        {
+            ValueVector array;
+            for (;;)
+            {
+                switch (_parser.next())
+                {
+                    case XMLPullParser::Event::START_ELEMENT:
+                    {
+                        Value value;
+                        if (!readObject(&value, depth + 1))
+                            return false;
+                        if (!value.isNull())
+                            array.push_back(std::move(value));
+                        break;
+                    }
+                    case XMLPullParser::Event::END_ELEMENT:
+                        *out = Value(std::move(array));
+                        return true;
+                    case XMLPullParser::Event::TEXT:
+                        break;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+        // Reads the text up to the end of the current element, which has no child elements.
+        bool readText(std::string* out)
+        {
+            out->clear();
+            for (;;)
+            {
+                switch (_parser.next())
+                {
+                    case XMLPullParser::Event::TEXT:
+                        out->append(_parser.getText());
+                        break;
+                    case XMLPullParser::Event::END_ELEMENT:
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+        }
+
+        bool skipElement()
+        {
+            size_t depth = _parser.getDepth();
+            while (_parser.getDepth() >= depth)
+            {
+                auto event = _parser.next();
+                if (XMLPullParser::Event::END_DOCUMENT == event || XMLPullParser::Event::INVALID == event)
+                    return false;
+            }
+            return true;
+        }
+
+        XMLPullParser _parser;
+        std::string _text;
+    };
+
+    class BinaryPlistReader
+    {
+    public:
+        BinaryPlistReader(const unsigned char* data, size_t length)
+        : _data(data)
+        , _length(length)
+        {
+        }
+
+        bool read(Value* out)
+        {
+            // header, objects, offset table, then a 32 byte trailer
+            if (_length < 8 + 32)
+                return false;
+
+            const unsigned char* trailer = _data + _length - 32;
+            _offsetSize = trailer[6];
+            _refSize = trailer[7];
+            _count = readInteger(trailer + 8, 8);
+            uint64_t top = readInteger(trailer + 16, 8);
+            _tableOffset = readInteger(trailer + 24, 8);
+
+            if (_offsetSize < 1 || _offsetSize > 8 || _refSize < 1 || _refSize > 8)
+                return false;
+            if (_tableOffset < 8 || _tableOffset > _length - 32 || _count > (_length - 32 - _tableOffset) / _offsetSize || top >= _count)
+                return false;
+
+            // a shared object is read once per reference, this stops a file with many of them from exploding
+            _budget = _length * 4 + 1024;
+            return readObject(top, 0, out);
+        }
+
+    private:
+        static uint64_t readInteger(const unsigned char* p, size_t size)
+        {
+            uint64_t ret = 0;
+            for (size_t i = 0; i < size; ++i)
+                ret = (ret << 8) | p[i];
+            return ret;
+        }
+
+        inline bool has(const unsigned char* p, uint64_t size) const
+        {
+            return size <= (uint64_t)(_data + _tableOffset - p);
+        }
+
+        // The count of a string, array or dict, in the low nibble or in an integer object after the marker.
+        bool readCount(const unsigned char*& p, uint64_t* count) const
+        {
+            unsigned char info = *p & 0x0F;
+            ++p;
+            if (info != 0x0F)
+            {
+                *count = info;
+                return true;
+            }
+
+            if (!has(p, 1) || (*p & 0xF0) != 0x10 || (*p & 0x0F) > 3)
+                return false;
+            size_t size = (size_t)1 << (*p & 0x0F);
+            if (!has(p + 1, size))
+                return false;
+            *count = readInteger(p + 1, size);
+            p += 1 + size;
+            return true;
+        }
+
+        bool readObject(uint64_t ref, int depth, Value* out)
+        {
+            if (ref >= _count || depth > MAX_DEPTH || 0 == _budget--)
+                return false;
+
+            uint64_t offset = readInteger(_data + _tableOffset + ref * _offsetSize, _offsetSize);
+            if (offset < 8 || offset >= _tableOffset)
+                return false;
+
+            const unsigned char* p = _data + offset;
+            unsigned char marker = *p;
+            unsigned char info = marker & 0x0F;
+            uint64_t count = 0;
+            switch (marker >> 4)
+            {
+                case 0x0:
+                    // null, false, true, fill
+                    if (0x08 == info || 0x09 == info)
+                        *out = Value(0x09 == info);
+                    else
+                        *out = Value::Null;
+                    return true;
+                case 0x1:
+                {
+                    if (info > 4)
+                        return false;
+                    size_t size = (size_t)1 << info;
+                    if (!has(p + 1, size))
+                        return false;
+                    // 16 byte integers only use their low 8 bytes, 8 byte ones are signed
+                    int64_t value = size > 8 ? (int64_t)readInteger(p + 1 + size - 8, 8) : (int64_t)readInteger(p + 1, size);
+                    if (value >= INT_MIN && value <= INT_MAX)
+                        *out = Value((int)value);
+                    else
+                        *out = Value((double)value);
+                    return true;
+                }
+                case 0x2:
+                {
+                    if (2 != info && 3 != info)
+                        return false;
+                    size_t size = (size_t)1 << info;
+                    if (!has(p + 1, size))
+                        return false;
+                    uint64_t bits = readInteger(p + 1, size);
+                    if (4 == size)
+                    {
+                        uint32_t bits32 = (uint32_t)bits;
+                        float value;
+                        memcpy(&value, &bits32, sizeof(value));
+                        *out = Value((double)value);
+                    }
+                    else
+                    {
+                        double value;
+                        memcpy(&value, &bits, sizeof(value));
+                        *out = Value(value);
+                    }
+                    return true;
+                }
+                case 0x5:
+                    if (!readCount(p, &count) || !has(p, count))
+                        return false;
+                    *out = Value(std::string((const char*)p, (size_t)count));
+                    return true;
+                case 0x6:
+                    if (!readCount(p, &count) || count > _length / 2 || !has(p, count * 2))
+                        return false;
+                    *out = Value(readUTF16(p, (size_t)count));
+                    return true;
+                case 0x3:
+                case 0x4:
+                case 0x8:
+                    // date, data and UID
+                    *out = Value::Null;
+                    return true;
+                case 0xA:
+                {
+                    if (!readCount(p, &count) || count > _length / _refSize || !has(p, count * _refSize))
+                        return false;
+                    ValueVector array;
+                    array.reserve((size_t)count);
+                    for (uint64_t i = 0; i < count; ++i)
+                    {
+                        Value value;
+                        if (!readObject(readInteger(p + i * _refSize, _refSize), depth + 1, &value))
+                            return false;
+                        if (!value.isNull())
+                            array.push_back(std::move(value));
+                    }
+                    *out = Value(std::move(array));
+                    return true;
+                }
+                case 0xD:
+                {
+                    if (!readCount(p, &count) || count > _length / _refSize || !has(p, count * 2 * _refSize))
+                        return false;
+                    ValueMap dict;
+                    dict.reserve((size_t)count);
+                    for (uint64_t i = 0; i < count; ++i)
+                    {
+                        Value key;
+                        Value value;
+                        if (!readObject(readInteger(p + i * _refSize, _refSize), depth + 1, &key) ||
+                            Value::Type::STRING != key.getType() ||
+                            !readObject(readInteger(p + (count + i) * _refSize, _refSize), depth + 1, &value))
+                            return false;
+                        if (!value.isNull())
+                            dict[key.asString()] = std::move(value);
+                    }
+                    *out = Value(std::move(dict));
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        // Converts big endian UTF-16 to UTF-8.
+        static std::string readUTF16(const unsigned char* p, size_t count)
+        {
+            std::string ret;
+            ret.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t c = (p[i * 2] << 8) | p[i * 2 + 1];
+                if (c >= 0xD800 && c < 0xDC00 && i + 1 < count)
+                {
+                    uint32_t low = (p[i * 2 + 2] << 8) | p[i * 2 + 3];
+                    if (low >= 0xDC00 && low < 0xE000)
+                    {
+                        c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                        ++i;
+                    }
+                }
+
+                if (c < 0x80)
+                {
+                    ret.push_back((char)c);
+                }
+                else if (c < 0x800)
+                {
+                    ret.push_back((char)(0xC0 | (c >> 6)));
+                    ret.push_back((char)(0x80 | (c & 0x3F)));
+                }
+                else if (c < 0x10000)
+                {
+                    ret.push_back((char)(0xE0 | (c >> 12)));
+                    ret.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                    ret.push_back((char)(0x80 | (c & 0x3F)));
+                }
+                else
+                {
+                    ret.push_back((char)(0xF0 | (c >> 18)));
+                    ret.push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+                    ret.push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+                    ret.push_back((char)(0x80 | (c & 0x3F)));
+                }
+            }
+            return ret;
+        }
+
+        const unsigned char* _data;
+        size_t _length;
+        size_t _offsetSize = 0;
+        size_t _refSize = 0;
+        uint64_t _count = 0;
+        uint64_t _tableOffset = 0;
+        uint64_t _budget = 0;
+    };
+}
+
+Value PlistParser::parse(const char* data, size_t length)
+{
+    if (!data || 0 == length)
+        return Value::Null;
+
+    Value ret;
+    bool ok;
+    if (isBinaryPlist(data, length))
+        ok = BinaryPlistReader((const unsigned char*)data, length).read(&ret);
+    else
+        ok = XMLPlistReader(data, length).read(&ret);
+
+    if (!ok)
+        return Value::Null;
+    return ret;
+}
+
+bool PlistParser::isBinaryPlist(const char* data, size_t length)
+{
+    return length >= 8 && memcmp(data, "bplist00", 8) == 0;
+}
+
+NS_CC_END
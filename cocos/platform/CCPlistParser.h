@@ -0,0 +1,59 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "base/CCValue.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * Reads property lists into Values, from XML or from binary plists ("bplist00").
+ * The XML is tokenized by XMLPullParser and the Values are built as the elements are read, nothing else is
+ * materialized. Dates, data and UIDs have no Value type and are skipped, as the XML reader always did.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL PlistParser
+{
+public:
+    /**
+     * Parses a plist held in memory.
+     * @return The root object, a ValueMap or a ValueVector for the usual files. Value::Null if the data isn't a valid plist.
+     */
+    static Value parse(const char* data, size_t length);
+
+    /** Whether the data starts with the binary plist signature. */
+    static bool isBinaryPlist(const char* data, size_t length);
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
@@ -27,66 +27,11 @@
 #include <vector> // because its based on windows 8 build :P
 
 #include "platform/CCFileUtils.h"
-#include "tinyxml2/tinyxml2.h"
+#include "platform/CCXMLPullParser.h"
 
 
 NS_CC_BEGIN
 
-class XmlSaxHander : public tinyxml2::XMLVisitor
-{
-public:
-    XmlSaxHander():_ccsaxParserImp(0){};
-
-    virtual bool VisitEnter( const tinyxml2::XMLElement& element, const tinyxml2::XMLAttribute* firstAttribute );
-    virtual bool VisitExit( const tinyxml2::XMLElement& element );
-    virtual bool Visit( const tinyxml2::XMLText& text );
-    virtual bool Visit( const tinyxml2::XMLUnknown&){ return true; }
-
-    void setSAXParserImp(SAXParser* parser)
-    {
-        _ccsaxParserImp = parser;
-    }
-
-private:
-    SAXParser *_ccsaxParserImp;
-};
-
-
-bool XmlSaxHander::VisitEnter( const tinyxml2::XMLElement& element, const tinyxml2::XMLAttribute* firstAttribute )
-{
-    //log(" VisitEnter %s",element.Value());
-
-    std::vector<const char*> attsVector;
-    for( const tinyxml2::XMLAttribute* attrib = firstAttribute; attrib; attrib = attrib->Next() )
-    {
-        //log("%s", attrib->Name());
-        attsVector.push_back(attrib->Name());
-        //log("%s",attrib->Value());
-        attsVector.push_back(attrib->Value());
-    }
-
-    // nullptr is used in c++11
-    //attsVector.push_back(nullptr);
-    attsVector.push_back(nullptr);
-
-    SAXParser::startElement(_ccsaxParserImp, (const CC_XML_CHAR *)element.Value(), (const CC_XML_CHAR **)(&attsVector[0]));
-    return true;
-}
-bool XmlSaxHander::VisitExit( const tinyxml2::XMLElement& element )
-{
-    //log("VisitExit %s",element.Value());
-
-    SAXParser::endElement(_ccsaxParserImp, (const CC_XML_CHAR *)element.Value());
-    return true;
-}
-
-bool XmlSaxHander::Visit( const tinyxml2::XMLText& text )
-{
-    //log("Visit %s",text.Value());
-    SAXParser::textHandler(_ccsaxParserImp, (const CC_XML_CHAR *)text.Value(), static_cast<int>(strlen(text.Value())));
-    return true;
-}
-
 SAXParser::SAXParser()
 {
     _delegator = nullptr;
@@ -105,21 +50,46 @@ bool SAXParser::init(const char *encoding)
 
 bool SAXParser::parse(const char* xmlData, size_t dataLength)
 {
-    tinyxml2::XMLDocument tinyDoc;
-    tinyDoc.Parse(xmlData, dataLength);
-    XmlSaxHander printer;
-    printer.setSAXParserImp(this);
-
-    return tinyDoc.Accept( &printer );
+    // events are delivered while the data is read, there is no document in between
+    XMLPullParser parser(xmlData, dataLength);
+    std::vector<const char*> attsVector;
+    for (;;)
+    {
+        switch (parser.next())
+        {
+            case XMLPullParser::Event::START_ELEMENT:
+                attsVector.clear();
+                for (size_t i = 0, count = parser.getAttributeCount(); i < count; ++i)
+                {
+                    attsVector.push_back(parser.getAttributeName(i).c_str());
+                    attsVector.push_back(parser.getAttributeValue(i).c_str());
+                }
+                attsVector.push_back(nullptr);
+                SAXParser::startElement(this, (const CC_XML_CHAR *)parser.getName().c_str(), (const CC_XML_CHAR **)(&attsVector[0]));
+                break;
+            case XMLPullParser::Event::END_ELEMENT:
+                SAXParser::endElement(this, (const CC_XML_CHAR *)parser.getName().c_str());
+                break;
+            case XMLPullParser::Event::TEXT:
+                SAXParser::textHandler(this, (const CC_XML_CHAR *)parser.getText().c_str(), static_cast<int>(parser.getText().length()));
+                break;
+            case XMLPullParser::Event::END_DOCUMENT:
+                return true;
+            default:
+                CCLOG("cocos2d: SAXParser: invalid XML at offset %d", (int)parser.getErrorOffset());
+                return false;
+        }
+    }
 }
 
 bool SAXParser::parse(const std::string& filename)
 {
     bool ret = false;
-    Data data = FileUtils::getInstance()->getDataFromFile(filename);
-    if (!data.isNull())
+    MappedFile* file = FileUtils::getInstance()->mapFile(filename);
+    if (file)
     {
-        ret = parse((const char*)data.getBytes(), data.getSize());
+        ret = parse((const char*)file->getBytes(), file->getSize());
+        file->release();
     }
 
     return ret;
@@ -0,0 +1,359 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCXMLPullParser.h"
+
+#include <string.h>
+#include <algorithm>
+
+NS_CC_BEGIN
+
+namespace
+{
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    inline bool startsWith(const char* cursor, const char* end, const char* prefix, size_t length)
+    {
+        return (size_t)(end - cursor) >= length && memcmp(cursor, prefix, length) == 0;
+    }
+
+    void appendUTF8(uint32_t c, std::string* out)
+    {
+        if (c < 0x80)
+        {
+            out->push_back((char)c);
+        }
+        else if (c < 0x800)
+        {
+            out->push_back((char)(0xC0 | (c >> 6)));
+            out->push_back((char)(0x80 | (c & 0x3F)));
+        }
+        else if (c < 0x10000)
+        {
+            out->push_back((char)(0xE0 | (c >> 12)));
+            out->push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            out->push_back((char)(0x80 | (c & 0x3F)));
+        }
+        else
+        {
+            out->push_back((char)(0xF0 | (c >> 18)));
+            out->push_back((char)(0x80 | ((c >> 12) & 0x3F)));
+            out->push_back((char)(0x80 | ((c >> 6) & 0x3F)));
+            out->push_back((char)(0x80 | (c & 0x3F)));
+        }
+    }
+
+    // Decodes the entity at `p`, which points after the '&'. Returns the end of the entity, nullptr if it isn't one.
+    const char* decodeEntity(const char* p, const char* end, std::string* out)
+    {
+        const char* semicolon = (const char*)memchr(p, ';', std::min<size_t>(end - p, 12));
+        if (!semicolon)
+            return nullptr;
+
+        size_t length = semicolon - p;
+        if (length > 1 && p[0] == '#')
+        {
+            uint32_t c = 0;
+            bool hex = p[1] == 'x';
+            for (const char* digit = p + (hex ? 2 : 1); digit < semicolon; ++digit)
+            {
+                int d;
+                if (*digit >= '0' && *digit <= '9')
+                    d = *digit - '0';
+                else if (hex && *digit >= 'a' && *digit <= 'f')
+                    d = *digit - 'a' + 10;
+                else if (hex && *digit >= 'A' && *digit <= 'F')
+                    d = *digit - 'A' + 10;
+                else
+                    return nullptr;
+                c = c * (hex ? 16 : 10) + d;
+                if (c > 0x10FFFF)
+                    return nullptr;
+            }
+            appendUTF8(c, out);
+        }
+        else if (length == 2 && memcmp(p, "lt", 2) == 0)
+            out->push_back('<');
+        else if (length == 2 && memcmp(p, "gt", 2) == 0)
+            out->push_back('>');
+        else if (length == 3 && memcmp(p, "amp", 3) == 0)
+            out->push_back('&');
+        else if (length == 4 && memcmp(p, "quot", 4) == 0)
+            out->push_back('"');
+        else if (length == 4 && memcmp(p, "apos", 4) == 0)
+            out->push_back('\'');
+        else
+            return nullptr;
+
+        return semicolon + 1;
+    }
+}
+
+XMLPullParser::XMLPullParser(const char* data, size_t length)
+: _begin(data)
+, _cursor(data)
+, _end(data + length)
+{
+    // skip the UTF-8 BOM
+    if (startsWith(_cursor, _end, "\xEF\xBB\xBF", 3))
+        _cursor += 3;
+}
+
+XMLPullParser::Event XMLPullParser::next()
+{
+    if (Event::END_DOCUMENT == _event || Event::INVALID == _event)
+        return _event;
+
+    if (_pendingEnd)
+    {
+        _pendingEnd = false;
+        --_openCount;
+        return _event = Event::END_ELEMENT;
+    }
+
+    _attributeCount = 0;
+    while (_cursor < _end)
+    {
+        const char* start = _cursor;
+        if (*_cursor != '<')
+        {
+            const char* lt = (const char*)memchr(_cursor, '<', _end - _cursor);
+            _cursor = lt ? lt : _end;
+
+            const char* p = start;
+            while (p < _cursor && (isSpace(*p) || *p == '\0'))
+                ++p;
+            // whitespace between elements and text outside the root element are dropped
+            if (p == _cursor || 0 == _openCount)
+                continue;
+
+            decodeText(start, _cursor, &_text);
+            return _event = Event::TEXT;
+        }
+
+        if (startsWith(_cursor, _end, "<?", 2))
+        {
+            if (!skipUntil("?>"))
+                return fail(start);
+            continue;
+        }
+
+        if (startsWith(_cursor, _end, "<!--", 4))
+        {
+            if (!skipUntil("-->"))
+                return fail(start);
+            continue;
+        }
+
+        if (startsWith(_cursor, _end, "<![CDATA[", 9))
+        {
+            _cursor += 9;
+            const char* contentStart = _cursor;
+            if (!skipUntil("]]>"))
+                return fail(start);
+            _text.assign(contentStart, _cursor - 3);
+            return _event = Event::TEXT;
+        }
+
+        if (startsWith(_cursor, _end, "<!", 2))
+        {
+            // <!DOCTYPE ...> with an optional [internal subset]
+            int brackets = 0;
+            for (_cursor += 2; _cursor < _end; ++_cursor)
+            {
+                if (*_cursor == '[')
+                    ++brackets;
+                else if (*_cursor == ']')
+                    --brackets;
+                else if (*_cursor == '>' && brackets <= 0)
+                    break;
+            }
+            if (_cursor == _end)
+                return fail(start);
+            ++_cursor;
+            continue;
+        }
+
+        if (startsWith(_cursor, _end, "</", 2))
+        {
+            _cursor += 2;
+            if (!readName(&_name))
+                return fail(start);
+            while (_cursor < _end && isSpace(*_cursor))
+                ++_cursor;
+            if (_cursor == _end || *_cursor != '>')
+                return fail(start);
+            ++_cursor;
+
+            if (0 == _openCount || _openElements[_openCount - 1] != _name)
+                return fail(start);
+            --_openCount;
+            return _event = Event::END_ELEMENT;
+        }
+
+        ++_cursor;
+        bool empty = false;
+        if (!readName(&_name) || !readAttributes(&empty))
+            return fail(start);
+
+        if (_openCount == _openElements.size())
+            _openElements.push_back(_name);
+        else
+            _openElements[_openCount] = _name;
+        ++_openCount;
+
+        _pendingEnd = empty;
+        return _event = Event::START_ELEMENT;
+    }
+
+    if (_openCount > 0)
+        return fail(_cursor);
+    return _event = Event::END_DOCUMENT;
+}
+
+XMLPullParser::Event XMLPullParser::fail(const char* at)
+{
+    _errorOffset = at - _begin;
+    return _event = Event::INVALID;
+}
+
+bool XMLPullParser::skipUntil(const char* terminator)
+{
+    size_t length = strlen(terminator);
+    while (_cursor < _end)
+    {
+        const char* p = (const char*)memchr(_cursor, terminator[0], _end - _cursor);
+        if (!p)
+            break;
+        if (startsWith(p, _end, terminator, length))
+        {
+            _cursor = p + length;
+            return true;
+        }
+        _cursor = p + 1;
+    }
+    _cursor = _end;
+    return false;
+}
+
+bool XMLPullParser::readName(std::string* out)
+{
+    const char* start = _cursor;
+    while (_cursor < _end && !isSpace(*_cursor) && *_cursor != '/' && *_cursor != '>' && *_cursor != '=')
+        ++_cursor;
+
+    if (_cursor == start)
+        return false;
+    out->assign(start, _cursor);
+    return true;
+}
+
+bool XMLPullParser::readAttributes(bool* empty)
+{
+    for (;;)
+    {
+        while (_cursor < _end && isSpace(*_cursor))
+            ++_cursor;
+        if (_cursor == _end)
+            return false;
+
+        if (*_cursor == '>')
+        {
+            ++_cursor;
+            return true;
+        }
+        if (*_cursor == '/')
+        {
+            if (_cursor + 1 == _end || _cursor[1] != '>')
+                return false;
+            _cursor += 2;
+            *empty = true;
+            return true;
+        }
+
+        if (_attributes.size() < (_attributeCount + 1) * 2)
+            _attributes.resize((_attributeCount + 1) * 2);
+
+        std::string& name = _attributes[_attributeCount * 2];
+        std::string& value = _attributes[_attributeCount * 2 + 1];
+        if (!readName(&name))
+            return false;
+        while (_cursor < _end && isSpace(*_cursor))
+            ++_cursor;
+        if (_cursor == _end || *_cursor != '=')
+            return false;
+        ++_cursor;
+        while (_cursor < _end && isSpace(*_cursor))
+            ++_cursor;
+        if (_cursor == _end || (*_cursor != '"' && *_cursor != '\''))
+            return false;
+
+        const char* valueStart = _cursor + 1;
+        const char* quote = (const char*)memchr(valueStart, *_cursor, _end - valueStart);
+        if (!quote)
+            return false;
+        decodeText(valueStart, quote, &value);
+        _cursor = quote + 1;
+        ++_attributeCount;
+    }
+}
+
+void XMLPullParser::decodeText(const char* begin, const char* end, std::string* out)
+{
+    out->clear();
+    const char* run = begin;
+    for (const char* p = begin; p < end; ++p)
+    {
+        if (*p == '&')
+        {
+            out->append(run, p);
+            const char* next = decodeEntity(p + 1, end, out);
+            if (next)
+            {
+                run = next;
+                p = next - 1;
+            }
+            else
+            {
+                // not an entity we know, keep it as it is
+                run = p;
+            }
+        }
+        else if (*p == '\r')
+        {
+            // line ends are normalized to \n
+            out->append(run, p);
+            out->push_back('\n');
+            if (p + 1 < end && p[1] == '\n')
+                ++p;
+            run = p + 1;
+        }
+    }
+    out->append(run, end);
+}
+
+NS_CC_END
@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "platform/CCPlatformMacros.h"
+
+#include <string>
+#include <vector>
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * An XML reader that tokenizes a buffer in place and returns one event at a time, without building a document.
+ * The buffer is not copied, it has to stay valid while the parser is used. Comments, processing instructions and
+ * the DOCTYPE are skipped, entities and character references are decoded, CDATA sections are returned as text
+ * and whitespace only text between elements is dropped. An empty element `<a/>` returns a start and an end event.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL XMLPullParser
+{
+public:
+    enum class Event
+    {
+        START_ELEMENT,
+        END_ELEMENT,
+        TEXT,
+        END_DOCUMENT,
+        INVALID
+    };
+
+    XMLPullParser(const char* data, size_t length);
+
+    /** Reads the next event. After END_DOCUMENT or INVALID it keeps returning the same event. */
+    Event next();
+
+    /** The name of the current element, for START_ELEMENT and END_ELEMENT. */
+    inline const std::string& getName() const { return _name; }
+    /** The attributes of the current START_ELEMENT. */
+    inline size_t getAttributeCount() const { return _attributeCount; }
+    inline const std::string& getAttributeName(size_t index) const { return _attributes[index * 2]; }
+    inline const std::string& getAttributeValue(size_t index) const { return _attributes[index * 2 + 1]; }
+    /** The decoded text of the current TEXT event, large texts may be split into several events. */
+    inline const std::string& getText() const { return _text; }
+    /** Depth of the current element, 1 for the root element. */
+    inline size_t getDepth() const { return _openCount; }
+    /** The offset in the buffer where the parser stopped after an INVALID event. */
+    inline size_t getErrorOffset() const { return _errorOffset; }
+
+private:
+    Event fail(const char* at);
+    bool skipUntil(const char* terminator);
+    bool readName(std::string* out);
+    bool readAttributes(bool* empty);
+    void decodeText(const char* begin, const char* end, std::string* out);
+
+    const char* _begin;
+    const char* _cursor;
+    const char* _end;
+    Event _event = Event::START_ELEMENT;
+    bool _pendingEnd = false;
+
+    std::string _name;
+    std::string _text;
+    // names and values, the strings are reused between elements
+    std::vector<std::string> _attributes;
+    size_t _attributeCount = 0;
+    // the first _openCount names are the open elements
+    std::vector<std::string> _openElements;
+    size_t _openCount = 0;
+    size_t _errorOffset = 0;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
@@ -34,6 +34,7 @@ THE SOFTWARE.
 // #include "android/asset_manager.h"
 // #include "android/asset_manager_jni.h"
 #include "base/ZipUtils.h"
+#include "base/CCAssetBundle.h"
 
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -289,6 +290,11 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
+    string name;
+    AssetBundle* bundle = getBundleForPath(fullPath, &name);
+    if (bundle)
+        return bundle->getFileData(name, buffer) ? FileUtils::Status::OK : FileUtils::Status::ReadFailed;
+
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
@@ -333,6 +339,63 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     return FileUtils::Status::OK;
 }
 
+MappedFile* FileUtilsAndroid::mapFile(const std::string& filename)
+{
+    static const std::string apkprefix("assets/");
+    if (filename.empty())
+        return nullptr;
+
+    string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return nullptr;
+
+    string name;
+    AssetBundle* bundle = getBundleForPath(fullPath, &name);
+    if (bundle)
+        return bundle->mapFile(name);
+
+    if (fullPath[0] == '/')
+        return FileUtils::mapFile(fullPath);
+
+    string relativePath = string();
+    size_t position = fullPath.find(apkprefix);
+    if (0 == position) {
+        // "assets/" is at the beginning of the path and we don't want it
+        relativePath += fullPath.substr(apkprefix.size());
+    } else {
+        relativePath = fullPath;
+    }
+
+    // Assets stored uncompressed in the apk are mapped by the asset manager, the others are inflated by it.
+    if (!obbfile && assetmanager)
+    {
+        AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_BUFFER);
+        if (nullptr != asset)
+        {
+            const void* buffer = AAsset_getBuffer(asset);
+            if (buffer)
+            {
+                return MappedFile::createWithMapping(static_cast<const unsigned char*>(buffer), AAsset_getLength(asset), [asset](const unsigned char*, ssize_t) {
+                    AAsset_close(asset);
+                });
+            }
+            AAsset_close(asset);
+        }
+    }
+
+    if (obbfile)
+    {
+        MappedFile* file = obbfile->mapFile(relativePath);
+        if (file)
+            return file;
+    }
+
+    Data data;
+    if (getContents(fullPath, &data) != FileUtils::Status::OK)
+        return nullptr;
+    return MappedFile::createWithData(std::move(data));
+}
+
 string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
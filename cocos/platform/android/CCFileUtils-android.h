@@ -67,6 +67,7 @@ public:
     virtual std::string getNewFilename(const std::string &filename) const override;
 
     virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) override;
+    virtual MappedFile* mapFile(const std::string& filename) override;
 
     virtual std::string getWritablePath() const override;
     virtual bool isAbsolutePath(const std::string& strPath) const override;
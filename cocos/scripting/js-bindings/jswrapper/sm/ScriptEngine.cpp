@@ -1036,21 +1036,23 @@ namespace se {
             clearException();
 
             ok = false;
-            std::string jsFileContent = _fileOperationDelegate.onGetStringFromFile(path);
-            if (!jsFileContent.empty())
-            {
-                JS::CompileOptions op(_cx);
-                op.setUTF8(true);
-                op.setFileAndLine(path.c_str(), 1);
-                ok = JS::Compile(_cx, op, jsFileContent.c_str(), jsFileContent.size(), script);
-                if (ok)
+            // Compile the file contents in place, the delegate may hand out a mapped file.
+            _fileOperationDelegate.onGetDataFromFile(path, [&](const uint8_t* data, size_t dataLen) {
+                if (data != nullptr && dataLen > 0)
                 {
-                    compileSucceed = true;
-                    std::string fullPath = _fileOperationDelegate.onGetFullPath(path);
-                    _filenameScriptMap[fullPath] = new (std::nothrow) JS::PersistentRootedScript(_cx, script.get());
+                    JS::CompileOptions op(_cx);
+                    op.setUTF8(true);
+                    op.setFileAndLine(path.c_str(), 1);
+                    ok = JS::Compile(_cx, op, reinterpret_cast<const char*>(data), dataLen, script);
+                    if (ok)
+                    {
+                        compileSucceed = true;
+                        std::string fullPath = _fileOperationDelegate.onGetFullPath(path);
+                        _filenameScriptMap[fullPath] = new (std::nothrow) JS::PersistentRootedScript(_cx, script.get());
+                    }
+                    assert(compileSucceed);
                 }
-                assert(compileSucceed);
-            }
+            });
         }
         
         clearException();
@@ -631,9 +631,7 @@ namespace se {
             sourceUrl = sourceUrl.substr(prefixPos + prefixKey.length());
         }
 
-        std::string scriptStr(script, length);
-
-        v8::MaybeLocal<v8::String> source = v8::String::NewFromUtf8(_isolate, scriptStr.c_str(), v8::NewStringType::kNormal);
+        v8::MaybeLocal<v8::String> source = v8::String::NewFromUtf8(_isolate, script, v8::NewStringType::kNormal, (int)length);
         if (source.IsEmpty())
             return false;
 
@@ -678,15 +676,22 @@ namespace se {
         assert(!path.empty());
         assert(_fileOperationDelegate.isValid());
 
-        std::string scriptBuffer = _fileOperationDelegate.onGetStringFromFile(path);
+        // Evaluate the file contents in place, the delegate may hand out a mapped file.
+        bool empty = true;
+        bool ok = false;
+        _fileOperationDelegate.onGetDataFromFile(path, [&](const uint8_t* data, size_t dataLen) {
+            if (data != nullptr && dataLen > 0)
+            {
+                empty = false;
+                ok = evalString(reinterpret_cast<const char*>(data), dataLen, ret, path.c_str());
+            }
+        });
 
-        if (!scriptBuffer.empty())
+        if (empty)
         {
-            return evalString(scriptBuffer.c_str(), scriptBuffer.length(), ret, path.c_str());
+            SE_LOGE("ScriptEngine::runScript script %s, buffer is empty!\n", path.c_str());
         }
-
-        SE_LOGE("ScriptEngine::runScript script %s, buffer is empty!\n", path.c_str());
-        return false;
+        return ok;
     }
 
     void ScriptEngine::clearException()
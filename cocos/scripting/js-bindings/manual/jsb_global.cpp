@@ -39,14 +39,17 @@ void jsb_init_file_operation_delegate()
         delegate.onGetDataFromFile = [](const std::string& path, const std::function<void(const uint8_t*, size_t)>& readCallback) -> void{
             assert(!path.empty());
 
-            Data fileData;
-
             std::string byteCodePath = removeFileExt(path) + BYTE_CODE_FILE_EXT;
             if (FileUtils::getInstance()->isFileExist(byteCodePath)) {
-                fileData = FileUtils::getInstance()->getDataFromFile(byteCodePath);
+                MappedFile* fileData = FileUtils::getInstance()->mapFile(byteCodePath);
+                if (fileData == nullptr) {
+                    SE_REPORT_ERROR("Can't read code for %s", byteCodePath.c_str());
+                    return;
+                }
 
                 size_t dataLen = 0;
-                uint8_t* data = xxtea_decrypt((unsigned char*)fileData.getBytes(), (uint32_t)fileData.getSize(), (unsigned char*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), (uint32_t*)&dataLen);
+                uint8_t* data = xxtea_decrypt((unsigned char*)fileData->getBytes(), (uint32_t)fileData->getSize(), (unsigned char*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), (uint32_t*)&dataLen);
+                fileData->release();
 
                 if (data == nullptr) {
                     SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
@@ -76,8 +79,15 @@ void jsb_init_file_operation_delegate()
                 return;
             }
 
-            fileData = FileUtils::getInstance()->getDataFromFile(path);
-            readCallback(fileData.getBytes(), fileData.getSize());
+            // The script is handed over in place, the mapping is released once the callback returned.
+            MappedFile* fileData = FileUtils::getInstance()->mapFile(path);
+            if (fileData) {
+                readCallback(fileData->getBytes(), fileData->getSize());
+                fileData->release();
+            }
+            else {
+                readCallback(nullptr, 0);
+            }
         };
 
         delegate.onGetStringFromFile = [](const std::string& path) -> std::string{
@@ -85,10 +95,15 @@ void jsb_init_file_operation_delegate()
 
             std::string byteCodePath = removeFileExt(path) + BYTE_CODE_FILE_EXT;
             if (FileUtils::getInstance()->isFileExist(byteCodePath)) {
-                Data fileData = FileUtils::getInstance()->getDataFromFile(byteCodePath);
+                MappedFile* fileData = FileUtils::getInstance()->mapFile(byteCodePath);
+                if (fileData == nullptr) {
+                    SE_REPORT_ERROR("Can't read code for %s", byteCodePath.c_str());
+                    return "";
+                }
 
                 uint32_t dataLen;
-                uint8_t* data = xxtea_decrypt((uint8_t*)fileData.getBytes(), (uint32_t)fileData.getSize(), (uint8_t*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), &dataLen);
+                uint8_t* data = xxtea_decrypt((uint8_t*)fileData->getBytes(), (uint32_t)fileData->getSize(), (uint8_t*)xxteaKey.c_str(), (uint32_t)xxteaKey.size(), &dataLen);
+                fileData->release();
                 
                 if (data == nullptr) {
                     SE_REPORT_ERROR("Can't decrypt code for %s", byteCodePath.c_str());
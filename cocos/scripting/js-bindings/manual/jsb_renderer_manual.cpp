@@ -170,9 +170,9 @@ static bool js_renderer_Effect_extractDefines(se::State& s)
     CC_UNUSED bool ok = true;
     if (argc == 1) {
         se::Object* out = args[0].toObject();
-        cocos2d::ValueMap valueMap;
-        cobj->extractDefines(valueMap);
-        fillObjectWithValueMap(valueMap, out);
+        cocos2d::renderer::DefineSet defines;
+        cobj->extractDefines(defines);
+        fillObjectWithValueMap(defines.toValueMap(), out);
         s.rval().setObject(out);
         return true;
     }
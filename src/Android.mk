@@ -15,17 +15,23 @@ LOCAL_SRC_FILES := $(LOCAL_PATH)/Types.cpp \
                    $(LOCAL_PATH)/gfx/GFXUtils.cpp \
                    $(LOCAL_PATH)/gfx/GraphicsHandle.cpp \
                    $(LOCAL_PATH)/gfx/IndexBuffer.cpp \
+                   $(LOCAL_PATH)/gfx/MipmapStreamer.cpp \
                    $(LOCAL_PATH)/gfx/Program.cpp \
                    $(LOCAL_PATH)/gfx/RenderBuffer.cpp \
                    $(LOCAL_PATH)/gfx/RenderTarget.cpp \
                    $(LOCAL_PATH)/gfx/State.cpp \
+                   $(LOCAL_PATH)/gfx/TexelConversion.cpp \
                    $(LOCAL_PATH)/gfx/Texture.cpp \
                    $(LOCAL_PATH)/gfx/Texture2D.cpp \
+                   $(LOCAL_PATH)/gfx/TextureResidency.cpp \
                    $(LOCAL_PATH)/gfx/VertexBuffer.cpp \
                    $(LOCAL_PATH)/gfx/VertexFormat.cpp \
+                   $(LOCAL_PATH)/renderer/AtlasBatch.cpp \
+                   $(LOCAL_PATH)/renderer/AtlasPacker.cpp \
                    $(LOCAL_PATH)/renderer/BaseRenderer.cpp \
                    $(LOCAL_PATH)/renderer/Camera.cpp \
                    $(LOCAL_PATH)/renderer/Config.cpp \
+                   $(LOCAL_PATH)/renderer/DefineSet.cpp \
                    $(LOCAL_PATH)/renderer/Effect.cpp \
                    $(LOCAL_PATH)/renderer/InputAssembler.cpp \
                    $(LOCAL_PATH)/renderer/Light.cpp \
@@ -34,6 +40,7 @@ LOCAL_SRC_FILES := $(LOCAL_PATH)/Types.cpp \
                    $(LOCAL_PATH)/renderer/ProgramLib.cpp \
                    $(LOCAL_PATH)/renderer//Scene.cpp \
                    $(LOCAL_PATH)/renderer/Technique.cpp \
+                   $(LOCAL_PATH)/renderer/TextureAtlas.cpp \
                    $(LOCAL_PATH)/renderer/View.cpp \
                    $(LOCAL_PATH)/renderer/ForwardRenderer.cpp
 
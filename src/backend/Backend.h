@@ -12,5 +12,7 @@
 #include "backend/VertexLayout.h"
 #include "backend/ShaderModule.h"
 #include "backend/Texture.h"
+#include "backend/Sampler.h"
+#include "backend/TextureUploadQueue.h"
 #include "backend/DepthStencilState.h"
 #include "backend/BlendState.h"
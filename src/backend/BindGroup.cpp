@@ -1,5 +1,8 @@
 #include "BindGroup.h"
 #include "Texture.h"
+#include "Sampler.h"
+
+#include <string.h>
 
 CC_BACKEND_BEGIN
 
@@ -72,6 +75,39 @@ void BindGroup::TextureInfo::releaseTextures()
         CC_SAFE_RELEASE(texture);
 }
 
+BindGroup::SamplerInfo::SamplerInfo(const std::string& _name, const std::vector<Sampler*>& _samplers)
+: name(_name)
+, samplers(_samplers)
+{
+    for (auto& sampler : samplers)
+        CC_SAFE_RETAIN(sampler);
+}
+
+BindGroup::SamplerInfo::~SamplerInfo()
+{
+    releaseSamplers();
+}
+
+BindGroup::SamplerInfo& BindGroup::SamplerInfo::operator=(SamplerInfo&& rhs)
+{
+    if (this != &rhs)
+    {
+        name = rhs.name;
+        
+        // Take over the references held by rhs.
+        releaseSamplers();
+        samplers = std::move(rhs.samplers);
+        rhs.samplers.clear();
+    }
+    return *this;
+}
+
+void BindGroup::SamplerInfo::releaseSamplers()
+{
+    for (auto& sampler : samplers)
+        CC_SAFE_RELEASE(sampler);
+}
+
 void BindGroup::setTexture(const std::string &name, uint32_t index, Texture *texture)
 {
     TextureInfo textureInfo(name, {index}, {texture});
@@ -86,6 +122,18 @@ void BindGroup::setTextureArray(const std::string& name, const std::vector<uint3
     _textureInfos[name] = std::move(textureInfo);
 }
 
+void BindGroup::setSampler(const std::string& name, Sampler* sampler)
+{
+    SamplerInfo samplerInfo(name, {sampler});
+    _samplerInfos[name] = std::move(samplerInfo);
+}
+
+void BindGroup::setSamplerArray(const std::string& name, const std::vector<Sampler*>& samplers)
+{
+    SamplerInfo samplerInfo(name, samplers);
+    _samplerInfos[name] = std::move(samplerInfo);
+}
+
 void BindGroup::setUniform(const std::string& name, void* data, uint32_t size)
 {
     UniformInfo uniform(name, data, size);
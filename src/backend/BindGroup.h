@@ -42,16 +42,34 @@ public:
         std::vector<Texture*> textures;
     };
     
+    struct SamplerInfo
+    {
+        SamplerInfo(const std::string& _name, const std::vector<Sampler*>& _samplers);
+        SamplerInfo() = default;
+        ~SamplerInfo();
+        SamplerInfo& operator =(SamplerInfo&& rhs);
+        
+        void releaseSamplers();
+        
+        std::string name;
+        std::vector<Sampler*> samplers;
+    };
+    
     void setTexture(const std::string& name, uint32_t index, Texture* texture);
     void setTextureArray(const std::string& name, const std::vector<uint32_t>& indices, const std::vector<Texture*> textures);
+    // Samplers override the default sampler states of the textures bound to the uniform with the same name.
+    void setSampler(const std::string& name, Sampler* sampler);
+    void setSamplerArray(const std::string& name, const std::vector<Sampler*>& samplers);
     void setUniform(const std::string& name, void* data, uint32_t size);
     
     inline const std::unordered_map<std::string, UniformInfo>& getUniformInfos() const { return _uniformInfos; }
     inline const std::unordered_map<std::string, TextureInfo>& getTextureInfos() const { return _textureInfos; }
+    inline const std::unordered_map<std::string, SamplerInfo>& getSamplerInfos() const { return _samplerInfos; }
     
 private:
     std::unordered_map<std::string, UniformInfo> _uniformInfos;
     std::unordered_map<std::string, TextureInfo> _textureInfos;
+    std::unordered_map<std::string, SamplerInfo> _samplerInfos;
 };
 
 CC_BACKEND_END
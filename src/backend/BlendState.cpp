@@ -1,5 +1,32 @@
 #include "BlendState.h"
+#include "HashUtils.h"
 
 CC_BACKEND_BEGIN
 
+bool BlendDescriptor::operator==(const BlendDescriptor& rhs) const
+{
+    return (writeMask == rhs.writeMask &&
+            blendEnabled == rhs.blendEnabled &&
+            rgbBlendOperation == rhs.rgbBlendOperation &&
+            alphaBlendOperation == rhs.alphaBlendOperation &&
+            sourceRGBBlendFactor == rhs.sourceRGBBlendFactor &&
+            destinationRGBBlendFactor == rhs.destinationRGBBlendFactor &&
+            sourceAlphaBlendFactor == rhs.sourceAlphaBlendFactor &&
+            destinationAlphaBlendFactor == rhs.destinationAlphaBlendFactor);
+}
+
+std::size_t BlendDescriptor::hash() const
+{
+    std::size_t seed = 0;
+    hashCombine(seed, (uint32_t)writeMask);
+    hashCombine(seed, blendEnabled);
+    hashCombine(seed, (uint32_t)rgbBlendOperation);
+    hashCombine(seed, (uint32_t)alphaBlendOperation);
+    hashCombine(seed, (uint32_t)sourceRGBBlendFactor);
+    hashCombine(seed, (uint32_t)destinationRGBBlendFactor);
+    hashCombine(seed, (uint32_t)sourceAlphaBlendFactor);
+    hashCombine(seed, (uint32_t)destinationAlphaBlendFactor);
+    return seed;
+}
+
 CC_BACKEND_END
@@ -4,10 +4,15 @@
 #include "Types.h"
 #include "base/CCRef.h"
 
+#include <cstddef>
+
 CC_BACKEND_BEGIN
 
 struct BlendDescriptor
 {
+    bool operator ==(const BlendDescriptor& rhs) const;
+    std::size_t hash() const;
+    
     ColorWriteMask writeMask = ColorWriteMask::ALL;
     
     bool blendEnabled = false;
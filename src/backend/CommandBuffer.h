@@ -31,11 +31,17 @@ public:
     void setStencilReferenceValue(uint32_t value);
     void setStencilReferenceValue(uint32_t frontRef, uint32_t backRef);
     
+    // Number of frame buffer invalidations issued for LoadAction::DONT_CARE and StoreAction::DONT_CARE.
+    // Backends that support load/store actions natively, such as metal, don't issue invalidations.
+    inline uint32_t getInvalidationCount() const { return _invalidationCount; }
+    inline void resetInvalidationCount() { _invalidationCount = 0; }
+    
 protected:
     virtual ~CommandBuffer() = default;
     
     uint32_t _stencilReferenceValueFront = 0;
     uint32_t _stencilReferenceValueBack = 0;
+    uint32_t _invalidationCount = 0;
 };
 
 CC_BACKEND_END
@@ -1,7 +1,21 @@
 #include "DepthStencilState.h"
+#include "HashUtils.h"
 
 CC_BACKEND_BEGIN
 
+namespace
+{
+    void hashStencilDescriptor(std::size_t& seed, const StencilDescriptor& stencil)
+    {
+        hashCombine(seed, (uint32_t)stencil.stencilFailureOperation);
+        hashCombine(seed, (uint32_t)stencil.depthFailureOperation);
+        hashCombine(seed, (uint32_t)stencil.depthStencilPassOperation);
+        hashCombine(seed, (uint32_t)stencil.stencilCompareFunction);
+        hashCombine(seed, stencil.readMask);
+        hashCombine(seed, stencil.writeMask);
+    }
+}
+
 bool StencilDescriptor::operator==(const StencilDescriptor &rhs) const
 {
     return (stencilFailureOperation == rhs.stencilFailureOperation &&
@@ -13,6 +27,24 @@ bool StencilDescriptor::operator==(const StencilDescriptor &rhs) const
 
 }
 
+bool DepthStencilDescriptor::operator==(const DepthStencilDescriptor& rhs) const
+{
+    return (depthCompareFunction == rhs.depthCompareFunction &&
+            depthWriteEnabled == rhs.depthWriteEnabled &&
+            backFaceStencil == rhs.backFaceStencil &&
+            frontFaceStencil == rhs.frontFaceStencil);
+}
+
+std::size_t DepthStencilDescriptor::hash() const
+{
+    std::size_t seed = 0;
+    hashCombine(seed, (uint32_t)depthCompareFunction);
+    hashCombine(seed, depthWriteEnabled);
+    hashStencilDescriptor(seed, backFaceStencil);
+    hashStencilDescriptor(seed, frontFaceStencil);
+    return seed;
+}
+
 DepthStencilState::DepthStencilState(const DepthStencilDescriptor& descriptor)
 : _depthStencilInfo(descriptor)
 {
@@ -5,6 +5,8 @@
 
 #include "base/CCRef.h"
 
+#include <cstddef>
+
 CC_BACKEND_BEGIN
 
 struct StencilDescriptor
@@ -21,6 +23,9 @@ struct StencilDescriptor
 
 struct DepthStencilDescriptor
 {
+    bool operator ==(const DepthStencilDescriptor& rhs) const;
+    std::size_t hash() const;
+    
     CompareFunction depthCompareFunction = CompareFunction::LESS;
     bool depthWriteEnabled = false;
     
@@ -7,6 +7,8 @@
 #include "Texture.h"
 #include "DepthStencilState.h"
 #include "BlendState.h"
+#include "Sampler.h"
+#include "TextureUploadQueue.h"
 
 #include "base/CCRef.h"
 
@@ -35,7 +37,9 @@ public:
     virtual RenderPass* newRenderPass(const RenderPassDescriptor& descriptor) = 0;
     // Create a texture, not auto released.
     virtual Texture* newTexture(const TextureDescriptor& descriptor) = 0;
-    // Create a auto released shader module.
+    // Create a sampler, not auto released. Samplers with the same descriptor are shared.
+    virtual Sampler* newSampler(const SamplerDescriptor& descriptor) = 0;
+    // Create a auto released shader module, retain it to keep it after the autorelease pool is drained.
     virtual ShaderModule* createShaderModule(ShaderStage stage, const std::string& source) = 0;
     // Create a auto released depth stencil state.
     virtual DepthStencilState* createDepthStencilState(const DepthStencilDescriptor& descriptor) = 0;
@@ -44,8 +48,18 @@ public:
     // Create a render pipeline, not auto released.
     virtual RenderPipeline* newRenderPipeline(const RenderPipelineDescriptor& descriptor) = 0;
     
+    // Release the cached objects that are only referenced by the device, such as the states and shader
+    // modules of scenes that were unloaded. Objects returned by the create functions that are not
+    // retained by their users are released too.
+    virtual void purgeCachedObjects() {}
+    
+    // Queue used to upload texture data over several frames, process it once per frame.
+    inline TextureUploadQueue* getTextureUploadQueue() { return &_textureUploadQueue; }
+    
 private:
     static Device* _instance;
+    
+    TextureUploadQueue _textureUploadQueue;
 };
 
 CC_BACKEND_END
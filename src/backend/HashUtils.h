@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstddef>
+#include <functional>
+
+CC_BACKEND_BEGIN
+
+// Combine the hash of value into seed, the same as boost::hash_combine().
+template <typename T>
+inline void hashCombine(std::size_t& seed, const T& value)
+{
+    seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+CC_BACKEND_END
@@ -18,7 +18,8 @@ RenderPassColorAttachments& RenderPassColorAttachments::operator=(const RenderPa
     if (this != &rhs)
     {
         clearColor = rhs.clearColor;
-        needClearColor = rhs.needClearColor;
+        loadAction = rhs.loadAction;
+        storeAction = rhs.storeAction;
         
         rhs.retainTextures();
         releaseTextures();
@@ -63,8 +64,10 @@ RenderPassDepthStencilAttachment& RenderPassDepthStencilAttachment::operator=(co
 {
     if (this != &rhs)
     {
-        needClearDepth = rhs.needClearDepth;
-        needClearStencil = rhs.needClearStencil;
+        depthLoadAction = rhs.depthLoadAction;
+        depthStoreAction = rhs.depthStoreAction;
+        stencilLoadAction = rhs.stencilLoadAction;
+        stencilStoreAction = rhs.stencilStoreAction;
         clearDepth = rhs.clearDepth;
         clearStencil = rhs.clearStencil;
         
@@ -88,7 +91,7 @@ void RenderPassDescriptor::setColorAttachment(uint32_t attachment, Texture* text
 void RenderPassDescriptor::setClearColor(float r, float g, float b, float a)
 {
     _colorAttachments.clearColor = {r, g, b, a};
-    _colorAttachments.needClearColor = true;
+    _colorAttachments.loadAction = LoadAction::CLEAR;
 }
 
 void RenderPassDescriptor::setDepthStencilAttachment(Texture* texture)
@@ -106,13 +109,43 @@ void RenderPassDescriptor::setDepthStencilAttachment(Texture* texture)
 void RenderPassDescriptor::setClearDepth(float clearValue)
 {
     _depthStencilAttachment.clearDepth = clearValue;
-    _depthStencilAttachment.needClearDepth = true;
+    _depthStencilAttachment.depthLoadAction = LoadAction::CLEAR;
 }
 
 void RenderPassDescriptor::setClearStencil(uint32_t clearValue)
 {
     _depthStencilAttachment.clearStencil = clearValue;
-    _depthStencilAttachment.needClearStencil = true;
+    _depthStencilAttachment.stencilLoadAction = LoadAction::CLEAR;
+}
+
+void RenderPassDescriptor::setColorLoadAction(LoadAction loadAction)
+{
+    _colorAttachments.loadAction = loadAction;
+}
+
+void RenderPassDescriptor::setColorStoreAction(StoreAction storeAction)
+{
+    _colorAttachments.storeAction = storeAction;
+}
+
+void RenderPassDescriptor::setDepthLoadAction(LoadAction loadAction)
+{
+    _depthStencilAttachment.depthLoadAction = loadAction;
+}
+
+void RenderPassDescriptor::setDepthStoreAction(StoreAction storeAction)
+{
+    _depthStencilAttachment.depthStoreAction = storeAction;
+}
+
+void RenderPassDescriptor::setStencilLoadAction(LoadAction loadAction)
+{
+    _depthStencilAttachment.stencilLoadAction = loadAction;
+}
+
+void RenderPassDescriptor::setStencilStoreAction(StoreAction storeAction)
+{
+    _depthStencilAttachment.stencilStoreAction = storeAction;
 }
 
 bool RenderPassDescriptor::hasStencil() const
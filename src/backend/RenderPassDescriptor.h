@@ -22,7 +22,8 @@ struct RenderPassColorAttachments
     std::vector<Texture*> textures;
     
     std::array<float, 4> clearColor = {0.f, 0.f, 0.f, 0.f};
-    bool needClearColor = false;
+    LoadAction loadAction = LoadAction::LOAD;
+    StoreAction storeAction = StoreAction::STORE;
     
 private:
     void releaseTextures() const;
@@ -37,10 +38,12 @@ struct RenderPassDepthStencilAttachment
     RenderPassDepthStencilAttachment& operator =(const RenderPassDepthStencilAttachment& rhs);
     
     float clearDepth = 1.f;
-    bool needClearDepth = false;
+    LoadAction depthLoadAction = LoadAction::LOAD;
+    StoreAction depthStoreAction = StoreAction::STORE;
     
     uint32_t clearStencil = 0;
-    bool needClearStencil = false;
+    LoadAction stencilLoadAction = LoadAction::LOAD;
+    StoreAction stencilStoreAction = StoreAction::STORE;
     
     Texture *texture = nullptr;
 };
@@ -54,6 +57,14 @@ public:
     void setClearDepth(float clearValue);
     void setClearStencil(uint32_t clearValue);
     
+    // Setting a clear value also sets the corresponding load action to LoadAction::CLEAR.
+    void setColorLoadAction(LoadAction loadAction);
+    void setColorStoreAction(StoreAction storeAction);
+    void setDepthLoadAction(LoadAction loadAction);
+    void setDepthStoreAction(StoreAction storeAction);
+    void setStencilLoadAction(LoadAction loadAction);
+    void setStencilStoreAction(StoreAction storeAction);
+    
     bool hasStencil() const;
     
     inline const RenderPassDepthStencilAttachment& getDepthStencilAttachment() const { return _depthStencilAttachment; }
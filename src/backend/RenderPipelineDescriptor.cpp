@@ -2,6 +2,7 @@
 #include "ShaderModule.h"
 #include "DepthStencilState.h"
 #include "BlendState.h"
+#include "HashUtils.h"
 
 #include <assert.h>
 
@@ -63,4 +64,22 @@ void RenderPipelineDescriptor::setVertexLayout(uint32_t index, const VertexLayou
     _vertexLayouts[index] = vertexLayout;
 }
 
+std::size_t RenderPipelineDescriptor::getProgramHash() const
+{
+    std::size_t seed = 0;
+    hashCombine(seed, _vertexShaderModule);
+    hashCombine(seed, _fragmentShaderModule);
+    return seed;
+}
+
+std::size_t RenderPipelineDescriptor::hash() const
+{
+    std::size_t seed = getProgramHash();
+    for (const auto& vertexLayout : _vertexLayouts)
+        hashCombine(seed, vertexLayout.hash());
+    hashCombine(seed, _depthStencilState);
+    hashCombine(seed, _blendState);
+    return seed;
+}
+
 CC_BACKEND_END
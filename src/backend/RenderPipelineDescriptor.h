@@ -4,6 +4,7 @@
 #include "Types.h"
 #include "VertexLayout.h"
 
+#include <cstddef>
 #include <vector>
 
 CC_BACKEND_BEGIN
@@ -29,6 +30,12 @@ public:
     inline DepthStencilState* getDepthStencilState() const { return _depthStencilState; }
     inline BlendState* getBlendState() const { return _blendState; }
     
+    // Hash of shader modules, which are the states baked into a linked program.
+    std::size_t getProgramHash() const;
+    // Hash of all states: shader modules, vertex layouts, depth stencil state and blend state.
+    // States are compared by identity, which is enough as Device caches states with the same descriptor.
+    std::size_t hash() const;
+    
 private:
     ShaderModule* _vertexShaderModule = nullptr;
     ShaderModule* _fragmentShaderModule = nullptr;
@@ -0,0 +1,33 @@
+#include "Sampler.h"
+#include "HashUtils.h"
+
+CC_BACKEND_BEGIN
+
+bool SamplerDescriptor::operator==(const SamplerDescriptor& rhs) const
+{
+    return (mipmapEnabled == rhs.mipmapEnabled &&
+            magFilter == rhs.magFilter &&
+            minFilter == rhs.minFilter &&
+            mipmapFilter == rhs.mipmapFilter &&
+            sAddressMode == rhs.sAddressMode &&
+            tAddressMode == rhs.tAddressMode);
+}
+
+std::size_t SamplerDescriptor::hash() const
+{
+    std::size_t seed = 0;
+    hashCombine(seed, mipmapEnabled);
+    hashCombine(seed, (uint32_t)magFilter);
+    hashCombine(seed, (uint32_t)minFilter);
+    hashCombine(seed, (uint32_t)mipmapFilter);
+    hashCombine(seed, (uint32_t)sAddressMode);
+    hashCombine(seed, (uint32_t)tAddressMode);
+    return seed;
+}
+
+Sampler::Sampler(const SamplerDescriptor& descriptor)
+: _descriptor(descriptor)
+{
+}
+
+CC_BACKEND_END
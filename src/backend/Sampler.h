@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Macros.h"
+#include "Types.h"
+#include "base/CCRef.h"
+
+#include <cstddef>
+
+CC_BACKEND_BEGIN
+
+struct SamplerDescriptor
+{
+    bool operator ==(const SamplerDescriptor& rhs) const;
+    std::size_t hash() const;
+    
+    bool mipmapEnabled = false;
+    SamplerFilter magFilter = SamplerFilter::LINEAR;
+    SamplerFilter minFilter = SamplerFilter::LINEAR;
+    SamplerFilter mipmapFilter = SamplerFilter::LINEAR;
+    SamplerAddressMode sAddressMode = SamplerAddressMode::REPEAT;
+    SamplerAddressMode tAddressMode = SamplerAddressMode::REPEAT;
+};
+
+// Sampler states which are independent of textures, so that the same texture can be sampled
+// in different ways. A sampler is bound to a texture uniform through BindGroup.
+class Sampler : public cocos2d::Ref
+{
+public:
+    inline const SamplerDescriptor& getDescriptor() const { return _descriptor; }
+    
+protected:
+    Sampler(const SamplerDescriptor& descriptor);
+    virtual ~Sampler() = default;
+    
+    SamplerDescriptor _descriptor;
+};
+
+CC_BACKEND_END
@@ -1,27 +1,34 @@
 #include "Texture.h"
+#include <atomic>
 
 CC_BACKEND_BEGIN
 
 namespace
 {
-    uint8_t computeBytesPerElement(TextureFormat textureFormat)
+    // textures may be created and released on loader threads
+    std::atomic<uint64_t> s_totalMemorySize(0);
+    
+    uint64_t computeMemorySize(const TextureDescriptor& descriptor)
     {
-        uint8_t ret = 0;
-        switch (textureFormat)
+        uint64_t bytesPerElement = Texture::computeBytesPerElement(descriptor.textureFormat);
+        if (TextureFormat::D24S8 == descriptor.textureFormat)
+            bytesPerElement = 4;
+        
+        uint64_t size = 0;
+        uint32_t width = descriptor.width;
+        uint32_t height = descriptor.height;
+        while (true)
         {
-            case TextureFormat::R8G8B8A8:
-                ret = 4;
-                break;
-            case TextureFormat::R8G8B8:
-                ret = 3;
-                break;
-            case TextureFormat::A8:
-                ret = 1;
-                break;
-            default:
+            size += (uint64_t)width * height * bytesPerElement;
+            if (!descriptor.samplerDescriptor.mipmapEnabled || (width <= 1 && height <= 1))
                 break;
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
         }
-        return ret;
+        
+        if (TextureType::TEXTURE_CUBE == descriptor.textureType)
+            size *= 6;
+        return size;
     }
 }
 
@@ -33,10 +40,39 @@ Texture::Texture(const TextureDescriptor& descriptor)
 , _bytesPerElement(computeBytesPerElement(descriptor.textureFormat))
 , _isMipmapEnabled(descriptor.samplerDescriptor.mipmapEnabled)
 , _textureUsage(descriptor.textureUsage)
+, _memorySize(computeMemorySize(descriptor))
 {
+    s_totalMemorySize += _memorySize;
 }
 
 Texture::~Texture()
-{}
+{
+    s_totalMemorySize -= _memorySize;
+}
+
+uint64_t Texture::getTotalMemorySize()
+{
+    return s_totalMemorySize;
+}
+
+uint8_t Texture::computeBytesPerElement(TextureFormat textureFormat)
+{
+    uint8_t ret = 0;
+    switch (textureFormat)
+    {
+        case TextureFormat::R8G8B8A8:
+            ret = 4;
+            break;
+        case TextureFormat::R8G8B8:
+            ret = 3;
+            break;
+        case TextureFormat::A8:
+            ret = 1;
+            break;
+        default:
+            break;
+    }
+    return ret;
+}
 
 CC_BACKEND_END
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Types.h"
+#include "Sampler.h"
 #include "base/CCRef.h"
 
 CC_BACKEND_BEGIN
@@ -14,6 +15,7 @@ struct TextureDescriptor
     uint32_t height = 0;
     uint32_t depth = 0;
     
+    // Default sampler states, used when no sampler is bound with the texture.
     SamplerDescriptor samplerDescriptor;
 };
 
@@ -22,11 +24,23 @@ class Texture : public cocos2d::Ref
 public:
     virtual void updateData(uint8_t* data) = 0;
     virtual void updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) = 0;
+    // Same as updateSubData() but mipmaps are not generated, invoke generateMipmaps() after the last upload.
+    virtual void uploadSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) = 0;
+    // Generate mipmaps from level 0, do nothing if mipmap is not enabled.
+    virtual void generateMipmaps() = 0;
+    
+    // The bytes of all components of the data passed to updateData().
+    static uint8_t computeBytesPerElement(TextureFormat textureFormat);
     
     inline TextureFormat getTextureFormat() const { return _textureFormat; }
     inline TextureUsage getTextureUsage() const { return _textureUsage; }
     inline uint32_t getWidth() const { return _width; }
     inline uint32_t getHeight() const { return _height; }
+    inline bool isMipmapEnabled() const { return _isMipmapEnabled; }
+    // Bytes of GPU memory of all faces and mipmap levels.
+    inline uint64_t getMemorySize() const { return _memorySize; }
+    // Bytes of GPU memory of all living textures.
+    static uint64_t getTotalMemorySize();
     
 protected:
     Texture(const TextureDescriptor& descriptor);
@@ -40,6 +54,7 @@ protected:
     TextureFormat _textureFormat = TextureFormat::R8G8B8;
     TextureUsage _textureUsage = TextureUsage::READ;
     bool _isMipmapEnabled = false;
+    uint64_t _memorySize = 0;
 };
 
 CC_BACKEND_END
@@ -0,0 +1,217 @@
+#include "TextureUploadQueue.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    // Cost of generating a whole mipmap chain, in bytes of level 0.
+    uint32_t computeMipmapCost(const Texture* texture)
+    {
+        return texture->getWidth() * texture->getHeight() * Texture::computeBytesPerElement(texture->getTextureFormat()) / 3;
+    }
+}
+
+TextureUploadQueue::~TextureUploadQueue()
+{
+    for (auto& request : _requests)
+    {
+        free(request.data);
+        request.texture->release();
+    }
+    for (auto& texture : _pendingMipmaps)
+        texture->release();
+}
+
+void TextureUploadQueue::uploadData(Texture* texture, uint8_t* data, bool takeOwnership)
+{
+    uploadSubData(texture, 0, 0, texture->getWidth(), texture->getHeight(), data, takeOwnership);
+}
+
+void TextureUploadQueue::uploadSubData(Texture* texture, uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data, bool takeOwnership)
+{
+    if (!texture || !data || 0 == width || 0 == height)
+    {
+        if (takeOwnership)
+            free(data);
+        return;
+    }
+    
+    uint32_t bytesPerElement = Texture::computeBytesPerElement(texture->getTextureFormat());
+    if (0 == bytesPerElement)
+    {
+        texture->updateSubData(xoffset, yoffset, width, height, data);
+        if (takeOwnership)
+            free(data);
+        return;
+    }
+    
+    UploadRequest request;
+    request.texture = texture;
+    request.xoffset = xoffset;
+    request.yoffset = yoffset;
+    request.width = width;
+    request.height = height;
+    request.bytesPerRow = width * bytesPerElement;
+    
+    uint32_t size = request.bytesPerRow * height;
+    if (takeOwnership)
+        request.data = data;
+    else
+    {
+        request.data = (uint8_t*)malloc(size);
+        if (!request.data)
+            return;
+        memcpy(request.data, data, size);
+    }
+    
+    texture->retain();
+    _requests.push_back(request);
+    _pendingBytes += size;
+}
+
+void TextureUploadQueue::cancel(Texture* texture)
+{
+    for (auto iter = _requests.begin(); iter != _requests.end();)
+    {
+        if (texture == iter->texture)
+        {
+            _pendingBytes -= (iter->height - iter->uploadedRows) * iter->bytesPerRow;
+            free(iter->data);
+            iter->texture->release();
+            iter = _requests.erase(iter);
+        }
+        else
+            ++iter;
+    }
+    
+    auto iter = std::find(_pendingMipmaps.begin(), _pendingMipmaps.end(), texture);
+    if (_pendingMipmaps.end() != iter)
+    {
+        _pendingMipmaps.erase(iter);
+        texture->release();
+    }
+}
+
+bool TextureUploadQueue::isPending(const Texture* texture) const
+{
+    for (const auto& request : _requests)
+    {
+        if (texture == request.texture)
+            return true;
+    }
+    return _pendingMipmaps.end() != std::find(_pendingMipmaps.begin(), _pendingMipmaps.end(), texture);
+}
+
+void TextureUploadQueue::process()
+{
+    auto start = std::chrono::steady_clock::now();
+    auto isOverTime = [&]() -> bool {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        return elapsed >= _microsecondsPerFrame;
+    };
+    
+    uint32_t budget = _bytesPerFrame;
+    bool uploaded = false;
+    
+    // Mipmaps of textures finished in previous frames.
+    auto mipmaps = std::move(_pendingMipmaps);
+    _pendingMipmaps.clear();
+    for (auto iter = mipmaps.begin(); iter != mipmaps.end(); ++iter)
+    {
+        if (uploaded && (0 == budget || isOverTime()))
+        {
+            _pendingMipmaps.insert(_pendingMipmaps.end(), iter, mipmaps.end());
+            return;
+        }
+        
+        budget -= std::min(budget, computeMipmapCost(*iter));
+        generateMipmaps(*iter);
+        uploaded = true;
+    }
+    
+    while (!_requests.empty())
+    {
+        if (uploaded && (0 == budget || isOverTime()))
+            break;
+        
+        auto& request = _requests.front();
+        uint32_t rows = std::max(1u, budget / request.bytesPerRow);
+        budget -= std::min(budget, uploadRows(request, rows));
+        uploaded = true;
+        
+        if (request.uploadedRows == request.height)
+        {
+            finish(request);
+            _requests.pop_front();
+        }
+    }
+}
+
+void TextureUploadQueue::flush()
+{
+    while (!_requests.empty())
+    {
+        auto& request = _requests.front();
+        uploadRows(request, request.height);
+        finish(request);
+        _requests.pop_front();
+    }
+    
+    auto mipmaps = std::move(_pendingMipmaps);
+    _pendingMipmaps.clear();
+    for (auto& texture : mipmaps)
+        generateMipmaps(texture);
+}
+
+uint32_t TextureUploadQueue::uploadRows(UploadRequest& request, uint32_t rows)
+{
+    rows = std::min(rows, request.height - request.uploadedRows);
+    request.texture->uploadSubData(request.xoffset,
+                                   request.yoffset + request.uploadedRows,
+                                   request.width,
+                                   rows,
+                                   request.data + request.uploadedRows * request.bytesPerRow);
+    request.uploadedRows += rows;
+    
+    uint32_t bytes = rows * request.bytesPerRow;
+    _pendingBytes -= bytes;
+    return bytes;
+}
+
+void TextureUploadQueue::finish(UploadRequest& request)
+{
+    free(request.data);
+    request.data = nullptr;
+    
+    // The reference is passed to mipmap generation if needed.
+    Texture* texture = request.texture;
+    if (texture->isMipmapEnabled() &&
+        _pendingMipmaps.end() == std::find(_pendingMipmaps.begin(), _pendingMipmaps.end(), texture))
+        _pendingMipmaps.push_back(texture);
+    else
+        texture->release();
+}
+
+void TextureUploadQueue::generateMipmaps(Texture* texture)
+{
+    // Wait for other uploads of the same texture.
+    for (const auto& request : _requests)
+    {
+        if (texture == request.texture)
+        {
+            texture->release();
+            return;
+        }
+    }
+    
+    texture->generateMipmaps();
+    texture->release();
+}
+
+CC_BACKEND_END
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Macros.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+CC_BACKEND_BEGIN
+
+class Texture;
+
+// Uploads texture data in slices over several frames, so that creating many textures doesn't stall
+// a frame. Mipmaps of a texture are generated in the frame after its last slice is uploaded.
+// process() should be invoked once per frame before rendering.
+class TextureUploadQueue
+{
+public:
+    TextureUploadQueue() = default;
+    ~TextureUploadQueue();
+    
+    // Queue the data of level 0. If `takeOwnership` is true, `data` should be allocated by malloc()
+    // and is freed after uploaded, otherwise the data is copied. Textures whose format has no fixed
+    // bytes per pixel, such as D24S8, can't be sliced and are uploaded immediately.
+    void uploadData(Texture* texture, uint8_t* data, bool takeOwnership = false);
+    void uploadSubData(Texture* texture, uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data, bool takeOwnership = false);
+    // Drop the pending uploads and mipmap generation of a texture.
+    void cancel(Texture* texture);
+    bool isPending(const Texture* texture) const;
+    
+    // Upload at most `bytesPerFrame` bytes and at most `microsecondsPerFrame` long, at least one slice
+    // is uploaded every frame.
+    void process();
+    // Upload all pending data immediately, for example before taking a screenshot.
+    void flush();
+    
+    inline void setBytesPerFrame(uint32_t bytes) { _bytesPerFrame = bytes; }
+    inline uint32_t getBytesPerFrame() const { return _bytesPerFrame; }
+    inline void setMicrosecondsPerFrame(uint32_t microseconds) { _microsecondsPerFrame = microseconds; }
+    inline uint32_t getMicrosecondsPerFrame() const { return _microsecondsPerFrame; }
+    inline std::size_t getPendingBytes() const { return _pendingBytes; }
+    
+private:
+    struct UploadRequest
+    {
+        Texture* texture = nullptr;
+        uint32_t xoffset = 0;
+        uint32_t yoffset = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t bytesPerRow = 0;
+        uint32_t uploadedRows = 0;
+        uint8_t* data = nullptr;
+    };
+    
+    // Return the bytes uploaded.
+    uint32_t uploadRows(UploadRequest& request, uint32_t rows);
+    void finish(UploadRequest& request);
+    void generateMipmaps(Texture* texture);
+    
+    std::deque<UploadRequest> _requests;
+    // Textures whose uploading finished and waiting for mipmap generation.
+    std::vector<Texture*> _pendingMipmaps;
+    std::size_t _pendingBytes = 0;
+    uint32_t _bytesPerFrame = 4 * 1024 * 1024;
+    uint32_t _microsecondsPerFrame = 4000;
+};
+
+CC_BACKEND_END
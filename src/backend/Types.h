@@ -157,14 +157,22 @@ enum class ColorWriteMask: uint32_t
     ALL = 0x0000000F
 };
 
-struct SamplerDescriptor
-{
-    bool mipmapEnabled = false;
-    SamplerFilter magFilter = SamplerFilter::LINEAR;
-    SamplerFilter minFilter = SamplerFilter::LINEAR;
-    SamplerFilter mipmapFilter = SamplerFilter::LINEAR;
-    SamplerAddressMode sAddressMode = SamplerAddressMode::REPEAT;
-    SamplerAddressMode tAddressMode = SamplerAddressMode::REPEAT;
+enum class LoadAction: uint32_t
+{
+    // Preserve the existing contents of the attachment.
+    LOAD,
+    // Clear the attachment with its clear value.
+    CLEAR,
+    // Existing contents are undefined, so they don't have to be loaded.
+    DONT_CARE
+};
+
+enum class StoreAction: uint32_t
+{
+    // Keep the rendered contents after the render pass ends.
+    STORE,
+    // The rendered contents are not needed after the render pass ends.
+    DONT_CARE
 };
 
 enum class CullMode: uint32_t
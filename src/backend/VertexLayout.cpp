@@ -1,4 +1,5 @@
 #include "VertexLayout.h"
+#include "HashUtils.h"
 
 CC_BACKEND_BEGIN
 
@@ -13,4 +14,34 @@ void VertexLayout::setLayout(uint32_t stride, VertexStepMode stepMode)
     _stepMode = stepMode;
 }
 
+bool VertexLayout::Attribute::operator==(const Attribute& rhs) const
+{
+    return (name == rhs.name &&
+            format == rhs.format &&
+            offset == rhs.offset &&
+            index == rhs.index);
+}
+
+bool VertexLayout::operator==(const VertexLayout& rhs) const
+{
+    return (_stride == rhs._stride &&
+            _stepMode == rhs._stepMode &&
+            _attributes == rhs._attributes);
+}
+
+std::size_t VertexLayout::hash() const
+{
+    std::size_t seed = 0;
+    hashCombine(seed, _stride);
+    hashCombine(seed, (uint32_t)_stepMode);
+    for (const auto& attribute : _attributes)
+    {
+        hashCombine(seed, attribute.name);
+        hashCombine(seed, (uint32_t)attribute.format);
+        hashCombine(seed, attribute.offset);
+        hashCombine(seed, attribute.index);
+    }
+    return seed;
+}
+
 CC_BACKEND_END
@@ -4,6 +4,7 @@
 #include "Types.h"
 #include "base/CCRef.h"
 
+#include <cstddef>
 #include <string>
 #include <cstdint>
 #include <vector>
@@ -22,6 +23,8 @@ public:
         , offset(_offset)
         {}
         
+        bool operator ==(const Attribute& rhs) const;
+        
         // name is used in opengl
         std::string name;
         VertexFormat format = VertexFormat::INT_R32G32B32;
@@ -38,6 +41,8 @@ public:
     inline VertexStepMode getVertexStepMode() const { return _stepMode; }
     inline const std::vector<Attribute>& getAttributes() const { return _attributes; }
     inline bool isValid() const { return _stride != 0; }
+    bool operator ==(const VertexLayout& rhs) const;
+    std::size_t hash() const;
     
 private:
     std::vector<Attribute> _attributes;
@@ -207,6 +207,7 @@ void CommandBufferMTL::setTextures() const
 void CommandBufferMTL::doSetTextures(const std::vector<std::string>& textures, bool isVertex) const
 {
     const auto& bindTextureInfos = _bindGroup->getTextureInfos();
+    const auto& bindSamplerInfos = _bindGroup->getSamplerInfos();
     int i = 0;
     for (const auto& texture : textures)
     {
@@ -217,18 +218,24 @@ void CommandBufferMTL::doSetTextures(const std::vector<std::string>& textures, b
             const auto& textures = iter->second.textures;
             const auto& mtlTexture = static_cast<TextureMTL*>(textures[0]);
             
+            // A sampler bound with the same name overrides the default sampler of the texture.
+            id<MTLSamplerState> mtlSamplerState = mtlTexture->getMTLSamplerState();
+            auto samplerIter = bindSamplerInfos.find(texture);
+            if (bindSamplerInfos.end() != samplerIter && !samplerIter->second.samplers.empty() && samplerIter->second.samplers[0])
+                mtlSamplerState = static_cast<SamplerMTL*>(samplerIter->second.samplers[0])->getMTLSamplerState();
+            
             if (isVertex)
             {
                 [_mtlRenderEncoder setVertexTexture:mtlTexture->getMTLTexture()
                                             atIndex:i];
-                [_mtlRenderEncoder setVertexSamplerState:mtlTexture->getMTLSamplerState()
+                [_mtlRenderEncoder setVertexSamplerState:mtlSamplerState
                                                  atIndex:i];
             }
             else
             {
                 [_mtlRenderEncoder setFragmentTexture:mtlTexture->getMTLTexture()
                                               atIndex:i];
-                [_mtlRenderEncoder setFragmentSamplerState:mtlTexture->getMTLSamplerState()
+                [_mtlRenderEncoder setFragmentSamplerState:mtlSamplerState
                                                    atIndex:i];
             }
             
@@ -2,6 +2,9 @@
 
 #include "../Device.h"
 #import <Metal/Metal.h>
+
+#include <cstddef>
+#include <unordered_map>
 #import <QuartzCore/CAMetalLayer.h>
 
 CC_BACKEND_BEGIN
@@ -23,10 +26,14 @@ public:
     virtual Buffer* newBuffer(uint32_t size, BufferType type, BufferUsage usage) override;
     virtual RenderPass* newRenderPass(const RenderPassDescriptor& descriptor) override;
     virtual Texture* newTexture(const TextureDescriptor& descriptor) override;
+    // Samplers are cached by descriptor, a cached sampler is retained before returned.
+    virtual Sampler* newSampler(const SamplerDescriptor& descriptor) override;
     virtual ShaderModule* createShaderModule(ShaderStage stage, const std::string& source) override;
     virtual DepthStencilState* createDepthStencilState(const DepthStencilDescriptor& descriptor) override;
     virtual BlendState* createBlendState(const BlendDescriptor& descriptor) override;
     virtual RenderPipeline* newRenderPipeline(const RenderPipelineDescriptor& descriptor) override;
+    
+    virtual void purgeCachedObjects() override;
         
     inline id<MTLDevice> getMTLDevice() const { return _mtlDevice; }
     inline id<MTLCommandQueue> getMTLCommandQueue() const { return _mtlCommandQueue; }
@@ -37,6 +44,9 @@ private:
     
     id<MTLDevice> _mtlDevice = nil;
     id<MTLCommandQueue> _mtlCommandQueue = nil;
+    
+    // Samplers keep their descriptors, which are compared when hashes are equal.
+    std::unordered_multimap<std::size_t, Sampler*> _samplerCache;
 };
 
 CC_BACKEND_END
@@ -6,6 +6,7 @@
 #include "RenderPassMTL.h"
 #include "DepthStencilStateMTL.h"
 #include "TextureMTL.h"
+#include "SamplerMTL.h"
 #include "BlendStateMTL.h"
 #include "Utils.h"
 
@@ -48,6 +49,8 @@ DeviceMTL::DeviceMTL()
 
 DeviceMTL::~DeviceMTL()
 {
+    for (auto& sampler : _samplerCache)
+        sampler.second->release();
 }
 
 CommandBuffer* DeviceMTL::newCommandBuffer()
@@ -62,7 +65,47 @@ Buffer* DeviceMTL::newBuffer(uint32_t size, BufferType type, BufferUsage usage)
 
 Texture* DeviceMTL::newTexture(const TextureDescriptor& descriptor)
 {
-    return new (std::nothrow) TextureMTL(_mtlDevice, descriptor);
+    auto defaultSampler = static_cast<SamplerMTL*>(newSampler(descriptor.samplerDescriptor));
+    auto texture = new (std::nothrow) TextureMTL(_mtlDevice, descriptor, defaultSampler);
+    CC_SAFE_RELEASE(defaultSampler);
+    return texture;
+}
+
+Sampler* DeviceMTL::newSampler(const SamplerDescriptor& descriptor)
+{
+    auto key = descriptor.hash();
+    auto range = _samplerCache.equal_range(key);
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (descriptor == iter->second->getDescriptor())
+        {
+            iter->second->retain();
+            return iter->second;
+        }
+    }
+    
+    auto sampler = new (std::nothrow) SamplerMTL(_mtlDevice, descriptor);
+    if (!sampler)
+        return nullptr;
+    
+    // One reference is held by the cache, the other one is returned to the caller.
+    sampler->retain();
+    _samplerCache.emplace(key, sampler);
+    return sampler;
+}
+
+void DeviceMTL::purgeCachedObjects()
+{
+    for (auto iter = _samplerCache.begin(); _samplerCache.end() != iter;)
+    {
+        if (1 == iter->second->getReferenceCount())
+        {
+            iter->second->release();
+            iter = _samplerCache.erase(iter);
+        }
+        else
+            ++iter;
+    }
 }
 
 RenderPass* DeviceMTL::newRenderPass(const RenderPassDescriptor& descriptor)
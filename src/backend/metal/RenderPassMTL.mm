@@ -5,6 +5,30 @@
 
 CC_BACKEND_BEGIN
 
+namespace
+{
+    MTLLoadAction toMTLLoadAction(LoadAction loadAction)
+    {
+        switch (loadAction)
+        {
+            case LoadAction::CLEAR:
+                return MTLLoadActionClear;
+            case LoadAction::DONT_CARE:
+                return MTLLoadActionDontCare;
+            default:
+                return MTLLoadActionLoad;
+        }
+    }
+    
+    MTLStoreAction toMTLStoreAction(StoreAction storeAction)
+    {
+        if (StoreAction::DONT_CARE == storeAction)
+            return MTLStoreActionDontCare;
+        else
+            return MTLStoreActionStore;
+    }
+}
+
 RenderPassMTL::RenderPassMTL(id<MTLDevice> mtlDevice, const RenderPassDescriptor& descriptor)
 : RenderPass(descriptor)
 {
@@ -49,19 +73,17 @@ void RenderPassMTL::setColorAttachments(const RenderPassDescriptor& descriptor)
             if (!texture)
                 continue;
             
-            if (renderPassColorAttachments.needClearColor)
+            _mtlRenderPassDescritpr.colorAttachments[i].loadAction = toMTLLoadAction(renderPassColorAttachments.loadAction);
+            if (LoadAction::CLEAR == renderPassColorAttachments.loadAction)
             {
-                _mtlRenderPassDescritpr.colorAttachments[i].loadAction = MTLLoadActionClear;
                 _mtlRenderPassDescritpr.colorAttachments[i].clearColor = MTLClearColorMake(renderPassColorAttachments.clearColor[0],
                                                                                            renderPassColorAttachments.clearColor[1],
                                                                                            renderPassColorAttachments.clearColor[2],
                                                                                            renderPassColorAttachments.clearColor[3]);
             }
-            else
-                _mtlRenderPassDescritpr.colorAttachments[i].loadAction = MTLLoadActionLoad;
             
             _mtlRenderPassDescritpr.colorAttachments[i].texture = static_cast<TextureMTL*>(texture)->getMTLTexture();
-            _mtlRenderPassDescritpr.colorAttachments[i].storeAction = MTLStoreActionStore;
+            _mtlRenderPassDescritpr.colorAttachments[i].storeAction = toMTLStoreAction(renderPassColorAttachments.storeAction);
             
             ++i;
         }
@@ -69,7 +91,7 @@ void RenderPassMTL::setColorAttachments(const RenderPassDescriptor& descriptor)
     else
     {
         _mtlRenderPassDescritpr.colorAttachments[0].texture = Utils::getTempColorAttachmentTexture();
-        if (renderPassColorAttachments.needClearColor)
+        if (LoadAction::CLEAR == renderPassColorAttachments.loadAction)
         {
             _mtlRenderPassDescritpr.colorAttachments[0].loadAction = MTLLoadActionClear;
             _mtlRenderPassDescritpr.colorAttachments[0].clearColor = MTLClearColorMake(renderPassColorAttachments.clearColor[0],
@@ -91,23 +113,17 @@ void RenderPassMTL::setDepthStencilAttachment(const RenderPassDescriptor &descri
         _mtlRenderPassDescritpr.stencilAttachment.texture = textureMTL->getMTLTexture();
     }
     
-    // Set depth clear value.
-    if (renderPassDepthStencilAttachment.needClearDepth)
-    {
-        _mtlRenderPassDescritpr.depthAttachment.loadAction = MTLLoadActionClear;
+    // Set depth load/store actions and clear value.
+    _mtlRenderPassDescritpr.depthAttachment.loadAction = toMTLLoadAction(renderPassDepthStencilAttachment.depthLoadAction);
+    _mtlRenderPassDescritpr.depthAttachment.storeAction = toMTLStoreAction(renderPassDepthStencilAttachment.depthStoreAction);
+    if (LoadAction::CLEAR == renderPassDepthStencilAttachment.depthLoadAction)
         _mtlRenderPassDescritpr.depthAttachment.clearDepth = renderPassDepthStencilAttachment.clearDepth;
-    }
-    else
-        _mtlRenderPassDescritpr.depthAttachment.loadAction = MTLLoadActionLoad;
     
-    // Set stencil clear value.
-    if (renderPassDepthStencilAttachment.needClearStencil)
-    {
-        _mtlRenderPassDescritpr.stencilAttachment.loadAction = MTLLoadActionClear;
+    // Set stencil load/store actions and clear value.
+    _mtlRenderPassDescritpr.stencilAttachment.loadAction = toMTLLoadAction(renderPassDepthStencilAttachment.stencilLoadAction);
+    _mtlRenderPassDescritpr.stencilAttachment.storeAction = toMTLStoreAction(renderPassDepthStencilAttachment.stencilStoreAction);
+    if (LoadAction::CLEAR == renderPassDepthStencilAttachment.stencilLoadAction)
         _mtlRenderPassDescritpr.stencilAttachment.clearStencil = renderPassDepthStencilAttachment.clearStencil;
-    }
-    else
-        _mtlRenderPassDescritpr.stencilAttachment.loadAction = MTLLoadActionLoad;
 }
 
 CC_BACKEND_END
@@ -87,7 +87,7 @@ RenderPipelineMTL::RenderPipelineMTL(id<MTLDevice> mtlDevice, const RenderPipeli
     // Depth stencil state.
     auto depthStencilState = descriptor.getDepthStencilState();
     if (depthStencilState)
-        _mtlDepthStencilState = static_cast<DepthStencilStateMTL*>(depthStencilState)->getMTLDepthStencilState();
+        _mtlDepthStencilState = [static_cast<DepthStencilStateMTL*>(depthStencilState)->getMTLDepthStencilState() retain];
     
     auto blendState = static_cast<BlendStateMTL*>(descriptor.getBlendState());
     if (blendState)
@@ -97,6 +97,7 @@ RenderPipelineMTL::RenderPipelineMTL(id<MTLDevice> mtlDevice, const RenderPipeli
 RenderPipelineMTL::~RenderPipelineMTL()
 {
     [_mtlRenderPipelineState release];
+    [_mtlDepthStencilState release];
 }
 
 void RenderPipelineMTL::apply(const RenderPass* renderPass)
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../Sampler.h"
+#import <Metal/Metal.h>
+
+CC_BACKEND_BEGIN
+
+class SamplerMTL : public Sampler
+{
+public:
+    SamplerMTL(id<MTLDevice> mtlDevice, const SamplerDescriptor& descriptor);
+    ~SamplerMTL();
+    
+    inline id<MTLSamplerState> getMTLSamplerState() const { return _mtlSamplerState; }
+    
+private:
+    id<MTLSamplerState> _mtlSamplerState = nil;
+};
+
+CC_BACKEND_END
@@ -0,0 +1,69 @@
+#include "SamplerMTL.h"
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    MTLSamplerAddressMode toMTLSamplerAddressMode(SamplerAddressMode mode)
+    {
+        MTLSamplerAddressMode ret = MTLSamplerAddressModeRepeat;
+        switch (mode) {
+            case SamplerAddressMode::REPEAT:
+                ret = MTLSamplerAddressModeRepeat;
+                break;
+            case SamplerAddressMode::MIRROR_REPEAT:
+                ret = MTLSamplerAddressModeMirrorRepeat;
+                break;
+            case SamplerAddressMode::CLAMP_TO_EDGE:
+                ret = MTLSamplerAddressModeClampToEdge;
+                break;
+            default:
+                assert(false);
+                break;
+        }
+        return ret;
+    }
+    
+    MTLSamplerMinMagFilter toMTLSamplerMinMagFilter(SamplerFilter mode)
+    {
+        switch (mode) {
+            case SamplerFilter::NEAREST:
+                return MTLSamplerMinMagFilterNearest;
+            case SamplerFilter::LINEAR:
+                return MTLSamplerMinMagFilterLinear;
+        }
+    }
+    
+    MTLSamplerMipFilter toMTLSamplerMipFilter(SamplerFilter mode) {
+        switch (mode) {
+            case SamplerFilter::NEAREST:
+                return MTLSamplerMipFilterNearest;
+            case SamplerFilter::LINEAR:
+                return MTLSamplerMipFilterLinear;
+        }
+    }
+}
+
+SamplerMTL::SamplerMTL(id<MTLDevice> mtlDevice, const SamplerDescriptor& descriptor)
+: Sampler(descriptor)
+{
+    MTLSamplerDescriptor *mtlDescriptor = [MTLSamplerDescriptor new];
+    mtlDescriptor.sAddressMode = toMTLSamplerAddressMode(descriptor.sAddressMode);
+    mtlDescriptor.tAddressMode = toMTLSamplerAddressMode(descriptor.tAddressMode);
+    
+    mtlDescriptor.minFilter = toMTLSamplerMinMagFilter(descriptor.minFilter);
+    mtlDescriptor.magFilter = toMTLSamplerMinMagFilter(descriptor.magFilter);
+    if (descriptor.mipmapEnabled)
+        mtlDescriptor.mipFilter = toMTLSamplerMipFilter(descriptor.mipmapFilter);
+    
+    _mtlSamplerState = [mtlDevice newSamplerStateWithDescriptor:mtlDescriptor];
+    
+    [mtlDescriptor release];
+}
+
+SamplerMTL::~SamplerMTL()
+{
+    [_mtlSamplerState release];
+}
+
+CC_BACKEND_END
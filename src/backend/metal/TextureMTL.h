@@ -2,6 +2,7 @@
 
 #include "../Texture.h"
 #include "DeviceMTL.h"
+#include "SamplerMTL.h"
 #import <Metal/Metal.h>
 
 CC_BACKEND_BEGIN
@@ -9,22 +10,23 @@ CC_BACKEND_BEGIN
 class TextureMTL : public Texture
 {
 public:
-    TextureMTL(id<MTLDevice> mtlDevice, const TextureDescriptor& descriptor);
+    // `defaultSampler` is created from descriptor.samplerDescriptor and used when no sampler is bound.
+    TextureMTL(id<MTLDevice> mtlDevice, const TextureDescriptor& descriptor, SamplerMTL* defaultSampler);
     ~TextureMTL();
     
     virtual void updateData(uint8_t* data) override;
     virtual void updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) override;
+    virtual void uploadSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) override;
+    virtual void generateMipmaps() override;
     
     inline id<MTLTexture> getMTLTexture() const { return _mtlTexture; }
-    inline id<MTLSamplerState> getMTLSamplerState() const { return _mtlSamplerState; }
+    inline id<MTLSamplerState> getMTLSamplerState() const { return _defaultSampler->getMTLSamplerState(); }
     
 private:
     void createTexture(id<MTLDevice> mtlDevice, const TextureDescriptor& descriptor);
-    void createSampler(id<MTLDevice> mtlDevice, const TextureDescriptor& descriptor);
     
     id<MTLTexture> _mtlTexture = nil;
-    id<MTLSamplerState> _mtlSamplerState = nil;
-    uint32_t _bytesPerRow = 0;
+    SamplerMTL* _defaultSampler = nullptr;
 };
 
 CC_BACKEND_END
@@ -5,45 +5,6 @@ CC_BACKEND_BEGIN
 
 namespace
 {
-    MTLSamplerAddressMode toMTLSamplerAddressMode(SamplerAddressMode mode)
-    {
-        MTLSamplerAddressMode ret = MTLSamplerAddressModeRepeat;
-        switch (mode) {
-            case SamplerAddressMode::REPEAT:
-                ret = MTLSamplerAddressModeRepeat;
-                break;
-            case SamplerAddressMode::MIRROR_REPEAT:
-                ret = MTLSamplerAddressModeMirrorRepeat;
-                break;
-            case SamplerAddressMode::CLAMP_TO_EDGE:
-                ret = MTLSamplerAddressModeClampToEdge;
-                break;
-            default:
-                assert(false);
-                break;
-        }
-        return ret;
-    }
-    
-    MTLSamplerMinMagFilter toMTLSamplerMinMagFilter(SamplerFilter mode)
-    {
-        switch (mode) {
-            case SamplerFilter::NEAREST:
-                return MTLSamplerMinMagFilterNearest;
-            case SamplerFilter::LINEAR:
-                return MTLSamplerMinMagFilterLinear;
-        }
-    }
-    
-    MTLSamplerMipFilter toMTLSamplerMipFilter(SamplerFilter mode) {
-        switch (mode) {
-            case SamplerFilter::NEAREST:
-                return MTLSamplerMipFilterNearest;
-            case SamplerFilter::LINEAR:
-                return MTLSamplerMipFilterLinear;
-        }
-    }
-    
     void convertRGB2RGBA(uint8_t* src, uint8_t* dst, uint32_t length)
     {
         for (uint32 i = 0; i < length; ++i)
@@ -70,23 +31,22 @@ namespace
     }
 }
 
-TextureMTL::TextureMTL(id<MTLDevice> mtlDevice, const TextureDescriptor& descriptor)
+TextureMTL::TextureMTL(id<MTLDevice> mtlDevice, const TextureDescriptor& descriptor, SamplerMTL* defaultSampler)
 : Texture(descriptor)
+, _defaultSampler(defaultSampler)
 {
+    CC_SAFE_RETAIN(_defaultSampler);
     createTexture(mtlDevice, descriptor);
-    createSampler(mtlDevice, descriptor);
     
     // Metal doesn't support RGB888, so should convert to RGBA888;
     if (TextureFormat::R8G8B8 == _textureFormat)
         _bytesPerElement = 4;
-    
-    _bytesPerRow = _bytesPerElement * descriptor.width;
 }
 
 TextureMTL::~TextureMTL()
 {
     [_mtlTexture release];
-    [_mtlSamplerState release];
+    CC_SAFE_RELEASE(_defaultSampler);
 }
 
 void TextureMTL::updateData(uint8_t* data)
@@ -95,6 +55,12 @@ void TextureMTL::updateData(uint8_t* data)
 }
 
 void TextureMTL::updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data)
+{
+    uploadSubData(xoffset, yoffset, width, height, data);
+    generateMipmaps();
+}
+
+void TextureMTL::uploadSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data)
 {
     MTLRegion region =
     {
@@ -110,11 +76,14 @@ void TextureMTL::updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t widt
     [_mtlTexture replaceRegion:region
                    mipmapLevel:0
                      withBytes:convertedData
-                   bytesPerRow:_bytesPerRow];
+                   bytesPerRow:_bytesPerElement * width];
     
     if (converted)
         free(convertedData);
-    
+}
+
+void TextureMTL::generateMipmaps()
+{
     // metal doesn't generate mipmaps automatically, so should generate it manually.
     if (_isMipmapEnabled)
         Utils::generateMipmaps(_mtlTexture);
@@ -135,20 +104,4 @@ void TextureMTL::createTexture(id<MTLDevice> mtlDevice, const TextureDescriptor&
     _mtlTexture = [mtlDevice newTextureWithDescriptor:textureDescriptor];
 }
 
-void TextureMTL::createSampler(id<MTLDevice> mtlDevice, const TextureDescriptor &descriptor)
-{
-    MTLSamplerDescriptor *mtlDescriptor = [MTLSamplerDescriptor new];
-    mtlDescriptor.sAddressMode = toMTLSamplerAddressMode(descriptor.samplerDescriptor.sAddressMode);
-    mtlDescriptor.tAddressMode = toMTLSamplerAddressMode(descriptor.samplerDescriptor.tAddressMode);
-    
-    mtlDescriptor.minFilter = toMTLSamplerMinMagFilter(descriptor.samplerDescriptor.minFilter);
-    mtlDescriptor.magFilter = toMTLSamplerMinMagFilter(descriptor.samplerDescriptor.magFilter);
-    if (_isMipmapEnabled)
-        mtlDescriptor.mipFilter = toMTLSamplerMipFilter(descriptor.samplerDescriptor.mipmapFilter);
-    
-    _mtlSamplerState = [mtlDevice newSamplerStateWithDescriptor:mtlDescriptor];
-    
-    [mtlDescriptor release];
-}
-
 CC_BACKEND_END
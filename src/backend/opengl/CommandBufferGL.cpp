@@ -3,11 +3,15 @@
 #include "RenderPipelineGL.h"
 #include "RenderPassGL.h"
 #include "TextureGL.h"
+#include "SamplerGL.h"
 #include "DepthStencilStateGL.h"
 #include "../RenderPass.h"
 #include "../BindGroup.h"
 #include "Program.h"
 #include "BlendStateGL.h"
+#include "VertexInputLayoutGL.h"
+
+#include <algorithm>
 
 CC_BACKEND_BEGIN
 
@@ -68,6 +72,10 @@ namespace
 CommandBufferGL::CommandBufferGL()
 {
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_defaultFBO);
+    
+    GLint maxVertexAttributes = 0;
+    glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxVertexAttributes);
+    _supportedAttributeMask = maxVertexAttributes >= 32 ? 0xffffffff : (1u << maxVertexAttributes) - 1;
 }
 
 CommandBufferGL::~CommandBufferGL()
@@ -77,11 +85,19 @@ CommandBufferGL::~CommandBufferGL()
 
 void CommandBufferGL::beginRenderPass(RenderPass *renderPass)
 {
+    _renderPass = static_cast<RenderPassGL*>(renderPass);
+    _isEnabledAttributeMaskValid = false;
+    _boundSamplerMask = 0;
+    
     // use default frame buffer
-    if (nullptr == renderPass)
+    if (nullptr == _renderPass)
         glBindFramebuffer(GL_FRAMEBUFFER, _defaultFBO);
     else
-        static_cast<RenderPassGL*>(renderPass)->apply(_defaultFBO);
+    {
+        _renderPass->apply(_defaultFBO);
+        if (_renderPass->invalidateLoadAttachments(_defaultFBO))
+            ++_invalidationCount;
+    }
 }
 
 void CommandBufferGL::setRenderPipeline(RenderPipeline* renderPipeline)
@@ -161,16 +177,20 @@ void CommandBufferGL::drawElements(PrimitiveType primitiveType, IndexFormat inde
 
 void CommandBufferGL::endRenderPass()
 {
+    if (_renderPass && _renderPass->invalidateStoreAttachments(_defaultFBO))
+        ++_invalidationCount;
+    
+    _renderPass = nullptr;
 }
 
-void CommandBufferGL::prepareDrawing() const
+void CommandBufferGL::prepareDrawing()
 {
     glViewport(_viewport.x, _viewport.y, _viewport.w, _viewport.h);
     
     const auto& program = _renderPipeline->getProgram();
     glUseProgram(program->getHandler());
     
-    bindVertexBuffer(program);
+    bindVertexBuffer(_renderPipeline->getVertexInputLayout());
     setUniforms(program);
 
     // Set depth/stencil state.
@@ -198,22 +218,25 @@ void CommandBufferGL::prepareDrawing() const
     }
 }
 
-void CommandBufferGL::bindVertexBuffer(Program *program) const
+void CommandBufferGL::bindVertexBuffer(VertexInputLayoutGL* vertexInputLayout)
 {
-    // Bind vertex buffers and set the attributes.
-    int i = 0;
-    const auto& attributeInfos = program->getAttributeInfos();
-    for (const auto& vertexBuffer : _vertexBuffers)
+    // Bind vertex buffers and set the attributes, vertex buffer i is described by vertex layout i.
+    const auto& attributeInfos = vertexInputLayout->getAttributeInfos();
+    const auto& attributeMasks = vertexInputLayout->getAttributeMasks();
+    const auto count = std::min(attributeInfos.size(), _vertexBuffers.size());
+    uint32_t boundAttributeMask = 0;
+    for (size_t i = 0; i < count; ++i)
     {
-        if (! vertexBuffer)
+        const auto& vertexBuffer = _vertexBuffers[i];
+        const auto& attributeInfo = attributeInfos[i];
+        if (! vertexBuffer || attributeInfo.empty())
             continue;
         
+        boundAttributeMask |= attributeMasks[i];
         glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getHandler());
         
-        const auto& attributeInfo = attributeInfos[i];
         for (const auto& attribute : attributeInfo)
         {
-            glEnableVertexAttribArray(attribute.location);
             glVertexAttribPointer(attribute.location,
                                   attribute.size,
                                   attribute.type,
@@ -221,16 +244,41 @@ void CommandBufferGL::bindVertexBuffer(Program *program) const
                                   attribute.stride,
                                   (GLvoid*)attribute.offset);
         }
+    }
+    
+    // Attributes of a layout without a vertex buffer would read the pointer of an earlier draw.
+    updateEnabledAttributes(vertexInputLayout->getEnabledAttributeMask() & boundAttributeMask);
+}
+
+void CommandBufferGL::updateEnabledAttributes(uint32_t enabledAttributeMask)
+{
+    // Only touch the attributes that changed since last draw, and disable stale ones. The first draw
+    // of a render pass sets all of them, as others may have changed them since.
+    uint32_t changedMask = enabledAttributeMask ^ _enabledAttributeMask;
+    if (!_isEnabledAttributeMaskValid)
+        changedMask = _supportedAttributeMask | enabledAttributeMask;
+    
+    for (GLuint location = 0; changedMask; ++location, changedMask >>= 1)
+    {
+        if (!(changedMask & 1))
+            continue;
         
-        ++i;
+        if (enabledAttributeMask & (1u << location))
+            glEnableVertexAttribArray(location);
+        else
+            glDisableVertexAttribArray(location);
     }
+    
+    _enabledAttributeMask = enabledAttributeMask;
+    _isEnabledAttributeMaskValid = true;
 }
 
-void CommandBufferGL::setUniforms(Program* program) const
+void CommandBufferGL::setUniforms(Program* program)
 {
     if (_bindGroup)
     {
         const auto& texutreInfos = _bindGroup->getTextureInfos();
+        const auto& samplerInfos = _bindGroup->getSamplerInfos();
         const auto& bindUniformInfos = _bindGroup->getUniformInfos();
         const auto& activeUniformInfos = program->getUniformInfos();
         for (const auto& activeUinform : activeUniformInfos)
@@ -253,10 +301,24 @@ void CommandBufferGL::setUniforms(Program* program) const
                 const auto& textures = (*bindUniformTextureInfo).second.textures;
                 const auto& indices = (*bindUniformTextureInfo).second.indices;
                 
+                // Samplers bound with the same name override the default samplers of textures.
+                const std::vector<Sampler*>* samplers = nullptr;
+                const auto& bindUniformSamplerInfo = samplerInfos.find(activeUinform.name);
+                if (samplerInfos.end() != bindUniformSamplerInfo)
+                    samplers = &(*bindUniformSamplerInfo).second.samplers;
+                
                 int i = 0;
                 for (const auto& texture: textures)
                 {
-                    static_cast<TextureGL*>(texture)->apply(indices[i]);
+                    const SamplerGL* sampler = nullptr;
+                    if (samplers && (size_t)i < samplers->size())
+                        sampler = static_cast<const SamplerGL*>((*samplers)[i]);
+                    
+                    auto textureGL = static_cast<TextureGL*>(texture);
+                    textureGL->apply(indices[i], sampler);
+#if CC_GL_SAMPLER_OBJECT_SUPPORTED
+                    bindSampler(indices[i], sampler ? sampler : textureGL->getDefaultSampler());
+#endif
                     ++i;
                 }
                 
@@ -270,6 +332,26 @@ void CommandBufferGL::setUniforms(Program* program) const
     }
 }
 
+void CommandBufferGL::bindSampler(int index, const SamplerGL* sampler)
+{
+    if (!sampler)
+        return;
+    
+    if (index >= MAX_TEXTURE_UNITS)
+    {
+        sampler->apply(index, GL_TEXTURE_2D);
+        return;
+    }
+    
+    const uint32_t bit = 1u << index;
+    if (!(_boundSamplerMask & bit) || _boundSamplers[index] != sampler->getId())
+    {
+        sampler->apply(index, GL_TEXTURE_2D);
+        _boundSamplers[index] = sampler->getId();
+        _boundSamplerMask |= bit;
+    }
+}
+
 #define DEF_TO_INT(pointer, index)     (*((GLint*)(pointer) + index))
 #define DEF_TO_FLOAT(pointer, index)   (*((GLfloat*)(pointer) + index))
 void CommandBufferGL::setUniform(bool isArray, GLuint location, uint32_t size, GLenum uniformType, void* data) const
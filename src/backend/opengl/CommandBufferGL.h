@@ -11,7 +11,10 @@ CC_BACKEND_BEGIN
 
 class BufferGL;
 class RenderPipelineGL;
+class RenderPassGL;
 class Program;
+class VertexInputLayoutGL;
+class SamplerGL;
 
 class CommandBufferGL : public CommandBuffer
 {
@@ -39,9 +42,11 @@ private:
         uint32_t h = 0;
     };
     
-    void prepareDrawing() const;
-    void bindVertexBuffer(Program* program) const;
-    void setUniforms(Program* program) const;
+    void prepareDrawing();
+    void bindVertexBuffer(VertexInputLayoutGL* vertexInputLayout);
+    void updateEnabledAttributes(uint32_t enabledAttributeMask);
+    void setUniforms(Program* program);
+    void bindSampler(int index, const SamplerGL* sampler);
     void setUniform(bool isArray, GLuint location, uint32_t size, GLenum uniformType, void* data) const;
     void cleanResources();
     
@@ -51,7 +56,21 @@ private:
     BindGroup* _bindGroup = nullptr;
     BufferGL* _indexBuffer = nullptr;
     RenderPipelineGL* _renderPipeline = nullptr;
+    RenderPassGL* _renderPass = nullptr; // weak reference
     CullMode _cullMode = CullMode::NONE;
+    
+    // Vertex attribute arrays enabled by this command buffer. They are context states that other
+    // command buffers and renderers may change, so they are synchronized again in every render pass.
+    uint32_t _enabledAttributeMask = 0;
+    uint32_t _supportedAttributeMask = 0;
+    bool _isEnabledAttributeMaskValid = false;
+    
+    // Ids of the sampler objects bound to each texture unit by this command buffer, to skip redundant
+    // glBindSampler() calls. A unit is only skipped if its bit is set in the mask, which is cleared in every
+    // render pass. Ids are compared as a purged sampler's GL name can be reused by a new sampler.
+    static const int MAX_TEXTURE_UNITS = 32;
+    uint32_t _boundSamplers[MAX_TEXTURE_UNITS] = {0};
+    uint32_t _boundSamplerMask = 0;
 };
 
 CC_BACKEND_END
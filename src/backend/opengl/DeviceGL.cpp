@@ -5,11 +5,82 @@
 #include "CommandBufferGL.h"
 #include "RenderPassGL.h"
 #include "TextureGL.h"
+#include "SamplerGL.h"
 #include "DepthStencilStateGL.h"
 #include "BlendStateGL.h"
+#include "Program.h"
+#include "VertexInputLayoutGL.h"
+#include "../HashUtils.h"
 
 CC_BACKEND_BEGIN
 
+namespace
+{
+    // The object of the entry with `hash` whose key satisfies `matches`, nullptr if there isn't one.
+    template <typename Cache, typename Predicate>
+    auto findCachedObject(const Cache& cache, std::size_t hash, Predicate matches) -> decltype(cache.begin()->second.object)
+    {
+        auto range = cache.equal_range(hash);
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (matches(iter->second.key))
+                return iter->second.object;
+        }
+        return nullptr;
+    }
+    
+    template <typename Cache>
+    void releaseCachedObjects(Cache& cache)
+    {
+        for (auto& entry : cache)
+            entry.second.object->release();
+    }
+    
+    // Release the objects whose only reference is held by the cache.
+    template <typename Cache>
+    void purgeUnreferencedObjects(Cache& cache)
+    {
+        for (auto iter = cache.begin(); cache.end() != iter;)
+        {
+            if (1 == iter->second.object->getReferenceCount())
+            {
+                iter->second.object->release();
+                iter = cache.erase(iter);
+            }
+            else
+                ++iter;
+        }
+    }
+}
+
+DeviceGL::ProgramKey::ProgramKey(const RenderPipelineDescriptor& descriptor)
+: vertexShaderModule(descriptor.getVertexShaderModule())
+, fragmentShaderModule(descriptor.getFragmentShaderModule())
+{
+}
+
+bool DeviceGL::ProgramKey::matches(const RenderPipelineDescriptor& descriptor) const
+{
+    return (vertexShaderModule == descriptor.getVertexShaderModule() &&
+            fragmentShaderModule == descriptor.getFragmentShaderModule());
+}
+
+DeviceGL::RenderPipelineKey::RenderPipelineKey(const RenderPipelineDescriptor& descriptor)
+: program(descriptor)
+, depthStencilState(descriptor.getDepthStencilState())
+, blendState(descriptor.getBlendState())
+, vertexLayouts(descriptor.getVertexLayouts())
+{
+}
+
+bool DeviceGL::RenderPipelineKey::matches(const RenderPipelineDescriptor& descriptor) const
+{
+    return (program.matches(descriptor) &&
+            depthStencilState == descriptor.getDepthStencilState() &&
+            blendState == descriptor.getBlendState() &&
+            vertexLayouts == descriptor.getVertexLayouts());
+}
+
 Device* Device::getInstance()
 {
     if (!_instance)
@@ -18,6 +89,30 @@ Device* Device::getInstance()
     return _instance;
 }
 
+DeviceGL::~DeviceGL()
+{
+    releaseCachedObjects(_renderPipelineCache);
+    releaseCachedObjects(_vertexInputLayoutCache);
+    releaseCachedObjects(_programCache);
+    releaseCachedObjects(_blendStateCache);
+    releaseCachedObjects(_depthStencilStateCache);
+    releaseCachedObjects(_shaderModuleCache);
+    releaseCachedObjects(_samplerCache);
+}
+
+void DeviceGL::purgeCachedObjects()
+{
+    // Pipelines hold the programs, vertex input layouts and states they are created with, and
+    // programs hold their shader modules, so users are purged before the objects they use.
+    purgeUnreferencedObjects(_renderPipelineCache);
+    purgeUnreferencedObjects(_vertexInputLayoutCache);
+    purgeUnreferencedObjects(_programCache);
+    purgeUnreferencedObjects(_blendStateCache);
+    purgeUnreferencedObjects(_depthStencilStateCache);
+    purgeUnreferencedObjects(_shaderModuleCache);
+    purgeUnreferencedObjects(_samplerCache);
+}
+
 CommandBuffer* DeviceGL::newCommandBuffer()
 {
     return new (std::nothrow) CommandBufferGL();
@@ -30,7 +125,32 @@ Buffer* DeviceGL::newBuffer(uint32_t size, BufferType type, BufferUsage usage)
 
 Texture* DeviceGL::newTexture(const TextureDescriptor& descriptor)
 {
-    return new (std::nothrow) TextureGL(descriptor);
+    auto defaultSampler = static_cast<SamplerGL*>(newSampler(descriptor.samplerDescriptor));
+    auto texture = new (std::nothrow) TextureGL(descriptor, defaultSampler);
+    CC_SAFE_RELEASE(defaultSampler);
+    return texture;
+}
+
+Sampler* DeviceGL::newSampler(const SamplerDescriptor& descriptor)
+{
+    auto key = descriptor.hash();
+    auto cached = findCachedObject(_samplerCache, key, [&](const SamplerDescriptor& cachedDescriptor) {
+        return descriptor == cachedDescriptor;
+    });
+    if (cached)
+    {
+        cached->retain();
+        return cached;
+    }
+    
+    auto sampler = new (std::nothrow) SamplerGL(descriptor);
+    if (!sampler)
+        return nullptr;
+    
+    // One reference is held by the cache, the other one is returned to the caller.
+    sampler->retain();
+    _samplerCache.emplace(key, CacheEntry<SamplerDescriptor, Sampler>{descriptor, sampler});
+    return sampler;
 }
 
 RenderPass* DeviceGL::newRenderPass(const RenderPassDescriptor& descriptor)
@@ -40,34 +160,116 @@ RenderPass* DeviceGL::newRenderPass(const RenderPassDescriptor& descriptor)
 
 ShaderModule* DeviceGL::createShaderModule(ShaderStage stage, const std::string& source)
 {
+    std::size_t key = std::hash<std::string>()(source);
+    hashCombine(key, (uint32_t)stage);
+    
+    auto cached = findCachedObject(_shaderModuleCache, key, [&](const ShaderModuleKey& cachedKey) {
+        return stage == cachedKey.stage && source == cachedKey.source;
+    });
+    if (cached)
+        return cached;
+    
     auto ret = new (std::nothrow) ShaderModuleGL(stage, source);
     if (ret)
-        ret->autorelease();
+    {
+        ShaderModuleKey cachedKey;
+        cachedKey.stage = stage;
+        cachedKey.source = source;
+        _shaderModuleCache.emplace(key, CacheEntry<ShaderModuleKey, ShaderModule>{cachedKey, ret});
+    }
     
     return ret;
 }
 
 DepthStencilState* DeviceGL::createDepthStencilState(const DepthStencilDescriptor& descriptor)
 {
+    auto key = descriptor.hash();
+    auto cached = findCachedObject(_depthStencilStateCache, key, [&](const DepthStencilDescriptor& cachedDescriptor) {
+        return descriptor == cachedDescriptor;
+    });
+    if (cached)
+        return cached;
+    
     auto ret = new (std::nothrow) DepthStencilStateGL(descriptor);
     if (ret)
-        ret->autorelease();
+        _depthStencilStateCache.emplace(key, CacheEntry<DepthStencilDescriptor, DepthStencilState>{descriptor, ret});
     
     return ret;
 }
 
 BlendState* DeviceGL::createBlendState(const BlendDescriptor& descriptor)
 {
+    auto key = descriptor.hash();
+    auto cached = findCachedObject(_blendStateCache, key, [&](const BlendDescriptor& cachedDescriptor) {
+        return descriptor == cachedDescriptor;
+    });
+    if (cached)
+        return cached;
+    
     auto ret = new (std::nothrow) BlendStateGL(descriptor);
     if (ret)
-        ret->autorelease();
+        _blendStateCache.emplace(key, CacheEntry<BlendDescriptor, BlendState>{descriptor, ret});
     
     return ret;
 }
 
 RenderPipeline* DeviceGL::newRenderPipeline(const RenderPipelineDescriptor& descriptor)
 {
-    return new (std::nothrow) RenderPipelineGL(descriptor);
+    auto key = descriptor.hash();
+    auto cached = findCachedObject(_renderPipelineCache, key, [&](const RenderPipelineKey& cachedKey) {
+        return cachedKey.matches(descriptor);
+    });
+    if (cached)
+    {
+        cached->retain();
+        return cached;
+    }
+    
+    auto program = getProgram(descriptor);
+    if (!program)
+        return nullptr;
+    
+    auto vertexInputLayout = getVertexInputLayout(program, descriptor.getVertexLayouts());
+    auto ret = new (std::nothrow) RenderPipelineGL(descriptor, program, vertexInputLayout);
+    if (ret)
+    {
+        ret->retain();
+        _renderPipelineCache.emplace(key, CacheEntry<RenderPipelineKey, RenderPipeline>{RenderPipelineKey(descriptor), ret});
+    }
+    
+    return ret;
+}
+
+Program* DeviceGL::getProgram(const RenderPipelineDescriptor& descriptor)
+{
+    auto key = descriptor.getProgramHash();
+    auto cached = findCachedObject(_programCache, key, [&](const ProgramKey& cachedKey) {
+        return cachedKey.matches(descriptor);
+    });
+    if (cached)
+        return cached;
+    
+    auto program = new (std::nothrow) Program(descriptor);
+    if (program)
+        _programCache.emplace(key, CacheEntry<ProgramKey, Program>{ProgramKey(descriptor), program});
+    
+    return program;
+}
+
+VertexInputLayoutGL* DeviceGL::getVertexInputLayout(const Program* program, const std::vector<VertexLayout>& vertexLayouts)
+{
+    auto key = VertexInputLayoutGL::computeHash(program, vertexLayouts);
+    auto cached = findCachedObject(_vertexInputLayoutCache, key, [&](const VertexInputLayoutKey& cachedKey) {
+        return program == cachedKey.program && vertexLayouts == cachedKey.vertexLayouts;
+    });
+    if (cached)
+        return cached;
+    
+    auto vertexInputLayout = new (std::nothrow) VertexInputLayoutGL(program, vertexLayouts);
+    if (vertexInputLayout)
+        _vertexInputLayoutCache.emplace(key, CacheEntry<VertexInputLayoutKey, VertexInputLayoutGL>{{program, vertexLayouts}, vertexInputLayout});
+    
+    return vertexInputLayout;
 }
 
 CC_BACKEND_END
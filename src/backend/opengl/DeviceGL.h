@@ -1,18 +1,94 @@
 #include "../Device.h"
 
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 CC_BACKEND_BEGIN
 
+class Program;
+class VertexInputLayoutGL;
+
 class DeviceGL : public Device
 {
 public:
+    ~DeviceGL();
+    
     virtual CommandBuffer* newCommandBuffer() override;
     virtual Buffer* newBuffer(uint32_t size, BufferType type, BufferUsage usage) override;
     virtual RenderPass* newRenderPass(const RenderPassDescriptor& descriptor) override;
     virtual Texture* newTexture(const TextureDescriptor& descriptor) override;
+    // Samplers are cached by descriptor, a cached sampler is retained before returned.
+    virtual Sampler* newSampler(const SamplerDescriptor& descriptor) override;
+    // Shader modules, depth stencil states and blend states are cached by their sources or descriptors,
+    // the returned objects are owned by the device, retain them if they are kept.
     virtual ShaderModule* createShaderModule(ShaderStage stage, const std::string& source) override;
     virtual DepthStencilState* createDepthStencilState(const DepthStencilDescriptor& descriptor) override;
     virtual BlendState* createBlendState(const BlendDescriptor& descriptor) override;
+    // Render pipelines are cached by descriptor. Pipelines with the same shader modules share the
+    // same linked program, and vertex layouts are resolved into shared vertex input layouts.
     virtual RenderPipeline* newRenderPipeline(const RenderPipelineDescriptor& descriptor) override;
+    
+    virtual void purgeCachedObjects() override;
+    
+private:
+    // A cached object and the states it was created from. Entries are found by hash, and the states
+    // are compared on a hit, so objects whose hashes collide are never mixed up.
+    template <typename Key, typename T>
+    struct CacheEntry
+    {
+        Key key;
+        T* object;
+    };
+    template <typename Key, typename T>
+    using Cache = std::unordered_multimap<std::size_t, CacheEntry<Key, T>>;
+    
+    struct ShaderModuleKey
+    {
+        ShaderStage stage = ShaderStage::VERTEX;
+        std::string source;
+    };
+    
+    // Shader modules and states are compared by identity, which is enough as they are cached by
+    // descriptor too, and the cached program and pipeline retain them.
+    struct ProgramKey
+    {
+        ProgramKey(const RenderPipelineDescriptor& descriptor);
+        bool matches(const RenderPipelineDescriptor& descriptor) const;
+        
+        ShaderModule* vertexShaderModule = nullptr;
+        ShaderModule* fragmentShaderModule = nullptr;
+    };
+    
+    struct RenderPipelineKey
+    {
+        RenderPipelineKey(const RenderPipelineDescriptor& descriptor);
+        bool matches(const RenderPipelineDescriptor& descriptor) const;
+        
+        ProgramKey program;
+        DepthStencilState* depthStencilState = nullptr;
+        BlendState* blendState = nullptr;
+        std::vector<VertexLayout> vertexLayouts;
+    };
+    
+    struct VertexInputLayoutKey
+    {
+        const Program* program;
+        std::vector<VertexLayout> vertexLayouts;
+    };
+    
+    Program* getProgram(const RenderPipelineDescriptor& descriptor);
+    VertexInputLayoutGL* getVertexInputLayout(const Program* program, const std::vector<VertexLayout>& vertexLayouts);
+    
+    // The device holds a reference of every cached object.
+    Cache<ShaderModuleKey, ShaderModule> _shaderModuleCache;
+    Cache<DepthStencilDescriptor, DepthStencilState> _depthStencilStateCache;
+    Cache<BlendDescriptor, BlendState> _blendStateCache;
+    Cache<ProgramKey, Program> _programCache;
+    Cache<VertexInputLayoutKey, VertexInputLayoutGL> _vertexInputLayoutCache;
+    Cache<RenderPipelineKey, RenderPipeline> _renderPipelineCache;
+    Cache<SamplerDescriptor, Sampler> _samplerCache;
 };
 
 CC_BACKEND_END
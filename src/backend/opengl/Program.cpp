@@ -1,60 +1,9 @@
 #include "Program.h"
 #include "ShaderModuleGL.h"
 
-CC_BACKEND_BEGIN
+#include <string.h>
 
-namespace
-{
-    GLenum toGLAttributeType(VertexFormat vertexFormat)
-    {
-        GLenum ret = GL_INT;
-        switch (vertexFormat)
-        {
-            case VertexFormat::FLOAT_R32G32B32A32:
-            case VertexFormat::FLOAT_R32G32B32:
-            case VertexFormat::FLOAT_R32G32:
-            case VertexFormat::FLOAT_R32:
-                ret = GL_FLOAT;
-                break;
-            case VertexFormat::INT_R32G32B32A32:
-            case VertexFormat::INT_R32G32B32:
-            case VertexFormat::INT_R32G32:
-            case VertexFormat::INT_R32:
-                ret = GL_INT;
-                break;
-            default:
-                break;
-        }
-        return ret;
-    }
-    
-    GLsizei getGLAttributeSize(VertexFormat vertexFormat)
-    {
-        GLsizei ret = 0;
-        switch (vertexFormat)
-        {
-            case VertexFormat::FLOAT_R32G32B32A32:
-            case VertexFormat::INT_R32G32B32A32:
-                ret = 4;
-                break;
-            case VertexFormat::FLOAT_R32G32B32:
-            case VertexFormat::INT_R32G32B32:
-                ret = 3;
-                break;
-            case VertexFormat::FLOAT_R32G32:
-            case VertexFormat::INT_R32G32:
-                ret = 2;
-                break;
-            case VertexFormat::FLOAT_R32:
-            case VertexFormat::INT_R32:
-                ret = 1;
-                break;
-            default:
-                break;
-        }
-        return ret;
-    }
-}
+CC_BACKEND_BEGIN
 
 Program::Program(const RenderPipelineDescriptor& descriptor)
 : _vertexShaderModule(static_cast<ShaderModuleGL*>(descriptor.getVertexShaderModule()))
@@ -66,7 +15,7 @@ Program::Program(const RenderPipelineDescriptor& descriptor)
     CC_SAFE_RETAIN(_fragmentShaderModule);
     
     compileProgram();
-    computeAttributeInfos(descriptor);
+    computeAttributeLocations();
     computeUniformInfos();
 }
 
@@ -108,46 +57,43 @@ void Program::compileProgram()
     }
 }
 
-void Program::computeAttributeInfos(const RenderPipelineDescriptor& descriptor)
+void Program::computeAttributeLocations()
 {
-    const auto& vertexLayouts = descriptor.getVertexLayouts();
-    for (const auto& vertexLayout : vertexLayouts)
+    if (!_program)
+        return;
+    
+    GLint numOfAttributes = 0;
+    glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &numOfAttributes);
+    if (!numOfAttributes)
+        return;
+    
+#define MAX_ATTRIBUTE_NAME_LENGTH 256
+    GLint length = 0;
+    GLint size = 0;
+    GLenum type = GL_FLOAT;
+    GLchar attributeName[MAX_ATTRIBUTE_NAME_LENGTH + 1];
+    for (int i = 0; i < numOfAttributes; ++i)
     {
-        if (! vertexLayout.isValid())
-            continue;
-        
-        VertexAttributeArray vertexAttributeArray;
-        
-        const auto& attributes = vertexLayout.getAttributes();
-        for (const auto& attribute : attributes)
-        {
-            AttributeInfo attributeInfo;
-            
-            if (!getAttributeLocation(attribute.name, attributeInfo.location))
-                continue;
-            
-            attributeInfo.stride = vertexLayout.getStride();
-            attributeInfo.offset = attribute.offset;
-            attributeInfo.type = toGLAttributeType(attribute.format);
-            attributeInfo.size = getGLAttributeSize(attribute.format);
-            
-            vertexAttributeArray.push_back(attributeInfo);
-        }
+        glGetActiveAttrib(_program, i, MAX_ATTRIBUTE_NAME_LENGTH, &length, &size, &type, attributeName);
+        attributeName[length] = '\0';
         
-        _attributeInfos.push_back(std::move(vertexAttributeArray));
+        // Built-in attributes, such as gl_VertexID, don't have a location.
+        GLint location = glGetAttribLocation(_program, attributeName);
+        if (-1 != location)
+            _attributeLocations[attributeName] = GLuint(location);
     }
 }
 
-bool Program::getAttributeLocation(const std::string& attributeName, uint32_t& location)
+bool Program::getAttributeLocation(const std::string& attributeName, uint32_t& location) const
 {
-    GLint loc = glGetAttribLocation(_program, attributeName.c_str());
-    if (-1 == loc)
+    const auto& iter = _attributeLocations.find(attributeName);
+    if (_attributeLocations.end() == iter)
     {
         printf("Cocos2d: %s: can not find vertex attribute of %s", __FUNCTION__, attributeName.c_str());
         return false;
     }
     
-    location = GLuint(loc);
+    location = iter->second;
     return true;
 }
 
@@ -7,20 +7,12 @@
 #include "platform/CCGL.h"
 
 #include <string>
+#include <unordered_map>
 
 CC_BACKEND_BEGIN
 
 class ShaderModuleGL;
 
-struct AttributeInfo
-{
-    uint32_t location = 0;
-    uint32_t size = 0;
-    GLenum type = GL_BYTE;
-    GLsizei stride = 0;
-    uint32_t offset = 0;
-};
-
 struct UniformInfo
 {
     std::string name;
@@ -34,26 +26,24 @@ struct UniformInfo
 class Program : public cocos2d::Ref
 {
 public:
-    typedef std::vector<AttributeInfo> VertexAttributeArray;
-    
     Program(const RenderPipelineDescriptor& descriptor);
     ~Program();
     
-    inline const std::vector<VertexAttributeArray>& getAttributeInfos() const { return _attributeInfos; }
+    // Get the location of an active attribute, returns false if the attribute is not active.
+    bool getAttributeLocation(const std::string& attributeName, uint32_t& location) const;
     inline const std::vector<UniformInfo>& getUniformInfos() const { return _uniformInfos; }
     inline GLuint getHandler() const { return _program; }
     
 private:
     void compileProgram();
-    void computeAttributeInfos(const RenderPipelineDescriptor& descriptor);
-    bool getAttributeLocation(const std::string& attributeName, uint32_t& location);
+    void computeAttributeLocations();
     void computeUniformInfos();
     
     GLuint _program = 0;
     ShaderModuleGL* _vertexShaderModule = nullptr;
     ShaderModuleGL* _fragmentShaderModule = nullptr;
     
-    std::vector<VertexAttributeArray> _attributeInfos;
+    std::unordered_map<std::string, uint32_t> _attributeLocations;
     std::vector<UniformInfo> _uniformInfos;
 };
 
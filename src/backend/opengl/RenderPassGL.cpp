@@ -2,14 +2,149 @@
 #include "TextureGL.h"
 #include "ccMacros.h"
 
+#include <string.h>
+
 CC_BACKEND_BEGIN
 
+namespace
+{
+    // Attachment names of the window system provided frame buffer. They are GL_COLOR_EXT/GL_DEPTH_EXT/GL_STENCIL_EXT
+    // in EXT_discard_framebuffer, and GL_COLOR/GL_DEPTH/GL_STENCIL in OpenGL ES 3.0, with the same values.
+    const GLenum DEFAULT_FRAMEBUFFER_COLOR = 0x1800;
+    const GLenum DEFAULT_FRAMEBUFFER_DEPTH = 0x1801;
+    const GLenum DEFAULT_FRAMEBUFFER_STENCIL = 0x1802;
+    
+    // The platform headers include OpenGL ES 2.0 only, so Android and iOS builds use EXT_discard_framebuffer
+    // and Mac builds don't invalidate. The OpenGL ES 3.0 branches are taken by the fake-gl tests only, until
+    // CCGL-android.h and CCGL-ios.h move to OpenGL ES 3.0.
+    bool isInvalidateFramebufferSupported()
+    {
+#if defined(GL_ES_VERSION_3_0)
+        return true;
+#elif defined(GL_EXT_discard_framebuffer)
+        static const GLubyte* extensions = glGetString(GL_EXTENSIONS);
+        static const bool supported = extensions && strstr((const char*)extensions, "GL_EXT_discard_framebuffer");
+        return supported;
+#else
+        return false;
+#endif
+    }
+    
+    bool invalidateFramebuffer(const std::vector<GLenum>& attachments)
+    {
+        if (attachments.empty() || !isInvalidateFramebufferSupported())
+            return false;
+        
+#if defined(GL_ES_VERSION_3_0)
+        glInvalidateFramebuffer(GL_FRAMEBUFFER, (GLsizei)attachments.size(), attachments.data());
+        return true;
+#elif defined(GL_EXT_discard_framebuffer)
+        glDiscardFramebufferEXT(GL_FRAMEBUFFER, (GLsizei)attachments.size(), attachments.data());
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
 RenderPassGL::RenderPassGL(const RenderPassDescriptor& descriptor)
 : RenderPass(descriptor)
 , _hasStencil(descriptor.hasStencil())
 {
     if (_depthStencilAttachmentSet || _colorAttachmentsSet)
         glGenFramebuffers(1, &_frameBuffer);
+    
+    computeInvalidateAttachments();
+}
+
+RenderPassGL::~RenderPassGL()
+{
+    if (_frameBuffer)
+        glDeleteFramebuffers(1, &_frameBuffer);
+}
+
+bool RenderPassGL::invalidateLoadAttachments(GLuint defaultFrameBuffer) const
+{
+    if (!_frameBuffer && defaultFrameBuffer)
+        return invalidateFramebuffer(_defaultObjectLoadInvalidateAttachments);
+    return invalidateFramebuffer(_loadInvalidateAttachments);
+}
+
+bool RenderPassGL::invalidateStoreAttachments(GLuint defaultFrameBuffer) const
+{
+    if (!_frameBuffer && defaultFrameBuffer)
+        return invalidateFramebuffer(_defaultObjectStoreInvalidateAttachments);
+    return invalidateFramebuffer(_storeInvalidateAttachments);
+}
+
+void RenderPassGL::computeInvalidateAttachments()
+{
+    std::vector<GLenum> colorAttachments;
+    std::vector<GLenum> depthAttachments;
+    std::vector<GLenum> stencilAttachments;
+    if (_frameBuffer)
+    {
+        if (_colorAttachmentsSet)
+        {
+            int i = 0;
+            for (const auto& texture : _colorAttachments.textures)
+            {
+                if (texture)
+                    colorAttachments.push_back(GL_COLOR_ATTACHMENT0 + i);
+                ++i;
+            }
+        }
+        
+        if (_depthStencilAttachmentSet && _depthStencilAttachment.texture)
+        {
+            depthAttachments.push_back(GL_DEPTH_ATTACHMENT);
+            if (_hasStencil)
+                stencilAttachments.push_back(GL_STENCIL_ATTACHMENT);
+        }
+    }
+    else
+    {
+        colorAttachments.push_back(DEFAULT_FRAMEBUFFER_COLOR);
+        depthAttachments.push_back(DEFAULT_FRAMEBUFFER_DEPTH);
+        stencilAttachments.push_back(DEFAULT_FRAMEBUFFER_STENCIL);
+        
+        appendInvalidateAttachments({GL_COLOR_ATTACHMENT0},
+                                    {GL_DEPTH_ATTACHMENT},
+                                    {GL_STENCIL_ATTACHMENT},
+                                    _defaultObjectLoadInvalidateAttachments,
+                                    _defaultObjectStoreInvalidateAttachments);
+    }
+    
+    appendInvalidateAttachments(colorAttachments,
+                                depthAttachments,
+                                stencilAttachments,
+                                _loadInvalidateAttachments,
+                                _storeInvalidateAttachments);
+}
+
+void RenderPassGL::appendInvalidateAttachments(const std::vector<GLenum>& colorAttachments,
+                                               const std::vector<GLenum>& depthAttachments,
+                                               const std::vector<GLenum>& stencilAttachments,
+                                               std::vector<GLenum>& loadInvalidateAttachments,
+                                               std::vector<GLenum>& storeInvalidateAttachments) const
+{
+    auto append = [](std::vector<GLenum>& dst, const std::vector<GLenum>& src) {
+        dst.insert(dst.end(), src.begin(), src.end());
+    };
+    
+    if (LoadAction::DONT_CARE == _colorAttachments.loadAction)
+        append(loadInvalidateAttachments, colorAttachments);
+    if (LoadAction::DONT_CARE == _depthStencilAttachment.depthLoadAction)
+        append(loadInvalidateAttachments, depthAttachments);
+    if (LoadAction::DONT_CARE == _depthStencilAttachment.stencilLoadAction)
+        append(loadInvalidateAttachments, stencilAttachments);
+    
+    if (StoreAction::DONT_CARE == _colorAttachments.storeAction)
+        append(storeInvalidateAttachments, colorAttachments);
+    if (StoreAction::DONT_CARE == _depthStencilAttachment.depthStoreAction)
+        append(storeInvalidateAttachments, depthAttachments);
+    if (StoreAction::DONT_CARE == _depthStencilAttachment.stencilStoreAction)
+        append(storeInvalidateAttachments, stencilAttachments);
 }
 
 void RenderPassGL::apply(GLuint defaultFrameBuffer) const
@@ -76,7 +211,7 @@ void RenderPassGL::apply(GLuint defaultFrameBuffer) const
         
     // set clear color, depth and stencil
     GLbitfield mask = 0;
-    if (_colorAttachments.needClearColor)
+    if (LoadAction::CLEAR == _colorAttachments.loadAction)
     {
         mask |= GL_COLOR_BUFFER_BIT;
         const auto& clearColor = _colorAttachments.clearColor;
@@ -89,7 +224,7 @@ void RenderPassGL::apply(GLuint defaultFrameBuffer) const
     GLboolean oldDepthTest = GL_FALSE;
     GLfloat oldDepthClearValue = 0.f;
     GLint oldDepthFunc = GL_LESS;
-    if (_depthStencilAttachment.needClearDepth)
+    if (LoadAction::CLEAR == _depthStencilAttachment.depthLoadAction)
     {
         glGetBooleanv(GL_DEPTH_WRITEMASK, &oldDepthWrite);
         glGetBooleanv(GL_DEPTH_TEST, &oldDepthTest);
@@ -105,7 +240,7 @@ void RenderPassGL::apply(GLuint defaultFrameBuffer) const
     
     CHECK_GL_ERROR_DEBUG();
     
-    if (_depthStencilAttachment.needClearStencil)
+    if (LoadAction::CLEAR == _depthStencilAttachment.stencilLoadAction)
     {
         mask |= GL_STENCIL_BUFFER_BIT;
         glClearStencil(_depthStencilAttachment.clearStencil);
@@ -115,7 +250,7 @@ void RenderPassGL::apply(GLuint defaultFrameBuffer) const
     CHECK_GL_ERROR_DEBUG();
     
     // restore depth test
-    if (_depthStencilAttachment.needClearDepth)
+    if (LoadAction::CLEAR == _depthStencilAttachment.depthLoadAction)
     {
         if (!oldDepthTest)
             glDisable(GL_DEPTH_TEST);
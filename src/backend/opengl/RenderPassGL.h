@@ -10,11 +10,33 @@ class RenderPassGL : public RenderPass
 {
 public:
     RenderPassGL(const RenderPassDescriptor& descriptor);
+    ~RenderPassGL();
+    
     void apply(GLuint defaultFrameBuffer) const;
     
+    // Invalidate attachments with LoadAction::DONT_CARE, should be invoked after apply() with the same
+    // default frame buffer. Returns true if an invalidation is issued.
+    bool invalidateLoadAttachments(GLuint defaultFrameBuffer) const;
+    // Invalidate attachments with StoreAction::DONT_CARE, should be invoked when the render pass ends.
+    // Returns true if an invalidation is issued.
+    bool invalidateStoreAttachments(GLuint defaultFrameBuffer) const;
+    
 private:
+    void computeInvalidateAttachments();
+    void appendInvalidateAttachments(const std::vector<GLenum>& colorAttachments,
+                                     const std::vector<GLenum>& depthAttachments,
+                                     const std::vector<GLenum>& stencilAttachments,
+                                     std::vector<GLenum>& loadInvalidateAttachments,
+                                     std::vector<GLenum>& storeInvalidateAttachments) const;
+    
     GLuint _frameBuffer = 0;
     bool _hasStencil = false;
+    std::vector<GLenum> _loadInvalidateAttachments;
+    std::vector<GLenum> _storeInvalidateAttachments;
+    // Used instead when the pass draws to a default frame buffer that is a frame buffer object, as on iOS,
+    // which names its attachments GL_COLOR_ATTACHMENT0/GL_DEPTH_ATTACHMENT/GL_STENCIL_ATTACHMENT.
+    std::vector<GLenum> _defaultObjectLoadInvalidateAttachments;
+    std::vector<GLenum> _defaultObjectStoreInvalidateAttachments;
 };
 
 CC_BACKEND_END
@@ -3,14 +3,18 @@
 #include "DepthStencilStateGL.h"
 #include "Program.h"
 #include "BlendStateGL.h"
+#include "VertexInputLayoutGL.h"
 
 #include <assert.h>
 
 CC_BACKEND_BEGIN
 
-RenderPipelineGL::RenderPipelineGL(const RenderPipelineDescriptor& descriptor)
+RenderPipelineGL::RenderPipelineGL(const RenderPipelineDescriptor& descriptor, Program* program, VertexInputLayoutGL* vertexInputLayout)
+: _program(program)
+, _vertexInputLayout(vertexInputLayout)
 {
-    _program = new Program(descriptor);
+    CC_SAFE_RETAIN(_program);
+    CC_SAFE_RETAIN(_vertexInputLayout);
     
     const auto& depthStencilState = descriptor.getDepthStencilState();
     CC_SAFE_RETAIN(depthStencilState);
@@ -24,6 +28,7 @@ RenderPipelineGL::RenderPipelineGL(const RenderPipelineDescriptor& descriptor)
 RenderPipelineGL::~RenderPipelineGL()
 {
     CC_SAFE_RELEASE(_program);
+    CC_SAFE_RELEASE(_vertexInputLayout);
     CC_SAFE_RELEASE(_depthStencilState);
     CC_SAFE_RELEASE(_blendState);
 }
@@ -12,19 +12,22 @@ CC_BACKEND_BEGIN
 class DepthStencilStateGL;
 class Program;
 class BlendStateGL;
+class VertexInputLayoutGL;
 
 class RenderPipelineGL : public RenderPipeline
 {
 public:
-    RenderPipelineGL(const RenderPipelineDescriptor& descriptor);
+    RenderPipelineGL(const RenderPipelineDescriptor& descriptor, Program* program, VertexInputLayoutGL* vertexInputLayout);
     ~RenderPipelineGL();
     
     inline Program* getProgram() const { return _program; }
+    inline VertexInputLayoutGL* getVertexInputLayout() const { return _vertexInputLayout; }
     inline DepthStencilStateGL* getDepthStencilState() const { return _depthStencilState; }
     inline BlendStateGL* getBlendState() const { return _blendState; }
     
 private:
     Program* _program = nullptr;
+    VertexInputLayoutGL* _vertexInputLayout = nullptr;
     DepthStencilStateGL* _depthStencilState = nullptr;
     BlendStateGL* _blendState = nullptr;
 };
@@ -0,0 +1,107 @@
+#include "SamplerGL.h"
+#include "ccMacros.h"
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    GLint toGLMagFilter(SamplerFilter magFilter)
+    {
+        GLint ret = GL_LINEAR;
+        switch (magFilter)
+        {
+            case SamplerFilter::LINEAR:
+                ret = GL_LINEAR;
+                break;
+            case SamplerFilter::NEAREST:
+                ret = GL_NEAREST;
+                break;
+            default:
+                break;
+        }
+        return ret;
+    }
+    
+    GLint toGLMinFilter(SamplerFilter minFilter, SamplerFilter mipmapFilter, bool mipmapEnabled)
+    {
+        if (mipmapEnabled)
+        {
+            if (SamplerFilter::LINEAR == minFilter)
+                return SamplerFilter::LINEAR == mipmapFilter ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST;
+            else
+                return SamplerFilter::LINEAR == mipmapFilter ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+        }
+        else
+        {
+            if (SamplerFilter::LINEAR == minFilter)
+                return GL_LINEAR;
+            else
+                return GL_NEAREST;
+        }
+    }
+    
+    GLint toGLAddressMode(SamplerAddressMode addressMode)
+    {
+        GLint ret = GL_REPEAT;
+        switch (addressMode)
+        {
+            case SamplerAddressMode::REPEAT:
+                ret = GL_REPEAT;
+                break;
+            case SamplerAddressMode::MIRROR_REPEAT:
+                ret = GL_MIRRORED_REPEAT;
+                break;
+            case SamplerAddressMode::CLAMP_TO_EDGE:
+                ret = GL_CLAMP_TO_EDGE;
+                break;
+            default:
+                break;
+        }
+        return ret;
+    }
+    
+    // Samplers are created on the GL thread.
+    uint32_t nextSamplerId = 1;
+}
+
+SamplerGL::SamplerGL(const SamplerDescriptor& descriptor)
+: Sampler(descriptor)
+, _id(nextSamplerId++)
+{
+    _magFilterGL = toGLMagFilter(descriptor.magFilter);
+    _minFilterGL = toGLMinFilter(descriptor.minFilter, descriptor.mipmapFilter, descriptor.mipmapEnabled);
+    _sAddressModeGL = toGLAddressMode(descriptor.sAddressMode);
+    _tAddressModeGL = toGLAddressMode(descriptor.tAddressMode);
+    
+#if CC_GL_SAMPLER_OBJECT_SUPPORTED
+    glGenSamplers(1, &_sampler);
+    glSamplerParameteri(_sampler, GL_TEXTURE_MAG_FILTER, _magFilterGL);
+    glSamplerParameteri(_sampler, GL_TEXTURE_MIN_FILTER, _minFilterGL);
+    glSamplerParameteri(_sampler, GL_TEXTURE_WRAP_S, _sAddressModeGL);
+    glSamplerParameteri(_sampler, GL_TEXTURE_WRAP_T, _tAddressModeGL);
+    CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+SamplerGL::~SamplerGL()
+{
+#if CC_GL_SAMPLER_OBJECT_SUPPORTED
+    if (_sampler)
+        glDeleteSamplers(1, &_sampler);
+#endif
+}
+
+void SamplerGL::apply(int index, GLenum target) const
+{
+#if CC_GL_SAMPLER_OBJECT_SUPPORTED
+    CC_UNUSED_PARAM(target);
+    glBindSampler(index, _sampler);
+#else
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, _magFilterGL);
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, _minFilterGL);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, _sAddressModeGL);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, _tAddressModeGL);
+#endif
+}
+
+CC_BACKEND_END
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../Sampler.h"
+#include "platform/CCGL.h"
+
+// Sampler objects are core in OpenGL ES 3.0. On other GL versions the sampler states are
+// written to the texture objects when a texture is bound with a different sampler. The platform
+// headers include OpenGL ES 2.0 only, so shipping builds take that path, sampler objects are only
+// used by the fake-gl tests until CCGL-android.h and CCGL-ios.h move to OpenGL ES 3.0.
+#if defined(GL_ES_VERSION_3_0)
+#define CC_GL_SAMPLER_OBJECT_SUPPORTED 1
+#else
+#define CC_GL_SAMPLER_OBJECT_SUPPORTED 0
+#endif
+
+CC_BACKEND_BEGIN
+
+class SamplerGL : public Sampler
+{
+public:
+    SamplerGL(const SamplerDescriptor& descriptor);
+    ~SamplerGL();
+    
+    // Bind the sampler to texture unit `index`, `target` is the texture currently bound to the unit.
+    // Command buffers track the bound samplers to skip redundant binds.
+    void apply(int index, GLenum target) const;
+    
+    inline GLuint getHandler() const { return _sampler; }
+    // Unique among all samplers created, unlike the address and the GL name which can be reused once
+    // a sampler is purged from the device cache. Never 0.
+    inline uint32_t getId() const { return _id; }
+    
+private:
+    GLuint _sampler = 0;
+    uint32_t _id = 0;
+    
+    GLint _magFilterGL = GL_LINEAR;
+    GLint _minFilterGL = GL_LINEAR;
+    GLint _sAddressModeGL = GL_REPEAT;
+    GLint _tAddressModeGL = GL_REPEAT;
+};
+
+CC_BACKEND_END
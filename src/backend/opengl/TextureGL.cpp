@@ -1,109 +1,55 @@
 #include "TextureGL.h"
+#include "SamplerGL.h"
 #include "ccMacros.h"
 
 CC_BACKEND_BEGIN
 
 namespace
 {
-    GLint toGLMagFilter(SamplerFilter magFilter)
-    {
-        GLint ret = GL_LINEAR;
-        switch (magFilter)
-        {
-            case SamplerFilter::LINEAR:
-                ret = GL_LINEAR;
-                break;
-            case SamplerFilter::NEAREST:
-                ret = GL_NEAREST;
-                break;
-            default:
-                break;
-        }
-        return ret;
-    }
+#if defined(GL_ES_VERSION_3_0)
+    // Pixel unpack buffer shared by all textures. It is orphaned before every upload, so the driver can
+    // keep transferring the previous data while the new data is written, and glTexSubImage2D() returns
+    // without waiting for the copy. The platform headers include OpenGL ES 2.0 only, so shipping builds
+    // upload from client memory and only the fake-gl tests use it, until they move to OpenGL ES 3.0.
+    GLuint stagingBuffer = 0;
     
-    GLint toGLMinFilter(SamplerFilter minFilter, SamplerFilter mipmapFilter, bool mipmapEnabled)
+    bool uploadWithStagingBuffer(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
+                                 GLenum format, GLenum type, const uint8_t* data, uint32_t size)
     {
-        if (mipmapEnabled)
+        if (!stagingBuffer)
+            glGenBuffers(1, &stagingBuffer);
+        
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        bool ret = false;
+        if (mapped)
         {
-            switch (minFilter)
+            memcpy(mapped, data, size);
+            if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER))
             {
-                case SamplerFilter::LINEAR:
-                    switch (mipmapFilter)
-                    {
-                        case SamplerFilter::LINEAR:
-                            return GL_LINEAR_MIPMAP_LINEAR;
-                        case SamplerFilter::NEAREST:
-                            return GL_LINEAR_MIPMAP_NEAREST;
-                    }
-                case SamplerFilter::NEAREST:
-                    switch (mipmapFilter)
-                    {
-                        case SamplerFilter::LINEAR:
-                            return GL_NEAREST_MIPMAP_LINEAR;
-                        case SamplerFilter::NEAREST:
-                            return GL_NEAREST_MIPMAP_NEAREST;
-                    }
+                glTexSubImage2D(GL_TEXTURE_2D, 0, xoffset, yoffset, width, height, format, type, nullptr);
+                ret = true;
             }
         }
-        else
-        {
-            if (SamplerFilter::LINEAR == minFilter)
-                return GL_LINEAR;
-            else
-                return GL_NEAREST;
-        }
-    }
-    
-    GLint toGLAddressMode(SamplerAddressMode addressMode)
-    {
-        GLint ret = GL_REPEAT;
-        switch (addressMode)
-        {
-            case SamplerAddressMode::REPEAT:
-                ret = GL_REPEAT;
-                break;
-            case SamplerAddressMode::MIRROR_REPEAT:
-                ret = GL_MIRRORED_REPEAT;
-                break;
-            case SamplerAddressMode::CLAMP_TO_EDGE:
-                ret = GL_CLAMP_TO_EDGE;
-                break;
-            default:
-                break;
-        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
         return ret;
     }
+#endif
 }
 
-TextureGL::TextureGL(const TextureDescriptor& descriptor) : Texture(descriptor)
+TextureGL::TextureGL(const TextureDescriptor& descriptor, SamplerGL* defaultSampler)
+: Texture(descriptor)
+, _defaultSampler(defaultSampler)
 {
+    CC_SAFE_RETAIN(_defaultSampler);
+    
     glGenTextures(1, &_texture);
     toGLTypes();
     
-    _magFilterGL = toGLMagFilter(descriptor.samplerDescriptor.magFilter);
-    _minFilterGL = toGLMinFilter(descriptor.samplerDescriptor.minFilter,
-                                 descriptor.samplerDescriptor.mipmapFilter, _isMipmapEnabled);
-    
-    _sAddressModeGL = toGLAddressMode(descriptor.samplerDescriptor.sAddressMode);
-    _tAddressModeGL = toGLAddressMode(descriptor.samplerDescriptor.tAddressMode);
-    
-    // Update data here because `updateData()` may not be invoked later.
+    // Allocate storage here because `updateData()` may not be invoked later.
     // For example, a texture used as depth buffer will not invoke updateData().
-    uint8_t* data = (uint8_t*)malloc(_width * _height * _bytesPerElement);
-    updateData(data);
-    free(data);
-}
-
-TextureGL::~TextureGL()
-{
-    if (_texture)
-        glDeleteTextures(1, &_texture);
-}
-
-void TextureGL::updateData(uint8_t* data)
-{
-    // TODO: support texture cube, and compressed data.
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, _texture);
     glTexImage2D(GL_TEXTURE_2D,
@@ -114,17 +60,44 @@ void TextureGL::updateData(uint8_t* data)
                  0,
                  _format,
                  _type,
-                 data);
-    CHECK_GL_ERROR_DEBUG();
-    
-    generateMipmpas();
+                 nullptr);
     CHECK_GL_ERROR_DEBUG();
 }
 
+TextureGL::~TextureGL()
+{
+    CC_SAFE_RELEASE(_defaultSampler);
+    if (_texture)
+        glDeleteTextures(1, &_texture);
+}
+
+void TextureGL::updateData(uint8_t* data)
+{
+    // TODO: support texture cube, and compressed data.
+    // Storage is allocated in the constructor, so only the contents are replaced.
+    updateSubData(0, 0, _width, _height, data);
+}
+
 void TextureGL::updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data)
+{
+    uploadSubData(xoffset, yoffset, width, height, data);
+    generateMipmaps();
+}
+
+void TextureGL::uploadSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data)
 {
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, _texture);
+    
+#if defined(GL_ES_VERSION_3_0)
+    uint32_t size = width * height * _bytesPerElement;
+    if (size > 0 && uploadWithStagingBuffer(xoffset, yoffset, width, height, _format, _type, data, size))
+    {
+        CHECK_GL_ERROR_DEBUG();
+        return;
+    }
+#endif
+    
     glTexSubImage2D(GL_TEXTURE_2D,
                     0,
                     xoffset,
@@ -135,26 +108,38 @@ void TextureGL::updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width
                     _type,
                     data);
     CHECK_GL_ERROR_DEBUG();
-    
-    generateMipmpas();
-    CHECK_GL_ERROR_DEBUG();
 }
 
-void TextureGL::apply(int index) const
-{
-    glActiveTexture(GL_TEXTURE0 + index);
-    glBindTexture(GL_TEXTURE_2D, _texture);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilterGL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilterGL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _sAddressModeGL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _tAddressModeGL);
-}
-
-void TextureGL::generateMipmpas() const
+void TextureGL::generateMipmaps()
 {
     if (_isMipmapEnabled &&
         TextureUsage::RENDER_TARGET != _textureUsage)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, _texture);
         glGenerateMipmap(GL_TEXTURE_2D);
+        CHECK_GL_ERROR_DEBUG();
+    }
+}
+
+void TextureGL::apply(int index, const SamplerGL* sampler) const
+{
+    glActiveTexture(GL_TEXTURE0 + index);
+    glBindTexture(GL_TEXTURE_2D, _texture);
+    
+#if CC_GL_SAMPLER_OBJECT_SUPPORTED
+    CC_UNUSED_PARAM(sampler);
+#else
+    if (!sampler)
+        sampler = _defaultSampler;
+    
+    // Texture parameters are part of the texture object, only rewrite them when the sampler changes.
+    if (sampler && sampler->getId() != _appliedSamplerId)
+    {
+        sampler->apply(index, GL_TEXTURE_2D);
+        _appliedSamplerId = sampler->getId();
+    }
+#endif
 }
 
 void TextureGL::toGLTypes()
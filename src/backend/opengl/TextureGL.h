@@ -5,29 +5,34 @@
 
 CC_BACKEND_BEGIN
 
+class SamplerGL;
+
 class TextureGL : public Texture
 {
 public:
-    TextureGL(const TextureDescriptor& descriptor);
+    // `defaultSampler` is created from descriptor.samplerDescriptor and used when no sampler is bound.
+    TextureGL(const TextureDescriptor& descriptor, SamplerGL* defaultSampler);
     ~TextureGL();
     
     virtual void updateData(uint8_t* data) override;
     virtual void updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) override;
+    virtual void uploadSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) override;
+    virtual void generateMipmaps() override;
     
-    void apply(int index) const;
+    // Bind the texture to unit `index`. Sampler objects are bound by the command buffer, without them
+    // the states of `sampler`, or of the default sampler, are written to the texture object.
+    void apply(int index, const SamplerGL* sampler = nullptr) const;
     inline GLuint getHandler() const { return _texture; }
+    inline const SamplerGL* getDefaultSampler() const { return _defaultSampler; }
     
 private:
     void toGLTypes();
-    void generateMipmpas() const;
     
     GLuint _texture = 0;
-    SamplerDescriptor _samplerDescriptor;
-    
-    GLint _magFilterGL = GL_LINEAR;
-    GLint _minFilterGL = GL_LINEAR;
-    GLint _sAddressModeGL = GL_REPEAT;
-    GLint _tAddressModeGL = GL_REPEAT;
+    SamplerGL* _defaultSampler = nullptr;
+    // Id of the sampler whose states are written to the texture object, used when sampler objects are not
+    // supported. The sampler may be purged since, its id is never reused unlike its address.
+    mutable uint32_t _appliedSamplerId = 0;
     
     // Used in glTexImage2D().
     GLint _internalFormat = GL_RGBA;
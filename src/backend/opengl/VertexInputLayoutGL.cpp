@@ -0,0 +1,111 @@
+#include "VertexInputLayoutGL.h"
+#include "Program.h"
+#include "../HashUtils.h"
+
+#include <cassert>
+
+CC_BACKEND_BEGIN
+
+namespace
+{
+    GLenum toGLAttributeType(VertexFormat vertexFormat)
+    {
+        GLenum ret = GL_INT;
+        switch (vertexFormat)
+        {
+            case VertexFormat::FLOAT_R32G32B32A32:
+            case VertexFormat::FLOAT_R32G32B32:
+            case VertexFormat::FLOAT_R32G32:
+            case VertexFormat::FLOAT_R32:
+                ret = GL_FLOAT;
+                break;
+            case VertexFormat::INT_R32G32B32A32:
+            case VertexFormat::INT_R32G32B32:
+            case VertexFormat::INT_R32G32:
+            case VertexFormat::INT_R32:
+                ret = GL_INT;
+                break;
+            default:
+                break;
+        }
+        return ret;
+    }
+    
+    GLsizei getGLAttributeSize(VertexFormat vertexFormat)
+    {
+        GLsizei ret = 0;
+        switch (vertexFormat)
+        {
+            case VertexFormat::FLOAT_R32G32B32A32:
+            case VertexFormat::INT_R32G32B32A32:
+                ret = 4;
+                break;
+            case VertexFormat::FLOAT_R32G32B32:
+            case VertexFormat::INT_R32G32B32:
+                ret = 3;
+                break;
+            case VertexFormat::FLOAT_R32G32:
+            case VertexFormat::INT_R32G32:
+                ret = 2;
+                break;
+            case VertexFormat::FLOAT_R32:
+            case VertexFormat::INT_R32:
+                ret = 1;
+                break;
+            default:
+                break;
+        }
+        return ret;
+    }
+}
+
+std::size_t VertexInputLayoutGL::computeHash(const Program* program, const std::vector<VertexLayout>& vertexLayouts)
+{
+    std::size_t seed = 0;
+    hashCombine(seed, program);
+    for (const auto& vertexLayout : vertexLayouts)
+        hashCombine(seed, vertexLayout.hash());
+    return seed;
+}
+
+VertexInputLayoutGL::VertexInputLayoutGL(const Program* program, const std::vector<VertexLayout>& vertexLayouts)
+{
+    // Keep an entry for every vertex layout, even if it is invalid, so that the attributes
+    // match the index of the vertex buffer.
+    _attributeInfos.resize(vertexLayouts.size());
+    _attributeMasks.resize(vertexLayouts.size());
+    
+    int i = 0;
+    for (const auto& vertexLayout : vertexLayouts)
+    {
+        auto& attributeMask = _attributeMasks[i];
+        auto& vertexAttributeArray = _attributeInfos[i++];
+        if (! vertexLayout.isValid())
+            continue;
+        
+        const auto& attributes = vertexLayout.getAttributes();
+        for (const auto& attribute : attributes)
+        {
+            AttributeInfo attributeInfo;
+            
+            if (!program->getAttributeLocation(attribute.name, attributeInfo.location))
+                continue;
+            
+            attributeInfo.stride = vertexLayout.getStride();
+            attributeInfo.offset = attribute.offset;
+            attributeInfo.type = toGLAttributeType(attribute.format);
+            attributeInfo.size = getGLAttributeSize(attribute.format);
+            
+            // The enabled attributes are kept in a 32 bit mask, higher locations can't be used.
+            assert(attributeInfo.location < 32);
+            if (attributeInfo.location >= 32)
+                continue;
+            attributeMask |= (1u << attributeInfo.location);
+            _enabledAttributeMask |= (1u << attributeInfo.location);
+            
+            vertexAttributeArray.push_back(attributeInfo);
+        }
+    }
+}
+
+CC_BACKEND_END
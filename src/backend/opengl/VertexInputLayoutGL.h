@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../Macros.h"
+#include "../VertexLayout.h"
+#include "base/CCRef.h"
+#include "platform/CCGL.h"
+
+#include <cstddef>
+#include <vector>
+
+CC_BACKEND_BEGIN
+
+class Program;
+
+struct AttributeInfo
+{
+    uint32_t location = 0;
+    uint32_t size = 0;
+    GLenum type = GL_BYTE;
+    GLsizei stride = 0;
+    uint32_t offset = 0;
+};
+
+// Vertex layouts resolved against the attribute locations of a linked program. It is immutable
+// and shared by all render pipelines with the same program and vertex layouts.
+class VertexInputLayoutGL : public cocos2d::Ref
+{
+public:
+    typedef std::vector<AttributeInfo> VertexAttributeArray;
+    
+    static std::size_t computeHash(const Program* program, const std::vector<VertexLayout>& vertexLayouts);
+    
+    VertexInputLayoutGL(const Program* program, const std::vector<VertexLayout>& vertexLayouts);
+    
+    // Attributes are indexed by the index of vertex buffer they are read from.
+    inline const std::vector<VertexAttributeArray>& getAttributeInfos() const { return _attributeInfos; }
+    // The bit of an attribute location is set if the attribute is used.
+    inline uint32_t getEnabledAttributeMask() const { return _enabledAttributeMask; }
+    // The attribute location bits of every vertex buffer, only the ones with a buffer bound are enabled.
+    inline const std::vector<uint32_t>& getAttributeMasks() const { return _attributeMasks; }
+    
+private:
+    std::vector<VertexAttributeArray> _attributeInfos;
+    std::vector<uint32_t> _attributeMasks;
+    uint32_t _enabledAttributeMask = 0;
+};
+
+CC_BACKEND_END
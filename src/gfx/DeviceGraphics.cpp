@@ -33,6 +33,7 @@
 #include "GFXUtils.h"
 
 #include "platform/CCPlatformConfig.h"
+#include "platform/CCImage.h"
 
 RENDERER_BEGIN
 
@@ -68,6 +69,26 @@ bool DeviceGraphics::supportGLExtension(const std::string& extension) const
     return  (_glExtensions && strstr(_glExtensions, extension.c_str() ) ) ? true : false;
 }
 
+void DeviceGraphics::deferDeletion(GraphicsHandle* handle)
+{
+    std::lock_guard<std::mutex> lock(_deferredDeletionsMutex);
+    _deferredDeletions.push_back(handle);
+}
+
+void DeviceGraphics::processDeferredDeletions()
+{
+    {
+        std::lock_guard<std::mutex> lock(_deferredDeletionsMutex);
+        if (_deferredDeletions.empty())
+            return;
+        _deletingHandles.swap(_deferredDeletions);
+    }
+
+    for (auto handle : _deletingHandles)
+        delete handle;
+    _deletingHandles.clear();
+}
+
 void DeviceGraphics::setFrameBuffer(const FrameBuffer* fb)
 {
     if (fb == _frameBuffer)
@@ -554,11 +575,31 @@ DeviceGraphics::DeviceGraphics()
 , _sw(0)
 , _sh(0)
 , _frameBuffer(nullptr)
+, _supportMipmapStreaming(false)
+, _ownerThread(std::this_thread::get_id())
 {
     _glExtensions = (char *)glGetString(GL_EXTENSIONS);
+
+    // Desktop OpenGL and OpenGL ES 3 have GL_TEXTURE_BASE_LEVEL.
+    const char* version = (const char*)glGetString(GL_VERSION);
+    const char* esPrefix = "OpenGL ES ";
+    if (version)
+    {
+        const char* es = strstr(version, esPrefix);
+        _supportMipmapStreaming = es == nullptr || es[strlen(esPrefix)] >= '3';
+    }
     
     initCaps();
     initStates();
+
+    // Images in a compressed format the GPU can't sample are decoded by software when loaded.
+    bool etc1 = supportGLExtension("GL_OES_compressed_ETC1_RGB8_texture");
+    bool pvrtc = supportGLExtension("GL_IMG_texture_compression_pvrtc");
+    cocos2d::Image::setCompressedFormatSupported(cocos2d::Image::PixelFormat::ETC, etc1);
+    cocos2d::Image::setCompressedFormatSupported(cocos2d::Image::PixelFormat::PVRTC2, pvrtc);
+    cocos2d::Image::setCompressedFormatSupported(cocos2d::Image::PixelFormat::PVRTC2A, pvrtc);
+    cocos2d::Image::setCompressedFormatSupported(cocos2d::Image::PixelFormat::PVRTC4, pvrtc);
+    cocos2d::Image::setCompressedFormatSupported(cocos2d::Image::PixelFormat::PVRTC4A, pvrtc);
     
     _newAttributes.resize(_caps.maxVertexAttributes);
     _enabledAtrributes.resize(_caps.maxVertexAttributes);
@@ -566,12 +607,14 @@ DeviceGraphics::DeviceGraphics()
     // Make sure _currentState and _nextState have enough sapce for textures.
     _currentState.setTexture(_caps.maxTextureUnits, nullptr);
     _nextState.setTexture(_caps.maxTextureUnits, nullptr);
+    _boundTextureHandles.resize(_caps.maxTextureUnits + 1, 0);
     
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_defaultFbo);
 }
 
 DeviceGraphics::~DeviceGraphics()
 {
+    processDeferredDeletions();
     delete _glExtensions;
     RENDERER_SAFE_RELEASE(_frameBuffer);
 }
@@ -1072,17 +1115,29 @@ void DeviceGraphics::commitTextures()
     int curTextureSize = static_cast<int>(curTextureUnits.size());
     const auto& nextTextureUnits = _nextState.getTextureUnits();
     int capacity = static_cast<int>(nextTextureUnits.size());
+    // Reload evicted textures before binding any unit: a reload binds on unit 0 and restores the
+    // texture of the current state there, which would undo a binding made for this draw.
     for (int i = 0; i < capacity; ++i)
     {
-        if (i >= curTextureSize || curTextureUnits[i] != nextTextureUnits[i])
+        if (nextTextureUnits[i])
+            _textureResidency.use(nextTextureUnits[i]);
+    }
+
+    int boundSize = static_cast<int>(_boundTextureHandles.size());
+    for (int i = 0; i < capacity; ++i)
+    {
+        auto texture = nextTextureUnits[i];
+        if (!texture)
+            continue;
+
+        // Reloaded textures have a new handle, which has to be bound even if the unit didn't change.
+        GLuint handle = texture->getHandle();
+        if (i >= curTextureSize || curTextureUnits[i] != texture || i >= boundSize || _boundTextureHandles[i] != handle)
         {
-            auto texture = nextTextureUnits[i];
-            if (texture)
-            {
-                GL_CHECK(glActiveTexture(GL_TEXTURE0 + i));
-                GL_CHECK(glBindTexture(texture->getTarget(),
-                                       texture->getHandle()));
-            }
+            GL_CHECK(glActiveTexture(GL_TEXTURE0 + i));
+            GL_CHECK(glBindTexture(texture->getTarget(), handle));
+            if (i < boundSize)
+                _boundTextureHandles[i] = handle;
         }
     }
 }
@@ -25,7 +25,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include "base/ccTypes.h"
@@ -37,6 +39,8 @@
 #include "../Macro.h"
 #include "../Types.h"
 #include "State.h"
+#include "TextureResidency.h"
+#include "MipmapStreamer.h"
 
 
 RENDERER_BEGIN
@@ -46,6 +50,7 @@ class VertexBuffer;
 class IndexBuffer;
 class Program;
 class Texture;
+class GraphicsHandle;
 
 class DeviceGraphics final : public Ref
 {
@@ -63,8 +68,20 @@ public:
     static DeviceGraphics* getInstance();
     
     inline const Capacity& getCapacity() const { return _caps; }
+    /** Accounts the memory of the textures of the device, set a budget on it to evict unused textures. */
+    inline TextureResidency& getTextureResidency() { return _textureResidency; }
+    inline MipmapStreamer& getMipmapStreamer() { return _mipmapStreamer; }
+    /** Whether mipmap levels can be clamped with GL_TEXTURE_BASE_LEVEL, OpenGL ES 2 can't. */
+    inline bool supportMipmapStreaming() const { return _supportMipmapStreaming; }
     bool supportGLExtension(const std::string& extension) const;
 
+    /** Whether the calling thread is the thread of the GL context, which created the device. */
+    inline bool isOwnerThread() const { return std::this_thread::get_id() == _ownerThread; }
+    /** Queues a GL object released on another thread, it is deleted by the next processDeferredDeletions(). */
+    void deferDeletion(GraphicsHandle* handle);
+    /** Deletes the GL objects released on other threads, the renderer invokes it at the beginning of every frame. */
+    void processDeferredDeletions();
+
     void setFrameBuffer(const FrameBuffer* fb);
     void setViewport(int x, int y, int w, int h);
     void setScissor(int x, int y, int w, int h);
@@ -183,6 +200,17 @@ private:
     
     State _nextState;
     State _currentState;
+    // the handle commitTextures() bound to every unit
+    std::vector<GLuint> _boundTextureHandles;
+
+    TextureResidency _textureResidency;
+    MipmapStreamer _mipmapStreamer;
+    bool _supportMipmapStreaming;
+
+    std::thread::id _ownerThread;
+    std::mutex _deferredDeletionsMutex;
+    std::vector<GraphicsHandle*> _deferredDeletions;
+    std::vector<GraphicsHandle*> _deletingHandles;
     
     friend class IndexBuffer;
     friend class Texture2D;
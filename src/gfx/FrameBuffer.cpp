@@ -28,8 +28,7 @@
 RENDERER_BEGIN
 
 FrameBuffer::FrameBuffer()
-: _device(nullptr)
-, _depthBuffer(nullptr)
+: _depthBuffer(nullptr)
 , _stencilBuffer(nullptr)
 , _depthStencilBuffer(nullptr)
 {
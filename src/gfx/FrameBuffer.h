@@ -58,7 +58,6 @@ public:
 private:
     virtual ~FrameBuffer();
 
-    DeviceGraphics* _device;
     std::vector<RenderTarget*> _colorBuffers;
     RenderTarget* _depthBuffer;
     RenderTarget* _stencilBuffer;
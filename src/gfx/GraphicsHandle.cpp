@@ -23,11 +23,13 @@
  ****************************************************************************/
 
 #include "GraphicsHandle.h"
+#include "DeviceGraphics.h"
 
 RENDERER_BEGIN
 
 GraphicsHandle::GraphicsHandle()
-: _glID(0)
+: _device(DeviceGraphics::getInstance())
+, _glID(0)
 {
 
 }
@@ -37,4 +39,12 @@ GraphicsHandle::~GraphicsHandle()
 
 }
 
+void GraphicsHandle::onLastRelease()
+{
+    if (_device->isOwnerThread())
+        delete this;
+    else
+        _device->deferDeletion(this);
+}
+
 RENDERER_END
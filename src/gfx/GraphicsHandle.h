@@ -31,6 +31,8 @@
 
 RENDERER_BEGIN
 
+class DeviceGraphics;
+
 class GraphicsHandle : public Ref
 {
 public:
@@ -39,6 +41,12 @@ public:
     inline GLuint getHandle() const { return _glID; }
 
 protected:
+    // GL objects are deleted on the GL thread, when released elsewhere they are queued to the device.
+    virtual void onLastRelease() override;
+
+    // The device of the GL thread, taken when the handle is created so that a handle released on another
+    // thread doesn't look the device up there. init() of the subclasses sets it again.
+    DeviceGraphics* _device;
     GLuint _glID;
 };
 
@@ -28,8 +28,7 @@
 RENDERER_BEGIN
 
 IndexBuffer::IndexBuffer()
-: _device(nullptr)
-, _format(IndexFormat::UINT16)
+: _format(IndexFormat::UINT16)
 , _usage(Usage::STATIC)
 , _numIndices(0)
 , _bytesPerIndex(0)
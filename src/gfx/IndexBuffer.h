@@ -69,7 +69,6 @@ public:
     }
     
 private:
-    DeviceGraphics* _device;
     IndexFormat _format;
     Usage _usage;
     uint32_t _numIndices;
@@ -0,0 +1,70 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "MipmapStreamer.h"
+#include "Texture2D.h"
+#include <algorithm>
+
+RENDERER_BEGIN
+
+MipmapStreamer::MipmapStreamer()
+: _maxUploadsPerFrame(2)
+, _streamOutFrames(120)
+, _next(0)
+{
+}
+
+void MipmapStreamer::add(Texture2D* texture)
+{
+    if (std::find(_textures.begin(), _textures.end(), texture) == _textures.end())
+        _textures.push_back(texture);
+}
+
+void MipmapStreamer::remove(Texture2D* texture)
+{
+    auto iter = std::find(_textures.begin(), _textures.end(), texture);
+    if (iter != _textures.end())
+        _textures.erase(iter);
+}
+
+void MipmapStreamer::beginFrame()
+{
+    size_t count = _textures.size();
+    if (0 == count)
+        return;
+
+    uint32_t uploads = 0;
+    size_t start = _next % count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t index = (start + i) % count;
+        if (_textures[index]->updateMipmapStreaming(uploads < _maxUploadsPerFrame, _streamOutFrames))
+        {
+            ++uploads;
+            _next = index + 1;
+        }
+    }
+}
+
+RENDERER_END
@@ -0,0 +1,68 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "../Macro.h"
+
+RENDERER_BEGIN
+
+class Texture2D;
+
+/**
+ * Streams the mipmap levels of textures set up with Texture2D::initMipmapStreaming(). The renderer requests the
+ * level every texture needs while drawing, at the beginning of the next frame one level is streamed in toward the
+ * request for a limited number of textures, levels which haven't been requested for a while are streamed out.
+ */
+class MipmapStreamer
+{
+public:
+    MipmapStreamer();
+
+    /** Sets how many levels can be uploaded in a frame, all textures share it. */
+    inline void setMaxUploadsPerFrame(uint32_t uploads) { _maxUploadsPerFrame = uploads; }
+    inline uint32_t getMaxUploadsPerFrame() const { return _maxUploadsPerFrame; }
+    /** Sets how many frames a level stays resident after it stopped being requested. */
+    inline void setStreamOutFrames(uint32_t frames) { _streamOutFrames = frames; }
+    inline uint32_t getStreamOutFrames() const { return _streamOutFrames; }
+
+    void add(Texture2D* texture);
+    void remove(Texture2D* texture);
+    inline bool empty() const { return _textures.empty(); }
+
+    /** Applies the requests of the last frame. */
+    void beginFrame();
+
+private:
+    std::vector<Texture2D*> _textures;
+    uint32_t _maxUploadsPerFrame;
+    uint32_t _streamOutFrames;
+    // The texture the uploads start from, so that all textures get their turn when the budget is small.
+    size_t _next;
+};
+
+RENDERER_END
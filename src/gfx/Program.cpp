@@ -232,8 +232,7 @@ void Program::Uniform::setUniform(const void* value, UniformElementType elementT
 }
 
 Program::Program()
-: _device(nullptr)
-, _id(0)
+: _id(0)
 , _linked(false)
 {
 
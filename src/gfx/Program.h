@@ -71,7 +71,6 @@ public:
     inline bool isLinked() const { return _linked; }
     void link();
 private:
-    DeviceGraphics* _device;
     std::vector<Attribute> _attributes;
     std::vector<Uniform> _uniforms;
     std::string _vertSource;
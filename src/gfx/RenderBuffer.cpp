@@ -28,8 +28,7 @@
 RENDERER_BEGIN
 
 RenderBuffer::RenderBuffer()
-: _device(nullptr)
-, _format(Format::RGBA4)
+: _format(Format::RGBA4)
 , _width(0)
 , _height(0)
 {
@@ -54,7 +54,6 @@ public:
     bool init(DeviceGraphics* device, Format format, uint16_t width, uint16_t height);
 
 private:
-    DeviceGraphics* _device;
     Format _format;
     uint16_t _width;
     uint16_t _height;
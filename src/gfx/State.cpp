@@ -254,13 +254,17 @@ State& State::operator=(State&& o)
         // bindings
         maxStream = o.maxStream;
 
-        _vertexBufferOffsets = std::move(o._vertexBufferOffsets);
+        // Swap the bindings instead of moving them, the device moves its next state after every draw and
+        // both states keep the storage of their vectors that way.
+        _vertexBufferOffsets.swap(o._vertexBufferOffsets);
+        o._vertexBufferOffsets.clear();
 
         for (auto vertexBuf : _vertexBuffers)
         {
             RENDERER_SAFE_RELEASE(vertexBuf);
         }
-        _vertexBuffers = std::move(o._vertexBuffers);
+        _vertexBuffers.swap(o._vertexBuffers);
+        o._vertexBuffers.clear();
 
         RENDERER_SAFE_RELEASE(_indexBuffer);
         _indexBuffer = o._indexBuffer;
@@ -270,7 +274,8 @@ State& State::operator=(State&& o)
         {
             RENDERER_SAFE_RELEASE(texture);
         }
-        _textureUnits = std::move(o._textureUnits);
+        _textureUnits.swap(o._textureUnits);
+        o._textureUnits.clear();
 
         RENDERER_SAFE_RELEASE(_program);
         _program = o._program;
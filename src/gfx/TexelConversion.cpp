@@ -0,0 +1,243 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "TexelConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RENDERER_TEXEL_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RENDERER_TEXEL_NEON 1
+#endif
+
+namespace {
+
+    // Exact round(c * a / 255) for c, a in [0, 255].
+    inline uint8_t premultiplyComponent(uint32_t c, uint32_t a)
+    {
+        uint32_t t = c * a + 128;
+        return (uint8_t)((t + (t >> 8)) >> 8);
+    }
+
+    inline void premultiplyPixel(const uint8_t* src, uint8_t* dst)
+    {
+        uint32_t a = src[3];
+        dst[0] = premultiplyComponent(src[0], a);
+        dst[1] = premultiplyComponent(src[1], a);
+        dst[2] = premultiplyComponent(src[2], a);
+        dst[3] = (uint8_t)a;
+    }
+
+    inline uint16_t packPixelRGB565(const uint8_t* src)
+    {
+        return (uint16_t)(((src[0] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) | ((src[2] & 0xF8) >> 3));
+    }
+
+    inline uint16_t packPixelRGBA4444(const uint8_t* src)
+    {
+        return (uint16_t)(((src[0] & 0xF0) << 8) | ((src[1] & 0xF0) << 4) | (src[2] & 0xF0) | (src[3] >> 4));
+    }
+
+#if RENDERER_TEXEL_SSE2
+    // Premultiply 4 pixels.
+    inline __m128i premultiply4(__m128i v)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+        lo = _mm_add_epi16(_mm_mullo_epi16(lo, alphaLo), half);
+        hi = _mm_add_epi16(_mm_mullo_epi16(hi, alphaHi), half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        __m128i ret = _mm_packus_epi16(lo, hi);
+        return _mm_or_si128(_mm_andnot_si128(alphaMask, ret), _mm_and_si128(alphaMask, v));
+    }
+
+    // Narrow 8 unsigned 32-bit lanes holding 16-bit values, _mm_packs_epi32() saturates signed values.
+    inline __m128i packUnsigned32To16(__m128i a, __m128i b)
+    {
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+        __m128i ret = _mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32));
+        return _mm_xor_si128(ret, bias16);
+    }
+
+    inline __m128i packRGB565x4(__m128i v)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xF8)), 8);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(v, 5), _mm_set1_epi32(0x7E0));
+        __m128i b = _mm_and_si128(_mm_srli_epi32(v, 19), _mm_set1_epi32(0x1F));
+        return _mm_or_si128(_mm_or_si128(r, g), b);
+    }
+
+    inline __m128i packRGBA4444x4(__m128i v)
+    {
+        __m128i r = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xF0)), 8);
+        __m128i g = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi32(0xF00));
+        __m128i b = _mm_and_si128(_mm_srli_epi32(v, 16), _mm_set1_epi32(0xF0));
+        __m128i a = _mm_srli_epi32(v, 28);
+        return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+    }
+#endif
+
+#if RENDERER_TEXEL_NEON
+    // Exact round(c * a / 255) of 8 components.
+    inline uint8x8_t premultiply8(uint8x8_t c, uint8x8_t a)
+    {
+        uint16x8_t t = vmull_u8(c, a);
+        return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+    }
+
+    inline uint8x16x4_t premultiply16(uint8x16x4_t v)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            v.val[i] = vcombine_u8(premultiply8(vget_low_u8(v.val[i]), vget_low_u8(v.val[3])),
+                                   premultiply8(vget_high_u8(v.val[i]), vget_high_u8(v.val[3])));
+        }
+        return v;
+    }
+
+    inline uint16x8_t packRGB565x8(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+    {
+        uint16x8_t ret = vshll_n_u8(r, 8);
+        ret = vsriq_n_u16(ret, vshll_n_u8(g, 8), 5);
+        return vsriq_n_u16(ret, vshll_n_u8(b, 8), 11);
+    }
+
+    inline uint16x8_t packRGBA4444x8(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+    {
+        uint16x8_t ret = vshll_n_u8(r, 8);
+        ret = vsriq_n_u16(ret, vshll_n_u8(g, 8), 4);
+        ret = vsriq_n_u16(ret, vshll_n_u8(b, 8), 8);
+        return vsriq_n_u16(ret, vshll_n_u8(a, 8), 12);
+    }
+#endif
+
+}
+
+RENDERER_BEGIN
+
+void premultiplyRGBA8(const uint8_t* src, uint8_t* dst, size_t pixels)
+{
+    size_t i = 0;
+#if RENDERER_TEXEL_SSE2
+    for (; i + 4 <= pixels; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), premultiply4(v));
+    }
+#elif RENDERER_TEXEL_NEON
+    for (; i + 16 <= pixels; i += 16)
+        vst4q_u8(dst + i * 4, premultiply16(vld4q_u8(src + i * 4)));
+#endif
+    for (; i < pixels; ++i)
+        premultiplyPixel(src + i * 4, dst + i * 4);
+}
+
+void packRGBA8ToRGB565(const uint8_t* src, uint16_t* dst, size_t pixels, bool premultiply)
+{
+    size_t i = 0;
+#if RENDERER_TEXEL_SSE2
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(src + i * 4 + 16));
+        if (premultiply)
+        {
+            v0 = premultiply4(v0);
+            v1 = premultiply4(v1);
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), packUnsigned32To16(packRGB565x4(v0), packRGB565x4(v1)));
+    }
+#elif RENDERER_TEXEL_NEON
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        if (premultiply)
+            v = premultiply16(v);
+        vst1q_u16(dst + i, packRGB565x8(vget_low_u8(v.val[0]), vget_low_u8(v.val[1]), vget_low_u8(v.val[2])));
+        vst1q_u16(dst + i + 8, packRGB565x8(vget_high_u8(v.val[0]), vget_high_u8(v.val[1]), vget_high_u8(v.val[2])));
+    }
+#endif
+    uint8_t pixel[4];
+    for (; i < pixels; ++i)
+    {
+        const uint8_t* p = src + i * 4;
+        if (premultiply)
+        {
+            premultiplyPixel(p, pixel);
+            p = pixel;
+        }
+        dst[i] = packPixelRGB565(p);
+    }
+}
+
+void packRGBA8ToRGBA4444(const uint8_t* src, uint16_t* dst, size_t pixels, bool premultiply)
+{
+    size_t i = 0;
+#if RENDERER_TEXEL_SSE2
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(src + i * 4 + 16));
+        if (premultiply)
+        {
+            v0 = premultiply4(v0);
+            v1 = premultiply4(v1);
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), packUnsigned32To16(packRGBA4444x4(v0), packRGBA4444x4(v1)));
+    }
+#elif RENDERER_TEXEL_NEON
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        if (premultiply)
+            v = premultiply16(v);
+        vst1q_u16(dst + i, packRGBA4444x8(vget_low_u8(v.val[0]), vget_low_u8(v.val[1]), vget_low_u8(v.val[2]), vget_low_u8(v.val[3])));
+        vst1q_u16(dst + i + 8, packRGBA4444x8(vget_high_u8(v.val[0]), vget_high_u8(v.val[1]), vget_high_u8(v.val[2]), vget_high_u8(v.val[3])));
+    }
+#endif
+    uint8_t pixel[4];
+    for (; i < pixels; ++i)
+    {
+        const uint8_t* p = src + i * 4;
+        if (premultiply)
+        {
+            premultiplyPixel(p, pixel);
+            p = pixel;
+        }
+        dst[i] = packPixelRGBA4444(p);
+    }
+}
+
+RENDERER_END
@@ -0,0 +1,47 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macro.h"
+
+#include <cstddef>
+#include <cstdint>
+
+RENDERER_BEGIN
+
+/**
+ * Texel conversion kernels for the common RGBA8 upload paths, vectorized with SSE2 or NEON when available.
+ * `pixels` is the number of pixels of one row, rows are converted one by one so that the caller can flip
+ * an image by walking the destination rows backwards.
+ */
+
+// Multiply the color components by alpha, rounding to nearest. `dst` may be the same as `src`.
+void premultiplyRGBA8(const uint8_t* src, uint8_t* dst, size_t pixels);
+// Pack to GL_UNSIGNED_SHORT_5_6_5, optionally premultiplying alpha first.
+void packRGBA8ToRGB565(const uint8_t* src, uint16_t* dst, size_t pixels, bool premultiply);
+// Pack to GL_UNSIGNED_SHORT_4_4_4_4, optionally premultiplying alpha first.
+void packRGBA8ToRGBA4444(const uint8_t* src, uint16_t* dst, size_t pixels, bool premultiply);
+
+RENDERER_END
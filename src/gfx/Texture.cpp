@@ -23,8 +23,11 @@
  ****************************************************************************/
 
 #include "Texture.h"
+#include "DeviceGraphics.h"
 #include "platform/CCPlatformConfig.h"
 
+#include <algorithm>
+
 namespace {
 
     struct GLFilter
@@ -171,8 +174,7 @@ Texture::GLTextureFmt Texture::_textureFmt[] = {
 };
 
 Texture::Texture()
-: _device(nullptr)
-, _anisotropy(1)
+: _anisotropy(1)
 , _target(0)
 , _wrapS(WrapMode::REPEAT)
 , _wrapT(WrapMode::REPEAT)
@@ -192,7 +194,9 @@ Texture::~Texture()
 {
     if (_glID == 0)
     {
-        RENDERER_LOGE("Invalid texture: %p", this);
+        // Evicted textures have no GL texture.
+        if (isResident())
+            RENDERER_LOGE("Invalid texture: %p", this);
         return;
     }
 
@@ -223,6 +227,65 @@ bool Texture::init(DeviceGraphics* device)
     return true;
 }
 
+void Texture::evictStorage()
+{
+    if (_glID != 0)
+    {
+        GL_CHECK(glDeleteTextures(1, &_glID));
+        _glID = 0;
+    }
+}
+
+bool Texture::reloadStorage(const std::string& /*sourcePath*/)
+{
+    return false;
+}
+
+void Texture::updateStorageBytes(uint32_t levels, uint32_t baseLevel/* = 0*/)
+{
+    uint32_t bitsPerPixel = glTextureFmt(_format).bpp;
+    uint32_t blockWidth = 1;
+    uint32_t blockHeight = 1;
+    switch (_format)
+    {
+        case Format::RGB_DXT1:
+        case Format::RGBA_DXT1:
+        case Format::RGB_ETC1:
+            bitsPerPixel = 4;
+            blockWidth = blockHeight = 4;
+            break;
+        case Format::RGBA_DXT3:
+        case Format::RGBA_DXT5:
+            bitsPerPixel = 8;
+            blockWidth = blockHeight = 4;
+            break;
+        // PVRTC levels are 2x2 blocks at least.
+        case Format::RGB_PVRTC_2BPPV1:
+        case Format::RGBA_PVRTC_2BPPV1:
+            bitsPerPixel = 2;
+            blockWidth = 16;
+            blockHeight = 8;
+            break;
+        case Format::RGB_PVRTC_4BPPV1:
+        case Format::RGBA_PVRTC_4BPPV1:
+            bitsPerPixel = 4;
+            blockWidth = blockHeight = 8;
+            break;
+        case Format::RGB16F:
+            bitsPerPixel = 48;
+            break;
+        case Format::RGBA16F:
+            bitsPerPixel = 64;
+            break;
+        default:
+            break;
+    }
+
+    uint64_t bytes = TextureResidency::computeBytes(bitsPerPixel, blockWidth, blockHeight,
+                                                    std::max(_width >> baseLevel, 1), std::max(_height >> baseLevel, 1), levels, 1);
+    _device->getTextureResidency().add(this, bytes);
+}
+
 GLenum Texture::glFilter(Filter filter, Filter mipFilter/* = TextureFilter::NONE*/)
 {
     if (filter < Filter::NEAREST || filter > Filter::LINEAR)
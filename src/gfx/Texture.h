@@ -29,6 +29,7 @@
 
 #include "GraphicsHandle.h"
 #include "RenderTarget.h"
+#include "TextureResidency.h"
 #include "base/CCData.h"
 
 #include <vector>
@@ -37,7 +38,7 @@ RENDERER_BEGIN
 
 class DeviceGraphics;
 
-class Texture : public RenderTarget
+class Texture : public RenderTarget, public TextureResidency::Storage
 {
 public:
     // texture filter
@@ -108,7 +109,7 @@ public:
         , mipFilter(Filter::LINEAR)
         , format(Format::RGBA8)
         , hasMipmap(false)
-        , flipY(true) // TODO: Default flipY value should be false ? If it's true, it will waste some CPU resource for re-format data.
+        , flipY(true) // Wide images are flipped by uploading rows in reverse order, others are flipped in a temporary copy.
         , premultiplyAlpha(false)
         {}
 
@@ -209,6 +210,10 @@ public:
     inline uint16_t getWidth() const { return _width; }
     inline uint16_t getHeight() const { return _height; }
 
+    /** Deletes the GL texture, it is recreated by reloadStorage(). */
+    virtual void evictStorage() override;
+    virtual bool reloadStorage(const std::string& sourcePath) override;
+
 protected:
     struct GLTextureFmt
     {
@@ -229,10 +234,11 @@ protected:
     virtual ~Texture();
 
     bool init(DeviceGraphics* device);
+    /** Registers the size of the texture with the residency manager of the device. */
+    void updateStorageBytes(uint32_t levels, uint32_t baseLevel = 0);
     
     static GLTextureFmt _textureFmt[];
 
-    DeviceGraphics* _device;
     GLint _anisotropy;
     GLuint _target;
     
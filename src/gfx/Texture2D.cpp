@@ -25,6 +25,7 @@
 #include "Texture2D.h"
 #include "DeviceGraphics.h"
 #include "GFXUtils.h"
+#include "TexelConversion.h"
 #include "firefox/WebGLFormats.h"
 #include "firefox/GLConsts.h"
 #include "firefox/WebGLTexelConversions.h"
@@ -41,6 +42,14 @@ enum class gfxAlphaType {
 
 using TexImageTarget = GLenum;
 
+#ifndef GL_TEXTURE_BASE_LEVEL
+#define GL_TEXTURE_BASE_LEVEL 0x813C
+#endif
+
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
 namespace {
 
     // Returns `value` rounded to the next highest multiple of `multiple`.
@@ -255,6 +264,91 @@ namespace {
         return true;
     }
 
+    // Rows shorter than this are cheaper to flip in a temporary copy than to upload one by one.
+    const uint32_t MIN_REVERSE_UPLOAD_ROW_BYTES = 4096;
+
+    bool
+    CanUploadRowsInReverse(TexImageTarget target, WebGLTexelFormat srcFormat, WebGLTexelFormat dstFormat,
+                           uint32_t srcRowLengthBytes, bool flipY, bool premultiplyAlpha)
+    {
+        return flipY &&
+               !IsTarget3D(target) &&
+               srcFormat == dstFormat &&
+               (!premultiplyAlpha || !HasColorAndAlpha(srcFormat)) &&
+               srcRowLengthBytes >= MIN_REVERSE_UPLOAD_ROW_BYTES;
+    }
+
+    // Flip an image without copying it, by uploading the source rows from the last destination row to the first.
+    void
+    UploadRowsInReverse(bool isSubImage, TexImageTarget target, GLint level,
+                        const DriverUnpackInfo* dui, GLint xOffset, GLint yOffset,
+                        uint32_t width, uint32_t height, const uint8_t* dataPtr, ptrdiff_t srcStride)
+    {
+        if (!isSubImage)
+            DoTexImage(target, level, dui, width, height, 1, nullptr);
+
+        const auto pi = dui->ToPacking();
+        for (uint32_t row = 0; row < height; ++row) {
+            DoTexSubImage(target, level, xOffset, yOffset + (height - 1 - row), 0, width, 1, 1,
+                          pi, dataPtr + row * srcStride);
+        }
+    }
+
+    // Convert RGBA8 sources with the vectorized kernels, returns false if the conversion isn't covered by them.
+    bool
+    ConvertWithKernels(const uint32_t rowLength, const uint32_t rowCount,
+                       WebGLTexelFormat srcFormat,
+                       const uint8_t* const srcBegin, const ptrdiff_t srcStride,
+                       WebGLTexelFormat dstFormat, const ptrdiff_t dstStride,
+                       const uint8_t** const out_begin,
+                       UniqueBuffer* const out_anchoredBuffer, bool flipY, bool premultiplyAlpha)
+    {
+        if (srcFormat != WebGLTexelFormat::RGBA8)
+            return false;
+
+        if (dstFormat != WebGLTexelFormat::RGBA8 &&
+            dstFormat != WebGLTexelFormat::RGB565 &&
+            dstFormat != WebGLTexelFormat::RGBA4444)
+            return false;
+
+        // Flips and stride changes only are row copies, ConvertImage() already handles them with memcpy().
+        if (dstFormat == WebGLTexelFormat::RGBA8 && !premultiplyAlpha)
+            return false;
+
+        const auto dstTotalBytes = CheckedUint32(rowCount) * dstStride;
+        if (!dstTotalBytes.isValid())
+            return false;
+
+        // Every row is written, so the buffer doesn't need to be cleared.
+        UniqueBuffer dstBuffer = malloc(dstTotalBytes.value());
+        if (!dstBuffer.get())
+            return false;
+        const auto dstBegin = static_cast<uint8_t*>(dstBuffer.get());
+
+        for (uint32_t row = 0; row < rowCount; ++row) {
+            const uint8_t* srcRow = srcBegin + row * srcStride;
+            uint8_t* dstRow = dstBegin + (flipY ? rowCount - 1 - row : row) * dstStride;
+
+            switch (dstFormat) {
+                case WebGLTexelFormat::RGBA8:
+                    cocos2d::renderer::premultiplyRGBA8(srcRow, dstRow, rowLength);
+                    break;
+                case WebGLTexelFormat::RGB565:
+                    cocos2d::renderer::packRGBA8ToRGB565(srcRow, reinterpret_cast<uint16_t*>(dstRow), rowLength, premultiplyAlpha);
+                    break;
+                case WebGLTexelFormat::RGBA4444:
+                    cocos2d::renderer::packRGBA8ToRGBA4444(srcRow, reinterpret_cast<uint16_t*>(dstRow), rowLength, premultiplyAlpha);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        *out_begin = dstBegin;
+        *out_anchoredBuffer = Move(dstBuffer);
+        return true;
+    }
+
     WebGLTexelFormat
     FormatForPackingInfo(const PackingInfo& pi)
     {
@@ -392,7 +486,22 @@ namespace {
             const auto dstRowLengthBytes = rowLength * dstBPP;
             const auto dstStride = RoundUpToMultipleOf(dstRowLengthBytes, dstAlignment);
 
+            if (depth == 1 &&
+                CanUploadRowsInReverse(target, srcFormat, dstFormat, srcRowLengthBytes, flipY, premultiplyAlpha))
+            {
+                UploadRowsInReverse(isSubImage, target, level, dui, xOffset, yOffset,
+                                    width, height, dataPtr, srcStride);
+                return true;
+            }
+
             ////
+            if (depth == 1 &&
+                ConvertWithKernels(rowLength, rowCount, srcFormat, dataPtr, srcStride,
+                                   dstFormat, dstStride, &uploadPtr, &tempBuffer, flipY, premultiplyAlpha))
+            {
+                break;
+            }
+
             if (!ConvertIfNeeded(funcName, rowLength, rowCount, srcFormat, dataPtr,
                                  srcStride, dstFormat, dstStride, &uploadPtr, &tempBuffer, flipY, premultiplyAlpha))
             {
@@ -503,6 +612,13 @@ namespace {
 RENDERER_BEGIN
 
 Texture2D::Texture2D()
+: _flipY(true)
+, _premultiplyAlpha(false)
+, _mipmapLevels(0)
+, _baseLevel(0)
+, _residentLevel(0)
+, _requestedLevel(0)
+, _unrequestedFrames(0)
 {
     RENDERER_LOGD("Construct Texture2D: %p", this);
 }
@@ -510,6 +626,8 @@ Texture2D::Texture2D()
 Texture2D::~Texture2D()
 {
     RENDERER_LOGD("Destruct Texture2D: %p", this);
+    if (isMipmapStreaming())
+        _device->getMipmapStreamer().remove(this);
 }
 
 bool Texture2D::init(DeviceGraphics* device, const Options& options)
@@ -544,6 +662,8 @@ void Texture2D::update(const Options& options)
     _wrapT = options.wrapT;
     _format = options.format;
     _compressed = _format >= Format::RGB_DXT1 && _format <= Format::RGBA_PVRTC_4BPPV1;
+    _flipY = options.flipY;
+    _premultiplyAlpha = options.premultiplyAlpha;
 
     // check if generate mipmap
     _hasMipmap = options.hasMipmap;
@@ -577,6 +697,11 @@ void Texture2D::update(const Options& options)
         GL_CHECK(glGenerateMipmap(GL_TEXTURE_2D));
     }
     _device->restoreTexture(0);
+
+    uint32_t levels = (uint32_t)options.images.size();
+    if (genMipmap)
+        levels = TextureResidency::computeLevels(_width, _height);
+    updateStorageBytes(levels > 0 ? levels : 1);
 }
 
 void Texture2D::updateSubImage(const SubImageOption& option)
@@ -599,8 +724,254 @@ void Texture2D::updateImage(const ImageOption& option)
     _device->restoreTexture(0);
 }
 
+void Texture2D::updateCompressedMipmaps(Format format, uint16_t width, uint16_t height, const cocos2d::MipmapInfo* mipmaps, int count)
+{
+    if (format < Format::RGB_DXT1 || format > Format::RGBA_PVRTC_4BPPV1)
+    {
+        RENDERER_LOGE("Texture2D::updateCompressedMipmaps: format %d isn't compressed.", (int)format);
+        return;
+    }
+
+    _width = width;
+    _height = height;
+    _format = format;
+    _compressed = true;
+    _hasMipmap = count > 1;
+
+    const GLTextureFmt& glFmt = glTextureFmt(_format);
+
+    GL_CHECK(glActiveTexture(GL_TEXTURE0));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, _glID));
+    for (int i = 0; i < count; ++i)
+    {
+        GLsizei levelWidth = std::max(_width >> i, 1);
+        GLsizei levelHeight = std::max(_height >> i, 1);
+        DoCompressedTexImage(GL_TEXTURE_2D, i, glFmt.internalFormat, levelWidth, levelHeight, 1, mipmaps[i].len, mipmaps[i].address);
+    }
+    setTexInfo();
+    _device->restoreTexture(0);
+
+    updateStorageBytes(count > 0 ? count : 1);
+}
+
+void Texture2D::setSourcePath(const std::string& sourcePath)
+{
+    _device->getTextureResidency().setSourcePath(this, sourcePath);
+}
+
+bool Texture2D::reloadStorage(const std::string& sourcePath)
+{
+    // Streamed textures come back with the levels they had, from their loader.
+    if (isMipmapStreaming())
+        return createStreamedStorage();
+
+    auto image = new (std::nothrow) cocos2d::Image();
+    bool ok = image && image->initWithImageFile(sourcePath);
+    if (ok && (image->getWidth() != _width || image->getHeight() != _height))
+    {
+        RENDERER_LOGW("Texture2D::reloadStorage: size of %s changed.", sourcePath.c_str());
+        ok = false;
+    }
+
+    if (ok)
+    {
+        GL_CHECK(glGenTextures(1, &_glID));
+        if (_compressed)
+        {
+            ok = image->isCompressed() && image->getNumberOfMipmaps() > 0;
+            if (ok)
+                updateCompressedMipmaps(_format, _width, _height, image->getMipmaps(), image->getNumberOfMipmaps());
+        }
+        else
+        {
+            // The file has to decode to the format the texture was created with.
+            const GLTextureFmt& glFmt = glTextureFmt(_format);
+            ok = !image->isCompressed() && image->getDataLen() == (ssize_t)_width * _height * glFmt.bpp / 8;
+            if (ok)
+            {
+                Options options;
+                options.width = _width;
+                options.height = _height;
+                options.anisotropy = _anisotropy;
+                options.wrapS = _wrapS;
+                options.wrapT = _wrapT;
+                options.minFilter = _minFilter;
+                options.magFilter = _magFilter;
+                options.mipFilter = _mipFilter;
+                options.format = _format;
+                options.hasMipmap = _hasMipmap;
+                options.flipY = _flipY;
+                options.premultiplyAlpha = _premultiplyAlpha;
+                options.images.resize(1);
+                options.images[0].copy(image->getData(), image->getDataLen());
+                update(options);
+            }
+        }
+
+        if (!ok)
+        {
+            RENDERER_LOGW("Texture2D::reloadStorage: failed to reload %s.", sourcePath.c_str());
+            GL_CHECK(glDeleteTextures(1, &_glID));
+            _glID = 0;
+        }
+    }
+
+    CC_SAFE_RELEASE(image);
+    return ok;
+}
+
+void Texture2D::initMipmapStreaming(const Options& options, int residentLevel, const MipmapLoader& loader)
+{
+    _width = options.width;
+    _height = options.height;
+    _anisotropy = options.anisotropy;
+    _minFilter = options.minFilter;
+    _magFilter = options.magFilter;
+    _mipFilter = options.mipFilter;
+    _wrapS = options.wrapS;
+    _wrapT = options.wrapT;
+    _format = options.format;
+    _compressed = _format >= Format::RGB_DXT1 && _format <= Format::RGBA_PVRTC_4BPPV1;
+    _flipY = options.flipY;
+    _premultiplyAlpha = options.premultiplyAlpha;
+    _hasMipmap = true;
+
+    int levels = (int)TextureResidency::computeLevels(_width, _height);
+    if (!_device->supportMipmapStreaming())
+        residentLevel = 0;
+    residentLevel = std::min(std::max(residentLevel, 0), levels - 1);
+
+    _mipmapLoader = loader;
+    _mipmapLevels = levels;
+    _baseLevel = residentLevel;
+    _residentLevel = residentLevel;
+    _requestedLevel = levels;
+    _unrequestedFrames = 0;
+
+    GL_CHECK(glActiveTexture(GL_TEXTURE0));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, _glID));
+    // The small level 0 allocated by init() stays below the base level, where it doesn't count for completeness.
+    for (int level = levels - 1; level >= residentLevel; --level)
+        uploadMipmapLevel(level);
+    setTexInfo();
+    if (_device->supportMipmapStreaming())
+    {
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, _baseLevel));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1));
+    }
+    _device->restoreTexture(0);
+
+    updateStorageBytes(levels - _baseLevel, _baseLevel);
+
+    // Nothing to stream if everything is resident already.
+    if (0 == residentLevel)
+    {
+        _mipmapLevels = 0;
+        _mipmapLoader = nullptr;
+    }
+    else
+        _device->getMipmapStreamer().add(this);
+}
+
+bool Texture2D::updateMipmapStreaming(bool canUpload, uint32_t streamOutFrames)
+{
+    int requested = std::min(_requestedLevel, _residentLevel);
+    _requestedLevel = _mipmapLevels;
+
+    // Evicted textures are reloaded with the levels they had.
+    if (!isResident())
+        return false;
+
+    if (requested < _baseLevel)
+    {
+        _unrequestedFrames = 0;
+        if (!canUpload)
+            return false;
+
+        GL_CHECK(glActiveTexture(GL_TEXTURE0));
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D, _glID));
+        bool ok = uploadMipmapLevel(_baseLevel - 1);
+        if (ok)
+            setBaseLevel(_baseLevel - 1);
+        _device->restoreTexture(0);
+        return ok;
+    }
+
+    if (requested > _baseLevel)
+    {
+        // Recreating the texture uploads the levels that stay, so it waits for the upload budget too.
+        if (++_unrequestedFrames < streamOutFrames || !canUpload)
+            return false;
+
+        // GL can't free a single level, the texture is recreated without it.
+        _unrequestedFrames = 0;
+        ++_baseLevel;
+        if (!createStreamedStorage())
+        {
+            --_baseLevel;
+            return false;
+        }
+        updateStorageBytes(_mipmapLevels - _baseLevel, _baseLevel);
+        return true;
+    }
+
+    _unrequestedFrames = 0;
+    return false;
+}
+
 // Private methods:
 
+bool Texture2D::createStreamedStorage()
+{
+    GLuint glID = 0;
+    GL_CHECK(glGenTextures(1, &glID));
+    GL_CHECK(glActiveTexture(GL_TEXTURE0));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, glID));
+    bool ok = true;
+    for (int level = _mipmapLevels - 1; level >= _baseLevel && ok; --level)
+        ok = uploadMipmapLevel(level);
+    if (ok)
+    {
+        setTexInfo();
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, _baseLevel));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _mipmapLevels - 1));
+        std::swap(glID, _glID);
+    }
+
+    if (0 != glID)
+        GL_CHECK(glDeleteTextures(1, &glID));
+    _device->restoreTexture(0);
+    return ok;
+}
+
+bool Texture2D::uploadMipmapLevel(int level)
+{
+    cocos2d::Data image;
+    if (!_mipmapLoader || !_mipmapLoader(level, image))
+    {
+        RENDERER_LOGW("Texture2D: failed to load mipmap level %d.", level);
+        return false;
+    }
+
+    ImageOption option;
+    option.level = level;
+    option.width = std::max(_width >> level, 1);
+    option.height = std::max(_height >> level, 1);
+    option.format = _format;
+    option.flipY = _flipY;
+    option.premultiplyAlpha = _premultiplyAlpha;
+    option.image = std::move(image);
+    setImage(glTextureFmt(_format), option);
+    return true;
+}
+
+void Texture2D::setBaseLevel(int level)
+{
+    _baseLevel = level;
+    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, _baseLevel));
+    updateStorageBytes(_mipmapLevels - _baseLevel, _baseLevel);
+}
+
 void Texture2D::setSubImage(const GLTextureFmt& glFmt, const SubImageOption& option)
 {
     const auto& img = option.image;
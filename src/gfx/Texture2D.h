@@ -28,6 +28,9 @@
 #include "../Types.h"
 
 #include "Texture.h"
+#include "platform/CCImage.h"
+
+#include <functional>
 
 RENDERER_BEGIN
 
@@ -43,13 +46,64 @@ public:
     void update(const Options& options);
     void updateSubImage(const SubImageOption& option);
     void updateImage(const ImageOption& option);
+    /**
+     * Uploads the mipmaps of a compressed image straight from the memory they point to, without copying them
+     * into Options::images first. `format` has to be a compressed format.
+     */
+    void updateCompressedMipmaps(Format format, uint16_t width, uint16_t height, const cocos2d::MipmapInfo* mipmaps, int count);
+    /**
+     * Sets the image file the texture was loaded from. Only textures with a source path can be evicted when the
+     * texture budget of the device is exceeded, they are decoded from it again the next time they are used.
+     */
+    void setSourcePath(const std::string& sourcePath);
+
+    virtual bool reloadStorage(const std::string& sourcePath) override;
+
+    /** Loads the image of mipmap `level` of a streamed texture, returns false if it isn't available. */
+    typedef std::function<bool(int level, cocos2d::Data& image)> MipmapLoader;
+    /**
+     * Uploads the mipmap levels from `residentLevel` down to 1x1 with `loader` and streams the bigger levels in
+     * when the renderer requests them, the levels are clamped with GL_TEXTURE_BASE_LEVEL. The size, format and
+     * sampler states are taken from `options`, its images are ignored. Every level is uploaded now if the device
+     * can't clamp mipmap levels. Create the texture with the default options first, so level 0 is small.
+     */
+    void initMipmapStreaming(const Options& options, int residentLevel, const MipmapLoader& loader);
+    /** Asks for `level` to be resident, the finest level requested in a frame is streamed in. */
+    inline void requestMipmapLevel(int level) { if (level < _requestedLevel) _requestedLevel = level; }
+    inline bool isMipmapStreaming() const { return _mipmapLevels > 0; }
+    inline int getBaseLevel() const { return _baseLevel; }
+    /**
+     * Called by the MipmapStreamer once a frame, streams one level in toward the requested level if `canUpload`
+     * is true, or streams the base level out if it wasn't requested for `streamOutFrames` frames. Streaming out
+     * recreates the texture with the remaining levels, so it waits for `canUpload` as well.
+     * Returns true if anything was uploaded.
+     */
+    bool updateMipmapStreaming(bool canUpload, uint32_t streamOutFrames);
 
 private:
     void setSubImage(const GLTextureFmt& glFmt, const SubImageOption& options);
     void setImage(const GLTextureFmt& glFmt, const ImageOption& options);
     void setMipmap(const std::vector<cocos2d::Data>& images, bool isFlipY, bool isPremultiplyAlpha);
     void setTexInfo();
+    /**
+     * Creates a new GL texture with the levels from the base level down to 1x1 and deletes the old one.
+     * Keeps the old texture if a level can't be loaded.
+     */
+    bool createStreamedStorage();
+    bool uploadMipmapLevel(int level);
+    void setBaseLevel(int level);
+
+    bool _flipY;
+    bool _premultiplyAlpha;
 
+    MipmapLoader _mipmapLoader;
+    // Number of levels of a streamed texture, 0 if it isn't streamed.
+    int _mipmapLevels;
+    int _baseLevel;
+    // The coarsest level streaming can go back to.
+    int _residentLevel;
+    int _requestedLevel;
+    uint32_t _unrequestedFrames;
 };
 
 RENDERER_END
@@ -0,0 +1,240 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "TextureResidency.h"
+
+RENDERER_BEGIN
+
+TextureResidency::Storage::Storage()
+: _residency(nullptr)
+, _bytes(0)
+, _lastUsedFrame(0)
+, _resident(false)
+{
+}
+
+TextureResidency::Storage::~Storage()
+{
+    if (_residency)
+        _residency->remove(this);
+}
+
+TextureResidency::TextureResidency()
+: _budget(0)
+, _evictAfterFrames(60)
+, _frame(0)
+{
+}
+
+TextureResidency::~TextureResidency()
+{
+    for (auto storage : _resident)
+        storage->_residency = nullptr;
+    for (auto storage : _evicted)
+        storage->_residency = nullptr;
+}
+
+void TextureResidency::setBudget(uint64_t bytes)
+{
+    _budget = bytes;
+}
+
+void TextureResidency::setEvictAfterFrames(uint32_t frames)
+{
+    _evictAfterFrames = frames > 0 ? frames : 1;
+}
+
+void TextureResidency::add(Storage* storage, uint64_t bytes)
+{
+    if (storage->_residency == this)
+    {
+        // Reloads update the size too, the storage is moved back to the resident list by use().
+        if (storage->_resident)
+        {
+            _stats.residentBytes = _stats.residentBytes - storage->_bytes + bytes;
+            if (_stats.residentBytes > _stats.peakResidentBytes)
+                _stats.peakResidentBytes = _stats.residentBytes;
+        }
+        else
+            _stats.evictedBytes = _stats.evictedBytes - storage->_bytes + bytes;
+        storage->_bytes = bytes;
+        return;
+    }
+
+    if (storage->_residency)
+        storage->_residency->remove(storage);
+
+    storage->_residency = this;
+    storage->_bytes = bytes;
+    storage->_lastUsedFrame = _frame;
+    storage->_resident = true;
+    storage->_iter = _resident.insert(_resident.begin(), storage);
+
+    _stats.residentBytes += bytes;
+    if (_stats.residentBytes > _stats.peakResidentBytes)
+        _stats.peakResidentBytes = _stats.residentBytes;
+}
+
+void TextureResidency::setSourcePath(Storage* storage, const std::string& sourcePath)
+{
+    storage->_sourcePath = sourcePath;
+}
+
+void TextureResidency::remove(Storage* storage)
+{
+    if (storage->_residency != this)
+        return;
+
+    if (storage->_resident)
+    {
+        _resident.erase(storage->_iter);
+        _stats.residentBytes -= storage->_bytes;
+    }
+    else
+    {
+        _evicted.erase(storage->_iter);
+        _stats.evictedBytes -= storage->_bytes;
+    }
+    storage->_residency = nullptr;
+    storage->_resident = false;
+}
+
+bool TextureResidency::use(Storage* storage)
+{
+    if (storage->_residency != this)
+        return false;
+
+    if (storage->_resident)
+    {
+        // Textures are used by many draws in a frame, only the first one moves it.
+        if (storage->_lastUsedFrame != _frame)
+        {
+            storage->_lastUsedFrame = _frame;
+            _resident.splice(_resident.begin(), _resident, storage->_iter);
+        }
+        return true;
+    }
+
+    if (!storage->reloadStorage(storage->_sourcePath))
+    {
+        ++_stats.failedReloads;
+        return false;
+    }
+
+    ++_stats.reloads;
+    _evicted.erase(storage->_iter);
+    _stats.evictedBytes -= storage->_bytes;
+    storage->_iter = _resident.insert(_resident.begin(), storage);
+    storage->_resident = true;
+    storage->_lastUsedFrame = _frame;
+
+    // Going over the budget here is fine, it is trimmed at the beginning of the next frame.
+    _stats.residentBytes += storage->_bytes;
+    if (_stats.residentBytes > _stats.peakResidentBytes)
+        _stats.peakResidentBytes = _stats.residentBytes;
+    return true;
+}
+
+void TextureResidency::beginFrame()
+{
+    ++_frame;
+    trim();
+}
+
+void TextureResidency::trim()
+{
+    if (0 == _budget)
+        return;
+
+    auto iter = _resident.end();
+    while (_stats.residentBytes > _budget && iter != _resident.begin())
+    {
+        --iter;
+        Storage* storage = *iter;
+        // The list is sorted by the last use, the textures in front of this one are used more recently.
+        if (_frame - storage->_lastUsedFrame < _evictAfterFrames)
+            break;
+
+        if (storage->_sourcePath.empty())
+            continue;
+
+        // Move past the node first, evicting erases it.
+        ++iter;
+        evict(storage);
+    }
+}
+
+TextureResidency::Stats TextureResidency::getStats() const
+{
+    Stats stats = _stats;
+    stats.budget = _budget;
+    stats.residentCount = (uint32_t)_resident.size();
+    stats.evictedCount = (uint32_t)_evicted.size();
+    stats.frame = _frame;
+    return stats;
+}
+
+uint64_t TextureResidency::computeBytes(uint32_t bitsPerPixel, uint32_t blockWidth, uint32_t blockHeight,
+                                        uint32_t width, uint32_t height, uint32_t levels, uint32_t faces)
+{
+    uint64_t bits = 0;
+    for (uint32_t level = 0; level < levels; ++level)
+    {
+        uint64_t levelWidth = width >> level > 0 ? width >> level : 1;
+        uint64_t levelHeight = height >> level > 0 ? height >> level : 1;
+        uint64_t blocksX = (levelWidth + blockWidth - 1) / blockWidth;
+        uint64_t blocksY = (levelHeight + blockHeight - 1) / blockHeight;
+        bits += blocksX * blockWidth * blocksY * blockHeight * bitsPerPixel;
+    }
+    return (bits + 7) / 8 * faces;
+}
+
+uint32_t TextureResidency::computeLevels(uint32_t width, uint32_t height)
+{
+    uint32_t size = width > height ? width : height;
+    uint32_t levels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+// Private methods:
+
+void TextureResidency::evict(Storage* storage)
+{
+    storage->evictStorage();
+
+    _resident.erase(storage->_iter);
+    storage->_iter = _evicted.insert(_evicted.end(), storage);
+    storage->_resident = false;
+
+    _stats.residentBytes -= storage->_bytes;
+    _stats.evictedBytes += storage->_bytes;
+    ++_stats.evictions;
+}
+
+RENDERER_END
@@ -0,0 +1,138 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <list>
+#include <string>
+#include "../Macro.h"
+
+RENDERER_BEGIN
+
+/**
+ * Accounts the GPU memory of textures and keeps it under a budget. Textures are kept in least recently used order,
+ * when the resident bytes exceed the budget the textures which haven't been used for a number of frames are evicted,
+ * oldest first. Only textures with a source path can be evicted, they are reloaded from it when they are used again.
+ */
+class TextureResidency
+{
+public:
+    /**
+     * The GPU storage of a texture, implemented by the texture. It is unregistered when destroyed.
+     */
+    class Storage
+    {
+    public:
+        virtual ~Storage();
+
+        /** Frees the GPU memory, the storage stays registered and is reloaded when it is used again. */
+        virtual void evictStorage() = 0;
+        /** Recreates the GPU memory from `sourcePath`, returns false if it failed. */
+        virtual bool reloadStorage(const std::string& sourcePath) = 0;
+
+        inline bool isResident() const { return _resident; }
+        inline uint64_t getStorageBytes() const { return _bytes; }
+        inline const std::string& getSourcePath() const { return _sourcePath; }
+
+    protected:
+        Storage();
+
+    private:
+        friend class TextureResidency;
+
+        TextureResidency* _residency;
+        std::list<Storage*>::iterator _iter;
+        std::string _sourcePath;
+        uint64_t _bytes;
+        uint32_t _lastUsedFrame;
+        bool _resident;
+    };
+
+    struct Stats
+    {
+        uint64_t budget = 0;
+        uint64_t residentBytes = 0;
+        uint64_t peakResidentBytes = 0;
+        uint64_t evictedBytes = 0;
+        uint32_t residentCount = 0;
+        uint32_t evictedCount = 0;
+        uint32_t frame = 0;
+        // Totals since the manager was created.
+        uint32_t evictions = 0;
+        uint32_t reloads = 0;
+        uint32_t failedReloads = 0;
+    };
+
+    TextureResidency();
+    ~TextureResidency();
+
+    /** Sets the budget in bytes, 0 means there is no budget and nothing is evicted. */
+    void setBudget(uint64_t bytes);
+    inline uint64_t getBudget() const { return _budget; }
+    /** Textures are only evicted if they haven't been used for `frames` frames, 1 at least. */
+    void setEvictAfterFrames(uint32_t frames);
+    inline uint32_t getEvictAfterFrames() const { return _evictAfterFrames; }
+
+    /** Registers `storage` as resident, or updates its size if it is registered already. */
+    void add(Storage* storage, uint64_t bytes);
+    /** Sets the file `storage` is reloaded from, an empty path means it can't be evicted. */
+    void setSourcePath(Storage* storage, const std::string& sourcePath);
+    void remove(Storage* storage);
+    /**
+     * Marks `storage` as used in the current frame, reloading it first if it was evicted.
+     * Returns false if it isn't registered or couldn't be reloaded.
+     */
+    bool use(Storage* storage);
+
+    /** Starts a new frame and evicts textures if the budget is exceeded. */
+    void beginFrame();
+    /** Evicts the least recently used textures until the budget is met or no texture can be evicted. */
+    void trim();
+
+    Stats getStats() const;
+    inline uint32_t getFrame() const { return _frame; }
+
+    /**
+     * Bytes of a texture with `levels` mipmap levels and `faces` faces. The size of every level is rounded up to
+     * `blockWidth` x `blockHeight` blocks, use 1 x 1 for uncompressed formats.
+     */
+    static uint64_t computeBytes(uint32_t bitsPerPixel, uint32_t blockWidth, uint32_t blockHeight,
+                                 uint32_t width, uint32_t height, uint32_t levels, uint32_t faces);
+    /** Number of levels of a full mipmap chain down to 1x1. */
+    static uint32_t computeLevels(uint32_t width, uint32_t height);
+
+private:
+    void evict(Storage* storage);
+
+    // Resident textures, the most recently used first.
+    std::list<Storage*> _resident;
+    std::list<Storage*> _evicted;
+    Stats _stats;
+    uint64_t _budget;
+    uint32_t _evictAfterFrames;
+    uint32_t _frame;
+};
+
+RENDERER_END
@@ -28,8 +28,7 @@
 RENDERER_BEGIN
 
 VertexBuffer::VertexBuffer()
-: _device(nullptr)
-, _usage(Usage::STATIC)
+: _usage(Usage::STATIC)
 , _numVertices(0)
 , _bytes(0)
 {
@@ -107,9 +107,9 @@ VertexFormat& VertexFormat::operator=(const VertexFormat& o)
     if (this != &o)
     {
         _attr2el = o._attr2el;
+        _bytes = o._bytes;
 #if GFX_DEBUG > 0
         _elements = o._elements;
-        _bytes = o._bytes;
 #endif
     }
     return *this;
@@ -120,10 +120,10 @@ VertexFormat& VertexFormat::operator=(VertexFormat&& o)
     if (this != &o)
     {
         _attr2el = std::move(o._attr2el);
-#if GFX_DEBUG > 0
-        _elements = std::move(o._elements);
         _bytes = o._bytes;
         o._bytes = 0;
+#if GFX_DEBUG > 0
+        _elements = std::move(o._elements);
 #endif
     }
     return *this;
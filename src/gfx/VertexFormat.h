@@ -94,7 +94,7 @@ private:
 #if GFX_DEBUG > 0
     std::vector<Element> _elements;
 #endif
-    uint32_t _bytes;
+    uint32_t _bytes = 0;
 
     friend class VertexBuffer;
 };
@@ -0,0 +1,186 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AtlasBatch.h"
+#include <algorithm>
+#include <new>
+#include "gfx/DeviceGraphics.h"
+#include "gfx/IndexBuffer.h"
+#include "gfx/VertexBuffer.h"
+#include "InputAssembler.h"
+
+RENDERER_BEGIN
+
+namespace
+{
+    // 16 bit indices address 65536 vertices, 4 per quad
+    const uint32_t MAX_QUADS_PER_DRAW = 65536 / 4;
+}
+
+AtlasBatch::AtlasBatch()
+{
+}
+
+AtlasBatch::~AtlasBatch()
+{
+    for (auto& batch : _batches)
+        RENDERER_SAFE_RELEASE(batch.ia);
+}
+
+bool AtlasBatch::init(DeviceGraphics* device)
+{
+    _device = device;
+    return nullptr != _device;
+}
+
+void AtlasBatch::clear()
+{
+    for (auto& batch : _batches)
+    {
+        batch.vertices.clear();
+        batch.indices.clear();
+    }
+    _draws.clear();
+}
+
+void AtlasBatch::addQuad(const TextureAtlas::Entry& entry, float x, float y, float width, float height, uint32_t color)
+{
+    if (entry.page >= _pages.size())
+        _pages.resize(entry.page + 1);
+
+    // continue in the next batch of the page once 16 bit indices run out
+    auto& batches = _pages[entry.page];
+    size_t chunk = 0;
+    while (chunk < batches.size() && _batches[batches[chunk]].vertices.size() / 4 >= MAX_QUADS_PER_DRAW)
+        ++chunk;
+    if (chunk == batches.size())
+    {
+        batches.push_back(_batches.size());
+        _batches.resize(_batches.size() + 1);
+    }
+
+    PageBatch& batch = _batches[batches[chunk]];
+    batch.texture = entry.texture;
+    uint16_t first = (uint16_t)batch.vertices.size();
+    batch.vertices.push_back({x, y, entry.u0, entry.v0, color});
+    batch.vertices.push_back({x + width, y, entry.u1, entry.v0, color});
+    batch.vertices.push_back({x + width, y + height, entry.u1, entry.v1, color});
+    batch.vertices.push_back({x, y + height, entry.u0, entry.v1, color});
+
+    const uint16_t quad[] = { 0, 1, 2, 2, 3, 0 };
+    for (auto index : quad)
+        batch.indices.push_back(first + index);
+}
+
+void AtlasBatch::commit()
+{
+    _draws.clear();
+    for (const auto& batches : _pages)
+    {
+        for (auto i : batches)
+        {
+            PageBatch& batch = _batches[i];
+            uint32_t quads = (uint32_t)batch.vertices.size() / 4;
+            if (0 == quads || !reserve(i, quads))
+                continue;
+
+            VertexBuffer* vb = batch.ia->getVertexBuffer();
+            IndexBuffer* ib = batch.ia->getIndexBuffer();
+            vb->update(0, batch.vertices.data(), batch.vertices.size() * sizeof(Vertex));
+            ib->update(0, batch.indices.data(), batch.indices.size() * sizeof(uint16_t));
+            batch.ia->setCount((int)batch.indices.size());
+            _draws.push_back(i);
+        }
+    }
+}
+
+InputAssembler* AtlasBatch::getInputAssembler(size_t index) const
+{
+    return index < _draws.size() ? _batches[_draws[index]].ia : nullptr;
+}
+
+Texture2D* AtlasBatch::getTexture(size_t index) const
+{
+    return index < _draws.size() ? _batches[_draws[index]].texture : nullptr;
+}
+
+// private functions
+
+bool AtlasBatch::reserve(size_t index, uint32_t quads)
+{
+    PageBatch& batch = _batches[index];
+    if (quads <= batch.capacity)
+        return true;
+
+    uint32_t capacity = std::max(batch.capacity, 64u);
+    while (capacity < quads)
+        capacity *= 2;
+    capacity = std::min(capacity, MAX_QUADS_PER_DRAW);
+
+    static const VertexFormat format({
+        { ATTRIB_NAME_POSITION, AttribType::FLOAT32, 2 },
+        { ATTRIB_NAME_UV0, AttribType::FLOAT32, 2 },
+        { ATTRIB_NAME_COLOR, AttribType::UINT8, 4, true }
+    });
+
+    std::vector<uint8_t> zeros(capacity * 4 * sizeof(Vertex));
+    auto vb = new (std::nothrow) VertexBuffer();
+    auto ib = new (std::nothrow) IndexBuffer();
+    if (nullptr == vb || nullptr == ib ||
+        !vb->init(_device, format, Usage::DYNAMIC, zeros.data(), zeros.size(), capacity * 4) ||
+        !ib->init(_device, IndexFormat::UINT16, Usage::DYNAMIC, zeros.data(), capacity * 6 * sizeof(uint16_t), capacity * 6))
+    {
+        RENDERER_SAFE_RELEASE(vb);
+        RENDERER_SAFE_RELEASE(ib);
+        return false;
+    }
+
+    // renderer stages refresh the buffers from these before drawing, _batches may have grown by then
+    vb->setFetchDataCallback([this, index](size_t* bytes) {
+        auto& vertices = _batches[index].vertices;
+        *bytes = vertices.size() * sizeof(Vertex);
+        return (uint8_t*)vertices.data();
+    });
+    ib->setFetchDataCallback([this, index](size_t* bytes) {
+        auto& indices = _batches[index].indices;
+        *bytes = indices.size() * sizeof(uint16_t);
+        return (uint8_t*)indices.data();
+    });
+
+    if (nullptr == batch.ia)
+        batch.ia = new (std::nothrow) InputAssembler();
+    if (nullptr == batch.ia)
+    {
+        vb->release();
+        ib->release();
+        return false;
+    }
+    batch.ia->init(vb, ib);
+    vb->release();
+    ib->release();
+    batch.capacity = capacity;
+    return true;
+}
+
+RENDERER_END
@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include "base/CCRef.h"
+#include "../Macro.h"
+#include "TextureAtlas.h"
+
+RENDERER_BEGIN
+
+class DeviceGraphics;
+class InputAssembler;
+class VertexBuffer;
+class IndexBuffer;
+
+/**
+ * Collects textured quads by atlas page, so every sprite packed into one page is drawn with a single
+ * InputAssembler and texture bind. Pages with more quads than 16 bit indices can address are split into
+ * several draws. Vertices are a_position (2 floats), a_uv0 (2 floats) and a_color (RGBA8).
+ */
+class AtlasBatch : public Ref
+{
+public:
+    struct Vertex
+    {
+        float x;
+        float y;
+        float u;
+        float v;
+        uint32_t color;
+    };
+
+    RENDERER_DEFINE_CREATE_METHOD_1(AtlasBatch, init, DeviceGraphics*)
+
+    AtlasBatch();
+    virtual ~AtlasBatch();
+
+    bool init(DeviceGraphics* device);
+
+    /** Drops the quads of the previous frame. */
+    void clear();
+    /** Adds a quad showing `entry` at (`x`, `y`) with the given size, `color` is RGBA8 in memory order. */
+    void addQuad(const TextureAtlas::Entry& entry, float x, float y, float width, float height, uint32_t color = 0xffffffff);
+    /** Uploads the quads added since clear(), one draw per page that has any, more for very large pages. */
+    void commit();
+
+    inline size_t getDrawCount() const { return _draws.size(); }
+    /** Geometry of the `index`th draw, valid after commit(). */
+    InputAssembler* getInputAssembler(size_t index) const;
+    /** Page texture of the `index`th draw, valid after commit(). */
+    Texture2D* getTexture(size_t index) const;
+
+private:
+    struct PageBatch
+    {
+        Texture2D* texture = nullptr;
+        std::vector<Vertex> vertices;
+        std::vector<uint16_t> indices;
+        InputAssembler* ia = nullptr;
+        uint32_t capacity = 0;
+    };
+
+    bool reserve(size_t index, uint32_t quads);
+
+    DeviceGraphics* _device = nullptr;
+    // every batch is one draw at most, a page fills its batches in order
+    std::vector<PageBatch> _batches;
+    std::vector<std::vector<size_t>> _pages;
+    std::vector<size_t> _draws;
+
+    CC_DISALLOW_COPY_ASSIGN_AND_MOVE(AtlasBatch);
+};
+
+RENDERER_END
@@ -0,0 +1,139 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AtlasPacker.h"
+
+RENDERER_BEGIN
+
+AtlasPacker::AtlasPacker()
+{
+}
+
+void AtlasPacker::reset(uint16_t width, uint16_t height)
+{
+    _width = width;
+    _height = height;
+    _usedArea = 0;
+    _skyline.clear();
+    _skyline.push_back({0, 0, width});
+}
+
+bool AtlasPacker::insert(uint16_t width, uint16_t height, Rect& rect)
+{
+    if (0 == width || 0 == height)
+        return false;
+
+    size_t bestIndex = _skyline.size();
+    uint32_t bestBottom = UINT32_MAX;
+    uint16_t bestWidth = UINT16_MAX;
+    uint16_t y = 0;
+    for (size_t i = 0, len = _skyline.size(); i < len; ++i)
+    {
+        if (!fits(i, width, height, y))
+            continue;
+
+        uint32_t bottom = y + height;
+        if (bottom < bestBottom || (bottom == bestBottom && _skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestBottom = bottom;
+            bestWidth = _skyline[i].width;
+            rect.x = _skyline[i].x;
+            rect.y = y;
+        }
+    }
+
+    if (bestIndex == _skyline.size())
+        return false;
+
+    rect.width = width;
+    rect.height = height;
+    addSegment(bestIndex, rect);
+    _usedArea += (uint32_t)width * height;
+    return true;
+}
+
+float AtlasPacker::getOccupancy() const
+{
+    uint32_t area = (uint32_t)_width * _height;
+    return area > 0 ? (float)_usedArea / area : 0.f;
+}
+
+// private functions
+
+bool AtlasPacker::fits(size_t index, uint16_t width, uint16_t height, uint16_t& y) const
+{
+    if ((uint32_t)_skyline[index].x + width > _width)
+        return false;
+
+    // the rectangle rests on the highest segment below it
+    y = 0;
+    int32_t remaining = width;
+    for (size_t i = index, len = _skyline.size(); remaining > 0 && i < len; ++i)
+    {
+        if (_skyline[i].y > y)
+            y = _skyline[i].y;
+        if ((uint32_t)y + height > _height)
+            return false;
+        remaining -= _skyline[i].width;
+    }
+    return true;
+}
+
+void AtlasPacker::addSegment(size_t index, const Rect& rect)
+{
+    _skyline.insert(_skyline.begin() + index, {rect.x, (uint16_t)(rect.y + rect.height), rect.width});
+
+    // cut away the segments now covered by the new one
+    uint32_t right = (uint32_t)rect.x + rect.width;
+    size_t i = index + 1;
+    while (i < _skyline.size() && _skyline[i].x < right)
+    {
+        uint32_t segmentRight = (uint32_t)_skyline[i].x + _skyline[i].width;
+        if (segmentRight <= right)
+        {
+            _skyline.erase(_skyline.begin() + i);
+        }
+        else
+        {
+            _skyline[i].width = (uint16_t)(segmentRight - right);
+            _skyline[i].x = (uint16_t)right;
+            break;
+        }
+    }
+
+    // merge neighbours at the same height
+    for (i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+            ++i;
+    }
+}
+
+RENDERER_END
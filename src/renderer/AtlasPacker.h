@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "../Macro.h"
+
+RENDERER_BEGIN
+
+/**
+ * Skyline bin packer for texture atlas pages. The top edge of everything packed so far is kept as a list of
+ * horizontal segments, a new rectangle goes to the lowest position it fits in, the narrowest segment wins ties.
+ * Rectangles can't be removed one by one, the page is reset instead.
+ */
+class AtlasPacker
+{
+public:
+    struct Rect
+    {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint16_t width = 0;
+        uint16_t height = 0;
+    };
+
+    AtlasPacker();
+
+    /** Empties the page and sets its size. */
+    void reset(uint16_t width, uint16_t height);
+    /** Finds room for a `width` x `height` rectangle, returns false if the page has none left. */
+    bool insert(uint16_t width, uint16_t height, Rect& rect);
+
+    inline uint16_t getWidth() const { return _width; }
+    inline uint16_t getHeight() const { return _height; }
+    inline uint32_t getUsedArea() const { return _usedArea; }
+    /** Fraction of the page covered by the packed rectangles. */
+    float getOccupancy() const;
+
+private:
+    struct Segment
+    {
+        uint16_t x;
+        uint16_t y;
+        uint16_t width;
+    };
+
+    bool fits(size_t index, uint16_t width, uint16_t height, uint16_t& y) const;
+    void addSegment(size_t index, const Rect& rect);
+
+    std::vector<Segment> _skyline;
+    uint16_t _width = 0;
+    uint16_t _height = 0;
+    uint32_t _usedArea = 0;
+};
+
+RENDERER_END
@@ -24,6 +24,8 @@
 
 #include "BaseRenderer.h"
 #include <new>
+#include <algorithm>
+#include <cmath>
 #include "gfx/DeviceGraphics.h"
 #include "gfx/Texture2D.h"
 #include "ProgramLib.h"
@@ -38,6 +40,20 @@
 
 RENDERER_BEGIN
 
+namespace
+{
+    // Requests the level whose texels match the pixels the texture covers, assuming it covers the whole node.
+    void requestMipmapLevel(Texture2D* texture, float screenSize)
+    {
+        if (!texture->isMipmapStreaming())
+            return;
+
+        float texels = std::max(texture->getWidth(), texture->getHeight());
+        int level = texels > screenSize ? (int)std::log2(texels / screenSize) : 0;
+        texture->requestMipmapLevel(level);
+    }
+}
+
 BaseRenderer::BaseRenderer()
 {}
 
@@ -51,6 +67,10 @@ BaseRenderer::~BaseRenderer()
     
     RENDERER_SAFE_RELEASE(_defaultTexture);
     _defaultTexture = nullptr;
+
+    for (auto view : _views)
+        view->release();
+    _views.clear();
 }
 
 bool BaseRenderer::init(DeviceGraphics* device, std::vector<ProgramLib::Template>& programTemplates)
@@ -122,13 +142,17 @@ void BaseRenderer::render(const View* view, const Scene* scene)
         }
     }
     
-    // dispatch draw items to different stage
-    _stageInfos.clear();
+    // dispatch draw items to different stage, the item vectors keep their capacity
+    _stageInfoCount = view->stages.size();
+    if (_stageInfos.size() < _stageInfoCount)
+        _stageInfos.resize(_stageInfoCount);
     StageItem stageItem;
-    StageInfo stageInfo;
-    for (const auto& stage : view->stages)
+    bool streaming = !_device->getMipmapStreamer().empty();
+    for (size_t stageIndex = 0; stageIndex < _stageInfoCount; ++stageIndex)
     {
-        std::vector<StageItem> stageItems;
+        const auto& stage = view->stages[stageIndex];
+        auto& stageItems = _stageInfos[stageIndex].items;
+        stageItems.clear();
         for (const auto& item : _drawItems)
         {
             auto tech = item.effect->getTechnique(stage);
@@ -141,19 +165,19 @@ void BaseRenderer::render(const View* view, const Scene* scene)
                 stageItem.defines = item.defines;
                 stageItem.technique = tech;
                 stageItem.sortKey = -1;
+                stageItem.screenSize = streaming ? computeScreenSize(view, item.node) : 0.f;
                 
                 stageItems.push_back(stageItem);
             }
         }
         
-        stageInfo.stage = stage;
-        stageInfo.items = std::move(stageItems);
-        _stageInfos.push_back(std::move(stageInfo));
+        _stageInfos[stageIndex].stage = stage;
     }
     
     // render stages
-    for (const auto& stageInfo : _stageInfos)
+    for (size_t stageIndex = 0; stageIndex < _stageInfoCount; ++stageIndex)
     {
+        const auto& stageInfo = _stageInfos[stageIndex];
         if (_stage2fn.end() != _stage2fn.find(stageInfo.stage))
         {
             auto& fn = _stage2fn.at(stageInfo.stage);
@@ -204,7 +228,8 @@ void BaseRenderer::draw(const StageItem& item)
         if (Effect::Property::Type::TEXTURE_2D == propType ||
             Effect::Property::Type::TEXTURE_CUBE == propType)
         {
-            if (0 != param.getCount())
+            // a single texture is stored as the value itself, only more than one is an array
+            if (1 < param.getCount())
             {
                 if (param.getCount() != prop->getCount())
                 {
@@ -212,17 +237,22 @@ void BaseRenderer::draw(const StageItem& item)
                     continue;
                 }
                 
-                std::vector<int> slots;
+                _textureSlots.clear();
                 for (int i = 0; i < param.getCount(); ++i)
-                    slots.push_back(allocTextureUnit());
+                    _textureSlots.push_back(allocTextureUnit());
                 _device->setTextureArray(param.getName(),
-                                         std::move(prop->getTextureArray()),
-                                         slots);
+                                         prop->getTextureArray(),
+                                         _textureSlots);
             }
             else
+            {
+                auto texture = (renderer::Texture *)(prop->getValue());
+                if (Effect::Property::Type::TEXTURE_2D == propType && item.screenSize > 0.f)
+                    requestMipmapLevel(static_cast<Texture2D*>(texture), item.screenSize);
                 _device->setTexture(param.getName(),
-                                    (renderer::Texture *)(prop->getValue()),
+                                    texture,
                                     allocTextureUnit());
+            }
         }
         else
         {
@@ -345,12 +375,36 @@ int BaseRenderer::allocTextureUnit()
 
 void BaseRenderer::reset()
 {
-    
+    // Every frame starts with a reset, textures which weren't used for a while may be evicted here.
+    _device->processDeferredDeletions();
+    _device->getTextureResidency().beginFrame();
+    _device->getMipmapStreamer().beginFrame();
+    _usedViewCount = 0;
 }
 
 View* BaseRenderer::requestView()
 {
-    return new (std::nothrow) View();
+    if (_usedViewCount == _views.size())
+        _views.push_back(new (std::nothrow) View());
+    return _views[_usedViewCount++];
+}
+
+float BaseRenderer::computeScreenSize(const View* view, const INode* node) const
+{
+    if (!node)
+        return 0.f;
+
+    // The node is taken as a unit sized object, scaled by its world scale.
+    Mat4 worldMatrix = node->getWorldMatrix();
+    Vec3 scale;
+    worldMatrix.getScale(&scale);
+    float size = std::max(std::abs(scale.x), std::max(std::abs(scale.y), std::abs(scale.z)));
+
+    // w is the view depth for perspective projections and 1 for orthographic ones.
+    Vec4 position(worldMatrix.m[12], worldMatrix.m[13], worldMatrix.m[14], 1.f);
+    view->matViewProj.transformVector(&position);
+    float w = std::max(std::abs(position.w), 0.0001f);
+    return size * view->matProj.m[5] * 0.5f * view->rect.h / w;
 }
 
 RENDERER_END
@@ -53,9 +53,11 @@ public:
         INode* node = nullptr;
         InputAssembler *ia = nullptr;
         Effect* effect = nullptr;
-        ValueMap* defines = nullptr;
+        DefineSet* defines = nullptr;
         Technique* technique = nullptr;
         int sortKey = -1;
+        // Pixels covered by one unit of the node on screen, picks the mipmap levels of streamed textures.
+        float screenSize = 0.f;
     };
     typedef std::function<void(const View*, const std::vector<StageItem>&)> StageCallback;
 
@@ -80,7 +82,9 @@ protected:
     void resetTextureUint();
     int allocTextureUnit();
     void reset();
+    // Returns a view owned by the renderer, views are handed out again after the next reset().
     View* requestView();
+    float computeScreenSize(const View* view, const INode* node) const;
     
     int _usedTextureUnits = 0;
     DeviceGraphics* _device = nullptr;
@@ -88,7 +92,12 @@ protected:
     Texture2D* _defaultTexture = nullptr;
     std::unordered_map<std::string, StageCallback> _stage2fn;
     std::vector<DrawItem> _drawItems;
+    // Reused from frame to frame, only the first _stageInfoCount entries belong to the current view.
     std::vector<StageInfo> _stageInfos;
+    size_t _stageInfoCount = 0;
+    std::vector<View*> _views;
+    size_t _usedViewCount = 0;
+    std::vector<int> _textureSlots;
 
     CC_DISALLOW_COPY_ASSIGN_AND_MOVE(BaseRenderer);
 };
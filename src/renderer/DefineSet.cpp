@@ -0,0 +1,228 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "DefineSet.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+RENDERER_BEGIN
+
+namespace
+{
+    std::mutex s_namesMutex;
+    std::unordered_map<std::string, DefineSet::NameID> s_nameIDs;
+    // a deque doesn't move its elements, getName() can return references
+    std::deque<std::string> s_names;
+
+    inline bool lessID(const DefineSet::Define& define, DefineSet::NameID id)
+    {
+        return define.id < id;
+    }
+}
+
+DefineSet::NameID DefineSet::getNameID(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(s_namesMutex);
+    auto iter = s_nameIDs.find(name);
+    if (iter != s_nameIDs.end())
+        return iter->second;
+
+    NameID id = (NameID)s_names.size();
+    s_names.push_back(name);
+    s_nameIDs.emplace(name, id);
+    return id;
+}
+
+const std::string& DefineSet::getName(NameID id)
+{
+    std::lock_guard<std::mutex> lock(s_namesMutex);
+    return s_names.at(id);
+}
+
+void DefineSet::set(NameID id, int32_t value, bool number)
+{
+    auto iter = std::lower_bound(_defines.begin(), _defines.end(), id, lessID);
+    if (iter != _defines.end() && iter->id == id)
+    {
+        if (iter->value == value && iter->number == number)
+            return;
+        iter->value = value;
+        iter->number = number;
+    }
+    else
+    {
+        _defines.insert(iter, {id, value, number});
+    }
+    updateHash();
+}
+
+void DefineSet::set(const std::string& name, const Value& value)
+{
+    auto type = value.getType();
+    if (Value::Type::INTEGER == type || Value::Type::UNSIGNED == type)
+        set(getNameID(name), value.asInt(), true);
+    else
+        set(getNameID(name), value.asBool() ? 1 : 0, false);
+}
+
+const DefineSet::Define* DefineSet::find(NameID id) const
+{
+    auto iter = std::lower_bound(_defines.begin(), _defines.end(), id, lessID);
+    if (iter != _defines.end() && iter->id == id)
+        return &(*iter);
+    return nullptr;
+}
+
+bool DefineSet::merge(const DefineSet& other)
+{
+    if (_hash == other._hash && *this == other)
+        return false;
+
+    // both are sorted, walk them together
+    bool changed = false;
+    auto iter = _defines.begin();
+    for (const auto& define : other._defines)
+    {
+        while (iter != _defines.end() && iter->id < define.id)
+            ++iter;
+
+        if (iter != _defines.end() && iter->id == define.id)
+        {
+            if (iter->value != define.value || iter->number != define.number)
+            {
+                iter->value = define.value;
+                iter->number = define.number;
+                changed = true;
+            }
+        }
+        else
+        {
+            iter = _defines.insert(iter, define);
+            changed = true;
+        }
+        ++iter;
+    }
+
+    if (changed)
+        updateHash();
+    return changed;
+}
+
+void DefineSet::clear()
+{
+    _defines.clear();
+    _hash = 0;
+}
+
+bool DefineSet::operator==(const DefineSet& other) const
+{
+    if (_hash != other._hash || _defines.size() != other._defines.size())
+        return false;
+
+    for (size_t i = 0, len = _defines.size(); i < len; ++i)
+    {
+        const Define& a = _defines[i];
+        const Define& b = other._defines[i];
+        if (a.id != b.id || a.value != b.value || a.number != b.number)
+            return false;
+    }
+    return true;
+}
+
+Value DefineSet::toValue(const Define& define)
+{
+    return define.number ? Value(define.value) : Value(define.value != 0);
+}
+
+ValueMap DefineSet::toValueMap() const
+{
+    ValueMap ret;
+    for (const auto& define : _defines)
+        ret.emplace(getName(define.id), toValue(define));
+    return ret;
+}
+
+void DefineSet::updateHash()
+{
+    // FNV-1a over the fields
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto& define : _defines)
+    {
+        hash = (hash ^ define.id) * 1099511628211ULL;
+        hash = (hash ^ (uint32_t)define.value) * 1099511628211ULL;
+        hash = (hash ^ (define.number ? 1 : 0)) * 1099511628211ULL;
+    }
+    _hash = (size_t)hash;
+}
+
+uint32_t DefineKeyLayout::add(DefineSet::NameID id, int32_t min, int32_t max)
+{
+    uint32_t bits = 1;
+    if (max > min)
+    {
+        // enough bits for max - min
+        bits = 0;
+        for (uint32_t range = (uint32_t)(max - min); range != 0; range >>= 1)
+            ++bits;
+    }
+    else
+    {
+        min = max = 0;
+    }
+
+    uint32_t offset = _bitCount;
+    _fields.push_back({id, offset, min, max});
+    _bitCount += bits;
+    return offset;
+}
+
+uint32_t DefineKeyLayout::getKey(const DefineSet& defines) const
+{
+    uint32_t key = 0;
+    for (const auto& field : _fields)
+    {
+        const DefineSet::Define* def = defines.find(field.id);
+        if (nullptr == def || 0 == def->value)
+            continue;
+
+        if (field.max > field.min && def->number)
+        {
+            // a value outside the range would share its key with another one
+            assert(def->value >= field.min && def->value <= field.max);
+            key |= (uint32_t)(def->value - field.min) << field.offset;
+        }
+        else
+        {
+            // a define that is off generates the same source as a missing one
+            key |= 1u << field.offset;
+        }
+    }
+    return key;
+}
+
+RENDERER_END
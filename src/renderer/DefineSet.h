@@ -0,0 +1,118 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "base/CCValue.h"
+#include "../Macro.h"
+
+RENDERER_BEGIN
+
+/**
+ * The shader defines of an effect or a draw, replaces a ValueMap of define name to value in the render loop.
+ * Names are interned into ids once, the defines are kept in a small vector sorted by id and the hash of the
+ * whole set is updated on change, so reading, merging and comparing sets touches no strings.
+ * A define is either a switch, emitted as `#define NAME` when non zero, or a number, substituted into the source.
+ */
+class DefineSet
+{
+public:
+    typedef uint32_t NameID;
+
+    struct Define
+    {
+        NameID id;
+        int32_t value;
+        bool number;
+    };
+
+    /** Returns the id of a define name, the same name always gets the same id. Safe to call from any thread. */
+    static NameID getNameID(const std::string& name);
+    /** Returns the name of an id returned by getNameID(). */
+    static const std::string& getName(NameID id);
+
+    /** Sets a define, adding it if needed. */
+    void set(NameID id, int32_t value, bool number = false);
+    /** Sets a define from a JS value: integers are numbers, anything else is a switch. */
+    void set(const std::string& name, const Value& value);
+    /** Returns the define, nullptr if the set doesn't have it. */
+    const Define* find(NameID id) const;
+    /** Sets all the defines of `other`, returns whether this set changed. */
+    bool merge(const DefineSet& other);
+    void clear();
+
+    inline bool empty() const { return _defines.empty(); }
+    inline size_t size() const { return _defines.size(); }
+    inline std::vector<Define>::const_iterator begin() const { return _defines.begin(); }
+    inline std::vector<Define>::const_iterator end() const { return _defines.end(); }
+    inline size_t getHash() const { return _hash; }
+
+    bool operator==(const DefineSet& other) const;
+    inline bool operator!=(const DefineSet& other) const { return !(*this == other); }
+
+    /** Converts a define to a Value, for the script bindings. */
+    static Value toValue(const Define& define);
+    /** Converts the set to a ValueMap, for the script bindings. */
+    ValueMap toValueMap() const;
+
+private:
+    void updateHash();
+
+    std::vector<Define> _defines;
+    size_t _hash = 0;
+};
+
+/**
+ * Packs the defines of a shader template into the bits of a program key, so that every variant of the template
+ * gets its own key. A switch takes one bit, set when it is non zero. A number declared with a range takes the bits
+ * to hold its value minus the min, a number outside its range asserts. A number without a range is keyed as a switch.
+ */
+class DefineKeyLayout
+{
+public:
+    /** Adds a define, a number if max > min, and returns the offset of its bits. */
+    uint32_t add(DefineSet::NameID id, int32_t min = 0, int32_t max = 0);
+    /** Returns the key of `defines`, missing defines count as 0. */
+    uint32_t getKey(const DefineSet& defines) const;
+    /** Returns the number of bits the keys take, past 32 they don't fit. */
+    inline uint32_t getBitCount() const { return _bitCount; }
+
+private:
+    struct Field
+    {
+        DefineSet::NameID id;
+        uint32_t offset;
+        int32_t min;
+        int32_t max;
+    };
+
+    std::vector<Field> _fields;
+    uint32_t _bitCount = 0;
+};
+
+RENDERER_END
@@ -27,13 +27,17 @@
 
 RENDERER_BEGIN
 
+RENDERER_DEFINE_SLAB_ALLOCATOR(Effect)
+
 Effect::Effect(const Vector<Technique*>& techniques,
                const std::unordered_map<std::string, Property>& properties,
                const std::vector<ValueMap>& defineTemplates)
 : _techniques(techniques)
 , _properties(properties)
-, _defineTemplates(defineTemplates)
 {
+    for (const auto& def : defineTemplates)
+        _defines.set(def.at("name").asString(), def.at("value"));
+
     RENDERER_LOGD("Effect construction: %p", this);
 }
 
@@ -45,7 +49,7 @@ Effect::~Effect()
 void Effect::clear()
 {
     _techniques.clear();
-    _defineTemplates.clear();
+    _defines.clear();
 }
 
 Technique* Effect::getTechnique(const std::string& stage) const
@@ -65,33 +69,24 @@ Technique* Effect::getTechnique(const std::string& stage) const
 
 Value Effect::getDefineValue(const std::string& name) const
 {
-    for (const auto& def : _defineTemplates)
-    {
-        if (name == def.at("name").asString())
-            return def.at("value");
-    }
+    const DefineSet::Define* def = _defines.find(DefineSet::getNameID(name));
+    if (def)
+        return DefineSet::toValue(*def);
     
-    RENDERER_LOGW("Failed to set define %s, define not found.", name.c_str());
+    RENDERER_LOGW("Failed to get define %s, define not found.", name.c_str());
     return Value::Null;
 }
 
 void Effect::setDefineValue(const std::string& name, const Value& value)
 {
-    for (auto& def : _defineTemplates)
-    {
-        if (name == def.at("name").asString())
-        {
-            def["value"] = value;
-            return;
-        }
-    }
+    // only the defines declared by the effect can be set
+    if (_defines.find(DefineSet::getNameID(name)))
+        _defines.set(name, value);
 }
 
-ValueMap* Effect::extractDefines(ValueMap& out) const
+DefineSet* Effect::extractDefines(DefineSet& out) const
 {
-    for (auto& def : _defineTemplates)
-        out[def.at("name").asString()] = def.at("value");
-    
+    out.merge(_defines);
     return &out;
 }
 
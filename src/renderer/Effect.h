@@ -29,12 +29,16 @@
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "../Macro.h"
+#include "SlabAllocator.h"
 #include "Technique.h"
+#include "DefineSet.h"
 
 RENDERER_BEGIN
 
 class Effect : public Ref
 {
+    RENDERER_DECLARE_SLAB_ALLOCATOR()
+
 public:
     
     typedef Technique::Parameter Property;
@@ -51,14 +55,14 @@ public:
     
     Value getDefineValue(const std::string& name) const;
     void setDefineValue(const std::string& name, const Value& value);
-    ValueMap* extractDefines(ValueMap& out) const;
+    DefineSet* extractDefines(DefineSet& out) const;
     
     const Property& getProperty(const std::string& name) const;
     void setProperty(const std::string& name, const Property& property);
     
 private:
     Vector<Technique*> _techniques;
-    std::vector<ValueMap> _defineTemplates;
+    DefineSet _defines;
     std::unordered_map<std::string, Property> _properties;
 };
 
@@ -59,10 +59,9 @@ void ForwardRenderer::render(Scene* scene)
     const auto& cameras = scene->getCameras();
     for (auto camera : cameras)
     {
-        View* view = new View();
+        View* view = requestView();
         camera->extractView(*view, _width, _height);
         BaseRenderer::render(view, scene);
-        view->release();
     }
 }
 
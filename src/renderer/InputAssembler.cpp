@@ -28,6 +28,8 @@
 
 RENDERER_BEGIN
 
+RENDERER_DEFINE_SLAB_ALLOCATOR(InputAssembler)
+
 InputAssembler::InputAssembler()
 {
 }
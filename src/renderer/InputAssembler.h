@@ -26,6 +26,7 @@
 
 #include "../Types.h"
 #include "../Macro.h"
+#include "SlabAllocator.h"
 
 RENDERER_BEGIN
 
@@ -34,6 +35,8 @@ class IndexBuffer;
 
 class InputAssembler : public Ref
 {
+    RENDERER_DECLARE_SLAB_ALLOCATOR()
+
 public:
     InputAssembler();
     ~InputAssembler();
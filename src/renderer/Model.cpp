@@ -28,6 +28,8 @@
 
 RENDERER_BEGIN
 
+RENDERER_DEFINE_SLAB_ALLOCATOR(Model)
+
 Model::Model()
 {
     RENDERER_LOGD("Model construction %p", this);
@@ -58,7 +60,7 @@ void Model::addEffect(Effect* effect)
     
     _effects.pushBack(effect);
     
-    ValueMap defs;
+    DefineSet defs;
     effect->extractDefines(defs);
     _defines.push_back(std::move(defs));
 }
@@ -77,7 +79,7 @@ void Model::extractDrawItem(DrawItem& out, uint32_t index) const
         out.node = _node;
         out.ia = nullptr;
         out.effect = _effects.at(0);
-        out.defines = out.effect->extractDefines(const_cast<ValueMap&>(_defines[0]));
+        out.defines = out.effect->extractDefines(const_cast<DefineSet&>(_defines[0]));
         
         return;
     }
@@ -102,7 +104,7 @@ void Model::extractDrawItem(DrawItem& out, uint32_t index) const
         index = (uint32_t)(effectsSize - 1);
     
     out.effect = const_cast<Effect*>(_effects.at(index));
-    out.defines = out.effect->extractDefines(const_cast<ValueMap&>(_defines[index]));
+    out.defines = out.effect->extractDefines(const_cast<DefineSet&>(_defines[index]));
 }
 
 RENDERER_END
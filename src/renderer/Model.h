@@ -28,7 +28,9 @@
 #include "base/CCVector.h"
 #include "base/CCValue.h"
 #include "math/Mat4.h"
+#include "DefineSet.h"
 #include "../Macro.h"
+#include "SlabAllocator.h"
 
 RENDERER_BEGIN
 
@@ -43,11 +45,13 @@ struct DrawItem
     Model* model = nullptr;
     InputAssembler* ia = nullptr;
     Effect* effect = nullptr;
-    ValueMap* defines;
+    DefineSet* defines = nullptr;
 };
 
 class Model : public Ref
 {
+    RENDERER_DECLARE_SLAB_ALLOCATOR()
+
 public:
     Model();
     ~Model();
@@ -79,7 +83,7 @@ private:
     Mat4 _worldMatrix;
     Vector<Effect*> _effects;
     Vector<InputAssembler*> _inputAssemblers;
-    std::vector<ValueMap> _defines;
+    std::vector<DefineSet> _defines;
     bool _dynamicIA = false;
     int _viewID = -1;
 };
@@ -26,6 +26,8 @@
 
 RENDERER_BEGIN
 
+RENDERER_DEFINE_SLAB_ALLOCATOR(Pass)
+
 Pass::Pass(const std::string& programName)
 : _programName(programName)
 {
@@ -27,12 +27,15 @@
 #include <string>
 #include <base/CCRef.h>
 #include "../Macro.h"
+#include "SlabAllocator.h"
 #include "../Types.h"
 
 RENDERER_BEGIN
 
 class Pass : public Ref
 {
+    RENDERER_DECLARE_SLAB_ALLOCATOR()
+
 public:
     Pass(const std::string& programName);
     virtual ~Pass();
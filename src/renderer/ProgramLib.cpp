@@ -34,36 +34,30 @@
 namespace {
     uint32_t _shdID = 0;
 
-    std::string generateDefines(const cocos2d::ValueMap& defMap)
+    std::string generateDefines(const cocos2d::renderer::DefineSet& defines)
     {
         std::string ret;
-        for (const auto& def : defMap)
+        for (const auto& def : defines)
         {
-            if (def.second.asBool())
+            if (def.value != 0)
             {
-                ret += "#define "  + def.first + "\n";
+                ret += "#define "  + cocos2d::renderer::DefineSet::getName(def.id) + "\n";
             }
         }
         return ret;
     }
 
-    std::string replaceMacroNums(const std::string str, const cocos2d::ValueMap& defMap)
+    std::string replaceMacroNums(const std::string str, const cocos2d::renderer::DefineSet& defines)
     {
-        cocos2d::ValueMap cache;
         std::string tmp = str;
-        for (const auto& def : defMap)
+        for (const auto& def : defines)
         {
-            if (def.second.getType() == cocos2d::Value::Type::INTEGER || def.second.getType() == cocos2d::Value::Type::UNSIGNED)
+            if (def.number)
             {
-                cache.emplace(def.first, def.second);
+                std::regex pattern(cocos2d::renderer::DefineSet::getName(def.id));
+                tmp = std::regex_replace(tmp, pattern, std::to_string(def.value));
             }
         }
-
-        for (const auto& def : cache)
-        {
-            std::regex pattern(def.first);
-            tmp = std::regex_replace(tmp, pattern, def.second.asString());
-        }
         return tmp;
     }
 
@@ -156,26 +150,27 @@ void ProgramLib::define(const std::string& name, const std::string& vert, const
     uint32_t id = ++_shdID;
 
     // calculate option mask offset
-    uint32_t offset = 0;
+    DefineKeyLayout keyLayout;
     for (auto& def : defines)
     {
         ValueMap& oneDefMap = def.asValueMap();
-        uint32_t cnt = 1;
-
-        //FIXME: currently we don't use min, max.
-//        if (def.min != -1 && def.max != -1) {
-//            cnt = (uint32_t)std::ceil((def.max - def.min) * 0.5);
-//
-//            def._map = std::bind(&Option::_map_1, def, std::placeholders::_1);
-//        }
-//        else
-//        {
-//            def._map = std::bind(&Option::_map_2, def, std::placeholders::_1);
-//        }
-
-        offset += cnt;
-
-        oneDefMap["_offset"] = offset;
+        int32_t min = 0;
+        int32_t max = 0;
+        auto minIter = oneDefMap.find("min");
+        auto maxIter = oneDefMap.find("max");
+        if (minIter != oneDefMap.end() && maxIter != oneDefMap.end())
+        {
+            min = minIter->second.asInt();
+            max = maxIter->second.asInt();
+        }
+
+        oneDefMap["_offset"] = keyLayout.add(DefineSet::getNameID(oneDefMap["name"].asString()), min, max);
+    }
+
+    // the key keeps 8 bits for the template id
+    if (keyLayout.getBitCount() > 24)
+    {
+        RENDERER_LOGW("Shader %s has too many defines: %u key bits of 24, some variants share a program.", name.c_str(), keyLayout.getBitCount());
     }
 
     std::string newVert = _precision + vert;
@@ -188,32 +183,21 @@ void ProgramLib::define(const std::string& name, const std::string& vert, const
     templ.vert = newVert;
     templ.frag = newFrag;
     templ.defines = defines;
+    templ.keyLayout = std::move(keyLayout);
 }
 
-uint32_t ProgramLib::getKey(const std::string& name, const ValueMap& defines)
+uint32_t ProgramLib::getKey(const std::string& name, const DefineSet& defines)
 {
     auto iter = _templates.find(name);
     assert(iter != _templates.end());
 
     auto& tmpl = iter->second;
-    int32_t key = 0;
-    for (auto& tmplDefs : tmpl.defines) {
-        auto& tmplDefMap = tmplDefs.asValueMap();
-        std::string tempName = tmplDefMap["name"].asString();
-        auto iter2 = defines.find(tempName);
-        if (iter2 == defines.end()) {
-            continue;
-        }
-//        const auto& value = iter2->second;
-//        key |= tmplDefs._map(100); //FIXME:
-        uint32_t offset = tmplDefMap["_offset"].asUnsignedInt();
-        key |= 1 << offset;
-    }
+    uint32_t key = tmpl.keyLayout.getKey(defines);
 
     return key << 8 | tmpl.id;
 }
 
-Program* ProgramLib::getProgram(const std::string& name, const ValueMap& defines)
+Program* ProgramLib::getProgram(const std::string& name, const DefineSet& defines)
 {
     uint32_t key = getKey(name, defines);
     auto iter = _cache.find(key);
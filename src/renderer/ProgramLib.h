@@ -26,6 +26,7 @@
 
 #include "../Macro.h"
 #include "base/CCValue.h"
+#include "DefineSet.h"
 
 #include <string>
 #include <vector>
@@ -45,17 +46,20 @@ public:
         std::string name;
         std::string vert;
         std::string frag;
+        // maps with the "name" of each define, and "min" and "max" for the numbers
         ValueVector defines;
+        // filled by define(): the key bits of the defines, so getKey() doesn't look up names
+        DefineKeyLayout keyLayout;
     };
 
     ProgramLib(DeviceGraphics* device, std::vector<Template>& templates);
     ~ProgramLib();
 
     void define(const std::string& name, const std::string& vert, const std::string& frag, ValueVector& defines);
-    uint32_t getKey(const std::string& name, const ValueMap& defines);
+    uint32_t getKey(const std::string& name, const DefineSet& defines);
 
     //note: the return value needs to be released by its 'release' method.
-    Program* getProgram(const std::string& name, const ValueMap& defines);
+    Program* getProgram(const std::string& name, const DefineSet& defines);
 
 private:
     DeviceGraphics* _device = nullptr;
@@ -25,6 +25,8 @@
 #pragma once
 
 #include "ForwardRenderer.h"
+#include "AtlasBatch.h"
+#include "AtlasPacker.h"
 #include "Camera.h"
 #include "Config.h"
 #include "Effect.h"
@@ -36,5 +38,6 @@
 #include "Renderer.h"
 #include "Scene.h"
 #include "Technique.h"
+#include "TextureAtlas.h"
 #include "RendererUtils.h"
 #include "View.h"
@@ -0,0 +1,197 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "../Macro.h"
+
+RENDERER_BEGIN
+
+/**
+ * Allocator for the objects of one renderer class.
+ *
+ * Objects are placed in slabs of SLAB_OBJECTS contiguous slots. Freed slots go to a free list and are
+ * handed out again, so a class whose objects are created and destroyed every frame stops touching the heap
+ * once it reaches its peak count. Slabs are never returned to the heap.
+ * Allocations of another size, i.e. of derived classes, go to the global heap.
+ */
+template<typename T, size_t SLAB_OBJECTS = 64>
+class SlabAllocator
+{
+public:
+    static void* allocate(size_t size)
+    {
+        return allocate(size, false);
+    }
+
+    static void* allocate(size_t size, const std::nothrow_t&) noexcept
+    {
+        return allocate(size, true);
+    }
+
+    static void deallocate(void* p, size_t size)
+    {
+        if (nullptr == p)
+            return;
+
+        if (sizeof(T) != size)
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        auto& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        release(pool, static_cast<Slot*>(p));
+    }
+
+    // Frees `p` without its size, for the delete of a nothrow new whose constructor threw: only memory
+    // inside a slab goes back to the free list, the memory of derived classes goes to the global heap.
+    static void deallocate(void* p, const std::nothrow_t&) noexcept
+    {
+        if (nullptr == p)
+            return;
+
+        auto& pool = getPool();
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            auto slot = static_cast<Slot*>(p);
+            std::less<Slot*> less;
+            for (auto slab : pool.slabs)
+            {
+                if (!less(slot, slab) && less(slot, slab + SLAB_OBJECTS))
+                {
+                    release(pool, slot);
+                    return;
+                }
+            }
+        }
+        ::operator delete(p);
+    }
+
+    // Number of objects in the slabs.
+    static size_t getLiveCount()
+    {
+        auto& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        return pool.liveCount;
+    }
+
+    static size_t getSlabCount()
+    {
+        auto& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        return pool.slabs.size();
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    struct Pool
+    {
+        std::mutex mutex;
+        Slot* freeList = nullptr;
+        std::vector<Slot*> slabs;
+        size_t liveCount = 0;
+    };
+
+    static Pool& getPool()
+    {
+        // Never destroyed, objects may be released by the destructors of other statics.
+        static Pool* pool = new Pool();
+        return *pool;
+    }
+
+    static void release(Pool& pool, Slot* slot)
+    {
+        slot->next = pool.freeList;
+        pool.freeList = slot;
+        --pool.liveCount;
+    }
+
+    static void* allocate(size_t size, bool nothrow)
+    {
+        if (sizeof(T) != size)
+            return nothrow ? ::operator new(size, std::nothrow) : ::operator new(size);
+
+        auto& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (nullptr == pool.freeList)
+        {
+            void* memory = nothrow ? ::operator new(sizeof(Slot) * SLAB_OBJECTS, std::nothrow) : ::operator new(sizeof(Slot) * SLAB_OBJECTS);
+            if (nullptr == memory)
+                return nullptr;
+
+            auto slab = static_cast<Slot*>(memory);
+            pool.slabs.push_back(slab);
+            for (size_t i = 0; i < SLAB_OBJECTS; ++i)
+                slab[i].next = i + 1 < SLAB_OBJECTS ? &slab[i + 1] : nullptr;
+            pool.freeList = slab;
+        }
+
+        auto slot = pool.freeList;
+        pool.freeList = slot->next;
+        ++pool.liveCount;
+        return slot;
+    }
+};
+
+RENDERER_END
+
+// Declares the class specific operator new and delete of a class allocated by a SlabAllocator.
+#define RENDERER_DECLARE_SLAB_ALLOCATOR() \
+public: \
+    static void* operator new(size_t size); \
+    static void* operator new(size_t size, const std::nothrow_t&) noexcept; \
+    static void operator delete(void* p, size_t size); \
+    static void operator delete(void* p, const std::nothrow_t&) noexcept;
+
+// Defines the operators declared by RENDERER_DECLARE_SLAB_ALLOCATOR, in the source file of the class.
+#define RENDERER_DEFINE_SLAB_ALLOCATOR(clsName) \
+void* clsName::operator new(size_t size) \
+{ \
+    return SlabAllocator<clsName>::allocate(size); \
+} \
+void* clsName::operator new(size_t size, const std::nothrow_t& tag) noexcept \
+{ \
+    return SlabAllocator<clsName>::allocate(size, tag); \
+} \
+void clsName::operator delete(void* p, size_t size) \
+{ \
+    SlabAllocator<clsName>::deallocate(p, size); \
+} \
+void clsName::operator delete(void* p, const std::nothrow_t& tag) noexcept \
+{ \
+    SlabAllocator<clsName>::deallocate(p, tag); \
+}
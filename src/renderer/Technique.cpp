@@ -30,6 +30,8 @@
 
 RENDERER_BEGIN
 
+RENDERER_DEFINE_SLAB_ALLOCATOR(Technique)
+
 // implementation of Parameter
 
 uint8_t Technique::Parameter::elementsOfType[] = {
@@ -30,6 +30,7 @@
 #include "base/CCVector.h"
 #include "base/CCRef.h"
 #include "../Macro.h"
+#include "SlabAllocator.h"
 
 RENDERER_BEGIN
 
@@ -38,6 +39,8 @@ class Texture;
 
 class Technique : public Ref
 {
+    RENDERER_DECLARE_SLAB_ALLOCATOR()
+
 public:
     
     class Parameter final
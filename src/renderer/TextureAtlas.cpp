@@ -0,0 +1,228 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "TextureAtlas.h"
+#include <new>
+#include <string.h>
+#include "gfx/DeviceGraphics.h"
+#include "gfx/Texture2D.h"
+
+RENDERER_BEGIN
+
+TextureAtlas::TextureAtlas()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (auto& page : _pages)
+        RENDERER_SAFE_RELEASE(page.texture);
+}
+
+bool TextureAtlas::init(DeviceGraphics* device, uint16_t pageWidth, uint16_t pageHeight, uint8_t maxPages, uint8_t padding)
+{
+    if (0 == pageWidth || 0 == pageHeight || 0 == maxPages)
+        return false;
+
+    _device = device;
+    _pageWidth = pageWidth;
+    _pageHeight = pageHeight;
+    _maxPages = maxPages;
+    _padding = padding;
+    return true;
+}
+
+bool TextureAtlas::add(const std::string& key, const uint8_t* pixels, uint16_t width, uint16_t height, Entry& entry)
+{
+    if (find(key, entry))
+        return true;
+
+    uint32_t paddedWidth = width + 2 * _padding;
+    uint32_t paddedHeight = height + 2 * _padding;
+    if (0 == width || 0 == height || paddedWidth > _pageWidth || paddedHeight > _pageHeight)
+    {
+        RENDERER_LOGW("TextureAtlas::add: %s (%dx%d) doesn't fit in a %dx%d page", key.c_str(), width, height, _pageWidth, _pageHeight);
+        return false;
+    }
+
+    AtlasPacker::Rect rect;
+    int pageIndex = -1;
+    for (size_t i = 0, len = _pages.size(); i < len; ++i)
+    {
+        if (_pages[i].packer.insert(paddedWidth, paddedHeight, rect))
+        {
+            pageIndex = (int)i;
+            break;
+        }
+    }
+
+    if (-1 == pageIndex && _pages.size() < _maxPages)
+    {
+        Texture::Options options;
+        options.width = _pageWidth;
+        options.height = _pageHeight;
+        options.wrapS = Texture::WrapMode::CLAMP;
+        options.wrapT = Texture::WrapMode::CLAMP;
+        options.format = Texture::Format::RGBA8;
+        options.hasMipmap = false;
+        options.flipY = false;
+
+        Page page;
+        page.texture = new (std::nothrow) Texture2D();
+        if (nullptr == page.texture || !page.texture->init(_device, options))
+        {
+            RENDERER_SAFE_RELEASE(page.texture);
+            return false;
+        }
+        page.packer.reset(_pageWidth, _pageHeight);
+        page.packer.insert(paddedWidth, paddedHeight, rect);
+        _pages.push_back(page);
+        pageIndex = (int)_pages.size() - 1;
+    }
+
+    if (-1 == pageIndex)
+    {
+        pageIndex = evictPage();
+        if (-1 == pageIndex)
+        {
+            RENDERER_LOGW("TextureAtlas::add: no room for %s, every page is in use this frame", key.c_str());
+            return false;
+        }
+        _pages[pageIndex].packer.insert(paddedWidth, paddedHeight, rect);
+    }
+
+    // upload the padding too, it may hold pixels of an evicted image
+    size_t rowBytes = paddedWidth * 4;
+    uint8_t* data = (uint8_t*)malloc(rowBytes * paddedHeight);
+    if (nullptr == data)
+        return false;
+    if (_padding > 0)
+        memset(data, 0, rowBytes * paddedHeight);
+    for (uint16_t y = 0; y < height; ++y)
+        memcpy(data + (y + _padding) * rowBytes + _padding * 4, pixels + y * width * 4, width * 4);
+
+    Texture::SubImageOption options;
+    options.x = rect.x;
+    options.y = rect.y;
+    options.width = rect.width;
+    options.height = rect.height;
+    options.format = Texture::Format::RGBA8;
+    options.flipY = false;
+    options.image.fastSet(data, rowBytes * paddedHeight);
+
+    Page& page = _pages[pageIndex];
+    page.texture->updateSubImage(options);
+    page.lastUsedFrame = _frame;
+    ++page.entryCount;
+
+    entry.texture = page.texture;
+    entry.page = (uint16_t)pageIndex;
+    entry.rect.x = rect.x + _padding;
+    entry.rect.y = rect.y + _padding;
+    entry.rect.width = width;
+    entry.rect.height = height;
+    entry.u0 = (float)entry.rect.x / _pageWidth;
+    entry.v0 = (float)entry.rect.y / _pageHeight;
+    entry.u1 = (float)(entry.rect.x + width) / _pageWidth;
+    entry.v1 = (float)(entry.rect.y + height) / _pageHeight;
+    _entries[key] = entry;
+    return true;
+}
+
+bool TextureAtlas::find(const std::string& key, Entry& entry)
+{
+    auto iter = _entries.find(key);
+    if (_entries.end() == iter)
+        return false;
+
+    entry = iter->second;
+    _pages[entry.page].lastUsedFrame = _frame;
+    return true;
+}
+
+void TextureAtlas::remove(const std::string& key)
+{
+    auto iter = _entries.find(key);
+    if (_entries.end() == iter)
+        return;
+
+    Page& page = _pages[iter->second.page];
+    _entries.erase(iter);
+    if (0 == --page.entryCount)
+        resetPage(page);
+}
+
+Texture2D* TextureAtlas::getPageTexture(uint16_t page) const
+{
+    return page < _pages.size() ? _pages[page].texture : nullptr;
+}
+
+TextureAtlas::Stats TextureAtlas::getStats() const
+{
+    Stats stats;
+    stats.pages = (uint32_t)_pages.size();
+    stats.entries = (uint32_t)_entries.size();
+    stats.evictions = _evictions;
+    for (const auto& page : _pages)
+        stats.occupancy += page.packer.getOccupancy();
+    if (stats.pages > 0)
+        stats.occupancy /= stats.pages;
+    return stats;
+}
+
+// private functions
+
+int TextureAtlas::evictPage()
+{
+    int victim = -1;
+    for (size_t i = 0, len = _pages.size(); i < len; ++i)
+    {
+        if (_pages[i].lastUsedFrame == _frame)
+            continue;
+        if (-1 == victim || _pages[i].lastUsedFrame < _pages[victim].lastUsedFrame)
+            victim = (int)i;
+    }
+
+    if (-1 == victim)
+        return -1;
+
+    for (auto iter = _entries.begin(); iter != _entries.end();)
+    {
+        if (iter->second.page == victim)
+            iter = _entries.erase(iter);
+        else
+            ++iter;
+    }
+    resetPage(_pages[victim]);
+    ++_evictions;
+    return victim;
+}
+
+void TextureAtlas::resetPage(Page& page)
+{
+    page.packer.reset(_pageWidth, _pageHeight);
+    page.entryCount = 0;
+}
+
+RENDERER_END
@@ -0,0 +1,123 @@
+/****************************************************************************
+ Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "base/CCRef.h"
+#include "../Macro.h"
+#include "AtlasPacker.h"
+
+RENDERER_BEGIN
+
+class DeviceGraphics;
+class Texture2D;
+
+/**
+ * Packs small RGBA8 images into shared Texture2D pages with AtlasPacker, so they can be drawn with one texture
+ * bind and batched together. When every page is full the least recently used page is evicted and repacked,
+ * pages used in the current frame are never evicted.
+ */
+class TextureAtlas : public Ref
+{
+public:
+    struct Entry
+    {
+        // page texture, owned by the atlas
+        Texture2D* texture = nullptr;
+        uint16_t page = 0;
+        // position of the image in the page in pixels, without padding
+        AtlasPacker::Rect rect;
+        // (u0, v0) is the first pixel of the first row of the image
+        float u0 = 0.f;
+        float v0 = 0.f;
+        float u1 = 0.f;
+        float v1 = 0.f;
+    };
+
+    struct Stats
+    {
+        uint32_t pages = 0;
+        uint32_t entries = 0;
+        uint32_t evictions = 0;
+        // average fraction of the pages covered by images
+        float occupancy = 0.f;
+    };
+
+    RENDERER_DEFINE_CREATE_METHOD_4(TextureAtlas, init, DeviceGraphics*, uint16_t, uint16_t, uint8_t)
+
+    TextureAtlas();
+    virtual ~TextureAtlas();
+
+    /**
+     * Pages are `pageWidth` x `pageHeight` and created when needed, at most `maxPages` of them.
+     * `padding` transparent pixels are kept around every image so linear filtering doesn't pick up neighbours.
+     */
+    bool init(DeviceGraphics* device, uint16_t pageWidth, uint16_t pageHeight, uint8_t maxPages, uint8_t padding = 1);
+
+    /**
+     * Uploads `width` x `height` RGBA8 `pixels` into a page under `key`, or finds the image if the key is packed already.
+     * Returns false if the image is larger than a page, or if every page is full and was used in the current frame.
+     */
+    bool add(const std::string& key, const uint8_t* pixels, uint16_t width, uint16_t height, Entry& entry);
+    /** Looks up `key` and marks its page as used, so the entry stays valid until the next beginFrame(). */
+    bool find(const std::string& key, Entry& entry);
+    /** Forgets `key`, the space is reclaimed once its page is empty or evicted. */
+    void remove(const std::string& key);
+    /** Starts a new frame for the least recently used eviction. */
+    inline void beginFrame() { ++_frame; }
+
+    inline size_t getPageCount() const { return _pages.size(); }
+    Texture2D* getPageTexture(uint16_t page) const;
+    Stats getStats() const;
+
+private:
+    struct Page
+    {
+        Texture2D* texture = nullptr;
+        AtlasPacker packer;
+        uint32_t lastUsedFrame = 0;
+        uint32_t entryCount = 0;
+    };
+
+    bool pack(uint16_t page, uint16_t width, uint16_t height, AtlasPacker::Rect& rect);
+    int evictPage();
+    void resetPage(Page& page);
+
+    DeviceGraphics* _device = nullptr;
+    uint16_t _pageWidth = 0;
+    uint16_t _pageHeight = 0;
+    uint8_t _maxPages = 0;
+    uint8_t _padding = 0;
+    uint32_t _frame = 1;
+    uint32_t _evictions = 0;
+    std::vector<Page> _pages;
+    std::unordered_map<std::string, Entry> _entries;
+
+    CC_DISALLOW_COPY_ASSIGN_AND_MOVE(TextureAtlas);
+};
+
+RENDERER_END
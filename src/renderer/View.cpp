@@ -26,6 +26,8 @@
 
 RENDERER_BEGIN
 
+RENDERER_DEFINE_SLAB_ALLOCATOR(View)
+
 namespace
 {
     uint32_t g_genID = 0;
@@ -29,6 +29,7 @@
 #include "math/Mat4.h"
 #include "base/ccTypes.h"
 #include "../Macro.h"
+#include "SlabAllocator.h"
 #include "../Types.h"
 
 RENDERER_BEGIN
@@ -38,6 +39,8 @@ class FrameBuffer;
 
 class View : public Ref
 {
+    RENDERER_DECLARE_SLAB_ALLOCATOR()
+
 public:
     View();
     
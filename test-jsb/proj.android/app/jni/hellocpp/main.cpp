@@ -6,6 +6,7 @@
 #include "jsb_conversions.hpp"
 #include "cocos/scripting/js-bindings/manual/jsb_renderer_manual.hpp"
 #include "cocos/scripting/js-bindings/auto/jsb_renderer_auto.hpp"
+#include "base/CCAutoreleasePool.h"
 
 
 #include <memory>
@@ -98,6 +99,8 @@ extern "C" {
         se::ValueArray args;
         args.push_back(se::Value(dt));
         tickVal.toObject()->call(args, nullptr);
+        // Release the objects autoreleased during the frame, including those finalized by the garbage collector.
+        cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
 
         dt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - prevTime).count() / 1000000.f;
 
@@ -23,6 +23,7 @@
 #include "cocos/scripting/js-bindings/manual/jsb_renderer_manual.hpp"
 
 #include "Utils.h"
+#include "base/CCAutoreleasePool.h"
 
 static std::chrono::steady_clock::time_point prevTime;
 static float dtSum = 0.0f;
@@ -55,6 +56,8 @@ SE_BIND_FUNC(setBunnyCount)
     args.push_back(se::Value(dt));
     tickVal.toObject()->call(args, nullptr);
     [((CCEAGLView*)self.view) swapBuffers];
+    // Release the objects autoreleased during the frame, including those finalized by the garbage collector.
+    cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
 
     dt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - prevTime).count() / 1000000.f;
 
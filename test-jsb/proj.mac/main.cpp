@@ -36,6 +36,7 @@
 #include "cocos/scripting/js-bindings/manual/jsb_renderer_manual.hpp"
 
 #include "Utils.h"
+#include "base/CCAutoreleasePool.h"
 
 static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
@@ -116,6 +117,8 @@ int main(int argc, char** argv)
         tickVal.toObject()->call(args, nullptr);
         
         glfwSwapBuffers(window);
+        // Release the objects autoreleased during the frame, including those finalized by the garbage collector.
+        cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
         glfwPollEvents();
         
         now = std::chrono::steady_clock::now();
@@ -6,6 +6,8 @@
 #include "TestBase.h"
 #include "defines.h"
 
+#include "backend/Device.h"
+#include "base/CCAutoreleasePool.h"
 #include "backend/BasicBackend.h"
 #include "backend/Texture2DBackend.h"
 #include "backend/BunnyBackend.h"
@@ -54,8 +56,11 @@ namespace
 @implementation RootViewController
 
 - (void) tick: (id) sender {
+    cocos2d::backend::Device::getInstance()->getTextureUploadQueue()->process();
     test->tick(0.016f); // FIXME:
     [((CCEAGLView*)self.view) swapBuffers];
+    // Release the objects autoreleased during the frame.
+    cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
 }
 
 // Implement loadView to create a view hierarchy programmatically, without using a nib.
@@ -16,6 +16,7 @@
 #include "../../../../tests/gfx/Texture2D.h"
 
 #include "../../../../tests/Utils.h"
+#include "base/CCAutoreleasePool.h"
 
 #define  LOG_TAG    "main"
 #define  LOGD(...)  __android_log_print(ANDROID_LOG_DEBUG,LOG_TAG,__VA_ARGS__)
@@ -56,6 +57,8 @@ extern "C" {
         if (!test)
             test = test = tests[nextIndex]();
         test->tick(0.016f);
+        // Release the objects autoreleased during the frame.
+        cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
     }
 
     JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeOnPause() {
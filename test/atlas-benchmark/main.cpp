@@ -0,0 +1,115 @@
+//
+//  main.cpp
+//  atlas-benchmark
+//
+//  Packs random UI sized images into texture atlas pages with renderer::AtlasPacker, checks that
+//  no two rectangles overlap, and prints the pack throughput and how much of the pages is filled.
+//  Exits with a non-zero status if a rectangle is out of bounds or overlaps another one.
+//
+//  Built by test/build-tests.sh.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "UnitTest.h"
+#include "renderer/AtlasPacker.h"
+
+using cocos2d::renderer::AtlasPacker;
+using unittest::check;
+
+namespace
+{
+    struct Size
+    {
+        uint16_t width;
+        uint16_t height;
+    };
+    
+    std::vector<Size> randomSizes(size_t count, int minSize, int maxSize, unsigned seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> distribution(minSize, maxSize);
+        std::vector<Size> sizes(count);
+        for (auto& size : sizes)
+        {
+            size.width = (uint16_t)distribution(random);
+            size.height = (uint16_t)distribution(random);
+        }
+        return sizes;
+    }
+    
+    bool overlaps(const AtlasPacker::Rect& a, const AtlasPacker::Rect& b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+    
+    // Packs `sizes` into as many pages as needed, opening a new page when the current ones are full.
+    void run(const char* name, const std::vector<Size>& sizes, uint16_t pageSize)
+    {
+        std::vector<AtlasPacker> pages;
+        std::vector<std::vector<AtlasPacker::Rect>> rects;
+        
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& size : sizes)
+        {
+            AtlasPacker::Rect rect;
+            size_t page = 0;
+            while (page < pages.size() && !pages[page].insert(size.width, size.height, rect))
+                ++page;
+            
+            if (page == pages.size())
+            {
+                pages.emplace_back();
+                pages.back().reset(pageSize, pageSize);
+                rects.emplace_back();
+                if (!pages.back().insert(size.width, size.height, rect))
+                {
+                    check(false, "an image fits an empty page");
+                    return;
+                }
+            }
+            rects[page].push_back(rect);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000000.0;
+        
+        bool ok = true;
+        for (const auto& pageRects : rects)
+        {
+            for (size_t i = 0; i < pageRects.size(); ++i)
+            {
+                const auto& rect = pageRects[i];
+                ok &= rect.x + rect.width <= pageSize && rect.y + rect.height <= pageSize;
+                for (size_t j = i + 1; j < pageRects.size(); ++j)
+                    ok &= !overlaps(rect, pageRects[j]);
+            }
+        }
+        
+        // every page but the last one is full, so their fill is what matters
+        double fill = 0;
+        for (size_t i = 0; i + 1 < pages.size(); ++i)
+            fill += pages[i].getOccupancy();
+        if (pages.size() > 1)
+            fill /= pages.size() - 1;
+        else
+            fill = pages[0].getOccupancy();
+        
+        printf("%-22s %5zu images  %4dx%-4d  %2zu pages  %8.0f inserts/ms  fill %5.1f%%  %s\n", name, sizes.size(),
+               pageSize, pageSize, pages.size(), sizes.size() / ms, fill * 100, ok ? "ok" : "OVERLAP");
+        check(ok, "rectangles are inside their page and don't overlap");
+    }
+}
+
+int main()
+{
+    run("glyphs 8-32", randomSizes(4000, 8, 32, 1), 512);
+    run("icons 16-128", randomSizes(2000, 16, 128, 2), 1024);
+    run("icons 16-128", randomSizes(2000, 16, 128, 3), 2048);
+    run("panels 64-400", randomSizes(400, 64, 400, 4), 2048);
+    
+    return unittest::report();
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env bash
+#
+# Builds the unit tests in test/unit-tests, the benchmarks in test/*-benchmark and the command line tools
+# in tools on Linux, against fake-gl instead of a GPU, then runs the unit tests. Run it from anywhere:
+#
+#   test/build-tests.sh [build directory, default build-tests]
+#
+# CXX, CC and CXXFLAGS are honored, for example CXXFLAGS=-DCC_REF_LEAK_DETECTION=1 to build with the
+# leak detection of Ref. Sources are rebuilt when they or a header they include change.
+#
+
+set -e
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+BUILD="$(mkdir -p "${1:-build-tests}" && cd "${1:-build-tests}" && pwd)"
+CXX="${CXX:-c++}"
+CC="${CC:-cc}"
+JOBS="$(nproc 2>/dev/null || echo 4)"
+
+FLAGS="-O2 -g -DLINUX -DCC_USE_JPEG=0 -DCC_USE_WEBP=0 -DCC_REF_THREAD_SAFE=1"
+if [ "$(uname -m)" = "x86_64" ]; then
+    FLAGS="$FLAGS -mssse3"
+fi
+INCLUDES="-Itest/fake-gl -Icocos -Icocos/base -Isrc -Icocos/platform -Iexternal/mac/include -Iexternal/source
+    -Iexternal/source/firefox -Iexternal/source/unzip -Itest/unit-tests"
+LIBS="-lpng -lz -pthread"
+
+ENGINE_SOURCES="test/fake-gl/FakeGL.cpp src/Types.cpp src/gfx/*.cpp src/renderer/*.cpp src/backend/*.cpp
+    src/backend/opengl/*.cpp cocos/math/*.cpp cocos/platform/*.cpp cocos/base/CCData.cpp cocos/base/ccTypes.cpp
+    cocos/base/CCRef.cpp cocos/base/CCAutoreleasePool.cpp cocos/base/CCConsole.cpp cocos/base/CCValue.cpp
+    cocos/base/CCAssetBundle.cpp cocos/base/CCMappedFile.cpp cocos/base/ZipUtils.cpp cocos/base/etc1.cpp
+    cocos/base/pvr.cpp cocos/base/TGAlib.cpp cocos/base/ccUTF8.cpp external/source/firefox/*.cpp
+    external/source/ConvertUTF/ConvertUTF.c external/source/ConvertUTF/ConvertUTFWrapper.cpp
+    external/source/tinyxml2/tinyxml2.cpp external/source/unzip/unzip.cpp external/source/unzip/ioapi.cpp
+    external/source/unzip/ioapi_mem.cpp"
+# The registry, checks, allocation counter and FileUtils shared by the unit tests and the benchmarks,
+# taken from an archive so a program only gets the ones it doesn't define itself. The tools don't link it.
+SUPPORT_SOURCES="test/unit-tests/UnitTest.cpp test/unit-tests/AllocationCounter.cpp test/unit-tests/FileUtilsTest.cpp"
+
+cd "$ROOT"
+
+# The object of `source`, out of date if it or a dependency recorded by the last build is newer.
+objectOf() { echo "$BUILD/obj/${1%.*}.o"; }
+outOfDate() {
+    local object; object="$(objectOf "$1")"
+    [ -f "$object" ] && [ -f "${object%.o}.d" ] || return 0
+    for dependency in $(sed -e 's/^[^:]*://' -e 's/\\$//' "${object%.o}.d"); do
+        [ "$dependency" -nt "$object" ] && return 0
+    done
+    return 1
+}
+compile() {
+    local object; object="$(objectOf "$1")"
+    mkdir -p "$(dirname "$object")"
+    echo "compiling $1"
+    case "$1" in
+        *.c) $CC $FLAGS $CFLAGS $INCLUDES -MMD -MF "${object%.o}.d" -c "$1" -o "$object" ;;
+        *) $CXX -std=c++11 $FLAGS $CXXFLAGS $INCLUDES -MMD -MF "${object%.o}.d" -c "$1" -o "$object" ;;
+    esac
+}
+export -f objectOf compile
+export BUILD CXX CC FLAGS CFLAGS CXXFLAGS INCLUDES
+
+BENCHMARKS="$(ls test/*-benchmark/main.cpp)"
+TOOLS="tools/etc1-encoder/main.cpp"
+UNIT_TESTS="$(ls test/unit-tests/*.cpp | grep -v -e UnitTest.cpp -e AllocationCounter.cpp -e FileUtilsTest.cpp)"
+STALE=""
+for source in $ENGINE_SOURCES $SUPPORT_SOURCES $BENCHMARKS $TOOLS $UNIT_TESTS; do
+    if outOfDate "$source"; then
+        STALE="$STALE $source"
+    fi
+done
+if [ -n "$STALE" ]; then
+    echo $STALE | tr ' ' '\n' | xargs -P "$JOBS" -I{} bash -c 'compile "$@"' _ {}
+fi
+
+objects() { for source in "$@"; do objectOf "$source"; done; }
+rm -f "$BUILD/libengine.a"
+ar rcs "$BUILD/libengine.a" $(objects $ENGINE_SOURCES)
+rm -f "$BUILD/libtestsupport.a"
+ar rcs "$BUILD/libtestsupport.a" $(objects $SUPPORT_SOURCES)
+
+for program in $BENCHMARKS; do
+    name="$(basename "$(dirname "$program")")"
+    $CXX $(objectOf "$program") -Wl,--start-group "$BUILD/libtestsupport.a" "$BUILD/libengine.a" -Wl,--end-group $LIBS -o "$BUILD/$name"
+done
+for program in $TOOLS; do
+    name="$(basename "$(dirname "$program")")"
+    $CXX $(objectOf "$program") "$BUILD/libengine.a" $LIBS -o "$BUILD/$name"
+done
+$CXX $(objects $UNIT_TESTS) -Wl,--start-group "$BUILD/libtestsupport.a" "$BUILD/libengine.a" -Wl,--end-group $LIBS -o "$BUILD/unit-tests"
+
+echo "built unit-tests, $(echo $BENCHMARKS | wc -w) benchmarks and $(echo $TOOLS | wc -w) tools in $BUILD"
+"$BUILD/unit-tests"
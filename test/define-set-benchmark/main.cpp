@@ -0,0 +1,189 @@
+//
+//  main.cpp
+//  define-set-benchmark
+//
+//  Compares the per draw define work of the renderer before and after DefineSet: for every draw item
+//  Model::extractDrawItem merges the effect defines into the model defines, then ProgramLib::getKey
+//  turns them into a program key. The legacy path is a copy of the ValueMap code. The new path merges
+//  with DefineSet like Effect::extractDefines and keys with the DefineKeyLayout of ProgramLib::getKey,
+//  without the template lookup, so it builds without a GL context.
+//  Exits with a non-zero status if two draw items get the same key but different defines, or the reverse.
+//
+//  Built by test/build-tests.sh.
+//
+//  Usage:
+//  define-set-benchmark [items]
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "UnitTest.h"
+#include "renderer/DefineSet.h"
+
+using namespace cocos2d;
+using namespace cocos2d::renderer;
+using unittest::check;
+
+namespace
+{
+    const char* DEFINE_NAMES[] = {
+        "USE_TEXTURE", "USE_MODEL", "ALPHA_TEST", "USE_TINT", "USE_SKINNING", "USE_NORMAL_TEXTURE",
+        "USE_EMISSIVE", "USE_SHADOW_MAP", "NUM_DIR_LIGHTS", "NUM_POINT_LIGHTS", "USE_RGBE_HDR", "USE_FOG"
+    };
+    const int DEFINE_COUNT = sizeof(DEFINE_NAMES) / sizeof(DEFINE_NAMES[0]);
+    // the light counts are numbers up to MAX_LIGHTS, everything else a switch
+    const int MAX_LIGHTS = 3;
+    const int EFFECT_COUNT = 16;
+
+    Value makeValue(int effect, int define)
+    {
+        // effects 2n and 2n + 1 only differ in their light counts, which are never 0 so they don't key as switches
+        if (define == 8 || define == 9)
+            return Value(1 + (effect + define) % MAX_LIGHTS);
+        return Value((((effect / 2) >> (define % 4)) & 1) != 0);
+    }
+
+    // What Effect, Model and ProgramLib did with ValueMaps.
+    struct LegacyEffect
+    {
+        std::vector<ValueMap> defineTemplates;
+
+        ValueMap* extractDefines(ValueMap& out) const
+        {
+            for (auto& def : defineTemplates)
+                out[def.at("name").asString()] = def.at("value");
+            return &out;
+        }
+    };
+
+    struct LegacyProgramLib
+    {
+        uint32_t id = 1;
+        ValueVector defines;
+
+        uint32_t getKey(const ValueMap& values)
+        {
+            int32_t key = 0;
+            for (auto& tmplDefs : defines)
+            {
+                auto& tmplDefMap = tmplDefs.asValueMap();
+                std::string tempName = tmplDefMap["name"].asString();
+                auto iter = values.find(tempName);
+                // the old key only tested presence, compare on the value like the new one
+                if (iter == values.end() || !iter->second.asBool())
+                    continue;
+                uint32_t offset = tmplDefMap["_offset"].asUnsignedInt();
+                key |= 1 << offset;
+            }
+            return key << 8 | id;
+        }
+    };
+
+    struct NewEffect
+    {
+        DefineSet defines;
+
+        DefineSet* extractDefines(DefineSet& out) const
+        {
+            out.merge(defines);
+            return &out;
+        }
+    };
+
+    // The key of a variant: the switches that are on and the numbers, which is what the shader source depends on.
+    std::string getVariant(const DefineSet& defines)
+    {
+        std::string variant;
+        for (const auto& def : defines)
+        {
+            if (def.value != 0)
+                variant += DefineSet::getName(def.id) + "=" + std::to_string(def.value) + ";";
+        }
+        return variant;
+    }
+
+    template <typename F>
+    double measure(F f, int iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            f();
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int items = argc > 1 ? atoi(argv[1]) : 10000;
+    if (items <= 0)
+        items = 10000;
+
+    std::vector<LegacyEffect> legacyEffects(EFFECT_COUNT);
+    std::vector<NewEffect> newEffects(EFFECT_COUNT);
+    LegacyProgramLib legacyLib;
+    DefineKeyLayout keyLayout;
+    for (int d = 0; d < DEFINE_COUNT; ++d)
+    {
+        ValueMap def;
+        def["name"] = DEFINE_NAMES[d];
+        def["_offset"] = d + 1;
+        legacyLib.defines.push_back(Value(def));
+        bool number = d == 8 || d == 9;
+        keyLayout.add(DefineSet::getNameID(DEFINE_NAMES[d]), 0, number ? MAX_LIGHTS : 0);
+    }
+    for (int e = 0; e < EFFECT_COUNT; ++e)
+    {
+        for (int d = 0; d < DEFINE_COUNT; ++d)
+        {
+            ValueMap def;
+            def["name"] = DEFINE_NAMES[d];
+            def["value"] = makeValue(e, d);
+            legacyEffects[e].defineTemplates.push_back(def);
+            newEffects[e].defines.set(DEFINE_NAMES[d], makeValue(e, d));
+        }
+    }
+
+    // one define map per model, like Model::_defines
+    std::vector<ValueMap> legacyDefines(items);
+    std::vector<DefineSet> newDefines(items);
+    std::vector<uint32_t> legacyKeys(items);
+    std::vector<uint32_t> newKeys(items);
+
+    int iterations = 20;
+    double legacy = measure([&]() {
+        for (int i = 0; i < items; ++i)
+        {
+            ValueMap* defines = legacyEffects[i % EFFECT_COUNT].extractDefines(legacyDefines[i]);
+            legacyKeys[i] = legacyLib.getKey(*defines);
+        }
+    }, iterations);
+    double flat = measure([&]() {
+        for (int i = 0; i < items; ++i)
+        {
+            DefineSet* defines = newEffects[i % EFFECT_COUNT].extractDefines(newDefines[i]);
+            newKeys[i] = keyLayout.getKey(*defines);
+        }
+    }, iterations);
+
+    // The draw items of an effect are one variant, each effect a different one.
+    int failures = 0;
+    std::vector<std::string> variants(EFFECT_COUNT);
+    for (int e = 0; e < EFFECT_COUNT && e < items; ++e)
+        variants[e] = getVariant(newDefines[e]);
+    for (int i = 0; i < items; ++i)
+    {
+        for (int j = 0; j < EFFECT_COUNT && j < items; ++j)
+        {
+            if ((newKeys[i] == newKeys[j]) != (variants[i % EFFECT_COUNT] == variants[j]))
+                ++failures;
+        }
+    }
+
+    printf("%d draw items, %d defines: ValueMap %.0f us, DefineSet %.0f us per frame (%.1fx)\n",
+           items, DEFINE_COUNT, legacy, flat, legacy / flat);
+    check(0 == failures, "draw items get the same key exactly when they get the same defines");
+    return unittest::report();
+}
@@ -0,0 +1,765 @@
+//
+//  FakeGL.cpp
+//  fake-gl
+//
+
+#include "FakeGL.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace fakegl
+{
+    State& getState()
+    {
+        static State state;
+        return state;
+    }
+
+    void reset()
+    {
+        getState() = State();
+    }
+
+    Texture* getTexture(GLuint name)
+    {
+        auto& textures = getState().textures;
+        auto iter = textures.find(name);
+        return textures.end() == iter ? nullptr : &iter->second;
+    }
+
+    GLuint getBoundTexture(int unit)
+    {
+        return getState().textures2D[unit];
+    }
+}
+
+using namespace fakegl;
+
+namespace
+{
+    GLuint* getTextureBinding(GLenum target)
+    {
+        auto& state = getState();
+        if (GL_TEXTURE_CUBE_MAP == target || (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z))
+            return &state.texturesCube[state.activeTexture];
+        return &state.textures2D[state.activeTexture];
+    }
+
+    Texture* getBoundTextureObject(GLenum target)
+    {
+        return getTexture(*getTextureBinding(target));
+    }
+
+    void setLevel(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height, bool compressed)
+    {
+        auto texture = getBoundTextureObject(target);
+        if (!texture)
+            return;
+
+        ++texture->uploads;
+        // like glTexImage2D, a level of size 0 has no storage
+        if (0 == width || 0 == height)
+        {
+            texture->levels.erase(level);
+            return;
+        }
+
+        TextureLevel& storage = texture->levels[level];
+        storage.width = width;
+        storage.height = height;
+        storage.internalFormat = internalFormat;
+        storage.compressed = compressed;
+    }
+
+    void updateLevel(GLenum target)
+    {
+        auto texture = getBoundTextureObject(target);
+        if (texture)
+            ++texture->uploads;
+    }
+
+    std::vector<unsigned char>* getBoundBuffer(GLenum target)
+    {
+        auto& state = getState();
+        GLuint name = 0;
+        switch (target)
+        {
+            case GL_ARRAY_BUFFER: name = state.arrayBuffer; break;
+            case GL_ELEMENT_ARRAY_BUFFER: name = state.elementArrayBuffer; break;
+            case GL_PIXEL_UNPACK_BUFFER: name = state.pixelUnpackBuffer; break;
+            default: break;
+        }
+        auto iter = state.buffers.find(name);
+        return state.buffers.end() == iter ? nullptr : &iter->second;
+    }
+
+    GLenum getVariableType(const std::string& type)
+    {
+        static const std::map<std::string, GLenum> types = {
+            { "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+            { "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+            { "bool", GL_BOOL }, { "bvec2", GL_BOOL_VEC2 }, { "bvec3", GL_BOOL_VEC3 }, { "bvec4", GL_BOOL_VEC4 },
+            { "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+            { "sampler2D", GL_SAMPLER_2D }, { "samplerCube", GL_SAMPLER_CUBE },
+        };
+        auto iter = types.find(type);
+        return types.end() == iter ? 0 : iter->second;
+    }
+
+    // Collects `attribute`/`in` and `uniform` declarations of a shader, one declaration per statement.
+    void parseDeclarations(const std::string& source, bool vertexInputs, std::vector<Variable>& attributes, std::vector<Variable>& uniforms)
+    {
+        std::string statements = source;
+        for (auto& c : statements)
+        {
+            if (';' == c || '{' == c || '}' == c)
+                c = '\n';
+        }
+
+        std::istringstream lines(statements);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::istringstream words(line);
+            std::vector<std::string> tokens;
+            std::string word;
+            while (words >> word)
+                tokens.push_back(word);
+            if (tokens.size() < 3)
+                continue;
+
+            bool isAttribute = "attribute" == tokens[0] || (vertexInputs && "in" == tokens[0]);
+            bool isUniform = "uniform" == tokens[0];
+            if (!isAttribute && !isUniform)
+                continue;
+
+            // skip precision qualifiers
+            size_t typeIndex = 1;
+            if ("lowp" == tokens[typeIndex] || "mediump" == tokens[typeIndex] || "highp" == tokens[typeIndex])
+                ++typeIndex;
+            if (typeIndex + 1 >= tokens.size())
+                continue;
+
+            Variable variable;
+            variable.type = getVariableType(tokens[typeIndex]);
+            variable.name = tokens[typeIndex + 1];
+            auto bracket = variable.name.find('[');
+            if (bracket != std::string::npos)
+            {
+                variable.size = atoi(variable.name.c_str() + bracket + 1);
+                variable.name = variable.name.substr(0, bracket);
+            }
+            if (0 == variable.type)
+                continue;
+
+            auto& list = isAttribute ? attributes : uniforms;
+            bool found = false;
+            for (const auto& existing : list)
+                found = found || existing.name == variable.name;
+            if (!found)
+                list.push_back(variable);
+        }
+    }
+
+    void getVariable(const std::vector<Variable>& list, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        if (index >= list.size())
+            return;
+        const auto& variable = list[index];
+        if (size)
+            *size = variable.size;
+        if (type)
+            *type = variable.type;
+        if (name && bufSize > 0)
+        {
+            GLsizei count = std::min(bufSize - 1, static_cast<GLsizei>(variable.name.size()));
+            memcpy(name, variable.name.c_str(), count);
+            name[count] = '\0';
+            if (length)
+                *length = count;
+        }
+    }
+
+    GLint getVariableLocation(const std::vector<Variable>& list, const GLchar* name)
+    {
+        std::string variableName = name;
+        auto bracket = variableName.find('[');
+        if (bracket != std::string::npos)
+            variableName = variableName.substr(0, bracket);
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (list[i].name == variableName)
+                return static_cast<GLint>(i);
+        }
+        return -1;
+    }
+
+    void recordDraw(GLsizei count)
+    {
+        auto& state = getState();
+        Draw draw;
+        draw.program = state.program;
+        memcpy(draw.textures, state.textures2D, sizeof(draw.textures));
+        memcpy(draw.samplers, state.samplers, sizeof(draw.samplers));
+        draw.enabledAttributes = state.enabledAttributes;
+        draw.count = count;
+        state.draws.push_back(draw);
+    }
+
+    void generateNames(GLsizei n, GLuint* names)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+            names[i] = getState().nextName++;
+    }
+}
+
+extern "C"
+{
+
+// textures
+
+void glGenTextures(GLsizei n, GLuint* textures)
+{
+    generateNames(n, textures);
+    for (GLsizei i = 0; i < n; ++i)
+        getState().textures[textures[i]];
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    auto& state = getState();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        state.textures.erase(textures[i]);
+        for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+        {
+            if (state.textures2D[unit] == textures[i])
+                state.textures2D[unit] = 0;
+            if (state.texturesCube[unit] == textures[i])
+                state.texturesCube[unit] = 0;
+        }
+    }
+}
+
+GLboolean glIsTexture(GLuint texture)
+{
+    return getTexture(texture) ? GL_TRUE : GL_FALSE;
+}
+
+void glActiveTexture(GLenum texture)
+{
+    getState().activeTexture = texture - GL_TEXTURE0;
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+    *getTextureBinding(target) = texture;
+    auto object = getTexture(texture);
+    if (object && 0 == object->target)
+        object->target = target;
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    auto texture = getBoundTextureObject(target);
+    if (!texture)
+        return;
+    if (GL_TEXTURE_BASE_LEVEL == pname)
+        texture->baseLevel = param;
+    else if (GL_TEXTURE_MAX_LEVEL == pname)
+        texture->maxLevel = param;
+}
+
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    glTexParameteri(target, pname, static_cast<GLint>(param));
+}
+
+void glTexParameteriv(GLenum target, GLenum pname, const GLint* params)
+{
+    glTexParameteri(target, pname, params[0]);
+}
+
+void glGetTexParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    auto texture = getBoundTextureObject(target);
+    *params = 0;
+    if (texture && GL_TEXTURE_BASE_LEVEL == pname)
+        *params = texture->baseLevel;
+    else if (texture && GL_TEXTURE_MAX_LEVEL == pname)
+        *params = texture->maxLevel;
+}
+
+void glPixelStorei(GLenum, GLint) {}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint, GLenum, GLenum, const GLvoid*)
+{
+    setLevel(target, level, internalformat, width, height, false);
+}
+
+void glTexSubImage2D(GLenum target, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*)
+{
+    updateLevel(target);
+}
+
+void glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint, GLsizei, const GLvoid*)
+{
+    setLevel(target, level, internalformat, width, height, true);
+}
+
+void glCompressedTexSubImage2D(GLenum target, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLsizei, const GLvoid*)
+{
+    updateLevel(target);
+}
+
+void glTexImage3D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei, GLint, GLenum, GLenum, const GLvoid*)
+{
+    setLevel(target, level, internalformat, width, height, false);
+}
+
+void glTexSubImage3D(GLenum target, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*)
+{
+    updateLevel(target);
+}
+
+void glCompressedTexImage3D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei, GLint, GLsizei, const GLvoid*)
+{
+    setLevel(target, level, internalformat, width, height, true);
+}
+
+void glCompressedTexSubImage3D(GLenum target, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLsizei, const GLvoid*)
+{
+    updateLevel(target);
+}
+
+void glGenerateMipmap(GLenum target)
+{
+    auto texture = getBoundTextureObject(target);
+    if (!texture || texture->levels.empty())
+        return;
+    TextureLevel level = texture->levels.begin()->second;
+    for (GLint i = texture->levels.begin()->first + 1; level.width > 1 || level.height > 1; ++i)
+    {
+        level.width = std::max(1, level.width / 2);
+        level.height = std::max(1, level.height / 2);
+        texture->levels[i] = level;
+    }
+}
+
+// samplers
+
+void glGenSamplers(GLsizei count, GLuint* samplers)
+{
+    auto& deleted = getState().deletedSamplers;
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (deleted.empty())
+        {
+            generateNames(1, &samplers[i]);
+        }
+        else
+        {
+            samplers[i] = deleted.back();
+            deleted.pop_back();
+        }
+    }
+}
+
+void glDeleteSamplers(GLsizei count, const GLuint* samplers)
+{
+    auto& state = getState();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        state.deletedSamplers.push_back(samplers[i]);
+        for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit)
+        {
+            if (state.samplers[unit] == samplers[i])
+                state.samplers[unit] = 0;
+        }
+    }
+}
+
+void glBindSampler(GLuint unit, GLuint sampler)
+{
+    if (unit < MAX_TEXTURE_UNITS)
+        getState().samplers[unit] = sampler;
+}
+void glSamplerParameteri(GLuint, GLenum, GLint) {}
+
+// buffers
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    generateNames(n, buffers);
+    for (GLsizei i = 0; i < n; ++i)
+        getState().buffers[buffers[i]];
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    auto& state = getState();
+    for (GLsizei i = 0; i < n; ++i)
+        state.buffers.erase(buffers[i]);
+}
+
+GLboolean glIsBuffer(GLuint buffer)
+{
+    return getState().buffers.count(buffer) ? GL_TRUE : GL_FALSE;
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    auto& state = getState();
+    if (GL_ARRAY_BUFFER == target)
+        state.arrayBuffer = buffer;
+    else if (GL_ELEMENT_ARRAY_BUFFER == target)
+        state.elementArrayBuffer = buffer;
+    else if (GL_PIXEL_UNPACK_BUFFER == target)
+        state.pixelUnpackBuffer = buffer;
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum)
+{
+    auto buffer = getBoundBuffer(target);
+    if (!buffer)
+        return;
+    buffer->assign(static_cast<size_t>(size), 0);
+    if (data && size > 0)
+        memcpy(buffer->data(), data, static_cast<size_t>(size));
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    auto buffer = getBoundBuffer(target);
+    if (buffer && data && static_cast<size_t>(offset + size) <= buffer->size())
+        memcpy(buffer->data() + offset, data, static_cast<size_t>(size));
+}
+
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield)
+{
+    auto buffer = getBoundBuffer(target);
+    if (!buffer || static_cast<size_t>(offset + length) > buffer->size())
+        return nullptr;
+    return buffer->data() + offset;
+}
+
+GLboolean glUnmapBuffer(GLenum)
+{
+    return GL_TRUE;
+}
+
+// shaders and programs
+
+GLuint glCreateShader(GLenum)
+{
+    GLuint name = getState().nextName++;
+    getState().shaderSources[name];
+    return name;
+}
+
+void glDeleteShader(GLuint shader)
+{
+    getState().shaderSources.erase(shader);
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    std::string source;
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (length && length[i] >= 0)
+            source.append(string[i], length[i]);
+        else
+            source.append(string[i]);
+    }
+    getState().shaderSources[shader] = source;
+}
+
+void glCompileShader(GLuint) {}
+
+void glGetShaderiv(GLuint, GLenum pname, GLint* params)
+{
+    *params = GL_COMPILE_STATUS == pname ? GL_TRUE : 0;
+}
+
+void glGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = '\0';
+}
+
+void glGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+{
+    const auto& text = getState().shaderSources[shader];
+    GLsizei count = bufSize > 0 ? std::min(bufSize - 1, static_cast<GLsizei>(text.size())) : 0;
+    if (source && bufSize > 0)
+    {
+        memcpy(source, text.c_str(), count);
+        source[count] = '\0';
+    }
+    if (length)
+        *length = count;
+}
+
+GLuint glCreateProgram(void)
+{
+    GLuint name = getState().nextName++;
+    getState().programs[name];
+    return name;
+}
+
+void glDeleteProgram(GLuint program)
+{
+    getState().programs.erase(program);
+}
+
+void glAttachShader(GLuint program, GLuint shader)
+{
+    getState().programs[program].shaders.push_back(shader);
+}
+
+void glLinkProgram(GLuint program)
+{
+    auto& state = getState();
+    auto& object = state.programs[program];
+    object.attributes.clear();
+    object.uniforms.clear();
+    for (size_t i = 0; i < object.shaders.size(); ++i)
+    {
+        // the vertex shader is attached first
+        parseDeclarations(state.shaderSources[object.shaders[i]], 0 == i, object.attributes, object.uniforms);
+    }
+}
+
+void glUseProgram(GLuint program)
+{
+    getState().program = program;
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    const auto& object = getState().programs[program];
+    switch (pname)
+    {
+        case GL_LINK_STATUS: *params = GL_TRUE; break;
+        case GL_ACTIVE_ATTRIBUTES: *params = static_cast<GLint>(object.attributes.size()); break;
+        case GL_ACTIVE_UNIFORMS: *params = static_cast<GLint>(object.uniforms.size()); break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH: *params = 256; break;
+        default: *params = 0; break;
+    }
+}
+
+void glGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = '\0';
+}
+
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getVariable(getState().programs[program].attributes, index, bufSize, length, size, type, name);
+}
+
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getVariable(getState().programs[program].uniforms, index, bufSize, length, size, type, name);
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar* name)
+{
+    return getVariableLocation(getState().programs[program].attributes, name);
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    return getVariableLocation(getState().programs[program].uniforms, name);
+}
+
+void glUniform1i(GLint, GLint) {}
+void glUniform2i(GLint, GLint, GLint) {}
+void glUniform3i(GLint, GLint, GLint, GLint) {}
+void glUniform4i(GLint, GLint, GLint, GLint, GLint) {}
+void glUniform1f(GLint, GLfloat) {}
+void glUniform2f(GLint, GLfloat, GLfloat) {}
+void glUniform3f(GLint, GLfloat, GLfloat, GLfloat) {}
+void glUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) {}
+void glUniform1iv(GLint, GLsizei, const GLint*) {}
+void glUniform2iv(GLint, GLsizei, const GLint*) {}
+void glUniform3iv(GLint, GLsizei, const GLint*) {}
+void glUniform4iv(GLint, GLsizei, const GLint*) {}
+void glUniform1fv(GLint, GLsizei, const GLfloat*) {}
+void glUniform2fv(GLint, GLsizei, const GLfloat*) {}
+void glUniform3fv(GLint, GLsizei, const GLfloat*) {}
+void glUniform4fv(GLint, GLsizei, const GLfloat*) {}
+void glUniformMatrix2fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+void glUniformMatrix3fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat*) {}
+
+// vertex attributes and draws
+
+void glEnableVertexAttribArray(GLuint index)
+{
+    if (index < 32)
+        getState().enabledAttributes |= 1u << index;
+}
+
+void glDisableVertexAttribArray(GLuint index)
+{
+    if (index < 32)
+        getState().enabledAttributes &= ~(1u << index);
+}
+
+void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+
+void glDrawArrays(GLenum, GLint, GLsizei count)
+{
+    recordDraw(count);
+}
+
+void glDrawElements(GLenum, GLsizei count, GLenum, const GLvoid*)
+{
+    recordDraw(count);
+}
+
+// framebuffers
+
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers) { generateNames(n, framebuffers); }
+void glDeleteFramebuffers(GLsizei, const GLuint*) {}
+
+void glBindFramebuffer(GLenum, GLuint framebuffer)
+{
+    getState().framebuffer = framebuffer;
+}
+
+void glFramebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) {}
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers) { generateNames(n, renderbuffers); }
+void glDeleteRenderbuffers(GLsizei, const GLuint*) {}
+void glBindRenderbuffer(GLenum, GLuint) {}
+void glRenderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) {}
+void glFramebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) {}
+
+GLenum glCheckFramebufferStatus(GLenum)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void glInvalidateFramebuffer(GLenum, GLsizei numAttachments, const GLenum* attachments)
+{
+    auto& state = getState();
+    for (GLsizei i = 0; i < numAttachments; ++i)
+    {
+        // GL_COLOR, GL_DEPTH and GL_STENCIL name the attachments of the window system provided frame buffer only.
+        bool windowSystemName = attachments[i] >= 0x1800 && attachments[i] <= 0x1802;
+        if (windowSystemName != (0 == state.framebuffer))
+        {
+            state.error = GL_INVALID_ENUM;
+            return;
+        }
+    }
+    state.invalidations.push_back(std::vector<GLenum>(attachments, attachments + numAttachments));
+}
+
+void glDrawBuffer(GLenum) {}
+void glReadBuffer(GLenum) {}
+
+// fixed function state
+
+void glEnable(GLenum) {}
+void glDisable(GLenum) {}
+void glHint(GLenum, GLenum) {}
+void glViewport(GLint, GLint, GLsizei, GLsizei) {}
+void glScissor(GLint, GLint, GLsizei, GLsizei) {}
+void glClear(GLbitfield) {}
+void glClearColor(GLclampf, GLclampf, GLclampf, GLclampf) {}
+void glClearDepth(GLclampd) {}
+void glClearStencil(GLint) {}
+void glColorMask(GLboolean, GLboolean, GLboolean, GLboolean) {}
+void glCullFace(GLenum) {}
+void glDepthFunc(GLenum) {}
+void glDepthMask(GLboolean) {}
+void glDepthRange(GLclampd, GLclampd) {}
+void glBlendColor(GLclampf, GLclampf, GLclampf, GLclampf) {}
+void glBlendEquation(GLenum) {}
+void glBlendEquationSeparate(GLenum, GLenum) {}
+void glBlendFunc(GLenum, GLenum) {}
+void glBlendFuncSeparate(GLenum, GLenum, GLenum, GLenum) {}
+void glStencilFunc(GLenum, GLint, GLuint) {}
+void glStencilFuncSeparate(GLenum, GLenum, GLint, GLuint) {}
+void glStencilMask(GLuint) {}
+void glStencilMaskSeparate(GLenum, GLuint) {}
+void glStencilOp(GLenum, GLenum, GLenum) {}
+void glStencilOpSeparate(GLenum, GLenum, GLenum, GLenum) {}
+void glFlush(void) {}
+void glFinish(void) {}
+
+// queries
+
+GLenum glGetError(void)
+{
+    auto& state = getState();
+    GLenum error = state.error;
+    state.error = GL_NO_ERROR;
+    return error;
+}
+
+const GLubyte* glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR: return reinterpret_cast<const GLubyte*>("fake-gl");
+        case GL_RENDERER: return reinterpret_cast<const GLubyte*>("fake-gl");
+        case GL_VERSION: return reinterpret_cast<const GLubyte*>("OpenGL ES 3.0 fake-gl");
+        case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte*>("OpenGL ES GLSL ES 3.00");
+        case GL_EXTENSIONS: return reinterpret_cast<const GLubyte*>("GL_OES_depth24 GL_OES_packed_depth_stencil");
+        default: return nullptr;
+    }
+}
+
+void glGetIntegerv(GLenum pname, GLint* params)
+{
+    auto& state = getState();
+    switch (pname)
+    {
+#if GL_MAX_TEXTURE_UNITS != GL_MAX_TEXTURE_IMAGE_UNITS
+        // the fixed function limit the renderer queries, desktop headers keep it apart from GL_MAX_TEXTURE_IMAGE_UNITS
+        case GL_MAX_TEXTURE_UNITS:
+#endif
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS: *params = MAX_TEXTURE_UNITS; break;
+        case GL_MAX_VERTEX_ATTRIBS: *params = MAX_VERTEX_ATTRIBS; break;
+        case GL_MAX_TEXTURE_SIZE: *params = 4096; break;
+        case GL_MAX_DRAW_BUFFERS:
+        case GL_MAX_COLOR_ATTACHMENTS: *params = 4; break;
+        case GL_ACTIVE_TEXTURE: *params = static_cast<GLint>(GL_TEXTURE0 + state.activeTexture); break;
+        case GL_TEXTURE_BINDING_2D: *params = static_cast<GLint>(state.textures2D[state.activeTexture]); break;
+        case GL_TEXTURE_BINDING_CUBE_MAP: *params = static_cast<GLint>(state.texturesCube[state.activeTexture]); break;
+        case GL_ARRAY_BUFFER_BINDING: *params = static_cast<GLint>(state.arrayBuffer); break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING: *params = static_cast<GLint>(state.elementArrayBuffer); break;
+        case GL_FRAMEBUFFER_BINDING: *params = static_cast<GLint>(state.framebuffer); break;
+        case GL_CURRENT_PROGRAM: *params = static_cast<GLint>(state.program); break;
+        case GL_DEPTH_FUNC: *params = GL_LESS; break;
+        case GL_UNPACK_ALIGNMENT: *params = 4; break;
+        default: *params = 0; break;
+    }
+}
+
+void glGetBooleanv(GLenum, GLboolean* params)
+{
+    *params = GL_FALSE;
+}
+
+void glGetFloatv(GLenum, GLfloat* params)
+{
+    *params = 0;
+}
+
+}
@@ -0,0 +1,111 @@
+//
+//  FakeGL.h
+//  fake-gl
+//
+//  A GL implementation without a GPU for the tests that run the GL backends on Linux. It keeps the
+//  state the engine depends on: texture objects and their levels, the texture and sampler bound to every
+//  unit, buffers, framebuffer invalidations, enabled vertex attributes, and a snapshot of the bindings for
+//  every draw. Programs link successfully and report the attributes and uniforms declared in their
+//  sources. Everything else is accepted and ignored.
+//
+//  test/build-tests.sh builds the unit tests and the benchmarks with -DLINUX and -Itest/fake-gl before
+//  -Icocos -Icocos/base, and links test/fake-gl/FakeGL.cpp.
+//
+
+#pragma once
+
+#include "platform/CCGL.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fakegl
+{
+    static const int MAX_TEXTURE_UNITS = 16;
+    static const int MAX_VERTEX_ATTRIBS = 16;
+
+    struct TextureLevel
+    {
+        GLsizei width = 0;
+        GLsizei height = 0;
+        GLenum internalFormat = 0;
+        bool compressed = false;
+    };
+
+    struct Texture
+    {
+        GLenum target = 0;
+        GLint baseLevel = 0;
+        GLint maxLevel = 1000;
+        // Levels that have storage, keyed by level.
+        std::map<GLint, TextureLevel> levels;
+        // glTexImage*, glTexSubImage* and glCompressedTex* calls.
+        uint32_t uploads = 0;
+    };
+
+    struct Variable
+    {
+        std::string name;
+        GLenum type = 0;
+        GLint size = 1;
+    };
+
+    struct Program
+    {
+        std::vector<GLuint> shaders;
+        std::vector<Variable> attributes;
+        std::vector<Variable> uniforms;
+    };
+
+    // The bindings a draw call was issued with.
+    struct Draw
+    {
+        GLuint program = 0;
+        GLuint textures[MAX_TEXTURE_UNITS] = {};
+        GLuint samplers[MAX_TEXTURE_UNITS] = {};
+        uint32_t enabledAttributes = 0;
+        GLsizei count = 0;
+    };
+
+    struct State
+    {
+        GLuint nextName = 1;
+
+        GLuint activeTexture = 0;
+        GLuint textures2D[MAX_TEXTURE_UNITS] = {};
+        GLuint texturesCube[MAX_TEXTURE_UNITS] = {};
+        std::map<GLuint, Texture> textures;
+
+        GLuint samplers[MAX_TEXTURE_UNITS] = {};
+        // Names of deleted samplers, reused by glGenSamplers() as drivers do.
+        std::vector<GLuint> deletedSamplers;
+
+        std::map<GLuint, std::vector<unsigned char>> buffers;
+        GLuint arrayBuffer = 0;
+        GLuint elementArrayBuffer = 0;
+        GLuint pixelUnpackBuffer = 0;
+
+        std::map<GLuint, std::string> shaderSources;
+        std::map<GLuint, Program> programs;
+        GLuint program = 0;
+
+        GLuint framebuffer = 0;
+        // Accepted glInvalidateFramebuffer calls. Attachment names that don't belong to the bound frame
+        // buffer set GL_INVALID_ENUM and invalidate nothing, as in OpenGL ES 3.0.
+        std::vector<std::vector<GLenum>> invalidations;
+        GLenum error = GL_NO_ERROR;
+
+        uint32_t enabledAttributes = 0;
+        std::vector<Draw> draws;
+    };
+
+    State& getState();
+    // Forgets every object and binding, as if a new context was created.
+    void reset();
+
+    // The texture object named `name`, nullptr if there isn't one.
+    Texture* getTexture(GLuint name);
+    // The 2D texture bound to `unit`.
+    GLuint getBoundTexture(int unit);
+}
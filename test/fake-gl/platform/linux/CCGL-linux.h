@@ -0,0 +1,29 @@
+//
+//  CCGL-linux.h
+//  fake-gl
+//
+//  GL declarations for tests that run the GL code against fake-gl on Linux. The desktop headers
+//  declare every entry point the engine uses, and GL_ES_VERSION_3_0 selects the code paths taken
+//  on OpenGL ES 3 devices.
+//
+
+#ifndef __CCGL_H__
+#define __CCGL_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#ifndef GL_ES_VERSION_3_0
+#define GL_ES_VERSION_3_0 1
+#endif
+
+#define GL_DEPTH_STENCIL_OES        GL_DEPTH_STENCIL
+#define GL_UNSIGNED_INT_24_8_OES    GL_UNSIGNED_INT_24_8
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CCGL_H__
@@ -0,0 +1,28 @@
+//
+//  CCPlatformDefine-linux.h
+//  fake-gl
+//
+//  Platform defines for tests built on Linux against fake-gl.
+//
+
+#ifndef __CCPLATFORMDEFINE_H__
+#define __CCPLATFORMDEFINE_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include <assert.h>
+
+#define CC_DLL
+
+#if CC_DISABLE_ASSERT > 0
+#define CC_ASSERT(cond)
+#else
+#define CC_ASSERT(cond) assert(cond)
+#endif
+
+#define CC_UNUSED_PARAM(unusedparam) (void)unusedparam
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CCPLATFORMDEFINE_H__
@@ -0,0 +1,35 @@
+//
+//  CCStdC-linux.h
+//  fake-gl
+//
+//  The C headers of the other platforms, for tests built on Linux against fake-gl.
+//
+
+#ifndef __CC_STD_C_H__
+#define __CC_STD_C_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/CCPlatformMacros.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/time.h>
+#include <stdint.h>
+
+#ifndef MIN
+#define MIN(x,y) (((x) > (y)) ? (y) : (x))
+#endif  // MIN
+
+#ifndef MAX
+#define MAX(x,y) (((x) < (y)) ? (y) : (x))
+#endif  // MAX
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif  // __CC_STD_C_H__
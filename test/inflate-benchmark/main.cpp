@@ -0,0 +1,210 @@
+//
+//  main.cpp
+//  inflate-benchmark
+//
+//  Compares the ZipUtils inflate paths on .gz and .ccz files: the previous grow-by-realloc inflate,
+//  inflateMemory sized by the gzip trailer, inflateMemoryTo / inflateCCZBufferTo into a reused buffer
+//  and the chunked inflateMemoryStreamed. Without arguments it generates a small corpus in memory.
+//  Exits with a non-zero status if any path inflates different data.
+//
+//  Built by test/build-tests.sh.
+//
+//  Usage:
+//  inflate-benchmark [file.gz|file.ccz]...
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#include "UnitTest.h"
+#include "platform/CCFileUtils.h"
+#include "base/ZipUtils.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    struct Sample
+    {
+        std::string name;
+        std::vector<unsigned char> compressed;
+    };
+
+    // What inflateMemory did before: start at 256k and double with realloc until the stream ends.
+    ssize_t legacyInflate(const unsigned char* in, ssize_t inLength, unsigned char** out)
+    {
+        ssize_t bufferSize = 256 * 1024;
+        *out = (unsigned char*)malloc(bufferSize);
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        stream.next_in = const_cast<unsigned char*>(in);
+        stream.avail_in = (uInt)inLength;
+        stream.next_out = *out;
+        stream.avail_out = (uInt)bufferSize;
+        inflateInit2(&stream, 15 + 32);
+        for (;;)
+        {
+            int err = inflate(&stream, Z_NO_FLUSH);
+            if (err == Z_STREAM_END)
+                break;
+            if (err != Z_OK)
+            {
+                inflateEnd(&stream);
+                free(*out);
+                *out = nullptr;
+                return -1;
+            }
+            *out = (unsigned char*)realloc(*out, bufferSize * 2);
+            stream.next_out = *out + bufferSize;
+            stream.avail_out = (uInt)bufferSize;
+            bufferSize *= 2;
+        }
+        inflateEnd(&stream);
+        return bufferSize - stream.avail_out;
+    }
+
+    std::vector<unsigned char> makeContent(size_t size, std::mt19937& random)
+    {
+        // Texture like data: runs of repeated texels with some noise.
+        std::vector<unsigned char> content(size);
+        for (size_t i = 0; i < size; ++i)
+            content[i] = (i / 64) % 7 == 0 ? (unsigned char)random() : (unsigned char)(i / 256);
+        return content;
+    }
+
+    std::vector<unsigned char> makeGZip(const std::vector<unsigned char>& content)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        std::vector<unsigned char> out(deflateBound(&stream, content.size()) + 32);
+        stream.next_in = const_cast<unsigned char*>(content.data());
+        stream.avail_in = (uInt)content.size();
+        stream.next_out = out.data();
+        stream.avail_out = (uInt)out.size();
+        deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return out;
+    }
+
+    std::vector<unsigned char> makeCCZ(const std::vector<unsigned char>& content)
+    {
+        uLongf size = compressBound(content.size());
+        std::vector<unsigned char> out(sizeof(CCZHeader) + size);
+        compress(out.data() + sizeof(CCZHeader), &size, content.data(), content.size());
+        out.resize(sizeof(CCZHeader) + size);
+        const unsigned char header[] = { 'C', 'C', 'Z', '!', 0, 0, 0, 2, 0, 0, 0, 0,
+            (unsigned char)(content.size() >> 24), (unsigned char)(content.size() >> 16), (unsigned char)(content.size() >> 8), (unsigned char)content.size() };
+        memcpy(out.data(), header, sizeof(header));
+        return out;
+    }
+
+    template <typename F>
+    double measure(F f, ssize_t bytes, int iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            f();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return (double)bytes * iterations / (1024.0 * 1024.0) / seconds;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<Sample> samples;
+    for (int i = 1; i < argc; ++i)
+    {
+        Sample sample;
+        sample.name = argv[i];
+        FILE* fp = fopen(argv[i], "rb");
+        if (!fp)
+        {
+            printf("Can't open %s\n", argv[i]);
+            return 1;
+        }
+        unsigned char chunk[64 * 1024];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+            sample.compressed.insert(sample.compressed.end(), chunk, chunk + n);
+        fclose(fp);
+        samples.push_back(std::move(sample));
+    }
+
+    if (samples.empty())
+    {
+        std::mt19937 random(7);
+        const size_t sizes[] = { 64 * 1024, 1024 * 1024, 8 * 1024 * 1024 };
+        for (size_t size : sizes)
+        {
+            auto content = makeContent(size, random);
+            samples.push_back({ std::to_string(size / 1024) + "k.gz", makeGZip(content) });
+            samples.push_back({ std::to_string(size / 1024) + "k.ccz", makeCCZ(content) });
+        }
+    }
+
+    printf("%-24s %10s %10s %10s %10s %10s  (MB/s inflated)\n", "file", "size", "legacy", "exact", "into", "streamed");
+    for (const auto& sample : samples)
+    {
+        const unsigned char* in = sample.compressed.data();
+        ssize_t inLength = sample.compressed.size();
+        bool ccz = ZipUtils::isCCZBuffer(in, inLength);
+        const unsigned char* stream = ccz ? in + sizeof(CCZHeader) : in;
+        ssize_t streamLength = ccz ? inLength - sizeof(CCZHeader) : inLength;
+
+        unsigned char* reference = nullptr;
+        ssize_t size = legacyInflate(stream, streamLength, &reference);
+        check(size >= 0, "the file is a zlib, gzip or ccz file");
+        if (size < 0)
+        {
+            printf("%-24s is not a zlib, gzip or ccz file\n", sample.name.c_str());
+            continue;
+        }
+        int iterations = (int)std::max<ssize_t>(1, (256 * 1024 * 1024) / std::max<ssize_t>(size, 1));
+
+        std::vector<unsigned char> into(size);
+        uLong crc = crc32(0, Z_NULL, 0);
+        uLong streamedCRC = 0;
+
+        double legacy = measure([&]() {
+            unsigned char* out = nullptr;
+            legacyInflate(stream, streamLength, &out);
+            free(out);
+        }, size, iterations);
+
+        double exact = measure([&]() {
+            unsigned char* out = nullptr;
+            ssize_t len = ccz ? ZipUtils::inflateCCZBuffer(in, inLength, &out) : ZipUtils::inflateMemory(const_cast<unsigned char*>(in), inLength, &out);
+            check(len == size && memcmp(out, reference, size) == 0, "inflateMemory and inflateCCZBuffer inflate the same data");
+            free(out);
+        }, size, iterations);
+
+        double intoSpeed = measure([&]() {
+            ssize_t len = ccz ? ZipUtils::inflateCCZBufferTo(in, inLength, into.data(), size) : ZipUtils::inflateMemoryTo(in, inLength, into.data(), size);
+            check(len == size && memcmp(into.data(), reference, size) == 0, "inflateMemoryTo and inflateCCZBufferTo inflate the same data");
+        }, size, iterations);
+
+        double streamed = measure([&]() {
+            streamedCRC = crc32(0, Z_NULL, 0);
+            check(ZipUtils::inflateMemoryStreamed(stream, streamLength, [&](const unsigned char* data, ssize_t len) {
+                streamedCRC = crc32(streamedCRC, data, (uInt)len);
+                return true;
+            }), "inflateMemoryStreamed inflates the stream");
+        }, size, iterations);
+
+        check(crc32(crc, reference, (uInt)size) == streamedCRC, "inflateMemoryStreamed inflates the same data");
+        check(ccz || ZipUtils::getInflatedSize(in, inLength) == size, "getInflatedSize reads the size from the gzip trailer");
+        free(reference);
+
+        printf("%-24s %10ld %10.1f %10.1f %10.1f %10.1f\n", sample.name.c_str(), (long)size, legacy, exact, intoSpeed, streamed);
+    }
+
+    return unittest::report();
+}
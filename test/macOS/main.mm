@@ -8,6 +8,7 @@
 #include "glfw3/glfw3native.h"
 
 #include "backend/metal/DeviceMTL.h"
+#include "base/CCAutoreleasePool.h"
 #include "../tests/TestBase.h"
 #include "../tests/Utils.h"
 
@@ -116,7 +117,10 @@ int main(int argc, char * argv[])
             cocos2d::backend::DeviceMTL::updateDrawable();
             // Should invoke after `cocos2d::backend::DeviceMTL::updateDrawable()`.
             initTests();
+            cocos2d::backend::Device::getInstance()->getTextureUploadQueue()->process();
             test->tick(dt);
+            // Release the objects autoreleased during the frame.
+            cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
             
             glfwPollEvents();
             
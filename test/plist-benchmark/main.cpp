@@ -0,0 +1,553 @@
+//
+//  main.cpp
+//  plist-benchmark
+//
+//  Compares reading a plist the way FileUtils used to, a tinyxml2 document visited by SAXParser into
+//  DictMaker, with PlistParser, which builds the Values while it tokenizes the XML, and with PlistParser on
+//  the same data as a binary plist. The old reader is a copy of DictMaker and of the tinyxml2 visitor of
+//  SAXParser as they were before PlistParser. Without arguments it generates a sprite sheet plist with
+//  4096 frames and a plist with entities, CDATA, comments in text, dates and nested arrays.
+//  Exits with a non-zero status if the three readers don't produce the same Values.
+//
+//  Built by test/build-tests.sh.
+//
+//  Usage:
+//  plist-benchmark [file.plist]...
+//
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "UnitTest.h"
+#include "platform/CCPlistParser.h"
+#include "platform/CCSAXParser.h"
+#include "tinyxml2/tinyxml2.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    // What FileUtils did before: DictMaker, the SAXDelegator that built the Values, unchanged but for CCASSERT.
+    typedef enum
+    {
+        SAX_NONE = 0,
+        SAX_KEY,
+        SAX_DICT,
+        SAX_INT,
+        SAX_REAL,
+        SAX_STRING,
+        SAX_ARRAY
+    }SAXState;
+
+    typedef enum
+    {
+        SAX_RESULT_NONE = 0,
+        SAX_RESULT_DICT,
+        SAX_RESULT_ARRAY
+    }SAXResult;
+
+    class DictMaker : public SAXDelegator
+    {
+    public:
+        SAXResult _resultType;
+        ValueMap _rootDict;
+        ValueVector _rootArray;
+
+        std::string _curKey;   ///< parsed key
+        std::string _curValue; // parsed value
+        SAXState _state;
+
+        ValueMap*  _curDict;
+        ValueVector* _curArray;
+
+        std::stack<ValueMap*> _dictStack;
+        std::stack<ValueVector*> _arrayStack;
+        std::stack<SAXState>  _stateStack;
+
+    public:
+        DictMaker(SAXResult resultType)
+            : _resultType(resultType)
+        {
+        }
+
+        void startElement(void *ctx, const char *name, const char **atts)
+        {
+            (void)ctx;
+            (void)atts;
+            const std::string sName(name);
+            if( sName == "dict" )
+            {
+                if(_resultType == SAX_RESULT_DICT && _rootDict.empty())
+                {
+                    _curDict = &_rootDict;
+                }
+
+                _state = SAX_DICT;
+
+                SAXState preState = SAX_NONE;
+                if (! _stateStack.empty())
+                {
+                    preState = _stateStack.top();
+                }
+
+                if (SAX_ARRAY == preState)
+                {
+                    // add a new dictionary into the array
+                    _curArray->push_back(Value(ValueMap()));
+                    _curDict = &(_curArray->rbegin())->asValueMap();
+                }
+                else if (SAX_DICT == preState)
+                {
+                    // add a new dictionary into the pre dictionary
+                    assert(! _dictStack.empty());
+                    ValueMap* preDict = _dictStack.top();
+                    (*preDict)[_curKey] = Value(ValueMap());
+                    _curDict = &(*preDict)[_curKey].asValueMap();
+                }
+
+                // record the dict state
+                _stateStack.push(_state);
+                _dictStack.push(_curDict);
+            }
+            else if(sName == "key")
+            {
+                _state = SAX_KEY;
+            }
+            else if(sName == "integer")
+            {
+                _state = SAX_INT;
+            }
+            else if(sName == "real")
+            {
+                _state = SAX_REAL;
+            }
+            else if(sName == "string")
+            {
+                _state = SAX_STRING;
+            }
+            else if (sName == "array")
+            {
+                _state = SAX_ARRAY;
+
+                if (_resultType == SAX_RESULT_ARRAY && _rootArray.empty())
+                {
+                    _curArray = &_rootArray;
+                }
+                SAXState preState = SAX_NONE;
+                if (! _stateStack.empty())
+                {
+                    preState = _stateStack.top();
+                }
+
+                if (preState == SAX_DICT)
+                {
+                    (*_curDict)[_curKey] = Value(ValueVector());
+                    _curArray = &(*_curDict)[_curKey].asValueVector();
+                }
+                else if (preState == SAX_ARRAY)
+                {
+                    assert(! _arrayStack.empty());
+                    ValueVector* preArray = _arrayStack.top();
+                    preArray->push_back(Value(ValueVector()));
+                    _curArray = &(_curArray->rbegin())->asValueVector();
+                }
+                // record the array state
+                _stateStack.push(_state);
+                _arrayStack.push(_curArray);
+            }
+            else
+            {
+                _state = SAX_NONE;
+            }
+        }
+
+        void endElement(void *ctx, const char *name)
+        {
+            (void)ctx;
+            SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
+            const std::string sName((char*)name);
+            if( sName == "dict" )
+            {
+                _stateStack.pop();
+                _dictStack.pop();
+                if ( !_dictStack.empty())
+                {
+                    _curDict = _dictStack.top();
+                }
+            }
+            else if (sName == "array")
+            {
+                _stateStack.pop();
+                _arrayStack.pop();
+                if (! _arrayStack.empty())
+                {
+                    _curArray = _arrayStack.top();
+                }
+            }
+            else if (sName == "true")
+            {
+                if (SAX_ARRAY == curState)
+                {
+                    _curArray->push_back(Value(true));
+                }
+                else if (SAX_DICT == curState)
+                {
+                    (*_curDict)[_curKey] = Value(true);
+                }
+            }
+            else if (sName == "false")
+            {
+                if (SAX_ARRAY == curState)
+                {
+                    _curArray->push_back(Value(false));
+                }
+                else if (SAX_DICT == curState)
+                {
+                    (*_curDict)[_curKey] = Value(false);
+                }
+            }
+            else if (sName == "string" || sName == "integer" || sName == "real")
+            {
+                if (SAX_ARRAY == curState)
+                {
+                    if (sName == "string")
+                        _curArray->push_back(Value(_curValue));
+                    else if (sName == "integer")
+                        _curArray->push_back(Value(atoi(_curValue.c_str())));
+                    else
+                        _curArray->push_back(Value(std::atof(_curValue.c_str())));
+                }
+                else if (SAX_DICT == curState)
+                {
+                    if (sName == "string")
+                        (*_curDict)[_curKey] = Value(_curValue);
+                    else if (sName == "integer")
+                        (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
+                    else
+                        (*_curDict)[_curKey] = Value(std::atof(_curValue.c_str()));
+                }
+
+                _curValue.clear();
+            }
+
+            _state = SAX_NONE;
+        }
+
+        void textHandler(void *ctx, const char *ch, int len)
+        {
+            (void)ctx;
+            if (_state == SAX_NONE)
+            {
+                return;
+            }
+
+            SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
+            const std::string text = std::string((char*)ch,len);
+
+            switch(_state)
+            {
+            case SAX_KEY:
+                _curKey = text;
+                break;
+            case SAX_INT:
+            case SAX_REAL:
+            case SAX_STRING:
+                {
+                    if (curState == SAX_DICT)
+                    {
+                        assert(!_curKey.empty());
+                    }
+
+                    _curValue.append(text);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    // The tinyxml2 visitor SAXParser fed its delegator from, unchanged but for calling the delegator directly.
+    class XmlSaxHander : public tinyxml2::XMLVisitor
+    {
+    public:
+        XmlSaxHander(SAXDelegator* delegator):_delegator(delegator){};
+
+        virtual bool VisitEnter( const tinyxml2::XMLElement& element, const tinyxml2::XMLAttribute* firstAttribute )
+        {
+            std::vector<const char*> attsVector;
+            for( const tinyxml2::XMLAttribute* attrib = firstAttribute; attrib; attrib = attrib->Next() )
+            {
+                attsVector.push_back(attrib->Name());
+                attsVector.push_back(attrib->Value());
+            }
+            attsVector.push_back(nullptr);
+
+            _delegator->startElement(nullptr, element.Value(), &attsVector[0]);
+            return true;
+        }
+
+        virtual bool VisitExit( const tinyxml2::XMLElement& element )
+        {
+            _delegator->endElement(nullptr, element.Value());
+            return true;
+        }
+
+        virtual bool Visit( const tinyxml2::XMLText& text )
+        {
+            _delegator->textHandler(nullptr, text.Value(), static_cast<int>(strlen(text.Value())));
+            return true;
+        }
+
+        virtual bool Visit( const tinyxml2::XMLUnknown&){ return true; }
+
+    private:
+        SAXDelegator* _delegator;
+    };
+
+    // getValueMapFromData, or getValueVectorFromFile for an array root, before PlistParser.
+    Value legacyParse(const std::string& data, Value::Type rootType)
+    {
+        DictMaker maker(Value::Type::VECTOR == rootType ? SAX_RESULT_ARRAY : SAX_RESULT_DICT);
+        tinyxml2::XMLDocument tinyDoc;
+        tinyDoc.Parse(data.data(), data.size());
+        XmlSaxHander handler(&maker);
+        tinyDoc.Accept(&handler);
+        return Value::Type::VECTOR == rootType ? Value(std::move(maker._rootArray)) : Value(std::move(maker._rootDict));
+    }
+
+    std::string makeSpriteSheet(int frames)
+    {
+        std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+            "<plist version=\"1.0\">\n<dict>\n\t<key>frames</key>\n\t<dict>\n";
+        char buffer[512];
+        for (int i = 0; i < frames; ++i)
+        {
+            snprintf(buffer, sizeof(buffer),
+                "\t\t<key>sprite_%d.png</key>\n\t\t<dict>\n"
+                "\t\t\t<key>frame</key>\n\t\t\t<string>{{%d,%d},{32,32}}</string>\n"
+                "\t\t\t<key>offset</key>\n\t\t\t<string>{0,0}</string>\n"
+                "\t\t\t<key>rotated</key>\n\t\t\t<%s/>\n"
+                "\t\t\t<key>sourceColorRect</key>\n\t\t\t<string>{{0,0},{32,32}}</string>\n"
+                "\t\t\t<key>sourceSize</key>\n\t\t\t<string>{32,32}</string>\n"
+                "\t\t</dict>\n", i, (i % 64) * 32, (i / 64) * 32, (i % 3) ? "false" : "true");
+            xml += buffer;
+        }
+        xml += "\t</dict>\n\t<key>metadata</key>\n\t<dict>\n"
+            "\t\t<key>format</key>\n\t\t<integer>2</integer>\n"
+            "\t\t<key>textureFileName</key>\n\t\t<string>sheet.png</string>\n"
+            "\t</dict>\n</dict>\n</plist>\n";
+        return xml;
+    }
+
+    // The cases the streaming tokenizer handles on its own: entities, character references, CDATA, comments
+    // inside text, dates and data, which are skipped, empty elements and arrays nested in arrays.
+    std::string makeMixed()
+    {
+        return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+            "<!-- generated -->\n"
+            "<plist version=\"1.0\">\n<dict>\n"
+            "\t<key>entities</key>\n\t<string>a &lt;b&gt; &amp; &quot;c&quot; &apos;d&apos; &#65;&#x42;</string>\n"
+            "\t<key>cdata</key>\n\t<string><![CDATA[<not> & markup]]></string>\n"
+            "\t<key>comment</key>\n\t<string>before<!-- skipped -->after</string>\n"
+            "\t<key>empty</key>\n\t<string></string>\n"
+            "\t<key>date</key>\n\t<date>2018-01-01T00:00:00Z</date>\n"
+            "\t<key>data</key>\n\t<data>AAEC</data>\n"
+            "\t<key>numbers</key>\n\t<array>\n\t\t<integer>-7</integer>\n\t\t<real>2.5</real>\n\t\t<true/>\n\t\t<false/>\n"
+            "\t\t<array>\n\t\t\t<string>nested</string>\n\t\t\t<dict>\n\t\t\t\t<key>deep</key>\n\t\t\t\t<integer>3</integer>\n\t\t\t</dict>\n\t\t</array>\n"
+            "\t</array>\n"
+            "\t<key>child</key>\n\t<dict>\n\t\t<key>name</key>\n\t\t<string>x</string>\n\t</dict>\n"
+            "</dict>\n</plist>\n";
+    }
+
+    // A binary plist writer with no uniquing, 4 byte offsets and references.
+    class BinaryWriter
+    {
+    public:
+        std::string write(const Value& root)
+        {
+            _objects.clear();
+            _offsets.clear();
+            add(root);
+
+            std::string out = "bplist00";
+            for (const auto& object : _objects)
+            {
+                _offsets.push_back((uint32_t)out.size());
+                out += object;
+            }
+            uint64_t tableOffset = out.size();
+            for (uint32_t offset : _offsets)
+                appendInteger(&out, offset, 4);
+            out.append(6, '\0');
+            out.push_back(4);
+            out.push_back(4);
+            appendInteger(&out, _objects.size(), 8);
+            appendInteger(&out, 0, 8);
+            appendInteger(&out, tableOffset, 8);
+            return out;
+        }
+
+    private:
+        static void appendInteger(std::string* out, uint64_t value, int size)
+        {
+            for (int i = size - 1; i >= 0; --i)
+                out->push_back((char)(value >> (i * 8)));
+        }
+
+        static void appendMarker(std::string* out, unsigned char type, size_t count)
+        {
+            if (count < 15)
+            {
+                out->push_back((char)(type << 4 | count));
+                return;
+            }
+            out->push_back((char)(type << 4 | 0x0F));
+            out->push_back((char)0x12);
+            appendInteger(out, count, 4);
+        }
+
+        uint32_t add(const Value& value)
+        {
+            uint32_t ref = (uint32_t)_objects.size();
+            _objects.emplace_back();
+            std::string object;
+            switch (value.getType())
+            {
+                case Value::Type::BOOLEAN:
+                    object.push_back(value.asBool() ? 0x09 : 0x08);
+                    break;
+                case Value::Type::INTEGER:
+                    object.push_back(0x13);
+                    appendInteger(&object, (uint64_t)(int64_t)value.asInt(), 8);
+                    break;
+                case Value::Type::DOUBLE:
+                case Value::Type::FLOAT:
+                {
+                    double d = value.asDouble();
+                    uint64_t bits;
+                    memcpy(&bits, &d, sizeof(bits));
+                    object.push_back(0x23);
+                    appendInteger(&object, bits, 8);
+                    break;
+                }
+                case Value::Type::VECTOR:
+                {
+                    std::vector<uint32_t> refs;
+                    for (const auto& child : value.asValueVector())
+                        refs.push_back(add(child));
+                    appendMarker(&object, 0xA, refs.size());
+                    for (uint32_t child : refs)
+                        appendInteger(&object, child, 4);
+                    break;
+                }
+                case Value::Type::MAP:
+                {
+                    std::vector<uint32_t> keys, values;
+                    for (const auto& pair : value.asValueMap())
+                    {
+                        keys.push_back(add(Value(pair.first)));
+                        values.push_back(add(pair.second));
+                    }
+                    appendMarker(&object, 0xD, keys.size());
+                    for (uint32_t child : keys)
+                        appendInteger(&object, child, 4);
+                    for (uint32_t child : values)
+                        appendInteger(&object, child, 4);
+                    break;
+                }
+                default:
+                {
+                    std::string s = value.asString();
+                    appendMarker(&object, 0x5, s.size());
+                    object += s;
+                    break;
+                }
+            }
+            _objects[ref] = std::move(object);
+            return ref;
+        }
+
+        std::vector<std::string> _objects;
+        std::vector<uint32_t> _offsets;
+    };
+
+    template <typename F>
+    double measure(F f, int iterations)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::pair<std::string, std::string>> samples;
+    for (int i = 1; i < argc; ++i)
+    {
+        FILE* fp = fopen(argv[i], "rb");
+        if (!fp)
+        {
+            printf("Can't open %s\n", argv[i]);
+            return 1;
+        }
+        std::string data;
+        char chunk[64 * 1024];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+            data.append(chunk, n);
+        fclose(fp);
+        samples.emplace_back(argv[i], std::move(data));
+    }
+    if (samples.empty())
+    {
+        samples.emplace_back("sprite sheet, 4096 frames", makeSpriteSheet(4096));
+        samples.emplace_back("entities, CDATA, comments", makeMixed());
+    }
+
+    printf("%-28s %10s %12s %12s %12s  (ms)\n", "file", "KB", "DictMaker", "streamed", "binary");
+    for (const auto& sample : samples)
+    {
+        const std::string& data = sample.second;
+        if (PlistParser::isBinaryPlist(data.data(), data.size()))
+        {
+            double binary = measure([&]() { PlistParser::parse(data.data(), data.size()); }, 10);
+            printf("%-28s %10zu %12s %12s %12.2f\n", sample.first.c_str(), data.size() / 1024, "-", "-", binary);
+            continue;
+        }
+
+        Value streamed = PlistParser::parse(data.data(), data.size());
+        std::string binaryData = BinaryWriter().write(streamed);
+        Value fromBinary = PlistParser::parse(binaryData.data(), binaryData.size());
+        bool binaryMatches = !streamed.isNull() && streamed == fromBinary;
+        check(binaryMatches, "the XML and binary readers agree");
+        if (!binaryMatches)
+        {
+            printf("%-28s the XML and binary readers disagree\n", sample.first.c_str());
+            continue;
+        }
+        bool legacyMatches = legacyParse(data, streamed.getType()) == streamed;
+        check(legacyMatches, "the old and the streaming XML readers agree");
+        if (!legacyMatches)
+        {
+            printf("%-28s the old and the streaming XML readers disagree\n", sample.first.c_str());
+            continue;
+        }
+
+        double legacyTime = measure([&]() { legacyParse(data, streamed.getType()); }, 10);
+        double streamedTime = measure([&]() { PlistParser::parse(data.data(), data.size()); }, 10);
+        double binaryTime = measure([&]() { PlistParser::parse(binaryData.data(), binaryData.size()); }, 10);
+        printf("%-28s %10zu %12.2f %12.2f %12.2f\n", sample.first.c_str(), data.size() / 1024, legacyTime, streamedTime, binaryTime);
+    }
+    return unittest::report();
+}
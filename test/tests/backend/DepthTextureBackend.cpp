@@ -225,6 +225,8 @@ DepthTextureBackend::DepthTextureBackend()
     backend::RenderPassDescriptor renderPassDescriptorBigTriangle;
     renderPassDescriptorBigTriangle.setClearColor(0.1f, 0.1f, 0.1f, 1);
     renderPassDescriptorBigTriangle.setClearDepth(1);
+    // Depth is only used while drawing, so it doesn't have to be written back.
+    renderPassDescriptorBigTriangle.setDepthStoreAction(backend::StoreAction::DONT_CARE);
     _renderPassBigTriangle = device->newRenderPass(renderPassDescriptorBigTriangle);
     
     _commandBuffer = device->newCommandBuffer();
@@ -89,16 +89,14 @@ Texture2DBackendTest::Texture2DBackendTest()
         bool ret = img->initWithImageFile("assets/uv_checker_01.jpg");
         assert(ret);
 
-        cocos2d::Data data;
-        data.copy(img->getData(), img->getDataLen());
-
         TextureDescriptor texDes;
         texDes.width = img->getWidth();
         texDes.height = img->getHeight();
         texDes.textureFormat = TextureFormat::R8G8B8;
         texDes.textureType = TextureType::TEXTURE_2D;
         _texture = device->newTexture(texDes);
-        _texture->updateData(data.getBytes());
+        // Uploaded over several frames.
+        device->getTextureUploadQueue()->uploadData(_texture, img->getData());
 
         img->release();
     }
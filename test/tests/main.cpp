@@ -28,6 +28,7 @@
 #include "defines.h"
 #include "Utils.h"
 
+#include "backend/Device.h"
 #include "backend/BasicBackend.h"
 #include "backend/Texture2DBackend.h"
 #include "backend/BunnyBackend.h"
@@ -96,6 +97,7 @@ int main(int argc, char** argv)
     while (!glfwWindowShouldClose(window))
     {
         prevTime = std::chrono::steady_clock::now();
+        cocos2d::backend::Device::getInstance()->getTextureUploadQueue()->process();
         test->tick(dt);
         
         glfwSwapBuffers(window);
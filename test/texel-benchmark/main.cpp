@@ -0,0 +1,138 @@
+//
+//  main.cpp
+//  texel-benchmark
+//
+//  Compares the vectorized texel conversion kernels used by Texture2D with per-texel
+//  scalar conversion, flipping RGBA8 images from 256x256 to 4096x4096. The output of the
+//  kernels is checked against the scalar conversion, and the benchmark exits with a
+//  non-zero status if any texel differs.
+//
+//  Built by test/build-tests.sh.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "UnitTest.h"
+#include "gfx/TexelConversion.h"
+
+using unittest::check;
+
+namespace
+{
+    const int ITERATIONS = 5;
+    
+    template <typename F>
+    double measure(F&& func)
+    {
+        double best = 1e30;
+        for (int i = 0; i < ITERATIONS; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+            if (ms < best)
+                best = ms;
+        }
+        return best;
+    }
+    
+    // Per-texel conversions, the same as the WebGL texel conversion templates. Premultiplying
+    // rounds to nearest like the kernels, c * a / 255 is never halfway between two integers.
+    void premultiplyScalar(const uint8_t* src, uint8_t* dst, size_t pixels)
+    {
+        for (size_t i = 0; i < pixels; ++i, src += 4, dst += 4)
+        {
+            uint32_t alpha = src[3];
+            dst[0] = (uint8_t)((src[0] * alpha + 127) / 255);
+            dst[1] = (uint8_t)((src[1] * alpha + 127) / 255);
+            dst[2] = (uint8_t)((src[2] * alpha + 127) / 255);
+            dst[3] = src[3];
+        }
+    }
+    
+    void packRGB565Scalar(const uint8_t* src, uint16_t* dst, size_t pixels)
+    {
+        for (size_t i = 0; i < pixels; ++i, src += 4)
+            dst[i] = (uint16_t)(((src[0] & 0xF8) << 8) | ((src[1] & 0xFC) << 3) | ((src[2] & 0xF8) >> 3));
+    }
+    
+    void packRGBA4444PremultipliedScalar(const uint8_t* src, uint16_t* dst, size_t pixels)
+    {
+        uint8_t pixel[4];
+        for (size_t i = 0; i < pixels; ++i, src += 4)
+        {
+            premultiplyScalar(src, pixel, 1);
+            dst[i] = (uint16_t)(((pixel[0] & 0xF0) << 8) | ((pixel[1] & 0xF0) << 4) | (pixel[2] & 0xF0) | (pixel[3] >> 4));
+        }
+    }
+    
+    // Convert row by row into flipped destination rows, as Texture2D does.
+    template <typename T, typename F>
+    void convertFlipped(uint32_t size, const uint8_t* src, T* dst, F&& convertRow)
+    {
+        // RGBA8 rows have 4 elements per pixel, packed 16-bit rows have 1.
+        const size_t elementsPerPixel = 1 == sizeof(T) ? 4 : 1;
+        for (uint32_t row = 0; row < size; ++row)
+            convertRow(src + (size_t)row * size * 4, dst + (size_t)(size - 1 - row) * size * elementsPerPixel, size);
+    }
+    
+    void report(uint32_t size, const char* name, double scalar, double kernel)
+    {
+        printf("%-10u %-22s %12.2f %12.2f %7.1fx\n", size, name, scalar, kernel, scalar / kernel);
+    }
+}
+
+int main()
+{
+    printf("%-10s %-22s %12s %12s %8s\n", "size", "conversion", "scalar(ms)", "kernel(ms)", "speedup");
+    
+    for (uint32_t size = 256; size <= 4096; size *= 2)
+    {
+        size_t pixels = (size_t)size * size;
+        std::vector<uint8_t> src(pixels * 4);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = (uint8_t)(rand() & 0xFF);
+        
+        std::vector<uint8_t> expected8(pixels * 4);
+        std::vector<uint8_t> dst8(pixels * 4);
+        std::vector<uint16_t> expected16(pixels);
+        std::vector<uint16_t> dst16(pixels);
+        
+        double scalar = measure([&]() {
+            convertFlipped(size, src.data(), expected8.data(), premultiplyScalar);
+        });
+        double kernel = measure([&]() {
+            convertFlipped(size, src.data(), dst8.data(), cocos2d::renderer::premultiplyRGBA8);
+        });
+        report(size, "premultiply", scalar, kernel);
+        check(expected8 == dst8, "premultiply kernel matches the scalar conversion");
+        
+        scalar = measure([&]() {
+            convertFlipped(size, src.data(), expected16.data(), packRGB565Scalar);
+        });
+        kernel = measure([&]() {
+            convertFlipped(size, src.data(), dst16.data(), [](const uint8_t* s, uint16_t* d, size_t n) {
+                cocos2d::renderer::packRGBA8ToRGB565(s, d, n, false);
+            });
+        });
+        report(size, "RGB565", scalar, kernel);
+        check(expected16 == dst16, "RGB565 kernel matches the scalar conversion");
+        
+        scalar = measure([&]() {
+            convertFlipped(size, src.data(), expected16.data(), packRGBA4444PremultipliedScalar);
+        });
+        kernel = measure([&]() {
+            convertFlipped(size, src.data(), dst16.data(), [](const uint8_t* s, uint16_t* d, size_t n) {
+                cocos2d::renderer::packRGBA8ToRGBA4444(s, d, n, true);
+            });
+        });
+        report(size, "RGBA4444+premultiply", scalar, kernel);
+        check(expected16 == dst16, "RGBA4444 premultiplied kernel matches the scalar conversion");
+    }
+    
+    return unittest::report();
+}
@@ -0,0 +1,94 @@
+//
+//  AllocationCounter.cpp
+//  unit-tests
+//
+//  Replaces the global allocation functions to count the allocations of the unit tests and the benchmarks.
+//  Every form of operator new allocates with malloc() and every form of operator delete frees with free().
+//
+
+#include "UnitTest.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> allocations(0);
+
+    void* allocate(size_t size)
+    {
+        ++allocations;
+        return malloc(size ? size : 1);
+    }
+}
+
+namespace unittest
+{
+    size_t getAllocationCount()
+    {
+        return allocations;
+    }
+}
+
+// GCC can't tell that the replacements below are a matching pair and warns that memory allocated by
+// operator new is released with free() once it inlines them into each other.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    free(p);
+}
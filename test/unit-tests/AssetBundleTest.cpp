@@ -0,0 +1,140 @@
+//
+//  AssetBundleTest.cpp
+//  unit-tests
+//
+//  Writes an asset bundle of stored and deflated files with AssetBundleWriter, checks that every file reads
+//  back the same through AssetBundle and through FileUtils once the bundle is added as a search path, that
+//  stored files are aligned views into the mapping, and compares the time to resolve and read all the files
+//  from the bundle and from the same files loose on disk.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+#include "UnitTest.h"
+#include "platform/CCFileUtils.h"
+#include "base/CCAssetBundle.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const int FILE_COUNT = 4000;
+    const uint32_t ALIGNMENT = 256;
+
+    struct Asset
+    {
+        std::string name;
+        std::vector<unsigned char> data;
+    };
+
+    double readAll(FileUtils* fileUtils, const std::vector<Asset>& assets)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& asset : assets)
+        {
+            Data data = fileUtils->getDataFromFile(asset.name);
+            check((size_t)data.getSize() == asset.data.size() && memcmp(data.getBytes(), asset.data.data(), asset.data.size()) == 0,
+                  "files read back the same");
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+UNIT_TEST(AssetBundle)
+{
+    std::string root = "/tmp/asset-bundle";
+    std::string loose = root + "/loose/";
+    std::string bundlePath = root + "/assets.bundle";
+    system(("rm -rf " + root + " && mkdir -p " + loose).c_str());
+
+    // Small text-like files and larger binary ones spread over a few directories.
+    std::mt19937 random(3);
+    std::vector<Asset> assets(FILE_COUNT);
+    AssetBundleWriter writer(ALIGNMENT);
+    for (int i = 0; i < FILE_COUNT; ++i)
+    {
+        Asset& asset = assets[i];
+        std::string dir = "dir" + std::to_string(i % 16) + "/";
+        asset.name = dir + "file" + std::to_string(i) + (i % 3 ? ".plist" : ".png");
+        asset.data.resize(i % 3 ? 200 + random() % 4000 : 4096 + random() % 65536);
+        for (size_t j = 0; j < asset.data.size(); ++j)
+            asset.data[j] = i % 3 ? "<key>frame</key>"[j % 16] : (unsigned char)random();
+
+        mkdir((loose + dir).c_str(), 0755);
+        FILE* fp = fopen((loose + asset.name).c_str(), "wb");
+        fwrite(asset.data.data(), 1, asset.data.size(), fp);
+        fclose(fp);
+
+        check(writer.addFile(asset.name, asset.data.data(), asset.data.size(),
+                             i % 3 ? AssetBundle::Compression::DEFLATE : AssetBundle::Compression::NONE), "add file");
+    }
+    check(!writer.addFile(assets[0].name, assets[0].data.data(), assets[0].data.size()), "duplicate names are rejected");
+    check(writer.addFile("empty.txt", nullptr, 0), "add an empty file");
+    check(writer.save(bundlePath), "save the bundle");
+
+    // The bundle on its own.
+    AssetBundle* bundle = AssetBundle::createWithFile(bundlePath);
+    check(bundle != nullptr, "open the bundle");
+    if (!bundle)
+        return;
+    check(bundle->getEntryCount() == FILE_COUNT + 1, "entry count");
+    check(!bundle->fileExists("dir0/missing.png"), "missing file");
+    check(bundle->getFileSize("empty.txt") == 0, "empty file");
+    for (int i = 0; i < 3; ++i)
+    {
+        MappedFile* file = bundle->mapFile(assets[i].name);
+        check(file && file->getSize() == (ssize_t)assets[i].data.size() && memcmp(file->getBytes(), assets[i].data.data(), file->getSize()) == 0, "map file");
+        // stored files are views into the mapping, at the bundle alignment
+        if (file && i % 3 == 0)
+            check(file->isMapped() && ((uintptr_t)file->getBytes() % ALIGNMENT) == 0, "stored files are aligned views");
+        CC_SAFE_RELEASE(file);
+    }
+    bundle->release();
+
+    // Corrupt bundles are rejected.
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(bundlePath);
+        data.getBytes()[12] = 3;
+        MappedFile* corrupt = MappedFile::createWithData(std::move(data));
+        AssetBundle* rejected = AssetBundle::createWithMappedFile(corrupt);
+        check(!rejected, "a bundle with a bad alignment is rejected");
+        CC_SAFE_RELEASE(rejected);
+        corrupt->release();
+    }
+
+    // Loose files against the bundle, both through FileUtils.
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->setSearchResolutionsOrder({ "hd/", "" });
+    fileUtils->setSearchPaths({ loose });
+    double looseTime = readAll(fileUtils, assets);
+
+    fileUtils->setSearchPaths({});
+    fileUtils->purgeCachedEntries();
+    check(fileUtils->addSearchBundle(bundlePath, true), "add the bundle to the search paths");
+    double bundleTime = readAll(fileUtils, assets);
+
+    std::string fullPath = fileUtils->fullPathForFilename(assets[1].name);
+    check(fullPath == bundlePath + "/" + assets[1].name, "full path inside the bundle");
+    check(fileUtils->isFileExist(fullPath) && fileUtils->isFileExist(assets[1].name), "bundle files exist");
+    check(fileUtils->getFileSize(fullPath) == (long)assets[1].data.size(), "bundle file size");
+    MappedFile* mapped = fileUtils->mapFile(assets[0].name);
+    check(mapped && mapped->isMapped(), "FileUtils maps stored bundle files");
+    CC_SAFE_RELEASE(mapped);
+
+    fileUtils->setSearchPaths({});
+    check(fileUtils->fullPathForFilename(assets[1].name).empty(), "setSearchPaths closes the bundle");
+
+    printf("%d files: loose %.1f ms, bundle %.1f ms\n", FILE_COUNT, looseTime, bundleTime);
+    system(("rm -rf " + root).c_str());
+
+    // The next test gets a FileUtils with the default search paths and resolutions order.
+    FileUtils::destroyInstance();
+}
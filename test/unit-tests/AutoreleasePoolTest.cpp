@@ -0,0 +1,140 @@
+//
+//  AutoreleasePoolTest.cpp
+//  unit-tests
+//
+//  Checks the lifetime rules of AutoreleasePool and PoolManager: autoreleased objects live until the pool of
+//  their thread is drained, scoped pools release their objects when they go out of scope, every thread has
+//  its own pools and a thread releases what is left in them when it exits. Then times a frame of short lived
+//  objects released one by one against the same objects autoreleased and drained at the end of the frame.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "UnitTest.h"
+#include "base/CCAutoreleasePool.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    std::atomic<int> s_live(0);
+
+    class Transient : public Ref
+    {
+    public:
+        Transient() { ++s_live; }
+        virtual ~Transient() { --s_live; }
+    };
+
+    // Autoreleases a child from its destructor, like an object dropping the last reference to a cached one.
+    class Owner : public Transient
+    {
+    public:
+        virtual ~Owner() { (new Transient())->autorelease(); }
+    };
+
+    void drain()
+    {
+        PoolManager::getInstance()->getCurrentPool()->clear();
+    }
+
+    template <typename F>
+    double measure(int iterations, F f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    }
+}
+
+UNIT_TEST(AutoreleasePool)
+{
+    const int objects = 100000;
+
+    // Autoreleased objects live until the end of the frame.
+    auto kept = new Transient();
+    kept->autorelease();
+    kept->retain();
+    (new Transient())->autorelease();
+    check(s_live == 2, "autoreleased objects are alive before the drain");
+    check(PoolManager::getInstance()->isObjectInPools(kept), "autoreleased object is in a pool");
+    drain();
+    check(s_live == 1 && kept->getReferenceCount() == 1, "drain releases once per autorelease");
+    kept->release();
+    check(s_live == 0, "retained object is released by its owner");
+
+    // Objects autoreleased while the pool is drained are released by the same drain.
+    (new Owner())->autorelease();
+    drain();
+    check(s_live == 0, "objects autoreleased by destructors are drained");
+    check(PoolManager::getInstance()->getCurrentPool()->getObjectCount() == 0, "pool is empty after the drain");
+
+    // A scoped pool takes the objects autoreleased in its scope.
+    auto outer = PoolManager::getInstance()->getCurrentPool();
+    (new Transient())->autorelease();
+    {
+        AutoreleasePool pool;
+        check(PoolManager::getInstance()->getCurrentPool() == &pool, "scoped pool is current");
+        (new Transient())->autorelease();
+        (new Transient())->autorelease();
+        check(pool.getObjectCount() == 2, "scoped pool takes the objects of its scope");
+    }
+    check(s_live == 1, "scoped pool releases its objects");
+    check(PoolManager::getInstance()->getCurrentPool() == outer, "previous pool is current again");
+    drain();
+
+    // Every thread has its own pools, and releases them when it exits.
+    std::thread worker([]() {
+        check(PoolManager::getInstance()->getCurrentPool()->getObjectCount() == 0, "worker pool starts empty");
+        (new Transient())->autorelease();
+        (new Owner())->autorelease();
+    });
+    worker.join();
+    check(s_live == 0, "thread exit releases its pools");
+    check(outer->getObjectCount() == 0, "worker objects don't go to the main thread pool");
+
+#if CC_REF_LEAK_DETECTION
+    // The device and the caches of other tests are alive too, only count the objects of this test.
+    auto countTransients = []() {
+        unsigned int count = 0;
+        for (const auto& entry : Ref::getLiveObjectCounts())
+        {
+            if (entry.first.find("Transient") != std::string::npos)
+                count += entry.second;
+        }
+        return count;
+    };
+    auto leaked = new Transient();
+    check(countTransients() == 1, "live objects are counted by type");
+    leaked->release();
+    check(countTransients() == 0, "no live objects are left");
+#endif
+
+    // A frame of short lived objects: released right away, or autoreleased and drained at the end of the frame.
+    std::vector<Transient*> frame(objects);
+    const int iterations = 20;
+    double immediate = measure(iterations, [&]() {
+        for (int i = 0; i < objects; ++i)
+            frame[i] = new Transient();
+        for (int i = 0; i < objects; ++i)
+            frame[i]->release();
+    });
+    double pooled = measure(iterations, [&]() {
+        for (int i = 0; i < objects; ++i)
+            (new Transient())->autorelease();
+        drain();
+    });
+    check(s_live == 0, "benchmark objects are released");
+
+    printf("%d objects per frame\n", objects);
+    printf("release one by one      %8.3f ms per frame\n", immediate);
+    printf("autorelease and drain   %8.3f ms per frame\n", pooled);
+}
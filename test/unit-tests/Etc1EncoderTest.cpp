@@ -0,0 +1,154 @@
+//
+//  Etc1EncoderTest.cpp
+//  unit-tests
+//
+//  Checks the quality presets of etc1_encode_image_quality: medium has to match etc1_encode_block block by
+//  block, high can't have a larger error than medium in any block and fast can't have a smaller one, and
+//  the threaded encoder has to match the single threaded one. Prints the total error of every preset.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "UnitTest.h"
+#include "base/etc1.h"
+
+using unittest::check;
+
+namespace
+{
+    struct RGBImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    // Noise, gradients and flat areas, so every kind of block is encoded.
+    RGBImage makeTestImage(uint32_t width, uint32_t height, unsigned seed)
+    {
+        std::mt19937 random(seed);
+        RGBImage image;
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(width * height * 3);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* pixel = &image.pixels[(y * width + x) * 3];
+                switch ((x / 16 + y / 16) % 3)
+                {
+                    case 0:
+                        for (int c = 0; c < 3; ++c)
+                            pixel[c] = (uint8_t)random();
+                        break;
+                    case 1:
+                        pixel[0] = (uint8_t)(x * 4);
+                        pixel[1] = (uint8_t)(y * 4);
+                        pixel[2] = (uint8_t)((x + y) * 2);
+                        break;
+                    default:
+                        pixel[0] = (uint8_t)(seed * 40);
+                        pixel[1] = (uint8_t)(seed * 90);
+                        pixel[2] = (uint8_t)(seed * 10);
+                        break;
+                }
+            }
+        }
+        return image;
+    }
+
+    bool encode(const RGBImage& image, int quality, int threads, std::vector<uint8_t>& encoded)
+    {
+        encoded.resize(etc1_get_encoded_data_size(image.width, image.height));
+        return etc1_encode_image_quality(image.pixels.data(), image.width, image.height, 3, image.width * 3,
+                                         encoded.data(), quality, threads) == 0;
+    }
+
+    // The weighted squared error the encoder minimizes, of the block at (bx, by) of `encoded`.
+    uint32_t blockError(const RGBImage& image, const uint8_t* encoded, uint32_t bx, uint32_t by)
+    {
+        uint8_t decoded[ETC1_DECODED_BLOCK_SIZE];
+        etc1_decode_block(encoded + ((by / 4) * ((image.width + 3) / 4) + bx / 4) * ETC1_ENCODED_BLOCK_SIZE, decoded);
+
+        uint32_t error = 0;
+        for (uint32_t y = 0; y < 4 && by + y < image.height; ++y)
+        {
+            for (uint32_t x = 0; x < 4 && bx + x < image.width; ++x)
+            {
+                const uint8_t* p = &image.pixels[((by + y) * image.width + bx + x) * 3];
+                const uint8_t* d = &decoded[(y * 4 + x) * 3];
+                error += 3 * (p[0] - d[0]) * (p[0] - d[0]) + 6 * (p[1] - d[1]) * (p[1] - d[1]) + (p[2] - d[2]) * (p[2] - d[2]);
+            }
+        }
+        return error;
+    }
+
+    // Encodes `image` block by block with etc1_encode_block, the encoder before the presets.
+    std::vector<uint8_t> encodeBlocks(const RGBImage& image)
+    {
+        std::vector<uint8_t> encoded(etc1_get_encoded_data_size(image.width, image.height));
+        uint8_t* out = encoded.data();
+        for (uint32_t by = 0; by < image.height; by += 4)
+        {
+            for (uint32_t bx = 0; bx < image.width; bx += 4, out += ETC1_ENCODED_BLOCK_SIZE)
+            {
+                uint8_t block[ETC1_DECODED_BLOCK_SIZE] = {};
+                uint32_t mask = 0;
+                for (uint32_t y = 0; y < 4 && by + y < image.height; ++y)
+                {
+                    for (uint32_t x = 0; x < 4 && bx + x < image.width; ++x)
+                    {
+                        memcpy(&block[(y * 4 + x) * 3], &image.pixels[((by + y) * image.width + bx + x) * 3], 3);
+                        mask |= 1u << (y * 4 + x);
+                    }
+                }
+                etc1_encode_block(block, mask, out);
+            }
+        }
+        return encoded;
+    }
+}
+
+UNIT_TEST(Etc1Encoder)
+{
+    // small and odd sizes have partial blocks, large ones are encoded on several threads
+    const uint32_t sizes[][2] = { {4, 4}, {13, 7}, {64, 64}, {250, 333}, {512, 512} };
+    for (const auto& size : sizes)
+    {
+        RGBImage image = makeTestImage(size[0], size[1], size[0] + size[1]);
+        std::vector<uint8_t> encoded[3];
+        for (int quality = ETC1_QUALITY_FAST; quality <= ETC1_QUALITY_HIGH; ++quality)
+        {
+            std::vector<uint8_t> single;
+            check(encode(image, quality, 0, encoded[quality]) && encode(image, quality, 1, single), "presets encode");
+            check(single == encoded[quality], "threaded output matches one thread");
+        }
+        check(encodeBlocks(image) == encoded[ETC1_QUALITY_MEDIUM], "medium matches etc1_encode_block");
+
+        bool highNotWorse = true;
+        bool fastNotBetter = true;
+        uint64_t errors[3] = {};
+        for (uint32_t by = 0; by < image.height; by += 4)
+        {
+            for (uint32_t bx = 0; bx < image.width; bx += 4)
+            {
+                uint32_t fast = blockError(image, encoded[ETC1_QUALITY_FAST].data(), bx, by);
+                uint32_t medium = blockError(image, encoded[ETC1_QUALITY_MEDIUM].data(), bx, by);
+                uint32_t high = blockError(image, encoded[ETC1_QUALITY_HIGH].data(), bx, by);
+                highNotWorse = highNotWorse && high <= medium;
+                fastNotBetter = fastNotBetter && fast >= medium;
+                errors[ETC1_QUALITY_FAST] += fast;
+                errors[ETC1_QUALITY_MEDIUM] += medium;
+                errors[ETC1_QUALITY_HIGH] += high;
+            }
+        }
+        check(highNotWorse, "high is never worse than medium");
+        check(fastNotBetter, "fast is never better than medium");
+        printf("%4ux%-4u  error fast %llu  medium %llu  high %llu\n", size[0], size[1], (unsigned long long)errors[ETC1_QUALITY_FAST],
+               (unsigned long long)errors[ETC1_QUALITY_MEDIUM], (unsigned long long)errors[ETC1_QUALITY_HIGH]);
+    }
+}
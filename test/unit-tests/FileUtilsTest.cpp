@@ -0,0 +1,31 @@
+//
+//  FileUtilsTest.cpp
+//  unit-tests
+//
+//  The FileUtils of the unit tests and the benchmarks, reading straight from the file system.
+//
+
+#include <string>
+#include <unistd.h>
+
+#include "platform/CCFileUtils.h"
+
+using namespace cocos2d;
+
+namespace
+{
+    class FileUtilsTest : public FileUtils
+    {
+    public:
+        FileUtilsTest() { init(); }
+        virtual std::string getWritablePath() const override { return "/tmp/"; }
+        virtual bool isFileExistInternal(const std::string& filename) const override { return access(filename.c_str(), F_OK) == 0; }
+    };
+}
+
+FileUtils* FileUtils::getInstance()
+{
+    if (!s_sharedFileUtils)
+        s_sharedFileUtils = new FileUtilsTest();
+    return s_sharedFileUtils;
+}
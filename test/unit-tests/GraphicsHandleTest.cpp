@@ -0,0 +1,35 @@
+//
+//  GraphicsHandleTest.cpp
+//  unit-tests
+//
+//  Releases a vertex buffer on another thread and checks that its GL buffer is deleted by the GL thread,
+//  when the device processes the deferred deletions, and not by the releasing thread.
+//
+
+#include <thread>
+
+#include "FakeGL.h"
+#include "UnitTest.h"
+#include "gfx/DeviceGraphics.h"
+#include "gfx/VertexBuffer.h"
+
+using namespace cocos2d;
+using namespace cocos2d::renderer;
+using unittest::check;
+
+UNIT_TEST(GraphicsHandle)
+{
+    auto device = DeviceGraphics::getInstance();
+    float vertices[8] = {};
+    VertexFormat format({ { ATTRIB_NAME_POSITION, AttribType::FLOAT32, 2 } });
+    auto vertexBuffer = new VertexBuffer();
+    vertexBuffer->init(device, format, Usage::STATIC, vertices, sizeof(vertices), 4);
+    GLuint name = vertexBuffer->getHandle();
+    check(GL_TRUE == glIsBuffer(name), "the vertex buffer has a GL buffer");
+
+    std::thread releaser([vertexBuffer]() { vertexBuffer->release(); });
+    releaser.join();
+    check(GL_TRUE == glIsBuffer(name), "a handle released on another thread isn't deleted there");
+    device->processDeferredDeletions();
+    check(GL_FALSE == glIsBuffer(name), "the GL thread deletes the handles released on other threads");
+}
@@ -0,0 +1,216 @@
+//
+//  ImageDecoderTest.cpp
+//  unit-tests
+//
+//  Decodes a batch of PNG images with ImageDecoder, half from memory and half from files, and checks that
+//  every image decodes to the pixels it was encoded from, premultiplied when asked, that callbacks are only
+//  invoked on the thread calling dispatchCompleted()/waitAll(), that a failed decode reports nullptr and
+//  that callbacks can queue more jobs. Then prints the time to decode the batch on the decoder threads and
+//  one by one on the calling thread.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "UnitTest.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "platform/CCImageDecoder.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const int IMAGE_COUNT = 48;
+
+    struct TestImage
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+        std::string path;
+        Data encoded;
+    };
+
+    // An RGBA8888 image with translucent pixels whose content depends on `index`.
+    std::vector<unsigned char> makePixels(int width, int height, int index)
+    {
+        std::vector<unsigned char> pixels((size_t)width * height * 4);
+        for (size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = (unsigned char)((i * 2654435761u + index * 40503u) >> 7);
+        return pixels;
+    }
+
+    std::vector<unsigned char> premultiply(const std::vector<unsigned char>& pixels)
+    {
+        std::vector<unsigned char> ret(pixels);
+        for (size_t i = 0; i < ret.size(); i += 4)
+        {
+            unsigned int color = CC_RGB_PREMULTIPLY_ALPHA(ret[i], ret[i + 1], ret[i + 2], ret[i + 3]);
+            ret[i] = (unsigned char)color;
+            ret[i + 1] = (unsigned char)(color >> 8);
+            ret[i + 2] = (unsigned char)(color >> 16);
+        }
+        return ret;
+    }
+
+    bool hasPixels(Image* image, int width, int height, const std::vector<unsigned char>& pixels)
+    {
+        return image &&
+               width == image->getWidth() &&
+               height == image->getHeight() &&
+               Image::PixelFormat::RGBA8888 == image->getRenderFormat() &&
+               (size_t)image->getDataLen() == pixels.size() &&
+               0 == memcmp(image->getData(), pixels.data(), pixels.size());
+    }
+
+    std::vector<TestImage> writeImages(const std::string& directory)
+    {
+        std::vector<TestImage> images(IMAGE_COUNT);
+        for (int i = 0; i < IMAGE_COUNT; ++i)
+        {
+            auto& image = images[i];
+            image.width = 128 + (i % 5) * 96;
+            image.height = 96 + (i % 7) * 64;
+            image.pixels = makePixels(image.width, image.height, i);
+            image.path = directory + "/" + std::to_string(i) + ".png";
+
+            auto encoder = new Image();
+            encoder->initWithRawData(image.pixels.data(), image.pixels.size(), image.width, image.height, 8);
+            encoder->saveToFile(image.path, false);
+            encoder->release();
+            image.encoded = FileUtils::getInstance()->getDataFromFile(image.path);
+        }
+        return images;
+    }
+
+    typedef std::function<void(int index, Image* image)> IndexedCallback;
+
+    // Queue every image, the even ones from memory and the odd ones from their files.
+    void queueImages(const std::vector<TestImage>& images, bool premultiplyAlpha, const IndexedCallback& callback)
+    {
+        auto decoder = ImageDecoder::getInstance();
+        for (int i = 0; i < (int)images.size(); ++i)
+        {
+            auto done = [i, callback](Image* image) {
+                callback(i, image);
+            };
+            if (0 == i % 2)
+            {
+                Data data;
+                data.copy(images[i].encoded.getBytes(), images[i].encoded.getSize());
+                decoder->decodeData(std::move(data), done, premultiplyAlpha);
+            }
+            else
+                decoder->decodeFile(images[i].path, done, premultiplyAlpha);
+        }
+    }
+
+    void testBatch(const std::vector<TestImage>& images, bool premultiplyAlpha)
+    {
+        const auto callerThread = std::this_thread::get_id();
+        std::vector<int> decoded(images.size(), 0);
+        int matching = 0;
+        int offThread = 0;
+
+        queueImages(images, premultiplyAlpha, [&](int index, Image* image) {
+            ++decoded[index];
+            if (std::this_thread::get_id() != callerThread)
+                ++offThread;
+
+            const auto& source = images[index];
+            auto expected = premultiplyAlpha ? premultiply(source.pixels) : source.pixels;
+            if (hasPixels(image, source.width, source.height, expected) && (!premultiplyAlpha || image->hasPremultipliedAlpha()))
+                ++matching;
+        });
+
+        auto decoder = ImageDecoder::getInstance();
+        check(images.size() == decoder->getPendingCount(), "batch: all jobs are pending");
+        // Let the workers finish some jobs, their callbacks wait for dispatchCompleted().
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        bool anyDecoded = false;
+        for (auto count : decoded)
+            anyDecoded = anyDecoded || count > 0;
+        check(!anyDecoded, "batch: callbacks are not invoked before they are dispatched");
+
+        decoder->dispatchCompleted();
+        decoder->waitAll();
+
+        bool allOnce = true;
+        for (auto count : decoded)
+            allOnce = allOnce && 1 == count;
+        check(allOnce, "batch: every callback is invoked once");
+        check(0 == offThread, "batch: callbacks are invoked on the dispatching thread");
+        check((int)images.size() == matching, premultiplyAlpha ? "batch: images decode to their premultiplied pixels" : "batch: images decode to their pixels");
+        check(0 == decoder->getPendingCount(), "batch: nothing is pending after waitAll()");
+    }
+
+    void testFailureAndChaining(const std::vector<TestImage>& images)
+    {
+        auto decoder = ImageDecoder::getInstance();
+        bool failedReported = false;
+        bool chainedDecoded = false;
+
+        Data garbage;
+        garbage.copy((const unsigned char*)"not an image at all", 19);
+        decoder->decodeData(std::move(garbage), [&](Image* image) {
+            failedReported = nullptr == image;
+
+            // Queue another job from a callback, waitAll() has to wait for it too.
+            decoder->decodeFile(images[1].path, [&](Image* chained) {
+                chainedDecoded = hasPixels(chained, images[1].width, images[1].height, images[1].pixels);
+            });
+        });
+
+        decoder->waitAll();
+        check(failedReported, "failure: an undecodable image reports nullptr");
+        check(chainedDecoded, "chaining: a job queued by a callback is decoded before waitAll() returns");
+    }
+
+    void benchmark(const std::vector<TestImage>& images)
+    {
+        auto start = std::chrono::steady_clock::now();
+        queueImages(images, false, [](int, Image*) {});
+        ImageDecoder::getInstance()->waitAll();
+        double threaded = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+
+        start = std::chrono::steady_clock::now();
+        for (const auto& source : images)
+        {
+            auto image = new Image();
+            image->initWithImageData(source.encoded.getBytes(), source.encoded.getSize());
+            image->release();
+        }
+        double serial = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+
+        printf("%d images, %zu decoder threads: %.2f ms, one by one: %.2f ms (%.1fx)\n",
+               (int)images.size(), ImageDecoder::getInstance()->getThreadCount(), threaded, serial, serial / threaded);
+    }
+}
+
+UNIT_TEST(ImageDecoder)
+{
+    std::string directory = "/tmp/image-decoder";
+    mkdir(directory.c_str(), 0755);
+
+    auto images = writeImages(directory);
+    check(ImageDecoder::getInstance()->getThreadCount() > 0, "the decoder has worker threads");
+
+    testBatch(images, false);
+    testBatch(images, true);
+    testFailureAndChaining(images);
+    benchmark(images);
+
+    ImageDecoder::destroyInstance();
+    for (const auto& image : images)
+        unlink(image.path.c_str());
+}
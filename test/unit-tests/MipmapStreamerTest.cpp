@@ -0,0 +1,258 @@
+//
+//  MipmapStreamerTest.cpp
+//  unit-tests
+//
+//  Streams the mipmap levels of textures with the MipmapStreamer against fake-gl and checks the levels that
+//  have storage and the base and max level of the GL textures: levels are streamed in one per frame toward
+//  the request within the upload budget, streamed out after they weren't requested for a while, and come
+//  back with the levels they had when an evicted texture is reloaded. Also checks that draws keep the
+//  textures they set on every unit while streamed textures are recreated or reloaded.
+//
+
+#include <string>
+#include <vector>
+
+#include "UnitTest.h"
+#include "FakeGL.h"
+#include "gfx/DeviceGraphics.h"
+#include "gfx/Program.h"
+#include "gfx/Texture2D.h"
+#include "gfx/VertexBuffer.h"
+
+using namespace cocos2d;
+using namespace cocos2d::renderer;
+using unittest::check;
+
+namespace
+{
+    const int SIZE = 256;
+    // 256x256 down to 1x1
+    const int LEVELS = 9;
+
+    const char* VERTEX_SHADER =
+        "attribute vec2 a_position;\n"
+        "void main() { gl_Position = vec4(a_position, 0.0, 1.0); }\n";
+    const char* FRAGMENT_SHADER =
+        "uniform sampler2D texture0;\n"
+        "uniform sampler2D texture1;\n"
+        "void main() { gl_FragColor = texture2D(texture0, vec2(0.0)) + texture2D(texture1, vec2(0.0)); }\n";
+
+    // A streamed texture and the levels its loader was asked for.
+    struct StreamedTexture
+    {
+        Texture2D* texture = nullptr;
+        std::vector<int> loads;
+    };
+
+    StreamedTexture* newStreamedTexture(DeviceGraphics* device, int residentLevel)
+    {
+        auto streamed = new StreamedTexture();
+        streamed->texture = new Texture2D();
+        streamed->texture->init(device, Texture::Options());
+
+        Texture::Options options;
+        options.width = SIZE;
+        options.height = SIZE;
+        options.flipY = false;
+        options.hasMipmap = true;
+        streamed->texture->initMipmapStreaming(options, residentLevel, [streamed](int level, Data& image) {
+            streamed->loads.push_back(level);
+            int size = std::max(SIZE >> level, 1);
+            std::vector<unsigned char> pixels(size * size * 4, (unsigned char)level);
+            image.copy(pixels.data(), pixels.size());
+            return true;
+        });
+        return streamed;
+    }
+
+    void deleteStreamedTexture(StreamedTexture* streamed)
+    {
+        streamed->texture->release();
+        delete streamed;
+    }
+
+    // Whether exactly the levels from `baseLevel` down to 1x1 have storage, with their sizes, and the GL
+    // texture is clamped to them. Levels below the base level may keep storage, only level 0 of init() does.
+    bool hasLevels(Texture2D* texture, int baseLevel)
+    {
+        auto object = fakegl::getTexture(texture->getHandle());
+        if (!object || object->baseLevel != baseLevel || object->maxLevel != LEVELS - 1 || texture->getBaseLevel() != baseLevel)
+            return false;
+
+        for (int level = 1; level < LEVELS; ++level)
+        {
+            auto iter = object->levels.find(level);
+            bool resident = object->levels.end() != iter;
+            if (resident != (level >= baseLevel))
+                return false;
+            if (resident && (iter->second.width != std::max(SIZE >> level, 1) || iter->second.height != std::max(SIZE >> level, 1)))
+                return false;
+        }
+        return true;
+    }
+
+    void testStreamIn(DeviceGraphics* device)
+    {
+        auto& streamer = device->getMipmapStreamer();
+        streamer.setMaxUploadsPerFrame(1);
+        streamer.setStreamOutFrames(1000);
+
+        auto first = newStreamedTexture(device, 4);
+        auto second = newStreamedTexture(device, 4);
+        check(hasLevels(first->texture, 4), "stream in: levels from the resident level down to 1x1 are uploaded");
+        check(std::vector<int>({ 8, 7, 6, 5, 4 }) == first->loads, "stream in: the resident levels are loaded from 1x1 up");
+
+        // Both want level 2, one level is uploaded per frame and the textures take turns.
+        int frames = 0;
+        while ((first->texture->getBaseLevel() > 2 || second->texture->getBaseLevel() > 2) && frames < 10)
+        {
+            first->texture->requestMipmapLevel(2);
+            second->texture->requestMipmapLevel(2);
+            int before = first->texture->getBaseLevel() + second->texture->getBaseLevel();
+            streamer.beginFrame();
+            check(before - 1 == first->texture->getBaseLevel() + second->texture->getBaseLevel(), "stream in: one level per frame within the budget");
+            ++frames;
+        }
+        check(4 == frames, "stream in: the textures take turns");
+        check(hasLevels(first->texture, 2) && hasLevels(second->texture, 2), "stream in: the requested levels are uploaded and the base level follows");
+
+        // Nothing changes while the request is met.
+        GLuint handle = first->texture->getHandle();
+        first->texture->requestMipmapLevel(2);
+        second->texture->requestMipmapLevel(3);
+        streamer.beginFrame();
+        check(hasLevels(first->texture, 2) && handle == first->texture->getHandle(), "stream in: met requests upload nothing");
+
+        deleteStreamedTexture(first);
+        deleteStreamedTexture(second);
+        check(streamer.empty(), "destroyed textures leave the streamer");
+    }
+
+    void testStreamOut(DeviceGraphics* device)
+    {
+        auto& streamer = device->getMipmapStreamer();
+        streamer.setMaxUploadsPerFrame(2);
+        streamer.setStreamOutFrames(3);
+
+        auto streamed = newStreamedTexture(device, 3);
+        streamed->texture->requestMipmapLevel(1);
+        streamer.beginFrame();
+        streamed->texture->requestMipmapLevel(1);
+        streamer.beginFrame();
+        check(hasLevels(streamed->texture, 1), "stream out: levels streamed in first");
+        uint64_t bytes = streamed->texture->getStorageBytes();
+
+        // Unrequested levels are streamed out one at a time after the stream out frames.
+        GLuint handle = streamed->texture->getHandle();
+        streamed->loads.clear();
+        for (int i = 0; i < 2; ++i)
+            streamer.beginFrame();
+        check(hasLevels(streamed->texture, 1), "stream out: levels stay for the stream out frames");
+        streamer.beginFrame();
+        check(hasLevels(streamed->texture, 2), "stream out: the base level is streamed out, its storage is gone");
+        check(handle != streamed->texture->getHandle() && nullptr == fakegl::getTexture(handle), "stream out: the texture is recreated and the old one deleted");
+        check(std::vector<int>({ 8, 7, 6, 5, 4, 3, 2 }) == streamed->loads, "stream out: the remaining levels are loaded again");
+        check(streamed->texture->getStorageBytes() < bytes, "stream out: the storage bytes shrink");
+
+        // It never goes past the resident level.
+        for (int i = 0; i < 20; ++i)
+            streamer.beginFrame();
+        check(hasLevels(streamed->texture, 3), "stream out: down to the resident level only");
+
+        // Without upload budget, levels stay until there is some.
+        streamed->texture->requestMipmapLevel(2);
+        streamer.beginFrame();
+        streamer.setMaxUploadsPerFrame(0);
+        for (int i = 0; i < 5; ++i)
+            streamer.beginFrame();
+        check(hasLevels(streamed->texture, 2), "stream out: waits for the upload budget");
+        streamer.setMaxUploadsPerFrame(2);
+        streamer.beginFrame();
+        check(hasLevels(streamed->texture, 3), "stream out: streams out once there is budget");
+
+        deleteStreamedTexture(streamed);
+    }
+
+    fakegl::Draw draw(DeviceGraphics* device, Program* program, VertexBuffer* vertices, Texture2D* unit0, Texture2D* unit1)
+    {
+        device->setProgram(program);
+        device->setVertexBuffer(0, vertices);
+        device->setTexture("texture0", unit0, 0);
+        device->setTexture("texture1", unit1, 1);
+        device->draw(0, 3);
+        return fakegl::getState().draws.back();
+    }
+
+    bool hasBindings(const fakegl::Draw& draw, Texture2D* unit0, Texture2D* unit1)
+    {
+        return 0 != unit0->getHandle() && 0 != unit1->getHandle() &&
+               draw.textures[0] == unit0->getHandle() && draw.textures[1] == unit1->getHandle();
+    }
+
+    void testBindings(DeviceGraphics* device)
+    {
+        auto& streamer = device->getMipmapStreamer();
+        streamer.setMaxUploadsPerFrame(2);
+        streamer.setStreamOutFrames(1);
+        auto& residency = device->getTextureResidency();
+        residency.setEvictAfterFrames(1);
+
+        auto program = Program::create(device, VERTEX_SHADER, FRAGMENT_SHADER);
+        program->retain();
+        program->link();
+        VertexFormat format({ { ATTRIB_NAME_POSITION, AttribType::FLOAT32, 2 } });
+        const float positions[] = { 0, 0, 1, 0, 0, 1 };
+        auto vertices = new VertexBuffer();
+        vertices->init(device, format, Usage::STATIC, positions, sizeof(positions), 3);
+
+        auto pinned = newStreamedTexture(device, 0);
+        auto streamed = newStreamedTexture(device, 3);
+        streamed->texture->requestMipmapLevel(2);
+        streamer.beginFrame();
+
+        // A stream out recreates the texture bound on unit 0, the next draw binds the new one.
+        check(hasBindings(draw(device, program, vertices, streamed->texture, pinned->texture), streamed->texture, pinned->texture), "bindings: the first draw binds its textures");
+        streamer.beginFrame();
+        streamer.beginFrame();
+        check(hasLevels(streamed->texture, 3), "bindings: the level is streamed out");
+        check(hasBindings(draw(device, program, vertices, streamed->texture, pinned->texture), streamed->texture, pinned->texture), "bindings: a recreated texture is rebound on its unit");
+
+        // Evict the streamed texture, which reloads on unit 1 while the pinned texture moved to unit 0.
+        streamed->texture->setSourcePath("streamed");
+        residency.setBudget(1);
+        for (uint32_t i = 0; i <= residency.getEvictAfterFrames(); ++i)
+            residency.beginFrame();
+        residency.setBudget(0);
+        check(!streamed->texture->isResident(), "bindings: the streamed texture is evicted");
+        check(hasBindings(draw(device, program, vertices, pinned->texture, streamed->texture), pinned->texture, streamed->texture), "bindings: a reload on unit 1 keeps the texture of unit 0");
+        check(hasLevels(streamed->texture, 3), "bindings: a reloaded texture has the levels it had");
+
+        deleteStreamedTexture(pinned);
+        deleteStreamedTexture(streamed);
+        vertices->release();
+        program->release();
+    }
+}
+
+UNIT_TEST(MipmapStreamer)
+{
+    auto device = DeviceGraphics::getInstance();
+    check(device->supportMipmapStreaming(), "fake-gl is OpenGL ES 3, which can clamp mipmap levels");
+
+    // The device is shared with the other tests, restore what the tests change.
+    auto& streamer = device->getMipmapStreamer();
+    auto& residency = device->getTextureResidency();
+    auto maxUploadsPerFrame = streamer.getMaxUploadsPerFrame();
+    auto streamOutFrames = streamer.getStreamOutFrames();
+    auto budget = residency.getBudget();
+    auto evictAfterFrames = residency.getEvictAfterFrames();
+
+    testStreamIn(device);
+    testStreamOut(device);
+    testBindings(device);
+
+    streamer.setMaxUploadsPerFrame(maxUploadsPerFrame);
+    streamer.setStreamOutFrames(streamOutFrames);
+    residency.setBudget(budget);
+    residency.setEvictAfterFrames(evictAfterFrames);
+}
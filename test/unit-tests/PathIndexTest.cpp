@@ -0,0 +1,120 @@
+//
+//  PathIndexTest.cpp
+//  unit-tests
+//
+//  Resolves files and directories with FileUtils::fullPathForFilename behind several missing search paths
+//  and resolution directories, with and without the path index, and checks that the index resolves every
+//  name to the same full path as the file system does: files, directories with and without a trailing '/',
+//  names in another case and missing names. Also checks that a manifest listing only files indexes their
+//  directories, then prints the time to resolve the names with and without the index.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "UnitTest.h"
+#include "platform/CCFileUtils.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const int MISSING_SEARCH_PATHS = 8;
+    const int LOOKUP_PASSES = 200;
+
+    void writeFile(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        fputs("path-index", file);
+        fclose(file);
+    }
+
+    std::vector<std::string> resolve(FileUtils* fileUtils, const std::vector<std::string>& names)
+    {
+        fileUtils->purgeCachedEntries();
+        std::vector<std::string> paths;
+        for (const auto& name : names)
+            paths.push_back(fileUtils->fullPathForFilename(name));
+        return paths;
+    }
+
+    double timeLookups(FileUtils* fileUtils, const std::vector<std::string>& names)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < LOOKUP_PASSES; ++i)
+            resolve(fileUtils, names);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+UNIT_TEST(PathIndex)
+{
+    std::string directory = "/tmp/path-index";
+    std::string root = directory + "/res/";
+    mkdir(directory.c_str(), 0755);
+    mkdir(root.c_str(), 0755);
+    for (auto name : { "hd", "sub", "sub/hd", "sub/deeper", "empty" })
+        mkdir((root + name).c_str(), 0755);
+    for (auto name : { "a.png", "hd/a.png", "sub/b.png", "sub/hd/b.png", "sub/deeper/c.png", "Upper.png" })
+        writeFile(root + name);
+
+    auto fileUtils = FileUtils::getInstance();
+    fileUtils->setPopupNotify(false);
+    fileUtils->setDefaultResourceRootPath(root);
+    std::vector<std::string> searchPaths;
+    for (int i = 0; i < MISSING_SEARCH_PATHS; ++i)
+        searchPaths.push_back("missing" + std::to_string(i));
+    searchPaths.push_back("sub");
+    fileUtils->setSearchPaths(searchPaths);
+    fileUtils->setSearchResolutionsOrder({ "missing-hd/", "hd/", "" });
+
+    const std::vector<std::string> names = {
+        "a.png", "b.png", "deeper/c.png", "sub/deeper/c.png", "Upper.png",
+        "sub", "sub/", "deeper", "sub/deeper/", "empty", "hd",
+        "A.png", "upper.png", "SUB", "missing.png", "sub/missing.png", "missing/a.png", "sub/../a.png"
+    };
+
+    auto probed = resolve(fileUtils, names);
+    check(root + "hd/a.png" == probed[0] && root + "sub/hd/b.png" == probed[1], "the file system finds the files it is given");
+    check(!probed[5].empty() && !probed[9].empty(), "the file system finds directories");
+
+    check(fileUtils->buildPathIndex() > 0, "the resource root is indexed");
+    check(probed == resolve(fileUtils, names), "the index resolves every name as the file system does");
+
+    // A manifest written at build time only lists files, their directories are indexed from it.
+    std::string manifest = directory + "/manifest.txt";
+    FILE* file = fopen(manifest.c_str(), "wb");
+    fputs("# files only\nsub/deeper/c.png\r\n\nUpper.png\n", file);
+    fclose(file);
+    check(fileUtils->loadPathIndex(manifest), "the manifest is loaded");
+    auto manifested = resolve(fileUtils, { "deeper", "sub", "sub/deeper/", "deeper/c.png", "a.png", "empty" });
+    check(root + "sub/deeper" == manifested[0] && root + "sub" == manifested[1], "directories of the listed files are indexed");
+    check(!manifested[2].empty() && !manifested[3].empty(), "listed files and their directories with a trailing '/' resolve");
+    check(manifested[4].empty() && manifested[5].empty(), "names the manifest doesn't list are not probed");
+
+    // A saved index loads back to the same index.
+    fileUtils->buildPathIndex();
+    size_t indexSize = fileUtils->getPathIndexSize();
+    check(fileUtils->savePathIndex(manifest) && fileUtils->loadPathIndex(manifest), "the index is saved and loaded");
+    check(indexSize == fileUtils->getPathIndexSize() && probed == resolve(fileUtils, names), "a saved index resolves as the scanned one");
+
+    double indexed = timeLookups(fileUtils, names);
+    fileUtils->clearPathIndex();
+    double unindexed = timeLookups(fileUtils, names);
+    printf("%d lookups over %zu search paths: file system %.2f ms, index %.2f ms (%.1fx)\n",
+           LOOKUP_PASSES * (int)names.size(), searchPaths.size() + 1, unindexed, indexed, unindexed / indexed);
+
+    unlink(manifest.c_str());
+    for (auto name : { "a.png", "hd/a.png", "sub/b.png", "sub/hd/b.png", "sub/deeper/c.png", "Upper.png" })
+        unlink((root + name).c_str());
+    for (auto name : { "sub/deeper", "sub/hd", "sub", "hd", "empty", "" })
+        rmdir((root + name).c_str());
+
+    // The next test gets a FileUtils with the default search paths.
+    FileUtils::destroyInstance();
+}
@@ -0,0 +1,219 @@
+//
+//  RefStressTest.cpp
+//  unit-tests
+//
+//  Hammers Ref::retain() and Ref::release() from several threads with CC_REF_THREAD_SAFE enabled. Shared
+//  objects retained and released concurrently must end with their initial count. Objects whose last
+//  reference is dropped by racing threads must be destructed exactly once, and the destructor must see what
+//  every owner wrote before releasing. Objects which override Ref::onLastRelease() like GraphicsHandle must
+//  be destructed on their owner thread when released elsewhere.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "UnitTest.h"
+#include "base/CCRef.h"
+
+#if !CC_REF_THREAD_SAFE
+#error "Build the unit tests with -DCC_REF_THREAD_SAFE=1"
+#endif
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    std::atomic<int> s_destructed(0);
+
+    // Every owner writes its slot before releasing, the destructor checks that it sees all of them.
+    class Shared : public Ref
+    {
+    public:
+        explicit Shared(int owners)
+        : _owners(owners)
+        , _marks(owners, 0)
+        {
+        }
+
+        virtual ~Shared()
+        {
+            for (int i = 0; i < _owners; ++i)
+            {
+                if (1 != _marks[i])
+                    s_lostWrites.fetch_add(1, std::memory_order_relaxed);
+            }
+            s_destructed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void mark(int owner) { _marks[owner] = 1; }
+
+        static std::atomic<int> s_lostWrites;
+
+    private:
+        int _owners;
+        std::vector<int> _marks;
+    };
+    std::atomic<int> Shared::s_lostWrites(0);
+
+    // Mirrors GraphicsHandle: released on another thread, it is queued and deleted by the owner thread.
+    class OwnedByThread : public Ref
+    {
+    public:
+        static std::thread::id s_owner;
+        static std::mutex s_mutex;
+        static std::vector<OwnedByThread*> s_queue;
+        static std::atomic<int> s_wrongThread;
+
+        static void processDeferredDeletions()
+        {
+            std::vector<OwnedByThread*> deleting;
+            {
+                std::lock_guard<std::mutex> lock(s_mutex);
+                deleting.swap(s_queue);
+            }
+            for (auto object : deleting)
+                delete object;
+        }
+
+        virtual ~OwnedByThread()
+        {
+            if (std::this_thread::get_id() != s_owner)
+                s_wrongThread.fetch_add(1, std::memory_order_relaxed);
+            s_destructed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+    protected:
+        virtual void onLastRelease() override
+        {
+            if (std::this_thread::get_id() == s_owner)
+            {
+                delete this;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(s_mutex);
+            s_queue.push_back(this);
+        }
+    };
+    std::thread::id OwnedByThread::s_owner;
+    std::mutex OwnedByThread::s_mutex;
+    std::vector<OwnedByThread*> OwnedByThread::s_queue;
+    std::atomic<int> OwnedByThread::s_wrongThread(0);
+
+    template <typename F>
+    void runThreads(int threads, F f)
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back(f, t);
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    double measurePairs(int threads, Ref* object, int pairs)
+    {
+        auto start = std::chrono::steady_clock::now();
+        runThreads(threads, [object, pairs](int) {
+            for (int i = 0; i < pairs; ++i)
+            {
+                object->retain();
+                object->release();
+            }
+        });
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / pairs;
+    }
+}
+
+UNIT_TEST(RefStress)
+{
+    const int threads = 4;
+
+    // Concurrent retain/release on shared objects.
+    const int sharedCount = 64;
+    std::vector<Shared*> shared;
+    for (int i = 0; i < sharedCount; ++i)
+        shared.push_back(new Shared(0));
+    runThreads(threads, [&shared](int t) {
+        unsigned int seed = 12345u + t;
+        for (int i = 0; i < 400000; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            auto object = shared[(seed >> 8) % sharedCount];
+            object->retain();
+            if (seed & 0x10000)
+                object->retain();
+            object->release();
+            if (seed & 0x10000)
+                object->release();
+        }
+    });
+    bool counts = true;
+    for (auto object : shared)
+        counts = counts && 1 == object->getReferenceCount();
+    check(counts, "shared objects keep their reference count");
+    for (auto object : shared)
+        object->release();
+    check(sharedCount == s_destructed.load(), "shared objects are destructed once");
+
+    // Racing last releases.
+    s_destructed = 0;
+    const int rounds = 20000;
+    std::vector<Shared*> handoff(rounds);
+    for (int i = 0; i < rounds; ++i)
+    {
+        handoff[i] = new Shared(threads);
+        for (int t = 1; t < threads; ++t)
+            handoff[i]->retain();
+    }
+    runThreads(threads, [&handoff, rounds](int t) {
+        for (int i = 0; i < rounds; ++i)
+        {
+            handoff[i]->mark(t);
+            handoff[i]->release();
+        }
+    });
+    check(rounds == s_destructed.load(), "objects released by racing threads are destructed once");
+    check(0 == Shared::s_lostWrites.load(), "destructors see the writes of every owner");
+
+    // Deferred destruction on the owner thread.
+    s_destructed = 0;
+    OwnedByThread::s_owner = std::this_thread::get_id();
+    const int owned = 10000;
+    std::vector<OwnedByThread*> objects(owned);
+    for (int i = 0; i < owned; ++i)
+    {
+        objects[i] = new OwnedByThread();
+        for (int t = 1; t < threads; ++t)
+            objects[i]->retain();
+    }
+    std::atomic<bool> done(false);
+    std::thread releaser([&objects, threads, &done]() {
+        runThreads(threads - 1, [&objects](int) {
+            for (auto object : objects)
+                object->release();
+        });
+        done = true;
+    });
+    // The owner keeps rendering frames while the other threads release.
+    for (auto object : objects)
+        object->release();
+    while (!done)
+    {
+        OwnedByThread::processDeferredDeletions();
+        std::this_thread::yield();
+    }
+    releaser.join();
+    OwnedByThread::processDeferredDeletions();
+    check(owned == s_destructed.load(), "deferred objects are destructed once");
+    check(0 == OwnedByThread::s_wrongThread.load(), "deferred objects are destructed on their owner thread");
+
+    auto object = new Shared(0);
+    printf("retain/release pair, 1 thread    %6.2f ns\n", measurePairs(1, object, 10000000));
+    printf("retain/release pair, %d threads   %6.2f ns\n", threads, measurePairs(threads, object, 2000000));
+    object->release();
+}
@@ -0,0 +1,195 @@
+//
+//  RenderPassInvalidationTest.cpp
+//  unit-tests
+//
+//  Runs render passes of the GL backend against fake-gl and checks that LoadAction::DONT_CARE and
+//  StoreAction::DONT_CARE attachments are invalidated when the pass begins and ends, that CLEAR and
+//  LOAD/STORE attachments are not, and that CommandBuffer::getInvalidationCount() counts them.
+//
+
+#include <vector>
+
+#include "FakeGL.h"
+#include "UnitTest.h"
+#include "backend/Device.h"
+#include "backend/CommandBuffer.h"
+#include "backend/RenderPass.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    // Attachment names of the default frame buffer, GL_COLOR/GL_DEPTH/GL_STENCIL in OpenGL ES 3.0.
+    const GLenum DEFAULT_COLOR = 0x1800;
+    const GLenum DEFAULT_DEPTH = 0x1801;
+    const GLenum DEFAULT_STENCIL = 0x1802;
+
+    struct PassResult
+    {
+        uint32_t invalidationCount = 0;
+        std::vector<std::vector<GLenum>> invalidations;
+    };
+
+    // Begins and ends `descriptor`'s pass once, and returns what was invalidated.
+    PassResult runPass(const backend::RenderPassDescriptor& descriptor)
+    {
+        auto device = backend::Device::getInstance();
+        auto renderPass = device->newRenderPass(descriptor);
+        auto commandBuffer = device->newCommandBuffer();
+
+        fakegl::getState().invalidations.clear();
+        commandBuffer->beginRenderPass(renderPass);
+        commandBuffer->endRenderPass();
+
+        PassResult result;
+        result.invalidationCount = commandBuffer->getInvalidationCount();
+        result.invalidations = fakegl::getState().invalidations;
+
+        commandBuffer->resetInvalidationCount();
+        check(0 == commandBuffer->getInvalidationCount(), "resetInvalidationCount() clears the count");
+
+        commandBuffer->release();
+        renderPass->release();
+        return result;
+    }
+
+    backend::Texture* newRenderTarget(backend::TextureFormat format)
+    {
+        backend::TextureDescriptor descriptor;
+        descriptor.width = 64;
+        descriptor.height = 64;
+        descriptor.textureType = backend::TextureType::TEXTURE_2D;
+        descriptor.textureUsage = backend::TextureUsage::RENDER_TARGET;
+        descriptor.textureFormat = format;
+        return backend::Device::getInstance()->newTexture(descriptor);
+    }
+
+    void testLoadAndStore()
+    {
+        backend::RenderPassDescriptor descriptor;
+        auto result = runPass(descriptor);
+        check(0 == result.invalidationCount, "LOAD/STORE attachments are not invalidated");
+        check(result.invalidations.empty(), "LOAD/STORE issue no glInvalidateFramebuffer");
+    }
+
+    void testClear()
+    {
+        backend::RenderPassDescriptor descriptor;
+        descriptor.setClearColor(0, 0, 0, 1);
+        descriptor.setClearDepth(1);
+        descriptor.setClearStencil(0);
+        auto result = runPass(descriptor);
+        check(0 == result.invalidationCount, "CLEAR attachments are not invalidated");
+    }
+
+    void testDefaultFramebufferDontCare()
+    {
+        backend::RenderPassDescriptor descriptor;
+        descriptor.setClearColor(0, 0, 0, 1);
+        descriptor.setDepthLoadAction(backend::LoadAction::DONT_CARE);
+        descriptor.setDepthStoreAction(backend::StoreAction::DONT_CARE);
+        descriptor.setStencilStoreAction(backend::StoreAction::DONT_CARE);
+        auto result = runPass(descriptor);
+        check(2 == result.invalidationCount, "default frame buffer: one invalidation when the pass begins and one when it ends");
+        check(2 == result.invalidations.size(), "default frame buffer: two glInvalidateFramebuffer calls");
+        if (2 == result.invalidations.size())
+        {
+            check(std::vector<GLenum>{ DEFAULT_DEPTH } == result.invalidations[0], "default frame buffer: depth is invalidated when the pass begins");
+            check(std::vector<GLenum>({ DEFAULT_DEPTH, DEFAULT_STENCIL }) == result.invalidations[1], "default frame buffer: depth and stencil are invalidated when the pass ends");
+        }
+    }
+
+    void testDefaultFramebufferColorDontCare()
+    {
+        backend::RenderPassDescriptor descriptor;
+        descriptor.setColorLoadAction(backend::LoadAction::DONT_CARE);
+        auto result = runPass(descriptor);
+        check(1 == result.invalidationCount, "default frame buffer: color DONT_CARE load is one invalidation");
+        check(1 == result.invalidations.size() && std::vector<GLenum>{ DEFAULT_COLOR } == result.invalidations[0], "default frame buffer: color is invalidated");
+    }
+
+    // The default frame buffer is a frame buffer object on iOS, its attachments aren't GL_COLOR/GL_DEPTH/GL_STENCIL.
+    void testDefaultFramebufferObject()
+    {
+        GLuint defaultFrameBuffer = 0;
+        glGenFramebuffers(1, &defaultFrameBuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, defaultFrameBuffer);
+
+        backend::RenderPassDescriptor descriptor;
+        descriptor.setColorLoadAction(backend::LoadAction::DONT_CARE);
+        descriptor.setDepthStoreAction(backend::StoreAction::DONT_CARE);
+        descriptor.setStencilStoreAction(backend::StoreAction::DONT_CARE);
+        auto result = runPass(descriptor);
+        check(GL_NO_ERROR == glGetError(), "default frame buffer object: attachment names are valid for the bound frame buffer");
+        check(2 == result.invalidationCount, "default frame buffer object: one invalidation when the pass begins and one when it ends");
+        if (2 == result.invalidations.size())
+        {
+            check(std::vector<GLenum>{ GL_COLOR_ATTACHMENT0 } == result.invalidations[0], "default frame buffer object: the color attachment is invalidated when the pass begins");
+            check(std::vector<GLenum>({ GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT }) == result.invalidations[1], "default frame buffer object: depth and stencil attachments are invalidated when the pass ends");
+        }
+        else
+        {
+            check(false, "default frame buffer object: two glInvalidateFramebuffer calls");
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &defaultFrameBuffer);
+    }
+
+    void testOffscreen()
+    {
+        auto color = newRenderTarget(backend::TextureFormat::R8G8B8A8);
+        auto depthStencil = newRenderTarget(backend::TextureFormat::D24S8);
+
+        backend::RenderPassDescriptor descriptor;
+        descriptor.setColorAttachment(0, color);
+        descriptor.setDepthStencilAttachment(depthStencil);
+        descriptor.setClearColor(0, 0, 0, 1);
+        descriptor.setDepthLoadAction(backend::LoadAction::DONT_CARE);
+        descriptor.setStencilLoadAction(backend::LoadAction::DONT_CARE);
+        descriptor.setColorStoreAction(backend::StoreAction::DONT_CARE);
+        auto result = runPass(descriptor);
+        check(2 == result.invalidationCount, "offscreen: one invalidation when the pass begins and one when it ends");
+        if (2 == result.invalidations.size())
+        {
+            check(std::vector<GLenum>({ GL_DEPTH_ATTACHMENT, GL_STENCIL_ATTACHMENT }) == result.invalidations[0], "offscreen: depth and stencil attachments are invalidated when the pass begins");
+            check(std::vector<GLenum>{ GL_COLOR_ATTACHMENT0 } == result.invalidations[1], "offscreen: the color attachment is invalidated when the pass ends");
+        }
+        else
+        {
+            check(false, "offscreen: two glInvalidateFramebuffer calls");
+        }
+
+        color->release();
+        depthStencil->release();
+    }
+
+    void testCountAccumulates()
+    {
+        backend::RenderPassDescriptor descriptor;
+        descriptor.setDepthStoreAction(backend::StoreAction::DONT_CARE);
+        auto device = backend::Device::getInstance();
+        auto renderPass = device->newRenderPass(descriptor);
+        auto commandBuffer = device->newCommandBuffer();
+        for (int i = 0; i < 3; ++i)
+        {
+            commandBuffer->beginRenderPass(renderPass);
+            commandBuffer->endRenderPass();
+        }
+        check(3 == commandBuffer->getInvalidationCount(), "the count accumulates over passes until it is reset");
+        commandBuffer->release();
+        renderPass->release();
+    }
+}
+
+UNIT_TEST(RenderPassInvalidation)
+{
+    testLoadAndStore();
+    testClear();
+    testDefaultFramebufferDontCare();
+    testDefaultFramebufferColorDontCare();
+    testDefaultFramebufferObject();
+    testOffscreen();
+    testCountAccumulates();
+}
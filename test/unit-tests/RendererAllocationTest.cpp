@@ -0,0 +1,261 @@
+//
+//  RendererAllocationTest.cpp
+//  unit-tests
+//
+//  Renders a sprite heavy scene with ForwardRenderer against fake-gl and counts the heap allocations of the
+//  frames: every frame the models get new input assemblers, as the batcher gives them, and the scene is
+//  drawn through BaseRenderer::render() and the transparent stage. Model, InputAssembler, Pass, Technique,
+//  Effect and View are placed in the slabs of their SlabAllocator and the renderer keeps its views, draw
+//  items and stage items across frames, so once the first frames filled the slabs, caches and vectors a
+//  frame must not allocate at all. The allocations are counted by AllocationCounter.cpp. Also checks
+//  that every model is drawn with the texture of its effect.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FakeGL.h"
+#include "UnitTest.h"
+#include "gfx/DeviceGraphics.h"
+#include "gfx/IndexBuffer.h"
+#include "gfx/Texture2D.h"
+#include "gfx/VertexBuffer.h"
+#include "renderer/Camera.h"
+#include "renderer/Config.h"
+#include "renderer/Effect.h"
+#include "renderer/ForwardRenderer.h"
+#include "renderer/INode.h"
+#include "renderer/InputAssembler.h"
+#include "renderer/Light.h"
+#include "renderer/Model.h"
+#include "renderer/Pass.h"
+#include "renderer/Scene.h"
+#include "renderer/Technique.h"
+#include "renderer/View.h"
+
+using namespace cocos2d;
+using namespace cocos2d::renderer;
+using unittest::check;
+
+namespace
+{
+    const int WIDTH = 960;
+    const int HEIGHT = 640;
+    // the sprites of one effect share its texture, as the sprites of an atlas do
+    const int EFFECTS = 8;
+    const int WARMUP_FRAMES = 3;
+    const int FRAMES = 100;
+
+    const char* VERTEX_SHADER =
+        "attribute vec2 a_position;\n"
+        "uniform mat4 model;\n"
+        "uniform mat4 viewProj;\n"
+        "void main() { gl_Position = viewProj * model * vec4(a_position, 0.0, 1.0); }\n";
+    const char* FRAGMENT_SHADER =
+        "uniform sampler2D texture;\n"
+        "void main() {\n"
+        "#ifdef USE_TEXTURE\n"
+        "  gl_FragColor = texture2D(texture, vec2(0.0));\n"
+        "#else\n"
+        "  gl_FragColor = vec4(1.0);\n"
+        "#endif\n"
+        "}\n";
+
+    const float QUAD_VERTICES[] = { 0, 0, 1, 0, 0, 1, 1, 1 };
+    const uint16_t QUAD_INDICES[] = { 0, 1, 2, 1, 3, 2 };
+
+    // A node standing still at `position`.
+    class TestNode : public INode
+    {
+    public:
+        explicit TestNode(const Vec3& position) : _position(position) { Mat4::createTranslation(position, &_world); }
+        virtual Mat4 getWorldMatrix() const override { return _world; }
+        virtual Mat4 getWorldRT() const override { return _world; }
+        virtual Vec3 getWorldPos() const override { return _position; }
+
+    private:
+        Vec3 _position;
+        Mat4 _world;
+    };
+
+    // The vertices and indices of a sprite, fetched by the transparent stage every frame.
+    struct Sprite
+    {
+        float vertices[8];
+        uint16_t indices[6];
+        VertexBuffer* vertexBuffer = nullptr;
+        IndexBuffer* indexBuffer = nullptr;
+        Model* model = nullptr;
+        TestNode* node = nullptr;
+    };
+
+    Texture2D* newTexture(DeviceGraphics* device, int seed)
+    {
+        std::vector<unsigned char> pixels(4 * 4 * 4, (unsigned char)seed);
+        Texture::Options options;
+        options.width = 4;
+        options.height = 4;
+        options.flipY = false;
+        options.images.resize(1);
+        options.images[0].copy(pixels.data(), pixels.size());
+        auto texture = new Texture2D();
+        texture->init(device, options);
+        return texture;
+    }
+
+    Effect* newEffect(Texture2D* texture)
+    {
+        std::vector<Technique::Parameter> parameters;
+        parameters.emplace_back("texture", Technique::Parameter::Type::TEXTURE_2D);
+        Vector<Pass*> passes;
+        auto pass = new Pass("sprite");
+        pass->setBlend();
+        passes.pushBack(pass);
+        pass->release();
+        auto technique = new Technique({ "transparent" }, parameters, passes, 0);
+
+        Vector<Technique*> techniques;
+        techniques.pushBack(technique);
+        technique->release();
+        std::unordered_map<std::string, Effect::Property> properties;
+        properties.emplace("texture", Effect::Property("texture", Technique::Parameter::Type::TEXTURE_2D, texture));
+        ValueMap useTexture;
+        useTexture["name"] = "USE_TEXTURE";
+        useTexture["value"] = true;
+        return new Effect(techniques, properties, { useTexture });
+    }
+
+    void initSprite(DeviceGraphics* device, Sprite& sprite, int index, Effect* effect)
+    {
+        for (int i = 0; i < 8; ++i)
+            sprite.vertices[i] = QUAD_VERTICES[i] * 32;
+        for (int i = 0; i < 6; ++i)
+            sprite.indices[i] = QUAD_INDICES[i];
+
+        VertexFormat format({ { ATTRIB_NAME_POSITION, AttribType::FLOAT32, 2 } });
+        sprite.vertexBuffer = new VertexBuffer();
+        sprite.vertexBuffer->init(device, format, Usage::DYNAMIC, sprite.vertices, sizeof(sprite.vertices), 4);
+        sprite.vertexBuffer->setFetchDataCallback([&sprite](size_t* bytes) {
+            *bytes = sizeof(sprite.vertices);
+            return (uint8_t*)sprite.vertices;
+        });
+        sprite.indexBuffer = new IndexBuffer();
+        sprite.indexBuffer->init(device, IndexFormat::UINT16, Usage::DYNAMIC, sprite.indices, sizeof(sprite.indices), 6);
+        sprite.indexBuffer->setFetchDataCallback([&sprite](size_t* bytes) {
+            *bytes = sizeof(sprite.indices);
+            return (uint8_t*)sprite.indices;
+        });
+
+        sprite.node = new TestNode(Vec3((float)(index % 30) * 32 - WIDTH / 2, (float)(index / 30 % 20) * 32 - HEIGHT / 2, 0));
+        sprite.model = new Model();
+        sprite.model->setNode(sprite.node);
+        sprite.model->addEffect(effect);
+    }
+
+    // Gives every model a new input assembler, then renders the scene.
+    void renderFrame(ForwardRenderer* renderer, Scene* scene, std::vector<Sprite>& sprites)
+    {
+        fakegl::getState().draws.clear();
+        for (auto& sprite : sprites)
+        {
+            auto ia = new InputAssembler();
+            ia->init(sprite.vertexBuffer, sprite.indexBuffer);
+            sprite.model->clearInputAssemblers();
+            sprite.model->addInputAssembler(ia);
+            ia->release();
+        }
+        renderer->render(scene);
+    }
+}
+
+UNIT_TEST(RendererAllocation)
+{
+    const int count = 1024;
+
+    auto device = DeviceGraphics::getInstance();
+    Config::addStage("transparent");
+
+    std::vector<ProgramLib::Template> templates(1);
+    templates[0].name = "sprite";
+    templates[0].vert = VERTEX_SHADER;
+    templates[0].frag = FRAGMENT_SHADER;
+    ValueMap useTexture;
+    useTexture["name"] = "USE_TEXTURE";
+    templates[0].defines.push_back(Value(useTexture));
+
+    auto renderer = new ForwardRenderer();
+    renderer->init(device, templates, WIDTH, HEIGHT);
+
+    auto scene = new Scene();
+    TestNode cameraNode(Vec3(0, 0, 600));
+    auto camera = new Camera();
+    camera->setNode(&cameraNode);
+    camera->setStages({ "transparent" });
+    camera->setClearFlags(ClearFlag::COLOR);
+    scene->addCamera(camera);
+
+    std::vector<Texture2D*> textures;
+    std::vector<Effect*> effects;
+    for (int i = 0; i < EFFECTS; ++i)
+    {
+        textures.push_back(newTexture(device, i + 1));
+        effects.push_back(newEffect(textures.back()));
+    }
+    std::vector<Sprite> sprites(count);
+    for (int i = 0; i < count; ++i)
+    {
+        initSprite(device, sprites[i], i, effects[i * EFFECTS / count]);
+        scene->addModel(sprites[i].model);
+    }
+    // fake-gl records the draws of a frame, it shouldn't be counted
+    fakegl::getState().draws.reserve(count);
+
+    // The first frames fill the slabs, the program cache and the vectors of the renderer.
+    size_t before = unittest::getAllocationCount();
+    for (int i = 0; i < WARMUP_FRAMES; ++i)
+        renderFrame(renderer, scene, sprites);
+    size_t warmup = unittest::getAllocationCount() - before;
+
+    const auto& draws = fakegl::getState().draws;
+    check(count == (int)draws.size(), "every model is drawn");
+    bool textured = true;
+    for (int i = 0; i < (int)draws.size() && i < count; ++i)
+        textured = textured && textures[i * EFFECTS / count]->getHandle() == draws[i].textures[1] && 6 == draws[i].count;
+    check(textured, "every model is drawn with the texture of its effect");
+    check(0 != draws.size() && draws.front().program == draws.back().program, "the models share the program of their pass");
+
+    before = unittest::getAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FRAMES; ++i)
+        renderFrame(renderer, scene, sprites);
+    auto end = std::chrono::steady_clock::now();
+    size_t steady = unittest::getAllocationCount() - before;
+    double ms = std::chrono::duration<double, std::milli>(end - start).count() / FRAMES;
+    check(count == (int)draws.size(), "every model is drawn in steady state frames");
+
+    printf("%d models per frame, %d slabs\n", count,
+            (int)(SlabAllocator<Model>::getSlabCount() + SlabAllocator<InputAssembler>::getSlabCount()
+                  + SlabAllocator<Pass>::getSlabCount() + SlabAllocator<Technique>::getSlabCount()
+                  + SlabAllocator<Effect>::getSlabCount() + SlabAllocator<View>::getSlabCount()));
+    printf("first %d frames %8zu allocations\n", WARMUP_FRAMES, warmup);
+    printf("steady frames  %8.2f allocations per frame, %.3f ms per frame\n", (double)steady / FRAMES, ms);
+    check(0 == steady, "steady state frames don't allocate");
+
+    scene->reset();
+    renderer->release();
+    for (auto& sprite : sprites)
+    {
+        sprite.model->release();
+        sprite.vertexBuffer->release();
+        sprite.indexBuffer->release();
+        delete sprite.node;
+    }
+    delete scene;
+    camera->release();
+    for (auto effect : effects)
+        effect->release();
+    for (auto texture : textures)
+        texture->release();
+}
@@ -0,0 +1,105 @@
+//
+//  SamplerTest.cpp
+//  unit-tests
+//
+//  Draws with sampler objects against fake-gl, which reuses the names of deleted samplers as drivers do,
+//  and checks that a sampler created after another one was purged from the device cache is bound even
+//  if it got the purged sampler's name.
+//
+
+#include "FakeGL.h"
+#include "UnitTest.h"
+#include "backend/Device.h"
+#include "backend/BindGroup.h"
+#include "backend/Buffer.h"
+#include "backend/CommandBuffer.h"
+#include "backend/RenderPass.h"
+#include "backend/RenderPipeline.h"
+#include "backend/ShaderModule.h"
+#include "backend/opengl/SamplerGL.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const char* VERTEX_SHADER =
+        "attribute vec2 a_position;\n"
+        "void main() { gl_Position = vec4(a_position, 0.0, 1.0); }\n";
+    const char* FRAGMENT_SHADER =
+        "uniform sampler2D texture;\n"
+        "void main() { gl_FragColor = texture2D(texture, vec2(0.0)); }\n";
+
+    // Draws `texture` sampled with `sampler`, and returns the sampler object fake-gl saw on unit 0.
+    GLuint draw(backend::CommandBuffer* commandBuffer, backend::RenderPipeline* renderPipeline,
+                backend::Buffer* vertices, backend::Texture* texture, backend::Sampler* sampler)
+    {
+        auto bindGroup = new backend::BindGroup();
+        bindGroup->setTexture("texture", 0, texture);
+        bindGroup->setSampler("texture", sampler);
+        commandBuffer->setRenderPipeline(renderPipeline);
+        commandBuffer->setBindGroup(bindGroup);
+        commandBuffer->setVertexBuffer(0, vertices);
+        commandBuffer->drawArrays(backend::PrimitiveType::TRIANGLE, 0, 3);
+        bindGroup->release();
+        return fakegl::getState().draws.back().samplers[0];
+    }
+
+    // A sampler that isn't the default sampler of textures, which stays in the device cache.
+    backend::Sampler* newSampler(backend::SamplerAddressMode addressMode)
+    {
+        backend::SamplerDescriptor descriptor;
+        descriptor.sAddressMode = addressMode;
+        descriptor.tAddressMode = addressMode;
+        return backend::Device::getInstance()->newSampler(descriptor);
+    }
+}
+
+UNIT_TEST(Sampler)
+{
+#if CC_GL_SAMPLER_OBJECT_SUPPORTED
+    auto device = backend::Device::getInstance();
+
+    backend::RenderPipelineDescriptor renderPipelineDescriptor;
+    renderPipelineDescriptor.setVertexShaderModule(device->createShaderModule(backend::ShaderStage::VERTEX, VERTEX_SHADER));
+    renderPipelineDescriptor.setFragmentShaderModule(device->createShaderModule(backend::ShaderStage::FRAGMENT, FRAGMENT_SHADER));
+    backend::VertexLayout vertexLayout;
+    vertexLayout.setAtrribute("a_position", 0, backend::VertexFormat::FLOAT_R32G32, 0);
+    vertexLayout.setLayout(2 * sizeof(float), backend::VertexStepMode::VERTEX);
+    renderPipelineDescriptor.setVertexLayout(0, vertexLayout);
+    auto renderPipeline = device->newRenderPipeline(renderPipelineDescriptor);
+    auto vertices = device->newBuffer(3 * 2 * sizeof(float), backend::BufferType::VERTEX, backend::BufferUsage::READ);
+
+    backend::TextureDescriptor textureDescriptor;
+    textureDescriptor.width = 4;
+    textureDescriptor.height = 4;
+    textureDescriptor.textureType = backend::TextureType::TEXTURE_2D;
+    textureDescriptor.textureFormat = backend::TextureFormat::R8G8B8A8;
+    auto texture = device->newTexture(textureDescriptor);
+
+    backend::RenderPassDescriptor renderPassDescriptor;
+    auto renderPass = device->newRenderPass(renderPassDescriptor);
+    auto commandBuffer = device->newCommandBuffer();
+    commandBuffer->beginRenderPass(renderPass);
+
+    auto repeated = newSampler(backend::SamplerAddressMode::MIRROR_REPEAT);
+    GLuint repeatedName = static_cast<backend::SamplerGL*>(repeated)->getHandler();
+    check(repeatedName == draw(commandBuffer, renderPipeline, vertices, texture, repeated), "the sampler of the draw is bound");
+
+    // Purging deletes the sampler, the next one gets its name and must still be bound.
+    repeated->release();
+    device->purgeCachedObjects();
+    auto clamped = newSampler(backend::SamplerAddressMode::CLAMP_TO_EDGE);
+    GLuint clampedName = static_cast<backend::SamplerGL*>(clamped)->getHandler();
+    check(repeatedName == clampedName, "fake-gl reuses the name of the purged sampler");
+    check(clampedName == draw(commandBuffer, renderPipeline, vertices, texture, clamped), "a sampler reusing the name of a purged sampler is bound");
+
+    commandBuffer->endRenderPass();
+    commandBuffer->release();
+    renderPass->release();
+    clamped->release();
+    texture->release();
+    vertices->release();
+    renderPipeline->release();
+#endif
+}
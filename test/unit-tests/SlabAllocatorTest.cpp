@@ -0,0 +1,77 @@
+//
+//  SlabAllocatorTest.cpp
+//  unit-tests
+//
+//  Checks that SlabAllocator puts objects of its class in the slabs and objects of derived classes on the
+//  heap, also when a nothrow new frees the memory of an object whose constructor threw, where operator
+//  delete doesn't get the size of the object.
+//
+
+#include <new>
+#include <stdexcept>
+
+#include "UnitTest.h"
+#include "renderer/SlabAllocator.h"
+
+using namespace cocos2d::renderer;
+using unittest::check;
+
+namespace
+{
+    class Slabbed
+    {
+        RENDERER_DECLARE_SLAB_ALLOCATOR()
+
+        explicit Slabbed(bool fail)
+        {
+            if (fail)
+                throw std::runtime_error("Slabbed");
+        }
+        virtual ~Slabbed() {}
+
+    private:
+        int _value = 0;
+    };
+
+    // Too large for the slabs of Slabbed.
+    class LargerSlabbed : public Slabbed
+    {
+    public:
+        explicit LargerSlabbed(bool fail) : Slabbed(fail) {}
+
+    private:
+        char _data[64] = {};
+    };
+
+    // Creates a `T` with a nothrow new whose constructor throws, returns whether it threw.
+    template <typename T>
+    bool newThrowing()
+    {
+        try
+        {
+            new (std::nothrow) T(true);
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+RENDERER_DEFINE_SLAB_ALLOCATOR(Slabbed)
+
+UNIT_TEST(SlabAllocator)
+{
+    Slabbed* slabbed = new Slabbed(false);
+    Slabbed* larger = new LargerSlabbed(false);
+    check(1 == SlabAllocator<Slabbed>::getLiveCount(), "objects of the class are in the slabs, derived ones aren't");
+    delete larger;
+    delete slabbed;
+    check(0 == SlabAllocator<Slabbed>::getLiveCount(), "deleted objects leave the slabs");
+
+    check(newThrowing<Slabbed>(), "the constructor of a slab object throws");
+    check(0 == SlabAllocator<Slabbed>::getLiveCount(), "a slab object whose constructor threw leaves the slab");
+    check(newThrowing<LargerSlabbed>(), "the constructor of a derived object throws");
+    check(0 == SlabAllocator<Slabbed>::getLiveCount(), "a derived object whose constructor threw doesn't go to the slab");
+}
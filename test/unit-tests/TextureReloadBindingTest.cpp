@@ -0,0 +1,160 @@
+//
+//  TextureReloadBindingTest.cpp
+//  unit-tests
+//
+//  Draws with DeviceGraphics against fake-gl while textures are evicted by the texture budget, and checks
+//  that every draw is issued with the textures it set on every unit. Reloading an evicted texture binds it
+//  on unit 0 and restores the texture of the previous draw there, which must not undo the binding of the
+//  draw being committed.
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "UnitTest.h"
+#include "FakeGL.h"
+#include "platform/CCImage.h"
+#include "gfx/DeviceGraphics.h"
+#include "gfx/Program.h"
+#include "gfx/Texture2D.h"
+#include "gfx/VertexBuffer.h"
+
+using namespace cocos2d;
+using namespace cocos2d::renderer;
+using unittest::check;
+
+namespace
+{
+    const int SIZE = 64;
+
+    const char* VERTEX_SHADER =
+        "attribute vec2 a_position;\n"
+        "void main() { gl_Position = vec4(a_position, 0.0, 1.0); }\n";
+    const char* FRAGMENT_SHADER =
+        "uniform sampler2D texture0;\n"
+        "uniform sampler2D texture1;\n"
+        "uniform sampler2D texture2;\n"
+        "void main() { gl_FragColor = texture2D(texture0, vec2(0.0)) + texture2D(texture1, vec2(0.0)) + texture2D(texture2, vec2(0.0)); }\n";
+
+    std::vector<unsigned char> makePixels(int seed)
+    {
+        std::vector<unsigned char> pixels(SIZE * SIZE * 4);
+        for (size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = (unsigned char)(i * 13 + seed);
+        return pixels;
+    }
+
+    // A texture with the pixels of `path`, which it is reloaded from once evicted if `reloadable`.
+    Texture2D* newTexture(DeviceGraphics* device, const std::string& path, int seed, bool reloadable)
+    {
+        auto pixels = makePixels(seed);
+        auto image = new Image();
+        image->initWithRawData(pixels.data(), pixels.size(), SIZE, SIZE, 8);
+        image->saveToFile(path, false);
+        image->release();
+
+        Texture::Options options;
+        options.width = SIZE;
+        options.height = SIZE;
+        options.flipY = false;
+        options.images.resize(1);
+        options.images[0].copy(pixels.data(), pixels.size());
+        auto texture = Texture2D::create(device, options);
+        texture->retain();
+        if (reloadable)
+            texture->setSourcePath(path);
+        return texture;
+    }
+
+    // Draws with `textures` on units 0, 1, 2 and returns the bindings fake-gl saw.
+    fakegl::Draw draw(DeviceGraphics* device, Program* program, VertexBuffer* vertices, Texture2D* const (&textures)[3])
+    {
+        device->setProgram(program);
+        device->setVertexBuffer(0, vertices);
+        device->setTexture("texture0", textures[0], 0);
+        device->setTexture("texture1", textures[1], 1);
+        device->setTexture("texture2", textures[2], 2);
+        device->draw(0, 3);
+        return fakegl::getState().draws.back();
+    }
+
+    bool hasBindings(const fakegl::Draw& draw, Texture2D* const (&textures)[3])
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            if (0 == textures[i]->getHandle() || draw.textures[i] != textures[i]->getHandle())
+                return false;
+        }
+        return true;
+    }
+
+    // Starts frames until every texture with a source path is evicted.
+    void evictAll(DeviceGraphics* device)
+    {
+        auto& residency = device->getTextureResidency();
+        for (uint32_t i = 0; i <= residency.getEvictAfterFrames(); ++i)
+            residency.beginFrame();
+    }
+}
+
+UNIT_TEST(TextureReloadBinding)
+{
+    std::string directory = "/tmp/texture-reload-binding";
+    mkdir(directory.c_str(), 0755);
+
+    auto device = DeviceGraphics::getInstance();
+    auto& residency = device->getTextureResidency();
+    auto budget = residency.getBudget();
+    auto evictAfterFrames = residency.getEvictAfterFrames();
+    residency.setBudget(1);
+    residency.setEvictAfterFrames(1);
+
+    auto program = Program::create(device, VERTEX_SHADER, FRAGMENT_SHADER);
+    program->retain();
+    program->link();
+
+    VertexFormat format({ { ATTRIB_NAME_POSITION, AttribType::FLOAT32, 2 } });
+    const float positions[] = { 0, 0, 1, 0, 0, 1 };
+    auto vertices = new VertexBuffer();
+    vertices->init(device, format, Usage::STATIC, positions, sizeof(positions), 3);
+
+    auto first = newTexture(device, directory + "/first.png", 1, true);
+    auto second = newTexture(device, directory + "/second.png", 2, true);
+    auto third = newTexture(device, directory + "/third.png", 3, true);
+    auto pinned = newTexture(device, directory + "/pinned.png", 4, false);
+
+    Texture2D* const firstDraw[3] = { first, second, third };
+    check(hasBindings(draw(device, program, vertices, firstDraw), firstDraw), "the textures of the first draw are bound");
+
+    // The unit 0 texture of the last draw is evicted along with the others, a reload on unit 1 or 2 restores
+    // it on unit 0 after the pinned texture was bound there.
+    evictAll(device);
+    check(!first->isResident() && !second->isResident() && !third->isResident(), "textures with a source path are evicted");
+    Texture2D* const reloadDraw[3] = { pinned, second, third };
+    check(hasBindings(draw(device, program, vertices, reloadDraw), reloadDraw), "reloads on units 1 and 2 keep the texture of unit 0");
+    check(second->isResident() && third->isResident(), "evicted textures are reloaded when they are drawn");
+
+    // Units that keep their texture are rebound when it was reloaded with a new handle.
+    evictAll(device);
+    Texture2D* const sameDraw[3] = { pinned, second, third };
+    check(hasBindings(draw(device, program, vertices, sameDraw), sameDraw), "reloaded textures are rebound on units that kept them");
+
+    // A reload on unit 0 itself.
+    evictAll(device);
+    Texture2D* const unitZeroDraw[3] = { first, pinned, third };
+    check(hasBindings(draw(device, program, vertices, unitZeroDraw), unitZeroDraw), "a reload on unit 0 binds every unit");
+
+    first->release();
+    second->release();
+    third->release();
+    pinned->release();
+    vertices->release();
+    program->release();
+    residency.setBudget(budget);
+    residency.setEvictAfterFrames(evictAfterFrames);
+    for (auto name : { "first", "second", "third", "pinned" })
+        unlink((directory + "/" + name + ".png").c_str());
+}
@@ -0,0 +1,175 @@
+//
+//  TextureResidencyTest.cpp
+//  unit-tests
+//
+//  Exercises the texture residency manager with fake textures whose "GPU memory" is counted by a fake
+//  allocator: byte accounting, LRU eviction under a budget, reloading evicted textures and the stats.
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "UnitTest.h"
+#include "gfx/TextureResidency.h"
+
+using cocos2d::renderer::TextureResidency;
+using unittest::check;
+
+namespace
+{
+    // Stands in for the GPU, counts the bytes of the living allocations.
+    struct FakeAllocator
+    {
+        uint64_t allocated = 0;
+        uint32_t allocations = 0;
+    };
+    
+    class FakeTexture : public TextureResidency::Storage
+    {
+    public:
+        FakeTexture(FakeAllocator& allocator, TextureResidency& residency, uint64_t bytes, const std::string& path)
+        : _allocator(allocator)
+        , _bytes(bytes)
+        {
+            allocate();
+            residency.add(this, bytes);
+            residency.setSourcePath(this, path);
+        }
+        
+        virtual ~FakeTexture()
+        {
+            if (_allocated)
+                _allocator.allocated -= _bytes;
+        }
+        
+        virtual void evictStorage() override
+        {
+            _allocator.allocated -= _bytes;
+            _allocated = false;
+        }
+        
+        virtual bool reloadStorage(const std::string& sourcePath) override
+        {
+            if (sourcePath == "missing.png")
+                return false;
+            allocate();
+            return true;
+        }
+        
+        bool isAllocated() const { return _allocated; }
+        
+    private:
+        void allocate()
+        {
+            _allocator.allocated += _bytes;
+            ++_allocator.allocations;
+            _allocated = true;
+        }
+        
+        FakeAllocator& _allocator;
+        uint64_t _bytes;
+        bool _allocated = false;
+    };
+    
+    void testComputeBytes()
+    {
+        check(TextureResidency::computeLevels(256, 64) == 9, "levels of 256x64");
+        check(TextureResidency::computeLevels(1, 1) == 1, "levels of 1x1");
+        check(TextureResidency::computeBytes(32, 1, 1, 256, 256, 1, 1) == 256 * 256 * 4, "RGBA8 without mipmaps");
+        // 4/3 of the base level, plus the rounding of the small levels.
+        check(TextureResidency::computeBytes(32, 1, 1, 256, 256, 9, 1) == 349524, "RGBA8 with mipmaps");
+        check(TextureResidency::computeBytes(32, 1, 1, 64, 64, 1, 6) == 64 * 64 * 4 * 6, "RGBA8 cube");
+        // ETC1 levels are 4x4 blocks of 8 bytes at least.
+        check(TextureResidency::computeBytes(4, 4, 4, 16, 16, 5, 1) == 128 + 32 + 8 + 8 + 8, "ETC1 with mipmaps");
+        check(TextureResidency::computeBytes(2, 16, 8, 8, 8, 1, 1) == 32, "PVRTC 2bpp minimum size");
+    }
+    
+    void testEviction()
+    {
+        FakeAllocator allocator;
+        TextureResidency residency;
+        residency.setEvictAfterFrames(3);
+        
+        const uint64_t MB = 1024 * 1024;
+        std::vector<std::unique_ptr<FakeTexture>> textures;
+        for (int i = 0; i < 8; ++i)
+            textures.emplace_back(new FakeTexture(allocator, residency, MB, "texture" + std::to_string(i) + ".png"));
+        std::unique_ptr<FakeTexture> renderTarget(new FakeTexture(allocator, residency, 2 * MB, ""));
+        
+        auto stats = residency.getStats();
+        check(stats.residentBytes == 10 * MB && allocator.allocated == 10 * MB, "resident bytes match the allocator");
+        check(stats.residentCount == 9, "resident count");
+        
+        // Nothing is evicted without a budget.
+        for (int frame = 0; frame < 10; ++frame)
+            residency.beginFrame();
+        check(residency.getStats().evictions == 0, "no evictions without a budget");
+        
+        // Textures 0-3 and the render target stay in use, 4-7 are idle.
+        for (int frame = 0; frame < 3; ++frame)
+        {
+            if (1 == frame)
+                residency.setBudget(7 * MB);
+            residency.beginFrame();
+            for (int i = 0; i < 4; ++i)
+                residency.use(textures[i].get());
+            residency.use(renderTarget.get());
+        }
+        stats = residency.getStats();
+        check(stats.evictions == 3, "only the textures over the budget are evicted");
+        check(stats.residentBytes == 7 * MB && allocator.allocated == 7 * MB, "resident bytes after eviction");
+        check(stats.evictedBytes == 3 * MB && stats.evictedCount == 3, "evicted bytes");
+        for (int i = 0; i < 4; ++i)
+            check(textures[i]->isResident() && textures[i]->isAllocated(), "used textures stay resident");
+        check(renderTarget->isResident(), "textures without a source path are never evicted");
+        
+        // Using an evicted texture reloads it.
+        FakeTexture* evicted = nullptr;
+        for (int i = 4; i < 8; ++i)
+            if (!textures[i]->isResident())
+                evicted = textures[i].get();
+        check(evicted != nullptr, "an idle texture was evicted");
+        if (evicted)
+        {
+            check(residency.use(evicted), "evicted texture reloads");
+            check(evicted->isResident() && evicted->isAllocated(), "reloaded texture is resident");
+            check(residency.getStats().reloads == 1, "reload counted");
+        }
+        
+        // Recently used textures aren't evicted even if the budget is exceeded.
+        residency.setBudget(1 * MB);
+        residency.beginFrame();
+        check(residency.getStats().residentBytes > 1 * MB, "recently used textures are kept over the budget");
+        for (int frame = 0; frame < 4; ++frame)
+        {
+            residency.beginFrame();
+            residency.use(renderTarget.get());
+        }
+        stats = residency.getStats();
+        check(stats.residentBytes == 2 * MB && stats.residentCount == 1, "everything idle with a source path is evicted");
+        check(allocator.allocated == 2 * MB, "allocator matches after evicting everything");
+        
+        // A texture whose source is gone fails to reload and stays evicted.
+        std::unique_ptr<FakeTexture> broken(new FakeTexture(allocator, residency, MB, "missing.png"));
+        for (int frame = 0; frame < 4; ++frame)
+            residency.beginFrame();
+        check(!broken->isResident(), "broken texture evicted");
+        check(!residency.use(broken.get()), "broken texture fails to reload");
+        check(residency.getStats().failedReloads == 1, "failed reload counted");
+        
+        // Destroyed textures are unregistered, resident or not.
+        textures.clear();
+        broken.reset();
+        stats = residency.getStats();
+        check(stats.residentCount == 1 && stats.evictedCount == 0, "destroyed textures are unregistered");
+        check(stats.residentBytes == 2 * MB && stats.evictedBytes == 0, "bytes of destroyed textures are released");
+        check(stats.peakResidentBytes >= 10 * MB, "peak bytes");
+    }
+}
+
+UNIT_TEST(TextureResidency)
+{
+    testComputeBytes();
+    testEviction();
+}
@@ -0,0 +1,308 @@
+//
+//  TextureUploadQueueTest.cpp
+//  unit-tests
+//
+//  Drives the texture upload queue with fake textures that record the rows they receive: slicing an upload
+//  over several frames, the byte budget shared by the requests of a frame, the pending byte count,
+//  cancelling a texture in the middle of its upload, mipmap generation in the frame after the last slice,
+//  and formats without fixed bytes per pixel, which are uploaded immediately.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "UnitTest.h"
+#include "backend/Texture.h"
+#include "backend/TextureUploadQueue.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    // A texture whose level 0 lives in memory and which records every slice it is given.
+    class FakeTexture : public backend::Texture
+    {
+    public:
+        struct Slice
+        {
+            uint32_t yoffset;
+            uint32_t height;
+        };
+
+        // Pixels are 4 bytes, whatever the format.
+        static FakeTexture* create(uint32_t width, uint32_t height, bool mipmapEnabled,
+                                   backend::TextureFormat format = backend::TextureFormat::R8G8B8A8)
+        {
+            backend::TextureDescriptor descriptor;
+            descriptor.width = width;
+            descriptor.height = height;
+            descriptor.textureFormat = format;
+            descriptor.samplerDescriptor.mipmapEnabled = mipmapEnabled;
+            return new FakeTexture(descriptor);
+        }
+
+        virtual void updateData(uint8_t* data) override
+        {
+            updateSubData(0, 0, _width, _height, data);
+        }
+
+        virtual void updateSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) override
+        {
+            uploadSubData(xoffset, yoffset, width, height, data);
+            generateMipmaps();
+        }
+
+        virtual void uploadSubData(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height, uint8_t* data) override
+        {
+            for (uint32_t row = 0; row < height; ++row)
+                memcpy(&pixels[((yoffset + row) * _width + xoffset) * 4], data + row * width * 4, width * 4);
+            slices.push_back({yoffset, height});
+        }
+
+        virtual void generateMipmaps() override
+        {
+            if (_isMipmapEnabled)
+                ++mipmapGenerations;
+        }
+
+        std::vector<uint8_t> pixels;
+        std::vector<Slice> slices;
+        uint32_t mipmapGenerations = 0;
+
+    private:
+        FakeTexture(const backend::TextureDescriptor& descriptor)
+        : backend::Texture(descriptor)
+        , pixels(descriptor.width * descriptor.height * 4, 0)
+        {}
+    };
+
+    std::vector<uint8_t> makePixels(uint32_t width, uint32_t height, uint8_t seed)
+    {
+        std::vector<uint8_t> pixels(width * height * 4);
+        for (size_t i = 0; i < pixels.size(); ++i)
+            pixels[i] = (uint8_t)(i * 7 + seed);
+        return pixels;
+    }
+
+    // Rows have to arrive in order, without gaps or overlaps.
+    bool areSlicesContiguous(const FakeTexture* texture)
+    {
+        uint32_t next = 0;
+        for (const auto& slice : texture->slices)
+        {
+            if (slice.yoffset != next || 0 == slice.height)
+                return false;
+            next += slice.height;
+        }
+        return next == texture->getHeight();
+    }
+
+    backend::TextureUploadQueue* newQueue(uint32_t bytesPerFrame)
+    {
+        auto queue = new backend::TextureUploadQueue();
+        queue->setBytesPerFrame(bytesPerFrame);
+        // Only the byte budget is tested, a frame never runs out of time.
+        queue->setMicrosecondsPerFrame(60 * 1000 * 1000);
+        return queue;
+    }
+
+    void testSlicedUpload()
+    {
+        // 256 bytes per row and 16 rows per frame.
+        auto queue = newQueue(4096);
+        auto texture = FakeTexture::create(64, 64, false);
+        auto pixels = makePixels(64, 64, 1);
+        queue->uploadData(texture, pixels.data());
+        check(pixels.size() == queue->getPendingBytes(), "sliced: the whole texture is pending");
+        check(2 == texture->getReferenceCount(), "sliced: the queue holds a reference while uploading");
+
+        int frames = 0;
+        while (queue->isPending(texture) && frames < 100)
+        {
+            queue->process();
+            ++frames;
+            if (1 == frames)
+            {
+                check(1 == texture->slices.size() && 16 == texture->slices[0].height, "sliced: the first frame uploads the rows that fit the budget");
+                check(pixels.size() - 4096 == queue->getPendingBytes(), "sliced: the uploaded rows are no longer pending");
+            }
+        }
+        check(4 == frames, "sliced: the rest is uploaded in the following frames");
+        check(areSlicesContiguous(texture), "sliced: rows are uploaded in order, without gaps");
+        check(pixels == texture->pixels, "sliced: the texture receives the queued data");
+        check(0 == queue->getPendingBytes(), "sliced: nothing is pending after the last slice");
+        check(1 == texture->getReferenceCount(), "sliced: the queue releases the texture after the last slice");
+
+        delete queue;
+        texture->release();
+    }
+
+    void testBudgetSharedByRequests()
+    {
+        auto queue = newQueue(4096);
+        // 10 rows of 256 bytes, then 16 rows of 256 bytes.
+        auto first = FakeTexture::create(64, 10, false);
+        auto second = FakeTexture::create(64, 16, false);
+        auto firstPixels = makePixels(64, 10, 2);
+        auto secondPixels = makePixels(64, 16, 3);
+        queue->uploadData(first, firstPixels.data());
+        queue->uploadData(second, secondPixels.data());
+
+        queue->process();
+        check(!queue->isPending(first), "shared budget: the first texture finishes in one frame");
+        check(1 == second->slices.size() && 6 == second->slices[0].height, "shared budget: what is left of the budget goes to the next request");
+        check((16 - 6) * 256 == queue->getPendingBytes(), "shared budget: pending bytes count the rows left");
+
+        queue->process();
+        check(!queue->isPending(second), "shared budget: the second texture continues where it stopped");
+        check(areSlicesContiguous(second) && secondPixels == second->pixels, "shared budget: the second texture receives all rows");
+        check(firstPixels == first->pixels, "shared budget: the first texture receives all rows");
+
+        delete queue;
+        first->release();
+        second->release();
+    }
+
+    void testRowLargerThanBudget()
+    {
+        // A row of 1024 bytes never fits, one row is uploaded every frame anyway.
+        auto queue = newQueue(100);
+        auto texture = FakeTexture::create(256, 3, false);
+        auto pixels = makePixels(256, 3, 4);
+        queue->uploadData(texture, pixels.data());
+
+        queue->process();
+        check(1 == texture->slices.size() && 1 == texture->slices[0].height, "small budget: one row is uploaded per frame");
+        queue->process();
+        queue->process();
+        check(!queue->isPending(texture) && pixels == texture->pixels, "small budget: the texture is complete after a frame per row");
+
+        delete queue;
+        texture->release();
+    }
+
+    void testCancelMidUpload()
+    {
+        auto queue = newQueue(4096);
+        auto cancelled = FakeTexture::create(64, 64, true);
+        auto other = FakeTexture::create(64, 8, false);
+        auto pixels = makePixels(64, 64, 5);
+        auto otherPixels = makePixels(64, 8, 6);
+        queue->uploadData(cancelled, pixels.data());
+        queue->uploadData(other, otherPixels.data());
+
+        queue->process();
+        check(1 == cancelled->slices.size(), "cancel: the texture is partially uploaded");
+
+        queue->cancel(cancelled);
+        check(!queue->isPending(cancelled), "cancel: the texture is no longer pending");
+        check(otherPixels.size() == queue->getPendingBytes(), "cancel: only the bytes of other requests are pending");
+        check(1 == cancelled->getReferenceCount(), "cancel: the queue releases the texture");
+
+        queue->process();
+        check(1 == cancelled->slices.size(), "cancel: no more rows are uploaded");
+        check(0 == cancelled->mipmapGenerations, "cancel: mipmaps are not generated");
+        check(!queue->isPending(other) && otherPixels == other->pixels, "cancel: other requests continue");
+        check(0 == queue->getPendingBytes(), "cancel: nothing is pending at the end");
+
+        delete queue;
+        cancelled->release();
+        other->release();
+    }
+
+    void testMipmapsAfterLastSlice()
+    {
+        auto queue = newQueue(4096);
+        auto texture = FakeTexture::create(64, 16, true);
+        auto pixels = makePixels(64, 16, 7);
+        queue->uploadData(texture, pixels.data());
+
+        queue->process();
+        check(1 == texture->slices.size() && 0 == texture->mipmapGenerations, "mipmaps: not generated in the frame of the last slice");
+        check(queue->isPending(texture), "mipmaps: the texture is pending until its mipmaps are generated");
+
+        queue->process();
+        check(1 == texture->mipmapGenerations, "mipmaps: generated in the next frame");
+        check(!queue->isPending(texture) && 1 == texture->getReferenceCount(), "mipmaps: the queue releases the texture");
+
+        // A pending mipmap generation is dropped when the texture is cancelled.
+        queue->uploadData(texture, pixels.data());
+        queue->process();
+        queue->cancel(texture);
+        queue->process();
+        check(1 == texture->mipmapGenerations && 1 == texture->getReferenceCount(), "mipmaps: cancel drops the pending generation");
+
+        delete queue;
+        texture->release();
+    }
+
+    void testFlush()
+    {
+        auto queue = newQueue(256);
+        auto texture = FakeTexture::create(64, 32, true);
+        auto pixels = makePixels(64, 32, 8);
+        auto data = (uint8_t*)malloc(pixels.size());
+        memcpy(data, pixels.data(), pixels.size());
+        queue->uploadData(texture, data, true);
+
+        queue->process();
+        queue->flush();
+        check(!queue->isPending(texture) && 0 == queue->getPendingBytes(), "flush: everything is uploaded");
+        check(areSlicesContiguous(texture) && pixels == texture->pixels, "flush: the rest of a partial upload is uploaded");
+        check(1 == texture->mipmapGenerations, "flush: mipmaps are generated");
+
+        delete queue;
+        texture->release();
+    }
+
+    void testFormatWithoutBytesPerElement()
+    {
+        auto queue = newQueue(256);
+        auto texture = FakeTexture::create(64, 32, true, backend::TextureFormat::D24S8);
+        auto pixels = makePixels(64, 32, 10);
+        auto data = (uint8_t*)malloc(pixels.size());
+        memcpy(data, pixels.data(), pixels.size());
+        queue->uploadData(texture, data, true);
+        check(!queue->isPending(texture) && 0 == queue->getPendingBytes(), "D24S8: nothing is queued");
+        check(1 == texture->slices.size() && pixels == texture->pixels, "D24S8: the data is uploaded at once");
+        check(1 == texture->mipmapGenerations, "D24S8: mipmaps are generated with the upload");
+        check(1 == texture->getReferenceCount(), "D24S8: the queue doesn't keep the texture");
+
+        queue->process();
+        check(1 == texture->slices.size(), "D24S8: process() has nothing to upload");
+
+        // Owned data of an empty upload is freed too, which the address sanitizer would report otherwise.
+        queue->uploadSubData(texture, 0, 0, 0, 0, (uint8_t*)malloc(16), true);
+        check(!queue->isPending(texture), "empty upload: nothing is queued");
+
+        delete queue;
+        texture->release();
+    }
+
+    void testDestroyWhilePending()
+    {
+        auto queue = newQueue(256);
+        auto texture = FakeTexture::create(64, 32, false);
+        auto pixels = makePixels(64, 32, 9);
+        queue->uploadData(texture, pixels.data());
+        queue->process();
+        delete queue;
+        check(1 == texture->getReferenceCount(), "destroy: the queue releases pending textures");
+        texture->release();
+    }
+}
+
+UNIT_TEST(TextureUploadQueue)
+{
+    testSlicedUpload();
+    testBudgetSharedByRequests();
+    testRowLargerThanBudget();
+    testCancelMidUpload();
+    testMipmapsAfterLastSlice();
+    testFlush();
+    testFormatWithoutBytesPerElement();
+    testDestroyWhilePending();
+}
@@ -0,0 +1,93 @@
+//
+//  UnitTest.cpp
+//  unit-tests
+//
+
+#include "UnitTest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct Test
+    {
+        const char* name;
+        unittest::TestFunction function;
+    };
+
+    // Registrars are static objects of other files, the list is created on first use.
+    std::vector<Test>& getTests()
+    {
+        static std::vector<Test> tests;
+        return tests;
+    }
+
+    int failures = 0;
+
+    bool matches(const char* name, int filterCount, const char* const* filters)
+    {
+        for (int i = 0; i < filterCount; ++i)
+        {
+            if (strstr(name, filters[i]))
+                return true;
+        }
+        return 0 == filterCount;
+    }
+}
+
+namespace unittest
+{
+    Registrar::Registrar(const char* name, TestFunction function)
+    {
+        getTests().push_back({ name, function });
+    }
+
+    void check(bool condition, const char* what)
+    {
+        if (!condition)
+        {
+            fprintf(stderr, "FAILED: %s\n", what);
+            ++failures;
+        }
+    }
+
+    int getFailureCount()
+    {
+        return failures;
+    }
+
+    int report()
+    {
+        // After the output of benchmarks, stdout is buffered when piped.
+        fflush(stdout);
+        if (failures > 0)
+        {
+            fprintf(stderr, "FAILED: %d checks\n", failures);
+            return 1;
+        }
+        fprintf(stderr, "ok\n");
+        return 0;
+    }
+
+    int runTests(int filterCount, const char* const* filters)
+    {
+        int failedTests = 0;
+        for (const auto& test : getTests())
+        {
+            if (!matches(test.name, filterCount, filters))
+                continue;
+
+            int before = failures;
+            fprintf(stderr, "%s\n", test.name);
+            test.function();
+            if (failures != before)
+            {
+                fprintf(stderr, "%s: FAILED %d checks\n", test.name, failures - before);
+                ++failedTests;
+            }
+        }
+        return failedTests;
+    }
+}
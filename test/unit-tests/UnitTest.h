@@ -0,0 +1,43 @@
+//
+//  UnitTest.h
+//  unit-tests
+//
+//  The checks shared by the unit tests and the benchmarks. A unit test is a function defined with
+//  UNIT_TEST(name), test/unit-tests/main.cpp runs every registered test, or the ones named on its
+//  command line. Build them with test/build-tests.sh.
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace unittest
+{
+    typedef void (*TestFunction)();
+
+    // Registers `function` to be run as the test `name`, used by UNIT_TEST().
+    struct Registrar
+    {
+        Registrar(const char* name, TestFunction function);
+    };
+
+    // Counts a failure and prints `what` if `condition` is false.
+    void check(bool condition, const char* what);
+    int getFailureCount();
+
+    // Prints the number of failed checks, or "ok", and returns the exit status of the program.
+    int report();
+
+    // Runs the registered tests whose name contains one of `filters`, or every test without filters.
+    // Returns the number of tests that failed a check.
+    int runTests(int filterCount, const char* const* filters);
+
+    // The number of times operator new was called so far, by any thread. See AllocationCounter.cpp.
+    size_t getAllocationCount();
+}
+
+// The test function is name##Test, so a test can be named after the class it tests.
+#define UNIT_TEST(name) \
+    static void name##Test(); \
+    static unittest::Registrar name##Registrar(#name, name##Test); \
+    static void name##Test()
@@ -0,0 +1,87 @@
+//
+//  VertexAttributeTest.cpp
+//  unit-tests
+//
+//  Draws with a render pipeline of two vertex layouts against fake-gl, and checks that only the attributes
+//  of the vertex buffers bound for a draw are enabled, so an attribute enabled by an earlier draw doesn't
+//  stay enabled when its buffer isn't set.
+//
+
+#include "FakeGL.h"
+#include "UnitTest.h"
+#include "backend/Device.h"
+#include "backend/Buffer.h"
+#include "backend/CommandBuffer.h"
+#include "backend/RenderPass.h"
+#include "backend/RenderPipeline.h"
+#include "backend/ShaderModule.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const char* VERTEX_SHADER =
+        "attribute vec2 a_position;\n"
+        "attribute vec4 a_color;\n"
+        "varying vec4 v_color;\n"
+        "void main() { v_color = a_color; gl_Position = vec4(a_position, 0.0, 1.0); }\n";
+    const char* FRAGMENT_SHADER =
+        "varying vec4 v_color;\n"
+        "void main() { gl_FragColor = v_color; }\n";
+
+    // fake-gl assigns attribute locations in declaration order.
+    const uint32_t POSITION = 1u << 0;
+    const uint32_t COLOR = 1u << 1;
+
+    // Draws with the vertex buffers that are not null, and returns the attributes fake-gl saw enabled.
+    uint32_t draw(backend::CommandBuffer* commandBuffer, backend::RenderPipeline* renderPipeline,
+                  backend::Buffer* positions, backend::Buffer* colors)
+    {
+        commandBuffer->setRenderPipeline(renderPipeline);
+        if (positions)
+            commandBuffer->setVertexBuffer(0, positions);
+        if (colors)
+            commandBuffer->setVertexBuffer(1, colors);
+        commandBuffer->drawArrays(backend::PrimitiveType::TRIANGLE, 0, 3);
+        return fakegl::getState().draws.back().enabledAttributes;
+    }
+}
+
+UNIT_TEST(VertexAttribute)
+{
+    auto device = backend::Device::getInstance();
+
+    backend::RenderPipelineDescriptor renderPipelineDescriptor;
+    renderPipelineDescriptor.setVertexShaderModule(device->createShaderModule(backend::ShaderStage::VERTEX, VERTEX_SHADER));
+    renderPipelineDescriptor.setFragmentShaderModule(device->createShaderModule(backend::ShaderStage::FRAGMENT, FRAGMENT_SHADER));
+    backend::VertexLayout positionLayout;
+    positionLayout.setAtrribute("a_position", 0, backend::VertexFormat::FLOAT_R32G32, 0);
+    positionLayout.setLayout(2 * sizeof(float), backend::VertexStepMode::VERTEX);
+    renderPipelineDescriptor.setVertexLayout(0, positionLayout);
+    backend::VertexLayout colorLayout;
+    colorLayout.setAtrribute("a_color", 1, backend::VertexFormat::FLOAT_R32G32B32A32, 0);
+    colorLayout.setLayout(4 * sizeof(float), backend::VertexStepMode::VERTEX);
+    renderPipelineDescriptor.setVertexLayout(1, colorLayout);
+    auto renderPipeline = device->newRenderPipeline(renderPipelineDescriptor);
+
+    auto positions = device->newBuffer(3 * 2 * sizeof(float), backend::BufferType::VERTEX, backend::BufferUsage::READ);
+    auto colors = device->newBuffer(3 * 4 * sizeof(float), backend::BufferType::VERTEX, backend::BufferUsage::READ);
+
+    backend::RenderPassDescriptor renderPassDescriptor;
+    auto renderPass = device->newRenderPass(renderPassDescriptor);
+    auto commandBuffer = device->newCommandBuffer();
+    commandBuffer->beginRenderPass(renderPass);
+
+    check((POSITION | COLOR) == draw(commandBuffer, renderPipeline, positions, colors), "the attributes of both vertex buffers are enabled");
+    check(POSITION == draw(commandBuffer, renderPipeline, positions, nullptr), "the attributes of a layout without a vertex buffer are disabled");
+    check(COLOR == draw(commandBuffer, renderPipeline, nullptr, colors), "the attributes of a layout before the bound vertex buffer are disabled");
+    check((POSITION | COLOR) == draw(commandBuffer, renderPipeline, positions, colors), "the attributes are enabled again once their vertex buffers are bound");
+
+    commandBuffer->endRenderPass();
+    commandBuffer->release();
+    renderPass->release();
+    positions->release();
+    colors->release();
+    renderPipeline->release();
+}
@@ -0,0 +1,22 @@
+//
+//  main.cpp
+//  unit-tests
+//
+//  Runs the unit tests, every test or the ones whose name contains one of the arguments, and exits with
+//  a non-zero status if a check fails. The engine logs go to stdout and the results to stderr.
+//
+//  Usage:
+//  unit-tests [test name ...] > /dev/null
+//
+
+#include <cstdio>
+
+#include "UnitTest.h"
+
+int main(int argc, char* argv[])
+{
+    int failedTests = unittest::runTests(argc - 1, argv + 1);
+    if (failedTests > 0)
+        fprintf(stderr, "FAILED: %d tests\n", failedTests);
+    return unittest::report();
+}
@@ -0,0 +1,282 @@
+//
+//  main.cpp
+//  utf8-benchmark
+//
+//  Compares StringUtils::UTF8ToUTF16, UTF16ToUTF8, getCharacterCountInUTF8String and isValidUTF8String
+//  against the scalar ConvertUTF routines on localized string tables. Without arguments it uses the
+//  built-in tables below, otherwise every line of each file is one entry of a table. Random and mutated
+//  byte strings check that both sides reject the same invalid input.
+//  Exits with a non-zero status if any result differs from ConvertUTF.
+//
+//  Built by test/build-tests.sh.
+//
+//  Usage:
+//  utf8-benchmark [strings.txt]...
+//
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "UnitTest.h"
+#include "base/ccUTF8.h"
+#include "ConvertUTF/ConvertUTF.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    struct Table
+    {
+        std::string name;
+        std::vector<std::string> strings;
+    };
+
+    const char* english[] = {
+        "Play", "Settings", "Continue", "New Game", "Are you sure you want to quit?",
+        "Level %d complete!", "You have unlocked a new character.", "Loading, please wait...",
+        "Tap anywhere to start", "Connection lost. Check your network settings and try again.",
+    };
+    const char* french[] = {
+        "Jouer", "Paramètres", "Continuer", "Nouvelle partie", "Voulez-vous vraiment quitter ?",
+        "Niveau %d terminé !", "Vous avez débloqué un nouveau personnage.", "Chargement, veuillez patienter…",
+        "Touchez l'écran pour commencer", "Connexion perdue. Vérifiez vos paramètres réseau et réessayez.",
+    };
+    const char* russian[] = {
+        "Играть", "Настройки", "Продолжить", "Новая игра", "Вы уверены, что хотите выйти?",
+        "Уровень %d пройден!", "Вы открыли нового персонажа.", "Загрузка, пожалуйста, подождите...",
+        "Коснитесь экрана, чтобы начать", "Соединение потеряно. Проверьте настройки сети и повторите попытку.",
+    };
+    const char* chinese[] = {
+        "开始游戏", "设置", "继续", "新游戏", "确定要退出吗？",
+        "第%d关完成！", "你解锁了一个新角色。", "加载中，请稍候……",
+        "点击任意位置开始", "连接已断开，请检查网络设置后重试。",
+    };
+    const char* japanese[] = {
+        "プレイ", "設定", "つづける", "ニューゲーム", "本当に終了しますか？",
+        "レベル%dクリア！", "新しいキャラクターが解放されました。", "読み込み中です。しばらくお待ちください…",
+        "画面をタップしてスタート", "接続が切れました。ネットワーク設定を確認して再試行してください。",
+    };
+    const char* mixed[] = {
+        "Score: 12345 🏆", "Player_01 说：gg", "HP 100/100 ⚔️ MP 50/50", "Ünïcödé ñame — «quoted»",
+        "{\"title\":\"新しいイベント\",\"reward\":500,\"icon\":\"event_star.png\"}",
+        "𝔘𝔫𝔦𝔠𝔬𝔡𝔢 outside the BMP 😀😁😂", "res/ui/buttons/btn_confirm_normal.png",
+    };
+
+    template <size_t N>
+    Table makeTable(const char* name, const char* (&strings)[N])
+    {
+        Table table;
+        table.name = name;
+        table.strings.assign(strings, strings + N);
+        return table;
+    }
+
+    bool referenceToUTF16(const std::string& utf8, std::u16string& out)
+    {
+        std::u16string working(utf8.length() * 2, 0);
+        auto src = reinterpret_cast<const UTF8*>(utf8.data());
+        auto dst = reinterpret_cast<UTF16*>(&working[0]);
+        if (ConvertUTF8toUTF16(&src, src + utf8.length(), &dst, dst + working.length(), strictConversion) != conversionOK)
+            return false;
+        working.resize(reinterpret_cast<char16_t*>(dst) - &working[0]);
+        out = working;
+        return true;
+    }
+
+    bool referenceToUTF8(const std::u16string& utf16, std::string& out)
+    {
+        std::string working(utf16.length() * 4, 0);
+        auto src = reinterpret_cast<const UTF16*>(utf16.data());
+        auto dst = reinterpret_cast<UTF8*>(&working[0]);
+        if (ConvertUTF16toUTF8(&src, src + utf16.length(), &dst, dst + working.length(), strictConversion) != conversionOK)
+            return false;
+        working.resize(reinterpret_cast<char*>(dst) - &working[0]);
+        out = working;
+        return true;
+    }
+
+    bool referenceIsValid(const std::string& utf8)
+    {
+        auto src = reinterpret_cast<const UTF8*>(utf8.data());
+        return isLegalUTF8String(&src, src + utf8.length());
+    }
+
+    // Checks `ok`, and prints the bytes of `input` if it isn't.
+    void checkInput(bool ok, const char* what, const std::string& input)
+    {
+        check(ok, what);
+        if (ok)
+            return;
+        printf("MISMATCH %s:", what);
+        for (unsigned char c : input)
+            printf(" %02x", c);
+        printf("\n");
+    }
+
+    void checkUTF8(const std::string& utf8)
+    {
+        std::u16string expected, actual;
+        bool expectedOK = referenceToUTF16(utf8, expected);
+        bool actualOK = StringUtils::UTF8ToUTF16(utf8, actual);
+        checkInput(expectedOK == actualOK && (!expectedOK || expected == actual), "UTF8ToUTF16", utf8);
+        checkInput(referenceIsValid(utf8) == StringUtils::isValidUTF8String(utf8), "isValidUTF8String", utf8);
+        checkInput(getUTF8StringLength(reinterpret_cast<const UTF8*>(utf8.c_str())) == StringUtils::getCharacterCountInUTF8String(utf8),
+                   "getCharacterCountInUTF8String", utf8);
+    }
+
+    void checkUTF16(const std::u16string& utf16)
+    {
+        std::string expected, actual;
+        bool expectedOK = referenceToUTF8(utf16, expected);
+        bool actualOK = StringUtils::UTF16ToUTF8(utf16, actual);
+        if (expectedOK != actualOK || (expectedOK && expected != actual))
+        {
+            std::string bytes(reinterpret_cast<const char*>(utf16.data()), utf16.length() * sizeof(char16_t));
+            checkInput(false, "UTF16ToUTF8", bytes);
+        }
+    }
+
+    // Truncations, invalid lead and continuation bytes, overlong forms, surrogates and out of range
+    // code points, at every position relative to the 16 byte chunks.
+    void fuzz(const std::vector<Table>& tables)
+    {
+        std::mt19937 random(20181019);
+        const unsigned char interesting[] = {
+            0x00, 0x7F, 0x80, 0xBF, 0xC0, 0xC1, 0xC2, 0xDF, 0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xFF, 0x9F, 0xA0, 0x8F, 0x90,
+        };
+
+        for (int i = 0; i < 50000; ++i)
+        {
+            std::string s(random() % 40, 'a');
+            for (auto& c : s)
+            {
+                unsigned r = random() % 4;
+                c = static_cast<char>(r == 0 ? interesting[random() % sizeof(interesting)] : r == 1 ? random() & 0xFF : 'a' + random() % 26);
+            }
+            checkUTF8(s);
+
+            std::u16string u(random() % 40, u'a');
+            for (auto& c : u)
+            {
+                unsigned r = random() % 4;
+                c = static_cast<char16_t>(r == 0 ? 0xD800 + random() % 0x800 : r == 1 ? random() & 0xFFFF : 'a' + random() % 26);
+            }
+            checkUTF16(u);
+        }
+
+        for (const auto& table : tables)
+        {
+            for (const auto& str : table.strings)
+            {
+                std::string padded = std::string(random() % 32, 'x') + str + std::string(random() % 32, 'y');
+                checkUTF8(padded);
+                for (size_t cut = 0; cut < padded.length(); ++cut)
+                {
+                    checkUTF8(padded.substr(0, cut));
+                    std::string mutated = padded;
+                    mutated[cut] = static_cast<char>(interesting[random() % sizeof(interesting)]);
+                    checkUTF8(mutated);
+                }
+
+                std::u16string utf16;
+                if (referenceToUTF16(padded, utf16))
+                {
+                    checkUTF16(utf16);
+                    for (size_t cut = 0; cut < utf16.length(); ++cut)
+                        checkUTF16(utf16.substr(0, cut));
+                }
+            }
+        }
+    }
+
+    template <typename F>
+    double measure(size_t bytes, F func)
+    {
+        const int rounds = 50;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i)
+            func();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return bytes * (double)rounds / elapsed.count() / (1024.0 * 1024.0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<Table> tables;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::ifstream file(argv[i]);
+        if (!file)
+        {
+            printf("Can't open %s\n", argv[i]);
+            return 1;
+        }
+        Table table;
+        table.name = argv[i];
+        std::string line;
+        while (std::getline(file, line))
+            table.strings.push_back(line);
+        tables.push_back(table);
+    }
+    if (tables.empty())
+    {
+        tables.push_back(makeTable("english", english));
+        tables.push_back(makeTable("french", french));
+        tables.push_back(makeTable("russian", russian));
+        tables.push_back(makeTable("chinese", chinese));
+        tables.push_back(makeTable("japanese", japanese));
+        tables.push_back(makeTable("mixed", mixed));
+    }
+
+    fuzz(tables);
+
+    printf("%-24s %8s | %8s %8s | %8s %8s | %8s %8s  (MB/s of UTF-8)\n", "table", "bytes",
+           "to16 ref", "to16", "to8 ref", "to8", "count ref", "count");
+
+    volatile size_t sink = 0;
+    for (const auto& table : tables)
+    {
+        // Repeat the table so timings are not dominated by clock resolution.
+        std::vector<std::string> strings;
+        std::vector<std::u16string> utf16s;
+        size_t bytes = 0;
+        while (bytes < 1024 * 1024)
+        {
+            for (const auto& str : table.strings)
+            {
+                std::u16string utf16;
+                if (!referenceToUTF16(str, utf16))
+                    continue;
+                checkUTF8(str);
+                checkUTF16(utf16);
+                strings.push_back(str);
+                utf16s.push_back(utf16);
+                bytes += str.length();
+            }
+            if (strings.empty())
+                break;
+        }
+        if (strings.empty())
+            continue;
+
+        std::u16string utf16;
+        std::string utf8;
+        double to16Ref = measure(bytes, [&]() { for (const auto& s : strings) { referenceToUTF16(s, utf16); sink += utf16.length(); } });
+        double to16 = measure(bytes, [&]() { for (const auto& s : strings) { StringUtils::UTF8ToUTF16(s, utf16); sink += utf16.length(); } });
+        double to8Ref = measure(bytes, [&]() { for (const auto& s : utf16s) { referenceToUTF8(s, utf8); sink += utf8.length(); } });
+        double to8 = measure(bytes, [&]() { for (const auto& s : utf16s) { StringUtils::UTF16ToUTF8(s, utf8); sink += utf8.length(); } });
+        double countRef = measure(bytes, [&]() { for (const auto& s : strings) sink += getUTF8StringLength(reinterpret_cast<const UTF8*>(s.c_str())); });
+        double count = measure(bytes, [&]() { for (const auto& s : strings) sink += StringUtils::getCharacterCountInUTF8String(s); });
+
+        printf("%-24s %8ld | %8.1f %8.1f | %8.1f %8.1f | %8.1f %8.1f\n", table.name.c_str(), (long)bytes,
+               to16Ref, to16, to8Ref, to8, countRef, count);
+    }
+
+    return unittest::report();
+}
@@ -0,0 +1,142 @@
+//
+//  main.cpp
+//  value-benchmark
+//
+//  Microbenchmarks for cocos2d::Value: the time and the heap allocations per operation of the copies,
+//  assignments and lookups the engine does with ValueMaps, counted by the operator new of test/unit-tests.
+//  Also checks that copies of shared containers don't see writes made through the other copy, and exits
+//  with a non-zero status if they do.
+//
+//  Built by test/build-tests.sh.
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "UnitTest.h"
+#include "base/CCValue.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const int ITERATIONS = 20000;
+
+    // What an effect define template and a small plist dictionary look like.
+    ValueMap makeDefine(int i)
+    {
+        ValueMap define;
+        define["name"] = "USE_DEFINE_" + std::to_string(i);
+        define["value"] = (i % 2) == 0;
+        return define;
+    }
+
+    ValueMap makeFrame(int i)
+    {
+        ValueMap frame;
+        frame["frame"] = "{{" + std::to_string(i) + ",0},{32,32}}";
+        frame["offset"] = "{0,0}";
+        frame["rotated"] = false;
+        frame["sourceColorRect"] = "{{0,0},{32,32}}";
+        frame["sourceSize"] = "{32,32}";
+        return frame;
+    }
+
+    ValueMap makeAtlas(int frames)
+    {
+        ValueMap frameMap;
+        for (int i = 0; i < frames; ++i)
+            frameMap["frame_" + std::to_string(i) + ".png"] = makeFrame(i);
+
+        ValueMap metadata;
+        metadata["format"] = 2;
+        metadata["textureFileName"] = "atlas.png";
+
+        ValueMap atlas;
+        atlas["frames"] = std::move(frameMap);
+        atlas["metadata"] = std::move(metadata);
+        return atlas;
+    }
+
+    template <typename F>
+    void run(const char* name, F f)
+    {
+        size_t allocations = unittest::getAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i)
+            f(i);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ITERATIONS;
+        printf("%-32s %10.1f ns %10.2f allocations\n", name, ns, (double)(unittest::getAllocationCount() - allocations) / ITERATIONS);
+    }
+}
+
+int main()
+{
+    std::vector<ValueMap> defines;
+    for (int i = 0; i < 12; ++i)
+        defines.push_back(makeDefine(i));
+    Value atlas(makeAtlas(64));
+    Value longString(std::string(64, 'x'));
+    volatile size_t sink = 0;
+
+    printf("%-32s %13s %21s  (per operation)\n", "", "time", "heap");
+    run("copy short string", [&](int) {
+        Value v("USE_TEXTURE");
+        Value copy(v);
+        sink += copy.getType() == Value::Type::STRING;
+    });
+    run("copy long string", [&](int) {
+        Value copy(longString);
+        sink += copy.getType() == Value::Type::STRING;
+    });
+    run("assign string by move", [&](int i) {
+        std::string s(40, 'a' + i % 26);
+        Value v;
+        v = std::move(s);
+        sink += v.getType() == Value::Type::STRING;
+    });
+    run("copy 12 define templates", [&](int) {
+        std::vector<ValueMap> copy(defines);
+        sink += copy.size();
+    });
+    run("copy 64 frame atlas Value", [&](int) {
+        Value copy(atlas);
+        sink += copy.getType() == Value::Type::MAP;
+    });
+    run("const read of copied atlas", [&](int) {
+        const Value copy(atlas);
+        const auto& frames = copy.asValueMap().at("frames").asValueMap();
+        sink += frames.at("frame_7.png").asValueMap().at("rotated").asBool();
+    });
+    run("grow ValueVector of maps", [&](int) {
+        ValueVector v;
+        for (int j = 0; j < 16; ++j)
+            v.push_back(Value(defines[j % 12]));
+        sink += v.size();
+    });
+    const std::string name("cc_matViewProjInverse");
+    const Value internedName = Value::intern(name);
+    run("compare interned names", [&](int) {
+        Value a = Value::intern(name);
+        sink += a == internedName;
+    });
+
+    // copy-on-write must not leak writes between copies
+    Value original(makeAtlas(4));
+    Value copy(original);
+    copy.asValueMap()["metadata"].asValueMap()["format"] = 3;
+    check(original.asValueMap().at("metadata").asValueMap().at("format").asInt() == 2, "a write through a copy doesn't change the original");
+
+    ValueMap& frames = original.asValueMap()["frames"].asValueMap();
+    Value later(original);
+    frames.erase("frame_0.png");
+    check(later.asValueMap().at("frames").asValueMap().size() == 4, "a write through the original doesn't change a copy");
+
+    Value interned = Value::intern(std::string(32, 'k'));
+    check(interned.asString() == std::string(32, 'k') && interned == Value(std::string(32, 'k')), "interned strings equal their value");
+
+    return unittest::report();
+}
@@ -0,0 +1,257 @@
+//
+//  main.cpp
+//  zip-benchmark
+//
+//  Writes a large zip archive of stored and deflated entries, checks that ZipFile reads every
+//  entry back correctly from several threads at once and that empty entries read as empty files,
+//  then prints the read throughput with one thread, with all threads behind a single lock (how reads
+//  were serialized before) and with all threads reading concurrently, for an archive opened from a
+//  path and from a mapped file. Every figure is the best of a few runs after a warm-up run.
+//  Reads from a path go through the file system and may not scale with threads, see ZipFile.
+//  Exits with a non-zero status if an entry reads back wrong.
+//
+//  Built by test/build-tests.sh.
+//
+//  Usage:
+//  zip-benchmark [archive path, default /tmp/zip-benchmark.zip]
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+#include "UnitTest.h"
+#include "platform/CCFileUtils.h"
+#include "base/ZipUtils.h"
+
+using namespace cocos2d;
+using unittest::check;
+
+namespace
+{
+    const int ENTRY_COUNT = 256;
+    const size_t ENTRY_SIZE = 256 * 1024;
+    const int ROUNDS = 4;
+    const int RUNS = 3;
+
+    struct Entry
+    {
+        std::string name;
+        std::vector<unsigned char> data;
+    };
+
+    void put16(std::vector<unsigned char>& out, uint32_t v) { out.push_back(v & 0xff); out.push_back((v >> 8) & 0xff); }
+    void put32(std::vector<unsigned char>& out, uint32_t v) { put16(out, v & 0xffff); put16(out, v >> 16); }
+
+    // Raw deflate as zip expects it, no zlib header.
+    std::vector<unsigned char> deflateRaw(const std::vector<unsigned char>& in)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        std::vector<unsigned char> out(deflateBound(&stream, in.size()));
+        stream.next_in = const_cast<unsigned char*>(in.data());
+        stream.avail_in = (uInt)in.size();
+        stream.next_out = out.data();
+        stream.avail_out = (uInt)out.size();
+        deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return out;
+    }
+
+    bool writeArchive(const std::string& path, const std::vector<Entry>& entries)
+    {
+        std::vector<unsigned char> archive, directory;
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const Entry& entry = entries[i];
+            // Odd entries are stored, the way apk packaging keeps media files.
+            bool stored = i % 2;
+            std::vector<unsigned char> payload = stored ? entry.data : deflateRaw(entry.data);
+            uint32_t crc = (uint32_t)crc32(0, entry.data.data(), (uInt)entry.data.size());
+            uint32_t offset = (uint32_t)archive.size();
+
+            put32(archive, 0x04034b50);
+            put16(archive, 20); put16(archive, 0); put16(archive, stored ? 0 : 8); put16(archive, 0); put16(archive, 0);
+            put32(archive, crc); put32(archive, (uint32_t)payload.size()); put32(archive, (uint32_t)entry.data.size());
+            put16(archive, (uint32_t)entry.name.size()); put16(archive, 0);
+            archive.insert(archive.end(), entry.name.begin(), entry.name.end());
+            archive.insert(archive.end(), payload.begin(), payload.end());
+
+            put32(directory, 0x02014b50);
+            put16(directory, 20); put16(directory, 20); put16(directory, 0); put16(directory, stored ? 0 : 8); put16(directory, 0); put16(directory, 0);
+            put32(directory, crc); put32(directory, (uint32_t)payload.size()); put32(directory, (uint32_t)entry.data.size());
+            put16(directory, (uint32_t)entry.name.size()); put16(directory, 0); put16(directory, 0); put16(directory, 0); put16(directory, 0);
+            put32(directory, 0); put32(directory, offset);
+            directory.insert(directory.end(), entry.name.begin(), entry.name.end());
+        }
+
+        uint32_t directoryOffset = (uint32_t)archive.size();
+        archive.insert(archive.end(), directory.begin(), directory.end());
+        put32(archive, 0x06054b50);
+        put16(archive, 0); put16(archive, 0); put16(archive, (uint32_t)entries.size()); put16(archive, (uint32_t)entries.size());
+        put32(archive, (uint32_t)directory.size()); put32(archive, directoryOffset); put16(archive, 0);
+
+        FILE* fp = fopen(path.c_str(), "wb");
+        if (!fp)
+            return false;
+        bool ret = fwrite(archive.data(), 1, archive.size(), fp) == archive.size();
+        fclose(fp);
+        return ret;
+    }
+
+    // Every thread reads every entry ROUNDS times, starting at a different entry. Returns the MB/s.
+    double readAll(ZipFile* zip, const std::vector<Entry>& entries, int threadCount, std::mutex* serialize, std::atomic<int>* failures)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([=, &entries]() {
+                std::vector<unsigned char> data;
+                ResizableBufferAdapter<std::vector<unsigned char>> adapter(&data);
+                for (int round = 0; round < ROUNDS; ++round)
+                {
+                    for (size_t i = 0; i < entries.size(); ++i)
+                    {
+                        const Entry& entry = entries[(i + t * entries.size() / threadCount) % entries.size()];
+                        bool ok;
+                        if (serialize)
+                        {
+                            std::lock_guard<std::mutex> lock(*serialize);
+                            ok = zip->getFileData(entry.name, &adapter);
+                        }
+                        else
+                        {
+                            ok = zip->getFileData(entry.name, &adapter);
+                        }
+                        if (!ok || data != entry.data)
+                            ++*failures;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double megabytes = (double)threadCount * ROUNDS * entries.size() * ENTRY_SIZE / (1024.0 * 1024.0);
+        return megabytes / seconds;
+    }
+
+    double bestOf(ZipFile* zip, const std::vector<Entry>& entries, int threadCount, std::mutex* serialize, std::atomic<int>* failures)
+    {
+        double best = 0;
+        for (int run = 0; run < RUNS; ++run)
+            best = std::max(best, readAll(zip, entries, threadCount, serialize, failures));
+        return best;
+    }
+
+    void benchmark(const char* title, ZipFile* zip, const std::vector<Entry>& entries, int threadCount, std::atomic<int>* failures)
+    {
+        // Warm up the page cache and the pool of unzip handles.
+        readAll(zip, entries, threadCount, nullptr, failures);
+
+        std::mutex lock;
+        double single = bestOf(zip, entries, 1, nullptr, failures);
+        double serialized = bestOf(zip, entries, threadCount, &lock, failures);
+        double concurrent = bestOf(zip, entries, threadCount, nullptr, failures);
+        printf("%-8s 1 thread %8.1f MB/s, %d threads locked %8.1f MB/s, %d threads concurrent %8.1f MB/s\n",
+               title, single, threadCount, serialized, threadCount, concurrent);
+    }
+
+    // Empty entries are files too, malloc(0) may return nullptr but that isn't a failed read.
+    void checkEmptyEntries(ZipFile* zip, const std::vector<std::string>& names, std::atomic<int>* failures)
+    {
+        for (const auto& name : names)
+        {
+            ssize_t size = -1;
+            unsigned char* bytes = zip->getFileData(name, &size);
+            if (!bytes || 0 != size)
+                ++*failures;
+            free(bytes);
+
+            std::vector<unsigned char> data(1);
+            ResizableBufferAdapter<std::vector<unsigned char>> adapter(&data);
+            if (!zip->getFileData(name, &adapter) || !data.empty())
+                ++*failures;
+
+            MappedFile* file = zip->mapFile(name);
+            if (!file || 0 != file->getSize())
+                ++*failures;
+            CC_SAFE_RELEASE(file);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string path = argc > 1 ? argv[1] : "/tmp/zip-benchmark.zip";
+
+    // Half random bytes, half repeating text, so the deflated entries actually compress.
+    std::mt19937 random(42);
+    std::vector<Entry> entries(ENTRY_COUNT);
+    for (int i = 0; i < ENTRY_COUNT; ++i)
+    {
+        entries[i].name = "assets/res/" + std::to_string(i) + ".bin";
+        entries[i].data.resize(ENTRY_SIZE);
+        for (size_t j = 0; j < ENTRY_SIZE; ++j)
+            entries[i].data[j] = j < ENTRY_SIZE / 2 ? (unsigned char)random() : (unsigned char)("cocos2d-x "[j % 10] + i);
+    }
+
+    // An empty entry of each kind, after the others so they keep their parity.
+    std::vector<Entry> archived(entries);
+    archived.resize(entries.size() + 2);
+    archived[entries.size()].name = "assets/res/empty-deflated.bin";
+    archived[entries.size() + 1].name = "assets/res/empty-stored.bin";
+    const std::vector<std::string> emptyNames = { archived[entries.size()].name, archived[entries.size() + 1].name };
+
+    if (!writeArchive(path, archived))
+    {
+        printf("Can't write %s\n", path.c_str());
+        return 1;
+    }
+
+    int threadCount = std::max(2u, std::thread::hardware_concurrency());
+    std::atomic<int> failures(0);
+
+    ZipFile* zip = new ZipFile(path);
+    checkEmptyEntries(zip, emptyNames, &failures);
+    benchmark("path", zip, entries, threadCount, &failures);
+    delete zip;
+
+    MappedFile* mapped = FileUtils::getInstance()->mapFile(path);
+    zip = ZipFile::createWithMappedFile(mapped);
+    CC_SAFE_RELEASE(mapped);
+    if (!zip)
+    {
+        printf("Can't open the mapped archive\n");
+        return 1;
+    }
+    checkEmptyEntries(zip, emptyNames, &failures);
+    benchmark("mapped", zip, entries, threadCount, &failures);
+
+    // Stored entries of the mapped archive are views, compressed ones are copies.
+    for (int i = 0; i < 2; ++i)
+    {
+        MappedFile* file = zip->mapFile(entries[i].name);
+        if (!file || file->getSize() != (ssize_t)ENTRY_SIZE || memcmp(file->getBytes(), entries[i].data.data(), ENTRY_SIZE) != 0
+            || file->isMapped() != (i % 2 == 1))
+            ++failures;
+        CC_SAFE_RELEASE(file);
+    }
+    delete zip;
+    remove(path.c_str());
+
+    check(0 == failures, "every entry reads back");
+    return unittest::report();
+}
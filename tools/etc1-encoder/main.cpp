@@ -0,0 +1,338 @@
+//
+//  main.cpp
+//  etc1-encoder
+//
+//  Batch converts PNG files into ETC1 PKM or KTX textures for the asset pipeline.
+//  Files are encoded concurrently by a pool of workers, a single large image is split
+//  into rows of blocks across all of them instead. The alpha channel is dropped.
+//
+//  The quality presets are checked by the Etc1Encoder unit test in test/unit-tests.
+//
+//  Build from the repository root, for example:
+//  c++ -O2 -std=c++11 -pthread -Icocos -Iexternal/source tools/etc1-encoder/main.cpp cocos/base/etc1.cpp -lpng -o etc1-encoder
+//
+//  Usage:
+//  etc1-encoder [-q fast|medium|high] [-f pkm|ktx] [-m] [-j threads] [-o dir] <png file or directory>...
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <png.h>
+
+#include "base/etc1.h"
+#include "tinydir/tinydir.h"
+
+namespace
+{
+    // GL_RGB, the base internal format of ETC1 textures in a KTX header
+    const uint32_t KTX_GL_RGB = 0x1907;
+    
+    const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    
+    struct Options
+    {
+        int quality = ETC1_QUALITY_MEDIUM;
+        bool ktx = false;
+        bool mipmaps = false;
+        int threads = 0;
+        std::string outputDir;
+    };
+    
+    struct RGBImage
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;
+    };
+    
+    std::mutex s_logMutex;
+    
+    void usage()
+    {
+        fprintf(stderr,
+                "usage: etc1-encoder [-q fast|medium|high] [-f pkm|ktx] [-m] [-j threads] [-o dir] <png file or directory>...\n"
+                "  -q  encoder preset, medium by default\n"
+                "  -f  output container, pkm by default\n"
+                "  -m  generate mipmaps, ktx only\n"
+                "  -j  number of worker threads, all hardware threads by default\n"
+                "  -o  output directory, next to the input files by default\n");
+    }
+    
+    bool hasPngExtension(const std::string& path)
+    {
+        if (path.size() < 4)
+            return false;
+        
+        std::string extension = path.substr(path.size() - 4);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".png";
+    }
+    
+    // Adds the PNG files below `path` to `files`, or `path` itself if it is a file.
+    void collectFiles(const std::string& path, std::vector<std::string>& files)
+    {
+        tinydir_dir dir;
+        if (tinydir_open(&dir, path.c_str()) == -1)
+        {
+            files.push_back(path);
+            return;
+        }
+        
+        for (; dir.has_next; tinydir_next(&dir))
+        {
+            tinydir_file file;
+            if (tinydir_readfile(&dir, &file) == -1)
+                continue;
+            
+            if (file.is_dir)
+            {
+                if (strcmp(file.name, ".") != 0 && strcmp(file.name, "..") != 0)
+                    collectFiles(file.path, files);
+            }
+            else if (hasPngExtension(file.path))
+            {
+                files.push_back(file.path);
+            }
+        }
+        tinydir_close(&dir);
+    }
+    
+    bool readPng(const std::string& path, RGBImage& image)
+    {
+        png_image png;
+        memset(&png, 0, sizeof(png));
+        png.version = PNG_IMAGE_VERSION;
+        
+        if (!png_image_begin_read_from_file(&png, path.c_str()))
+            return false;
+        
+        // read as RGBA and drop the alpha, so it isn't composited into the colors
+        png.format = PNG_FORMAT_RGBA;
+        std::vector<uint8_t> rgba(PNG_IMAGE_SIZE(png));
+        if (!png_image_finish_read(&png, nullptr, rgba.data(), 0, nullptr))
+        {
+            png_image_free(&png);
+            return false;
+        }
+        
+        image.width = png.width;
+        image.height = png.height;
+        image.pixels.resize(image.width * image.height * 3);
+        for (size_t i = 0, count = image.width * image.height; i < count; ++i)
+            memcpy(&image.pixels[i * 3], &rgba[i * 4], 3);
+        return true;
+    }
+    
+    // Box filters `src` to half its size, odd rows and columns are clamped at the edge.
+    RGBImage downsample(const RGBImage& src)
+    {
+        RGBImage dst;
+        dst.width = std::max(src.width / 2, 1u);
+        dst.height = std::max(src.height / 2, 1u);
+        dst.pixels.resize(dst.width * dst.height * 3);
+        
+        for (uint32_t y = 0; y < dst.height; ++y)
+        {
+            uint32_t y0 = std::min(y * 2, src.height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                uint32_t x0 = std::min(x * 2, src.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+                for (int c = 0; c < 3; ++c)
+                {
+                    int sum = src.pixels[(y0 * src.width + x0) * 3 + c] + src.pixels[(y0 * src.width + x1) * 3 + c]
+                            + src.pixels[(y1 * src.width + x0) * 3 + c] + src.pixels[(y1 * src.width + x1) * 3 + c];
+                    dst.pixels[(y * dst.width + x) * 3 + c] = (uint8_t)((sum + 2) / 4);
+                }
+            }
+        }
+        return dst;
+    }
+    
+    bool encode(const RGBImage& image, const Options& options, int threads, std::vector<uint8_t>& encoded)
+    {
+        encoded.resize(etc1_get_encoded_data_size(image.width, image.height));
+        return etc1_encode_image_quality(image.pixels.data(), image.width, image.height, 3, image.width * 3,
+                                         encoded.data(), options.quality, threads) == 0;
+    }
+    
+    void appendUInt32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(value));
+    }
+    
+    bool writePkm(const RGBImage& image, const Options& options, int threads, std::vector<uint8_t>& out)
+    {
+        std::vector<uint8_t> encoded;
+        if (!encode(image, options, threads, encoded))
+            return false;
+        
+        out.resize(ETC_PKM_HEADER_SIZE);
+        etc1_pkm_format_header(out.data(), image.width, image.height);
+        out.insert(out.end(), encoded.begin(), encoded.end());
+        return true;
+    }
+    
+    bool writeKtx(const RGBImage& image, const Options& options, int threads, std::vector<uint8_t>& out)
+    {
+        std::vector<RGBImage> levels(1, image);
+        while (options.mipmaps && (levels.back().width > 1 || levels.back().height > 1))
+            levels.push_back(downsample(levels.back()));
+        
+        out.assign(KTX_IDENTIFIER, KTX_IDENTIFIER + sizeof(KTX_IDENTIFIER));
+        appendUInt32(out, 0x04030201);                // endianness
+        appendUInt32(out, 0);                         // glType, compressed
+        appendUInt32(out, 1);                         // glTypeSize
+        appendUInt32(out, 0);                         // glFormat, compressed
+        appendUInt32(out, ETC1_RGB8_OES);             // glInternalFormat
+        appendUInt32(out, KTX_GL_RGB);                // glBaseInternalFormat
+        appendUInt32(out, image.width);
+        appendUInt32(out, image.height);
+        appendUInt32(out, 0);                         // pixelDepth
+        appendUInt32(out, 0);                         // numberOfArrayElements
+        appendUInt32(out, 1);                         // numberOfFaces
+        appendUInt32(out, (uint32_t)levels.size());   // numberOfMipmapLevels
+        appendUInt32(out, 0);                         // bytesOfKeyValueData
+        
+        std::vector<uint8_t> encoded;
+        for (const auto& level : levels)
+        {
+            // ETC1 levels are a multiple of 8 bytes, so they need no padding
+            if (!encode(level, options, threads, encoded))
+                return false;
+            appendUInt32(out, (uint32_t)encoded.size());
+            out.insert(out.end(), encoded.begin(), encoded.end());
+        }
+        return true;
+    }
+    
+    std::string outputPath(const std::string& input, const Options& options)
+    {
+        std::string path = input.substr(0, input.size() - (hasPngExtension(input) ? 4 : 0));
+        if (!options.outputDir.empty())
+        {
+            size_t slash = path.find_last_of("/\\");
+            path = options.outputDir + "/" + (slash == std::string::npos ? path : path.substr(slash + 1));
+        }
+        return path + (options.ktx ? ".ktx" : ".pkm");
+    }
+    
+    bool convert(const std::string& input, const Options& options, int threads, uint64_t& pixels)
+    {
+        RGBImage image;
+        if (!readPng(input, image))
+        {
+            std::lock_guard<std::mutex> lock(s_logMutex);
+            fprintf(stderr, "%s: can't read PNG\n", input.c_str());
+            return false;
+        }
+        
+        std::vector<uint8_t> out;
+        bool encoded = options.ktx ? writeKtx(image, options, threads, out) : writePkm(image, options, threads, out);
+        
+        std::string output = outputPath(input, options);
+        FILE* file = encoded ? fopen(output.c_str(), "wb") : nullptr;
+        bool written = file && fwrite(out.data(), 1, out.size(), file) == out.size();
+        if (file)
+            written = (fclose(file) == 0) && written;
+        
+        std::lock_guard<std::mutex> lock(s_logMutex);
+        if (!written)
+        {
+            fprintf(stderr, "%s: can't write %s\n", input.c_str(), output.c_str());
+            return false;
+        }
+        printf("%s -> %s (%ux%u)\n", input.c_str(), output.c_str(), image.width, image.height);
+        pixels += (uint64_t)image.width * image.height;
+        return true;
+    }
+    
+    bool parseQuality(const char* name, int& quality)
+    {
+        if (strcmp(name, "fast") == 0)
+            quality = ETC1_QUALITY_FAST;
+        else if (strcmp(name, "medium") == 0)
+            quality = ETC1_QUALITY_MEDIUM;
+        else if (strcmp(name, "high") == 0)
+            quality = ETC1_QUALITY_HIGH;
+        else
+            return false;
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::vector<std::string> files;
+    
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-q" && hasValue && parseQuality(argv[i + 1], options.quality))
+            ++i;
+        else if (arg == "-f" && hasValue && (strcmp(argv[i + 1], "pkm") == 0 || strcmp(argv[i + 1], "ktx") == 0))
+            options.ktx = strcmp(argv[++i], "ktx") == 0;
+        else if (arg == "-m")
+            options.mipmaps = true;
+        else if (arg == "-j" && hasValue && atoi(argv[i + 1]) > 0)
+            options.threads = atoi(argv[++i]);
+        else if (arg == "-o" && hasValue)
+            options.outputDir = argv[++i];
+        else if (!arg.empty() && arg[0] != '-')
+            collectFiles(arg, files);
+        else
+        {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+    
+    if (files.empty() || (options.mipmaps && !options.ktx))
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+    
+    int threadCount = options.threads > 0 ? options.threads : std::max((int)std::thread::hardware_concurrency(), 1);
+    int workers = std::min(threadCount, (int)files.size());
+    // with fewer files than threads the threads left are shared by the files instead
+    int threadsPerFile = std::max(threadCount / std::max(workers, 1), 1);
+    
+    std::atomic<size_t> next(0);
+    std::atomic<int> failures(0);
+    uint64_t pixels = 0;
+    auto start = std::chrono::steady_clock::now();
+    
+    auto work = [&]() {
+        for (size_t i = next++; i < files.size(); i = next++)
+        {
+            if (!convert(files[i], options, threadsPerFile, pixels))
+                ++failures;
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+    
+    double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    printf("%zu files, %d failed, %.1f MP in %.2f s (%.1f MP/s)\n", files.size(), failures.load(), pixels / 1e6, seconds,
+           seconds > 0 ? pixels / 1e6 / seconds : 0.0);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}